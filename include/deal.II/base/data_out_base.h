@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1999 - 2017 by the deal.II authors
+// Copyright (C) 1999 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -30,6 +30,8 @@
 
 #include <deal.II/base/mpi.h>
 
+#include <boost/serialization/version.hpp>
+
 // Only include the Tecplot API header if the appropriate files
 // were detected by configure
 #ifdef DEAL_II_HAVE_TECPLOT
@@ -1118,16 +1120,78 @@ namespace DataOutBase
     /**
      * Flag determining the compression level at which zlib, if available, is
      * run. The default is <tt>best_compression</tt>.
+     *
+     * For VTU output, each data array is split into blocks of 1 MiB that are
+     * compressed independently and in parallel, as allowed by the VTK file
+     * format. For large output, the choice <tt>best_speed</tt> together with
+     * several threads reduces the time spent in compression considerably.
      */
     ZlibCompressionLevel compression_level;
 
+    /**
+     * Flag determining whether the compressed data arrays of VTU files are
+     * written as raw binary data into an <tt>&lt;AppendedData&gt;</tt>
+     * section at the end of the file, rather than base64 encoded inside
+     * the XML elements of the arrays. This avoids the encoding step and
+     * makes the files about a quarter smaller, but the files are no longer
+     * pure XML. The compressed data of all arrays is held in memory until
+     * the end of the file is written.
+     *
+     * Appended data is not supported by
+     * DataOutInterface::write_vtu_in_parallel(), since the offsets of the
+     * arrays would depend on the data of all other processes. The flag has
+     * no effect if deal.II was configured without zlib. The default is
+     * <tt>false</tt>.
+     */
+    bool appended_raw_data;
+
     /**
      * Constructor.
      */
     VtkFlags (const double       time   = std::numeric_limits<double>::min(),
               const unsigned int cycle  = std::numeric_limits<unsigned int>::min(),
               const bool print_date_and_time = true,
-              const ZlibCompressionLevel compression_level = best_compression);
+              const ZlibCompressionLevel compression_level = best_compression,
+              const bool appended_raw_data = false);
+  };
+
+
+  /**
+   * A structure that describes the outcome of writing one file collectively
+   * from several processes, see DataOutInterface::write_vtu_in_parallel().
+   *
+   * @ingroup output
+   */
+  struct ParallelWriteStatistics
+  {
+    /**
+     * Constructor. Initialize all fields with zero.
+     */
+    ParallelWriteStatistics ();
+
+    /**
+     * The total size of the file written, in bytes.
+     */
+    std::size_t n_bytes;
+
+    /**
+     * The number of processes that wrote data to the file.
+     */
+    unsigned int n_aggregators;
+
+    /**
+     * The wall time, in seconds, spent on distributing the data to the
+     * writing processes and writing it to the file. This is the maximum over
+     * all processes and does not include the time spent on generating the
+     * data in memory.
+     */
+    double wall_time;
+
+    /**
+     * Return the bandwidth achieved in writing the file, in bytes per
+     * second, i.e., @p n_bytes divided by @p wall_time.
+     */
+    double bandwidth () const;
   };
 
 
@@ -1876,10 +1940,20 @@ namespace DataOutBase
    */
   void write_vtu_footer (std::ostream &out);
 
+  /**
+   * Same as above, but if @p appended_data is not empty, also write it as
+   * the raw <tt>&lt;AppendedData&gt;</tt> section of the file, see
+   * VtkFlags::appended_raw_data.
+   */
+  void write_vtu_footer (std::ostream            &out,
+                         const std::vector<char> &appended_data);
+
   /**
    * This function writes the main part for the xml based vtu file format. This routine
    * is used internally together with DataOutInterface::write_vtu_header() and
    * DataOutInterface::write_vtu_footer() by DataOutBase::write_vtu().
+   *
+   * This function can not be used with VtkFlags::appended_raw_data set.
    */
   template <int dim, int spacedim>
   void write_vtu_main (const std::vector<Patch<dim,spacedim> > &patches,
@@ -1888,6 +1962,21 @@ namespace DataOutBase
                        const VtkFlags                          &flags,
                        std::ostream                            &out);
 
+  /**
+   * Same as above, but if VtkFlags::appended_raw_data is set, the data
+   * arrays are appended to @p appended_data instead of being written to @p
+   * out, with offsets counted from the beginning of @p appended_data. Pass
+   * the same array to several calls of this function to write several
+   * pieces into one file, and finally to write_vtu_footer().
+   */
+  template <int dim, int spacedim>
+  void write_vtu_main (const std::vector<Patch<dim,spacedim> > &patches,
+                       const std::vector<std::string>          &data_names,
+                       const std::vector<std::tuple<unsigned int, unsigned int, std::string> > &vector_data_ranges,
+                       const VtkFlags                          &flags,
+                       std::ostream                            &out,
+                       std::vector<char>                       &appended_data);
+
   /**
    * Some visualization programs, such as ParaView, can read several separate
    * VTU files that all form part of the same simulation, in order to
@@ -2480,9 +2569,28 @@ public:
    * one used by the computation.  This routine uses MPI I/O to achieve high
    * performance on parallel filesystems. Also see
    * DataOutInterface::write_vtu().
-   */
-  void write_vtu_in_parallel (const char *filename,
-                              MPI_Comm comm) const;
+   *
+   * Each process first generates its part of the file in memory. The
+   * position of each part in the file then follows from an exclusive prefix
+   * sum over the sizes of the parts. The processes are split into
+   * @p n_aggregators contiguous groups, and the first process of each group
+   * collects the data of its group and writes it with a single collective
+   * call to <code>MPI_File_write_at_all</code>. This avoids both the
+   * serialization through the shared file pointer and the many small
+   * requests to the file system that result from all processes writing on
+   * their own. A good choice for @p n_aggregators is often the number of
+   * nodes of the machine, or the number of storage targets the file is
+   * striped over. The default value of zero selects one aggregator for
+   * every 16 processes.
+   *
+   * The function returns the size of the file and the time spent on
+   * writing it, from which the achieved bandwidth can be computed. The
+   * returned values are the same on all processes.
+   */
+  DataOutBase::ParallelWriteStatistics
+  write_vtu_in_parallel (const char        *filename,
+                         MPI_Comm           comm,
+                         const unsigned int n_aggregators = 0) const;
 
   /**
    * Some visualization programs, such as ParaView, can read several separate
@@ -2740,6 +2848,15 @@ protected:
    */
   void validate_dataset_names () const;
 
+  /**
+   * Return the flags that are used for output in VTK and VTU format, as set
+   * by set_flags(). This allows derived classes that write VTU output
+   * piece by piece through DataOutBase::write_vtu_main() to respect the
+   * user's choices.
+   */
+  const DataOutBase::VtkFlags &
+  get_vtk_flags () const;
+
 
   /**
    * The default number of subdivisions for patches. This is filled by
@@ -3040,11 +3157,20 @@ public:
    */
   void add_attribute(const std::string &attr_name, const unsigned int dimension);
 
+  /**
+   * Set the groups within the HDF5 files in which the mesh and the solution
+   * data sets referenced by this entry are stored. By default, both are
+   * stored at the root of their files. The group names need to start with a
+   * slash, e.g., <code>/step_3</code>.
+   */
+  void set_hdf5_groups(const std::string &mesh_group,
+                       const std::string &solution_group);
+
   /**
    * Read or write the data of this object for serialization
    */
   template <class Archive>
-  void serialize(Archive &ar, const unsigned int /*version*/)
+  void serialize(Archive &ar, const unsigned int version)
   {
     ar &valid
     &h5_sol_filename
@@ -3054,6 +3180,11 @@ public:
     &num_cells
     &dimension
     &attribute_dims;
+
+    // the groups were added in version 1 of the serialization format.
+    // archives written before refer to the root groups
+    if (version >= 1)
+      ar &h5_mesh_group &h5_sol_group;
   }
 
   /**
@@ -3078,6 +3209,18 @@ private:
    */
   std::string h5_mesh_filename;
 
+  /**
+   * The group within the HDF5 solution file that contains the data sets of
+   * this entry. Empty for the root group.
+   */
+  std::string h5_sol_group;
+
+  /**
+   * The group within the HDF5 mesh file that contains the mesh of this
+   * entry. Empty for the root group.
+   */
+  std::string h5_mesh_group;
+
   /**
    * The simulation time associated with this entry.
    */
@@ -3112,6 +3255,169 @@ private:
 
 
 
+
+/**
+ * A class that writes the output of a transient simulation into a single
+ * HDF5 file, along with an XDMF file that describes the time series and that
+ * can be read by visualization programs such as Paraview and VisIt. This is
+ * an alternative to writing one HDF5 file per time step through
+ * DataOutInterface::write_hdf5_parallel(), which leads to thousands of files
+ * for long simulations.
+ *
+ * Each call to write_time_step() adds a group <code>/step_N</code> to the
+ * HDF5 file that contains one data set per output field. The mesh is stored
+ * in a group <code>/mesh_M</code> that is only written if the mesh has
+ * changed since the previous step, i.e., if the vertex locations or the
+ * connectivity of the output differ on any process; otherwise, the new step
+ * refers to the mesh already stored in the file. All data sets are chunked
+ * and can be compressed with the deflate filter, optionally preceded by the
+ * shuffle filter that tends to improve the compression of floating point
+ * data. With MPI and a parallel HDF5 library, all processes write to the
+ * file using collective I/O.
+ *
+ * The file is closed between time steps, and the entry of each new step is
+ * written over the closing tags at the end of the XDMF file, followed by the
+ * closing tags again. Both files are thus valid at any point of the
+ * simulation, and the cost of updating the XDMF file does not grow with the
+ * number of steps. A typical use looks like this:
+ * @code
+ * HDF5TimeSeriesWriter writer ("solution.h5", "solution.xdmf",
+ *                              MPI_COMM_WORLD);
+ * for (unsigned int step=0; step<n_steps; ++step)
+ *   {
+ *     ... // advance the solution in time
+ *
+ *     DataOut<dim> data_out;
+ *     data_out.attach_dof_handler (dof_handler);
+ *     data_out.add_data_vector (solution, "u");
+ *     data_out.build_patches ();
+ *     writer.write_time_step (data_out, time);
+ *   }
+ * @endcode
+ *
+ * @ingroup output
+ */
+class HDF5TimeSeriesWriter
+{
+public:
+  /**
+   * A structure with the options for the data sets written into the HDF5
+   * file.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor.
+     */
+    AdditionalData (const unsigned int compression_level = 4,
+                    const bool         shuffle = true,
+                    const unsigned int chunk_size = 65536,
+                    const bool         filter_duplicate_vertices = false);
+
+    /**
+     * The level at which the deflate filter compresses the data sets,
+     * between 1 (fastest) and 9 (best compression). Zero disables
+     * compression.
+     */
+    unsigned int compression_level;
+
+    /**
+     * Whether the shuffle filter, which reorders the bytes of the values
+     * so that the bytes of equal significance are stored together, is applied
+     * before compression.
+     */
+    bool shuffle;
+
+    /**
+     * The number of nodes (or cells, for the connectivity) stored in one
+     * chunk of a data set. Compression acts on whole chunks, and reading a
+     * part of a data set needs to read all the chunks it touches.
+     */
+    unsigned int chunk_size;
+
+    /**
+     * Whether duplicate vertices and associated values are filtered out,
+     * see DataOutBase::DataOutFilterFlags::filter_duplicate_vertices.
+     */
+    bool filter_duplicate_vertices;
+  };
+
+  /**
+   * Constructor. The HDF5 file @p h5_filename is created, replacing any
+   * existing file of this name, upon the first call to write_time_step(). The
+   * XDMF file is written by the first process of @p comm and refers to the
+   * HDF5 file by the name given here, so the two files should be placed in
+   * the same directory.
+   */
+  HDF5TimeSeriesWriter (const std::string    &h5_filename,
+                        const std::string    &xdmf_filename,
+                        const MPI_Comm       &comm,
+                        const AdditionalData &additional_data = AdditionalData());
+
+  /**
+   * Write the output data of @p data_out, on which build_patches() has
+   * been called before, as the next time step with the given @p time. This
+   * function needs to be called on all processes of the communicator given
+   * to the constructor.
+   */
+  template <int dim, int spacedim>
+  void write_time_step (const DataOutInterface<dim,spacedim> &data_out,
+                        const double                          time);
+
+  /**
+   * Return the number of time steps written so far.
+   */
+  unsigned int n_time_steps () const;
+
+  /**
+   * Return the number of meshes written so far, which is less than the
+   * number of time steps if the mesh did not change between some of them.
+   */
+  unsigned int n_meshes () const;
+
+private:
+  /**
+   * The names of the HDF5 and the XDMF file.
+   */
+  const std::string h5_filename;
+  const std::string xdmf_filename;
+
+  /**
+   * The communicator of all processes that write to the files.
+   */
+  MPI_Comm comm;
+
+  /**
+   * The options for the data sets.
+   */
+  const AdditionalData additional_data;
+
+  /**
+   * The number of time steps written so far.
+   */
+  unsigned int n_written_steps;
+
+  /**
+   * The position of the closing tags at the end of the XDMF file, where the
+   * entry of the next time step is written. Only used on the first process
+   * of the communicator.
+   */
+  std::streamoff xdmf_footer_position;
+
+  /**
+   * The number of meshes written into the HDF5 file so far.
+   */
+  unsigned int n_written_meshes;
+
+  /**
+   * A hash of the part of the mesh output by this process at the last time
+   * step. It is used to detect whether the mesh needs to be written again.
+   */
+  std::size_t last_mesh_hash;
+};
+
+
+
 /* -------------------- inline functions ------------------- */
 
 namespace DataOutBase
@@ -3158,4 +3464,7 @@ namespace DataOutBase
 
 DEAL_II_NAMESPACE_CLOSE
 
+// version 1 of the serialization format of XDMFEntry added the HDF5 groups
+BOOST_CLASS_VERSION(dealii::XDMFEntry, 1)
+
 #endif
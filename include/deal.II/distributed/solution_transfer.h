@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2009 - 2017 by the deal.II authors
+// Copyright (C) 2009 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -110,6 +110,27 @@ namespace parallel
      * sol_trans.deserialize (distributed_vector);
      * @endcode
      *
+     * For large computations, the checkpoint format of
+     * parallel::distributed::Triangulation::save_checkpoint() is usually
+     * faster, since it stores the data through collective MPI-IO calls
+     * instead of p4est's file routines, and since it only stores as many
+     * values per cell as the finite element on that cell actually has. It is
+     * used in the same way:
+     * @code
+     * parallel::distributed::SolutionTransfer<dim,VectorType> sol_trans(dof_handler);
+     * sol_trans.prepare_checkpoint (vector);
+     *
+     * triangulation.save_checkpoint(filename);
+     * @endcode
+     * and
+     * @code
+     * //[create coarse mesh...]
+     * triangulation.load_checkpoint(filename);
+     *
+     * parallel::distributed::SolutionTransfer<dim,VectorType> sol_trans(dof_handler);
+     * sol_trans.restore_checkpoint (distributed_vector);
+     * @endcode
+     *
      *
      * <h3>Interaction with hanging nodes</h3>
      *
@@ -214,6 +235,39 @@ namespace parallel
        */
       void deserialize(std::vector<VectorType *> &all_in);
 
+
+      /**
+       * Prepare writing the given vectors into the checkpoint created by the
+       * next call to parallel::distributed::Triangulation::save_checkpoint().
+       * The given vectors need all information on the locally active DoFs
+       * (they must be ghosted), and they as well as this object need to be
+       * alive until the checkpoint has been written.
+       */
+      void prepare_checkpoint(const std::vector<const VectorType *> &all_in);
+
+
+      /**
+       * Same as the function above, only for a single vector.
+       */
+      void prepare_checkpoint(const VectorType &in);
+
+
+      /**
+       * Read the vectors stored by prepare_checkpoint() after a call to
+       * parallel::distributed::Triangulation::load_checkpoint(). The DoFHandler
+       * needs to have distributed the degrees of freedom on the loaded mesh,
+       * with the same finite element as when the checkpoint was written. The
+       * given vectors must be fully distributed vectors without ghost
+       * elements.
+       */
+      void restore_checkpoint(std::vector<VectorType *> &all_out);
+
+
+      /**
+       * Same as the function above, only for a single vector.
+       */
+      void restore_checkpoint(VectorType &out);
+
     private:
       /**
        * Pointer to the degree of freedom handler to work with.
@@ -257,6 +311,23 @@ namespace parallel
        */
       void register_data_attach(const std::size_t size);
 
+      /**
+       * A callback function that appends the values of the input vectors on
+       * the given cell to the buffer of a checkpoint.
+       */
+      void pack_checkpoint_callback(const typename Triangulation<dim,DoFHandlerType::space_dimension>::cell_iterator &cell,
+                                    std::vector<char> &data);
+
+      /**
+       * A callback function that sets the values of the output vectors on
+       * the given cell from the data in <tt>[begin,end)</tt> stored in a
+       * checkpoint.
+       */
+      void unpack_checkpoint_callback(const typename Triangulation<dim,DoFHandlerType::space_dimension>::cell_iterator &cell,
+                                      const char *begin,
+                                      const char *end,
+                                      std::vector<VectorType *> &all_out);
+
     };
 
 
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2008 - 2017 by the deal.II authors
+// Copyright (C) 2008 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -32,6 +32,7 @@
 #include <utility>
 #include <functional>
 #include <tuple>
+#include <cstdint>
 
 #ifdef DEAL_II_WITH_MPI
 #  include <mpi.h>
@@ -667,6 +668,79 @@ namespace parallel
                                                         const CellStatus,
                                                         const void *)> &unpack_callback);
 
+      /**
+       * Register a function that will be used by save_checkpoint() to store
+       * data for each locally owned active cell. Contrary to
+       * register_data_attach(), the callback appends the data of the given
+       * cell to the end of the buffer passed as second argument, and the
+       * size of the data may differ from cell to cell, for example because
+       * the cells use finite elements of different degrees. The buffer
+       * holds the data of all cells of this process and is written to the
+       * file as a whole, so the callback must neither modify nor remove the
+       * data already in it. The data can be read back with
+       * notify_ready_to_unpack_checkpoint() after a call to
+       * load_checkpoint().
+       *
+       * Several functions can be registered. They are called in the order of
+       * their registration, and the data they store needs to be unpacked in
+       * the same order.
+       */
+      void
+      register_checkpoint_data_attach (const std::function<void (const cell_iterator &,
+                                                                  std::vector<char> &)> &pack_callback);
+
+      /**
+       * Write a checkpoint of the triangulation and of the data of all
+       * functions registered with register_checkpoint_data_attach() since
+       * the last checkpoint. This is a collective operation.
+       *
+       * Contrary to save(), the cell data is not funneled through p4est and
+       * is not limited to a fixed size per cell. It is written into the file
+       * @p filename with collective MPI-IO calls, whereas the refinement
+       * information of the forest is stored in a separate, comparatively
+       * small file <tt>filename.mesh</tt>. The data file consists of a
+       * header, a table with the offsets of the data of every cell and
+       * registered function, and the data itself. All cells are stored in the
+       * global order of the forest, so that the file does not depend on the
+       * number of processes nor on the partition. Every process therefore
+       * reads or writes a single contiguous part of the offset table and of
+       * the data, which may also be mapped into memory directly. The header
+       * records a format version, the dimensions, the number of cells and
+       * registered functions, as well as check sums of the mesh and of the
+       * data, which load_checkpoint() verifies.
+       */
+      void save_checkpoint (const std::string &filename) const;
+
+      /**
+       * Load a checkpoint written by save_checkpoint(). The triangulation
+       * must only consist of the same coarse mesh that was used when saving.
+       * The data stored for the locally owned cells can then be accessed by
+       * calls to notify_ready_to_unpack_checkpoint().
+       *
+       * If the checkpoint is loaded with the same number of processes it was
+       * written with and @p autopartition is false, the partition of the
+       * mesh is the same as when saving and no data needs to be moved
+       * between processes. Otherwise, the cells are distributed uniformly
+       * among the processes, and each process reads the data of the cells it
+       * then owns.
+       */
+      void load_checkpoint (const std::string &filename,
+                            const bool         autopartition = false);
+
+      /**
+       * Call @p unpack_callback for each locally owned active cell with the
+       * data stored for this cell by the next function, in the order of
+       * registration, passed to register_checkpoint_data_attach() before
+       * the checkpoint was written. The data is given as the range
+       * <tt>[begin,end)</tt>, which points into the buffer that
+       * load_checkpoint() read the file into. This buffer is released once
+       * the data of all registered functions has been unpacked.
+       */
+      void
+      notify_ready_to_unpack_checkpoint (const std::function<void (const cell_iterator &,
+                                                                   const char *,
+                                                                   const char *)> &unpack_callback);
+
       /**
        * Return a permutation vector for the order the coarse cells are handed
        * off to p4est. For example the value of the $i$th element in this
@@ -776,6 +850,31 @@ namespace parallel
        */
       callback_list_t attached_data_pack_callbacks;
 
+      /**
+       * List of callback functions registered by
+       * register_checkpoint_data_attach() that are going to be called by
+       * save_checkpoint().
+       */
+      std::vector<std::function<void (const cell_iterator &,
+                                     std::vector<char> &)> > checkpoint_pack_callbacks;
+
+      /**
+       * The data of the locally owned cells read by load_checkpoint(), and
+       * the offsets of the data of each cell and registered function into
+       * this array. The offsets are stored cell by cell, and relative to the
+       * beginning of the data of the first locally owned cell.
+       */
+      std::vector<char>          checkpoint_data;
+      std::vector<std::uint64_t> checkpoint_data_offsets;
+
+      /**
+       * The number of functions whose data is stored in the checkpoint read
+       * by load_checkpoint(), and the number of them that have been unpacked
+       * by notify_ready_to_unpack_checkpoint() so far.
+       */
+      unsigned int n_checkpoint_attachments;
+      unsigned int n_checkpoint_attachments_unpacked;
+
 
       /**
        * Two arrays that store which p4est tree corresponds to which coarse
@@ -27,6 +27,8 @@
 
 DEAL_II_NAMESPACE_OPEN
 
+template <int dim, typename Number> class MatrixFree;
+
 /**
  * Implementation of a number of renumbering algorithms for the degrees of
  * freedom on a triangulation. The functions in this namespace compute
@@ -211,6 +213,27 @@ DEAL_II_NAMESPACE_OPEN
  * by the other cell.
  *
  *
+ * <h3>Numberings for memory locality</h3>
+ *
+ * The function hilbert_curve() orders the active cells along a Hilbert
+ * space-filling curve through their centers and then numbers the degrees of
+ * freedom in the order in which they are first encountered on these cells.
+ * Cells that are close in space, and therefore share many degrees of
+ * freedom, are thus close in the numbering as well, which makes access to
+ * vector entries in loops over all cells (e.g., in assembly, or in matrix-free
+ * operator evaluation) and in sparse matrix-vector products more cache
+ * friendly. In contrast to the ordering of the cells of a
+ * parallel::distributed::Triangulation, which follows a Morton curve within
+ * each coarse cell, the curve is computed from the geometry of the mesh and
+ * is thus independent of the coarse mesh.
+ *
+ * The function matrix_free_data_locality() uses the order in which a
+ * MatrixFree object visits its batches of cells instead. After the
+ * renumbering, the degrees of freedom first accessed in one batch of cells
+ * form a contiguous range, with the ranges of subsequent batches following
+ * each other.
+ *
+ *
  * <h3>Random renumbering</h3>
  *
  * The random() function renumbers degrees of freedom randomly. This function
@@ -1034,6 +1057,84 @@ namespace DoFRenumbering
    * @}
    */
 
+  /**
+   * @name Numberings for memory locality
+   * @{
+   */
+
+  /**
+   * Renumber the degrees of freedom along a Hilbert space-filling curve
+   * through the centers of the active cells. The cells are sorted along the
+   * curve, and the degrees of freedom are numbered in the order in which
+   * they are first encountered on these cells, in the same way as done by
+   * cell_wise(). See the general documentation of this namespace for
+   * further information.
+   *
+   * For parallel triangulations, only the locally owned cells are sorted,
+   * and the locally owned degrees of freedom are permuted among the indices
+   * they had before. The numbering is thus independent of the ordering of
+   * the cells of the triangulation.
+   */
+  template <typename DoFHandlerType>
+  void
+  hilbert_curve (DoFHandlerType &dof_handler);
+
+  /**
+   * Compute the renumbering vector needed by the hilbert_curve() function.
+   * Does not perform the renumbering on the DoFHandler dofs but returns the
+   * renumbering vector, which has as many entries as there are locally owned
+   * degrees of freedom.
+   */
+  template <typename DoFHandlerType>
+  void
+  compute_hilbert_curve (std::vector<types::global_dof_index> &new_dof_indices,
+                         const DoFHandlerType                 &dof_handler);
+
+  /**
+   * Renumber the degrees of freedom in the order in which the cell loop of
+   * @p matrix_free visits them: the degrees of freedom are numbered in the
+   * order in which they are first encountered when going through the batches
+   * of cells of @p matrix_free, and through the cells within each batch.
+   * Thus, the degrees of freedom first accessed in one batch form a
+   * contiguous range of indices, and the vector entries accessed by
+   * subsequent batches are close in memory. This reduces the number of cache
+   * lines and memory pages touched by FEEvaluation::read_dof_values() and
+   * FEEvaluation::distribute_local_to_global().
+   *
+   * The object @p matrix_free must have been initialized with @p
+   * dof_handler. Since the renumbering changes the degrees of freedom, @p
+   * matrix_free must be initialized again after calling this function, as
+   * well as any ConstraintMatrix or vector based on the old numbering. The
+   * grouping of cells into batches does not depend on the numbering of the
+   * degrees of freedom, so the renumbered object visits the degrees of
+   * freedom in ascending order.
+   *
+   * Only the numbering of the active degrees of freedom can be changed, so
+   * @p matrix_free must loop over the active cells. Objects set up for a
+   * multigrid level via MatrixFree::AdditionalData::level_mg_handler are
+   * not supported.
+   */
+  template <int dim, typename Number>
+  void
+  matrix_free_data_locality (DoFHandler<dim>               &dof_handler,
+                             const MatrixFree<dim,Number>  &matrix_free);
+
+  /**
+   * Compute the renumbering vector needed by the matrix_free_data_locality()
+   * function. Does not perform the renumbering on the DoFHandler dofs but
+   * returns the renumbering vector, which has as many entries as there are
+   * locally owned degrees of freedom.
+   */
+  template <int dim, typename Number>
+  void
+  compute_matrix_free_data_locality (std::vector<types::global_dof_index> &new_dof_indices,
+                                     const DoFHandler<dim>                &dof_handler,
+                                     const MatrixFree<dim,Number>         &matrix_free);
+
+  /**
+   * @}
+   */
+
   /**
    * @name Selective and random numberings
    * @{
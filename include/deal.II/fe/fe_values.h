@@ -2833,6 +2833,32 @@ public:
    */
   CellSimilarity::Similarity get_cell_similarity () const;
 
+  /**
+   * Allow or forbid the re-use of data from the previous cell (see
+   * get_cell_similarity()) when the program runs with more than one thread.
+   *
+   * If the current cell is a translation of the previous one, a number of
+   * quantities such as the Jacobians of the mapping and the gradients of
+   * the shape functions are not recomputed but taken from the previous
+   * cell. Each FEValues object keeps track of its own previous cell, so
+   * this is safe if every thread works on its own FEValues object, as is
+   * the case for the scratch data objects used with WorkStream. However,
+   * the data re-used on a cell is then the one computed on the first cell
+   * of a sequence of translated cells that the current thread happens to
+   * see, and this sequence depends on how tasks are scheduled. The results
+   * of two runs of a program may then differ in the last digits, which is
+   * why the re-use is switched off by default as soon as more than one
+   * thread is running. Call this function with argument @p true to enable
+   * it nevertheless, for example in the constructors of the scratch data
+   * objects of a WorkStream-based assembly, if round-off differences
+   * between runs are acceptable.
+   *
+   * This setting is not copied with any other setting of this object, so it
+   * needs to be set again on each object created in a copy constructor of
+   * a scratch data class.
+   */
+  void allow_cell_similarity_with_threads (const bool allow);
+
   /**
    * Determine an estimate for the memory consumption (in bytes) of this
    * object.
@@ -3030,6 +3056,12 @@ protected:
    */
   CellSimilarity::Similarity cell_similarity;
 
+  /**
+   * Whether cell similarity is detected also when more than one thread is
+   * running. See allow_cell_similarity_with_threads().
+   */
+  bool cell_similarity_with_threads;
+
   /**
    * A function that checks whether the new cell is similar to the one
    * previously used. Then, a significant amount of the data can be reused,
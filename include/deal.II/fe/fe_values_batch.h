@@ -0,0 +1,609 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_fe_values_batch_h
+#define dealii_fe_values_batch_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/point.h>
+#include <deal.II/base/quadrature.h>
+#include <deal.II/base/table.h>
+#include <deal.II/base/tensor.h>
+#include <deal.II/base/vectorization.h>
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_update_flags.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q1.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup feaccess */
+/*@{*/
+
+/**
+ * A class that provides the values and gradients of shape functions, the
+ * Jacobian determinants times quadrature weights, and the inverse
+ * Jacobians on a whole batch of cells at once. The number of cells in a
+ * batch is the number of lanes of VectorizedArray<Number>, and all
+ * quantities are stored in VectorizedArray layout, i.e., lane <i>l</i> of
+ * each value belongs to the <i>l</i>-th cell of the batch. Assembly loops
+ * written in terms of these quantities compute the local matrices and
+ * vectors of all cells of a batch simultaneously with SIMD instructions,
+ * rather than one cell after the other as with FEValues.
+ *
+ * In addition, this class avoids most of the work that FEValues::reinit()
+ * does for every cell: the values and gradients of the shape functions on
+ * the reference cell are computed once in the constructor. On each cell,
+ * only the mapping is evaluated, and the gradients on the real cells are
+ * obtained by multiplying the reference gradients with the inverse
+ * Jacobians of all cells of a batch at once. This only works for elements
+ * whose shape functions are simply mapped from the reference cell, such as
+ * FE_Q, FE_DGQ, or FESystem objects composed of these, and for which all
+ * shape functions are primitive. The constructor throws an exception for
+ * other elements.
+ *
+ * A typical assembly loop looks as follows:
+ * @code
+ *   FEValuesBatch<dim> fe_batch (mapping, fe, quadrature,
+ *                                update_gradients | update_JxW_values);
+ *   const unsigned int n_lanes = FEValuesBatch<dim>::n_lanes;
+ *
+ *   Table<2,VectorizedArray<double> > batch_matrix (dofs_per_cell,
+ *                                                   dofs_per_cell);
+ *   FullMatrix<double> cell_matrix (dofs_per_cell, dofs_per_cell);
+ *
+ *   std::vector<typename DoFHandler<dim>::active_cell_iterator> cells;
+ *   for (cell = dof_handler.begin_active(); cell != endc; )
+ *     {
+ *       cells.clear ();
+ *       for (; cell != endc && cells.size() < n_lanes; ++cell)
+ *         cells.push_back (cell);
+ *       fe_batch.reinit (cells);
+ *
+ *       for (unsigned int i=0; i<dofs_per_cell; ++i)
+ *         for (unsigned int j=0; j<dofs_per_cell; ++j)
+ *           {
+ *             VectorizedArray<double> sum = VectorizedArray<double>();
+ *             for (unsigned int q=0; q<n_q_points; ++q)
+ *               sum += fe_batch.shape_grad(i,q) * fe_batch.shape_grad(j,q)
+ *                      * fe_batch.JxW(q);
+ *             batch_matrix(i,j) = sum;
+ *           }
+ *
+ *       for (unsigned int lane=0; lane<cells.size(); ++lane)
+ *         {
+ *           FEValuesBatch<dim>::extract_lane (batch_matrix, lane, cell_matrix);
+ *           cells[lane]->get_dof_indices (local_dof_indices);
+ *           constraints.distribute_local_to_global (cell_matrix,
+ *                                                   local_dof_indices,
+ *                                                   system_matrix);
+ *         }
+ *     }
+ * @endcode
+ *
+ * If a batch contains fewer cells than there are lanes, for example at the
+ * end of the list of cells, the unused lanes are filled with the data of
+ * the first cell, except for the JxW values which are set to zero. Results
+ * in these lanes must simply be ignored.
+ *
+ * The class only supports the case <code>dim==spacedim</code>.
+ */
+template <int dim, typename Number = double>
+class FEValuesBatch
+{
+public:
+  /**
+   * The number of cells that are processed at once.
+   */
+  static const unsigned int n_lanes = VectorizedArray<Number>::n_array_elements;
+
+  /**
+   * Constructor. Set up the reference values of the shape functions of @p
+   * fe at the points of @p quadrature. The @p update_flags may contain
+   * update_values, update_gradients, update_JxW_values,
+   * update_inverse_jacobians, and update_quadrature_points.
+   */
+  FEValuesBatch (const Mapping<dim>       &mapping,
+                 const FiniteElement<dim> &fe,
+                 const Quadrature<dim>    &quadrature,
+                 const UpdateFlags         update_flags);
+
+  /**
+   * Constructor. Same as above, but use a $Q_1$ mapping.
+   */
+  FEValuesBatch (const FiniteElement<dim> &fe,
+                 const Quadrature<dim>    &quadrature,
+                 const UpdateFlags         update_flags);
+
+  /**
+   * Compute the data on the given cells. The number of cells must be
+   * between one and #n_lanes. The cell iterators may be anything that
+   * FEValues::reinit() accepts.
+   */
+  template <typename CellIteratorType>
+  void reinit (const std::vector<CellIteratorType> &cells);
+
+  /**
+   * Return the number of cells passed to the last call of reinit().
+   */
+  unsigned int n_filled_lanes () const;
+
+  /**
+   * Return the value of the <i>i</i>th shape function at the <i>q</i>th
+   * quadrature point. For the elements supported by this class, the values
+   * do not depend on the cell, so all lanes hold the same value.
+   */
+  const VectorizedArray<Number> &
+  shape_value (const unsigned int i,
+               const unsigned int q) const;
+
+  /**
+   * Return the gradient of the <i>i</i>th shape function at the <i>q</i>th
+   * quadrature point on all cells of the batch.
+   */
+  const Tensor<1,dim,VectorizedArray<Number> > &
+  shape_grad (const unsigned int i,
+              const unsigned int q) const;
+
+  /**
+   * Return the Jacobian determinant times the quadrature weight at the
+   * <i>q</i>th quadrature point on all cells of the batch.
+   */
+  const VectorizedArray<Number> &
+  JxW (const unsigned int q) const;
+
+  /**
+   * Return the inverse of the Jacobian of the mapping at the <i>q</i>th
+   * quadrature point on all cells of the batch, in the same index
+   * convention as FEValues::inverse_jacobian().
+   */
+  const Tensor<2,dim,VectorizedArray<Number> > &
+  inverse_jacobian (const unsigned int q) const;
+
+  /**
+   * Return the location of the <i>q</i>th quadrature point on all cells of
+   * the batch.
+   */
+  const Point<dim,VectorizedArray<Number> > &
+  quadrature_point (const unsigned int q) const;
+
+  /**
+   * Copy the entries of lane @p lane of a local matrix computed for a batch
+   * of cells into @p matrix, which is resized if necessary. The result can
+   * be passed to ConstraintMatrix::distribute_local_to_global() and
+   * similar functions that work on one cell at a time.
+   */
+  static void extract_lane (const Table<2,VectorizedArray<Number> > &batch_matrix,
+                            const unsigned int                       lane,
+                            FullMatrix<Number>                      &matrix);
+
+  /**
+   * Same as above for a local vector.
+   */
+  static void extract_lane (const AlignedVector<VectorizedArray<Number> > &batch_vector,
+                            const unsigned int                             lane,
+                            Vector<Number>                                &vector);
+
+  /**
+   * Number of shape functions per cell.
+   */
+  const unsigned int dofs_per_cell;
+
+  /**
+   * Number of quadrature points per cell.
+   */
+  const unsigned int n_quadrature_points;
+
+  /**
+   * Return the update flags given to the constructor.
+   */
+  UpdateFlags get_update_flags () const;
+
+  /**
+   * Return an estimate for the memory consumption, in bytes, of this
+   * object.
+   */
+  std::size_t memory_consumption () const;
+
+  /**
+   * Exception
+   */
+  DeclExceptionMsg (ExcElementNotSupported,
+                    "FEValuesBatch only supports elements whose shape "
+                    "functions are primitive and are mapped from the reference "
+                    "cell without any further transformation, such as FE_Q "
+                    "or FE_DGQ.");
+
+private:
+  /**
+   * Set up the reference data. Called from the constructors.
+   */
+  void initialize (const FiniteElement<dim> &fe,
+                   const Quadrature<dim>    &quadrature);
+
+  /**
+   * The flags given to the constructor.
+   */
+  const UpdateFlags update_flags;
+
+  /**
+   * A scalar FEValues object that only evaluates the mapping on each of the
+   * cells of a batch.
+   */
+  FEValues<dim> mapping_values;
+
+  /**
+   * The number of cells given to the last call of reinit().
+   */
+  unsigned int n_cells;
+
+  /**
+   * Values of the shape functions, indexed by shape function and
+   * quadrature point.
+   */
+  Table<2,VectorizedArray<Number> > shape_values;
+
+  /**
+   * Gradients of the shape functions on the reference cell, indexed by
+   * shape function and quadrature point.
+   */
+  Table<2,Tensor<1,dim,VectorizedArray<Number> > > reference_shape_gradients;
+
+  /**
+   * Gradients of the shape functions on the cells of the current batch.
+   */
+  Table<2,Tensor<1,dim,VectorizedArray<Number> > > shape_gradients;
+
+  /**
+   * Jacobian determinants times quadrature weights on the cells of the
+   * current batch.
+   */
+  AlignedVector<VectorizedArray<Number> > JxW_values;
+
+  /**
+   * Inverse Jacobians on the cells of the current batch.
+   */
+  AlignedVector<Tensor<2,dim,VectorizedArray<Number> > > inverse_jacobians;
+
+  /**
+   * Quadrature points on the cells of the current batch.
+   */
+  AlignedVector<Point<dim,VectorizedArray<Number> > > quadrature_points;
+};
+
+/*@}*/
+
+/*---------------------- Inline functions -----------------------------------*/
+
+#ifndef DOXYGEN
+
+
+template <int dim, typename Number>
+const unsigned int FEValuesBatch<dim,Number>::n_lanes;
+
+
+
+template <int dim, typename Number>
+inline
+FEValuesBatch<dim,Number>::FEValuesBatch (const Mapping<dim>       &mapping,
+                                          const FiniteElement<dim> &fe,
+                                          const Quadrature<dim>    &quadrature,
+                                          const UpdateFlags         update_flags)
+  :
+  dofs_per_cell (fe.dofs_per_cell),
+  n_quadrature_points (quadrature.size()),
+  update_flags (update_flags),
+  mapping_values (mapping, fe, quadrature,
+                  (update_flags & update_gradients ? update_inverse_jacobians : update_default)
+                  |
+                  (update_flags & (update_JxW_values | update_inverse_jacobians |
+                                   update_quadrature_points))),
+  n_cells (0)
+{
+  initialize (fe, quadrature);
+}
+
+
+
+template <int dim, typename Number>
+inline
+FEValuesBatch<dim,Number>::FEValuesBatch (const FiniteElement<dim> &fe,
+                                          const Quadrature<dim>    &quadrature,
+                                          const UpdateFlags         update_flags)
+  :
+  FEValuesBatch (StaticMappingQ1<dim>::mapping, fe, quadrature, update_flags)
+{}
+
+
+
+template <int dim, typename Number>
+inline
+void
+FEValuesBatch<dim,Number>::initialize (const FiniteElement<dim> &fe,
+                                       const Quadrature<dim>    &quadrature)
+{
+  Assert ((update_flags & ~(update_values | update_gradients | update_JxW_values |
+                            update_inverse_jacobians | update_quadrature_points))
+          == update_default,
+          ExcMessage ("FEValuesBatch only supports the flags update_values, "
+                      "update_gradients, update_JxW_values, "
+                      "update_inverse_jacobians, and update_quadrature_points."));
+
+  // the reference values can only be used if the shape functions are
+  // scalar and mapped by the covariant transformation. this excludes the
+  // non-primitive vector-valued elements. elements whose shape functions
+  // are only defined on the real cell will throw an exception when we ask
+  // for the values on the reference cell below
+  AssertThrow (fe.is_primitive(), ExcElementNotSupported());
+
+  if (update_flags & update_values)
+    {
+      shape_values.reinit (dofs_per_cell, n_quadrature_points);
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        for (unsigned int q=0; q<n_quadrature_points; ++q)
+          shape_values(i,q) = fe.shape_value (i, quadrature.point(q));
+    }
+
+  if (update_flags & update_gradients)
+    {
+      reference_shape_gradients.reinit (dofs_per_cell, n_quadrature_points);
+      shape_gradients.reinit (dofs_per_cell, n_quadrature_points);
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        for (unsigned int q=0; q<n_quadrature_points; ++q)
+          {
+            const Tensor<1,dim> gradient = fe.shape_grad (i, quadrature.point(q));
+            for (unsigned int d=0; d<dim; ++d)
+              reference_shape_gradients(i,q)[d] = gradient[d];
+          }
+      inverse_jacobians.resize (n_quadrature_points);
+    }
+
+  if (update_flags & update_JxW_values)
+    JxW_values.resize (n_quadrature_points);
+  if (update_flags & update_inverse_jacobians)
+    inverse_jacobians.resize (n_quadrature_points);
+  if (update_flags & update_quadrature_points)
+    quadrature_points.resize (n_quadrature_points);
+}
+
+
+
+template <int dim, typename Number>
+template <typename CellIteratorType>
+inline
+void
+FEValuesBatch<dim,Number>::reinit (const std::vector<CellIteratorType> &cells)
+{
+  Assert (cells.size() > 0 && cells.size() <= n_lanes,
+          ExcIndexRange (cells.size(), 1, n_lanes+1));
+  n_cells = cells.size();
+
+  // evaluate the mapping on each cell and transpose the scalar data into
+  // the vectorized layout
+  for (unsigned int lane=0; lane<n_cells; ++lane)
+    {
+      mapping_values.reinit (cells[lane]);
+
+      if (!JxW_values.empty())
+        for (unsigned int q=0; q<n_quadrature_points; ++q)
+          JxW_values[q][lane] = mapping_values.JxW(q);
+
+      if (!inverse_jacobians.empty())
+        for (unsigned int q=0; q<n_quadrature_points; ++q)
+          {
+            const DerivativeForm<1,dim,dim> &inverse_jacobian
+              = mapping_values.inverse_jacobian(q);
+            for (unsigned int d=0; d<dim; ++d)
+              for (unsigned int e=0; e<dim; ++e)
+                inverse_jacobians[q][d][e][lane] = inverse_jacobian[d][e];
+          }
+
+      if (!quadrature_points.empty())
+        for (unsigned int q=0; q<n_quadrature_points; ++q)
+          for (unsigned int d=0; d<dim; ++d)
+            quadrature_points[q][d][lane] = mapping_values.quadrature_point(q)[d];
+    }
+
+  // unused lanes get the data of the first cell so that all operations
+  // remain well-defined, but a zero JxW value so that integrals over these
+  // lanes vanish
+  for (unsigned int lane=n_cells; lane<n_lanes; ++lane)
+    {
+      for (unsigned int q=0; q<JxW_values.size(); ++q)
+        JxW_values[q][lane] = 0.;
+      for (unsigned int q=0; q<inverse_jacobians.size(); ++q)
+        for (unsigned int d=0; d<dim; ++d)
+          for (unsigned int e=0; e<dim; ++e)
+            inverse_jacobians[q][d][e][lane] = inverse_jacobians[q][d][e][0];
+      for (unsigned int q=0; q<quadrature_points.size(); ++q)
+        for (unsigned int d=0; d<dim; ++d)
+          quadrature_points[q][d][lane] = quadrature_points[q][d][0];
+    }
+
+  // transform the gradients of all cells in the batch at once: the
+  // gradient on the real cell is the reference gradient multiplied by the
+  // inverse Jacobian from the left, i.e., grad_d = sum_e ref_grad_e J^{-1}_ed
+  if (update_flags & update_gradients)
+    for (unsigned int q=0; q<n_quadrature_points; ++q)
+      {
+        const Tensor<2,dim,VectorizedArray<Number> > &inverse_jacobian
+          = inverse_jacobians[q];
+        for (unsigned int i=0; i<dofs_per_cell; ++i)
+          {
+            const Tensor<1,dim,VectorizedArray<Number> > &reference_gradient
+              = reference_shape_gradients(i,q);
+            Tensor<1,dim,VectorizedArray<Number> > &gradient = shape_gradients(i,q);
+            for (unsigned int d=0; d<dim; ++d)
+              {
+                VectorizedArray<Number> sum = reference_gradient[0] * inverse_jacobian[0][d];
+                for (unsigned int e=1; e<dim; ++e)
+                  sum += reference_gradient[e] * inverse_jacobian[e][d];
+                gradient[d] = sum;
+              }
+          }
+      }
+}
+
+
+
+template <int dim, typename Number>
+inline
+unsigned int
+FEValuesBatch<dim,Number>::n_filled_lanes () const
+{
+  return n_cells;
+}
+
+
+
+template <int dim, typename Number>
+inline
+const VectorizedArray<Number> &
+FEValuesBatch<dim,Number>::shape_value (const unsigned int i,
+                                        const unsigned int q) const
+{
+  Assert (update_flags & update_values,
+          (typename FEValuesBase<dim>::ExcAccessToUninitializedField("update_values")));
+  return shape_values(i,q);
+}
+
+
+
+template <int dim, typename Number>
+inline
+const Tensor<1,dim,VectorizedArray<Number> > &
+FEValuesBatch<dim,Number>::shape_grad (const unsigned int i,
+                                       const unsigned int q) const
+{
+  Assert (update_flags & update_gradients,
+          (typename FEValuesBase<dim>::ExcAccessToUninitializedField("update_gradients")));
+  Assert (n_cells > 0, ExcNotInitialized());
+  return shape_gradients(i,q);
+}
+
+
+
+template <int dim, typename Number>
+inline
+const VectorizedArray<Number> &
+FEValuesBatch<dim,Number>::JxW (const unsigned int q) const
+{
+  Assert (update_flags & update_JxW_values,
+          (typename FEValuesBase<dim>::ExcAccessToUninitializedField("update_JxW_values")));
+  Assert (n_cells > 0, ExcNotInitialized());
+  AssertIndexRange (q, n_quadrature_points);
+  return JxW_values[q];
+}
+
+
+
+template <int dim, typename Number>
+inline
+const Tensor<2,dim,VectorizedArray<Number> > &
+FEValuesBatch<dim,Number>::inverse_jacobian (const unsigned int q) const
+{
+  Assert (update_flags & update_inverse_jacobians,
+          (typename FEValuesBase<dim>::ExcAccessToUninitializedField("update_inverse_jacobians")));
+  Assert (n_cells > 0, ExcNotInitialized());
+  AssertIndexRange (q, n_quadrature_points);
+  return inverse_jacobians[q];
+}
+
+
+
+template <int dim, typename Number>
+inline
+const Point<dim,VectorizedArray<Number> > &
+FEValuesBatch<dim,Number>::quadrature_point (const unsigned int q) const
+{
+  Assert (update_flags & update_quadrature_points,
+          (typename FEValuesBase<dim>::ExcAccessToUninitializedField("update_quadrature_points")));
+  Assert (n_cells > 0, ExcNotInitialized());
+  AssertIndexRange (q, n_quadrature_points);
+  return quadrature_points[q];
+}
+
+
+
+template <int dim, typename Number>
+inline
+void
+FEValuesBatch<dim,Number>::extract_lane (const Table<2,VectorizedArray<Number> > &batch_matrix,
+                                         const unsigned int                       lane,
+                                         FullMatrix<Number>                      &matrix)
+{
+  AssertIndexRange (lane, n_lanes);
+  matrix.reinit (batch_matrix.size(0), batch_matrix.size(1), true);
+  for (unsigned int i=0; i<batch_matrix.size(0); ++i)
+    for (unsigned int j=0; j<batch_matrix.size(1); ++j)
+      matrix(i,j) = batch_matrix(i,j)[lane];
+}
+
+
+
+template <int dim, typename Number>
+inline
+void
+FEValuesBatch<dim,Number>::extract_lane (const AlignedVector<VectorizedArray<Number> > &batch_vector,
+                                         const unsigned int                             lane,
+                                         Vector<Number>                                &vector)
+{
+  AssertIndexRange (lane, n_lanes);
+  vector.reinit (batch_vector.size(), true);
+  for (unsigned int i=0; i<batch_vector.size(); ++i)
+    vector(i) = batch_vector[i][lane];
+}
+
+
+
+template <int dim, typename Number>
+inline
+UpdateFlags
+FEValuesBatch<dim,Number>::get_update_flags () const
+{
+  return update_flags;
+}
+
+
+
+template <int dim, typename Number>
+inline
+std::size_t
+FEValuesBatch<dim,Number>::memory_consumption () const
+{
+  return (mapping_values.memory_consumption() +
+          shape_values.memory_consumption() +
+          reference_shape_gradients.memory_consumption() +
+          shape_gradients.memory_consumption() +
+          JxW_values.memory_consumption() +
+          inverse_jacobians.memory_consumption() +
+          quadrature_points.memory_consumption());
+}
+
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
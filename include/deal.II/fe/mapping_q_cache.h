@@ -0,0 +1,156 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_mapping_q_cache_h
+#define dealii_mapping_q_cache_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/fe/mapping_q_generic.h>
+#include <deal.II/grid/tria.h>
+
+#include <boost/signals2/connection.hpp>
+
+#include <memory>
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+/*!@addtogroup mapping */
+/*@{*/
+
+
+/**
+ * A variant of MappingQGeneric that computes the support points of the
+ * mapping for all cells of a triangulation once and stores them, rather
+ * than recomputing them every time the mapping is evaluated on a cell.
+ *
+ * For curved domains, computing the support points of a high-order
+ * mapping involves many queries of the Manifold objects attached to the
+ * triangulation, which can be expensive. MappingQGeneric does this every
+ * time an FEValues object is reinitialized on a cell. If the mesh does not
+ * change over many assembly loops, for example in time-stepping codes, the
+ * same points are computed over and over again. This class avoids this
+ * cost at the expense of storing <code>(degree+1)^dim</code> points for
+ * each cell of the triangulation.
+ *
+ * The cache is filled by calling initialize(), which computes the support
+ * points of all cells on all levels of the given triangulation in
+ * parallel. The result is the same as with MappingQGeneric of the same
+ * degree. The object connects to the signals of the triangulation and
+ * discards the cache whenever the mesh is refined or coarsened, or the
+ * vertices are moved via functions that trigger the
+ * Triangulation::Signals::mesh_movement signal, such as GridTools::transform().
+ * After this, the class computes the support points on the fly, just like
+ * MappingQGeneric, until initialize() is called again. Changing vertex
+ * locations directly through <code>cell-@>vertex(v)</code> does not trigger
+ * any signal; in that case, initialize() must be called again manually.
+ *
+ * Copies of an object of this class, such as the ones created by clone(),
+ * share the cache with the original object.
+ */
+template <int dim, int spacedim=dim>
+class MappingQCache : public MappingQGeneric<dim,spacedim>
+{
+public:
+  /**
+   * Constructor. @p polynomial_degree denotes the polynomial degree of the
+   * polynomials that are used to map cells from the reference to the real
+   * cell. The cache is empty until initialize() is called.
+   */
+  explicit MappingQCache (const unsigned int polynomial_degree);
+
+  /**
+   * Copy constructor. The new object shares the cache with @p mapping.
+   */
+  MappingQCache (const MappingQCache<dim,spacedim> &mapping);
+
+  /**
+   * Destructor. Disconnects from the signal of the triangulation.
+   */
+  ~MappingQCache ();
+
+  // for documentation, see the Mapping base class
+  virtual
+  Mapping<dim,spacedim> *clone () const;
+
+  /**
+   * Compute the support points of the mapping on all cells of @p
+   * triangulation and store them. Any previously stored data is discarded.
+   *
+   * The cells are worked on by several threads at once, each of which
+   * queries the Manifold objects attached to @p triangulation. The
+   * Manifold::get_new_point() and related functions of these manifolds
+   * must therefore be safe to call concurrently. This is not the case for
+   * manifolds that modify internal state, e.g. a cache, in these functions;
+   * call MultithreadInfo::set_thread_limit(1) before this function when
+   * such manifolds are attached.
+   */
+  void initialize (const Triangulation<dim,spacedim> &triangulation);
+
+  /**
+   * Return whether the cache currently holds data, i.e., whether
+   * initialize() has been called and the triangulation has not changed
+   * since.
+   */
+  bool is_initialized () const;
+
+  /**
+   * Return an estimate (in bytes) for the memory consumption of this
+   * object.
+   */
+  std::size_t memory_consumption () const;
+
+protected:
+  /**
+   * Return the support points of the mapping on @p cell from the cache, or
+   * compute them as in MappingQGeneric if the cache is empty.
+   */
+  virtual
+  std::vector<Point<spacedim> >
+  compute_mapping_support_points (const typename Triangulation<dim,spacedim>::cell_iterator &cell) const;
+
+private:
+  /**
+   * Connect to the signal of the triangulation that invalidates the cache.
+   */
+  void connect_to_triangulation ();
+
+  /**
+   * The support points of all cells, indexed by the level and the index of
+   * the cell. The pointer is shared among copies of this object.
+   */
+  std::shared_ptr<std::vector<std::vector<std::vector<Point<spacedim> > > > >
+  support_point_cache;
+
+  /**
+   * The triangulation the cache has been computed for.
+   */
+  const Triangulation<dim,spacedim> *triangulation;
+
+  /**
+   * Connection to the Triangulation::Signals::any_change signal of the
+   * triangulation, which is also triggered upon mesh movement, that clears
+   * the cache.
+   */
+  boost::signals2::connection clear_on_change;
+};
+
+/*@}*/
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2000 - 2017 by the deal.II authors
+// Copyright (C) 2000 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -29,6 +29,7 @@
 
 #include <array>
 #include <cmath>
+#include <tuple>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -293,6 +294,26 @@ public:
      */
     void compute_shape_function_values (const std::vector<Point<dim> > &unit_points);
 
+    /**
+     * Set up the data for evaluating the mapping by sum factorization on
+     * cells, see the documentation of the shape_data_1d member variable. The
+     * argument contains the one-dimensional quadrature formulas whose
+     * tensor product is the cell quadrature formula; they may differ
+     * between the coordinate directions.
+     */
+    void
+    initialize_tensor_product_data (const std::array<Quadrature<1>,dim> &quadratures_1d);
+
+    /**
+     * Set up the data for evaluating the mapping by sum factorization on
+     * the faces of cells in standard orientation, see the documentation of
+     * the shape_data_1d member variable. The argument contains the
+     * one-dimensional quadrature formulas whose tensor product is the face
+     * quadrature formula.
+     */
+    void
+    initialize_tensor_product_face_data (const std::array<Quadrature<1>,dim-1> &face_quadratures_1d);
+
 
     /**
      * Shape function at quadrature point. Shape functions are in tensor
@@ -482,6 +503,58 @@ public:
      */
     bool tensor_product_quadrature;
 
+    /**
+     * In case the quadrature rule is a tensor product of one-dimensional
+     * formulas, possibly different ones in each coordinate direction, the
+     * values and derivatives of the one-dimensional polynomials underlying
+     * the mapping at the one-dimensional quadrature points. They allow to
+     * evaluate the mapping and its derivatives up to fourth order with sum
+     * factorization, i.e., by contracting the mapping support points with
+     * one coordinate direction at a time, for any combination of update
+     * flags.
+     *
+     * The data for coordinate direction <code>d</code> of the data set
+     * <code>s</code> is accessed as <code>shape_data_1d[s][d](derivative,
+     * polynomial, point)</code>. For cells, there is a single data set. For
+     * faces, there is one data set per face of the reference cell in
+     * standard orientation, where the direction normal to the face has a
+     * single point. The vector is empty if sum factorization is not
+     * possible.
+     */
+    std::vector<std::array<Table<3,double>,dim> > shape_data_1d;
+
+    /**
+     * For each data set in shape_data_1d, the number of the quadrature
+     * point that corresponds to each point of the tensor product in
+     * lexicographic order.
+     */
+    std::vector<std::vector<unsigned int> > tensor_point_numbering;
+
+    /**
+     * The numbering of the mapping support points in lexicographic order,
+     * as needed for sum factorization.
+     */
+    std::vector<unsigned int> lexicographic_support_points;
+
+    /**
+     * Temporary arrays for the sum factorization with shape_data_1d. The
+     * first two hold the intermediate results of the contractions, the last
+     * one the values of one derivative in the quadrature points. They are
+     * kept here to avoid allocating memory on each cell.
+     */
+    mutable std::vector<Tensor<1,spacedim> > tensor_values_in;
+    mutable std::vector<Tensor<1,spacedim> > tensor_values_out;
+    mutable std::vector<Tensor<1,spacedim> > tensor_values_result;
+
+    /**
+     * Temporary arrays for the derivatives of order two, three and four of
+     * the mapping in the quadrature points, used by the sum factorization
+     * when only their push forward to the real cell is requested.
+     */
+    mutable std::tuple<std::vector<DerivativeForm<2,dim,spacedim> >,
+            std::vector<DerivativeForm<3,dim,spacedim> >,
+            std::vector<DerivativeForm<4,dim,spacedim> > > tensor_derivatives;
+
     /**
      * Tensors of covariant transformation at each of the quadrature points.
      * The matrix stored is the Jacobian * G^{-1}, where G = Jacobian^{t} *
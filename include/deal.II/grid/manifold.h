@@ -316,6 +316,19 @@ namespace Manifolds
  * approximate the limit process, and derived classes should do so.
  *
  *
+ * <h3>Thread safety</h3>
+ *
+ * Triangulation::execute_coarsening_and_refinement() computes the new
+ * vertices on refined lines, and MappingQCache::initialize() the support
+ * points of all cells, on several threads at once. The const member
+ * functions of a manifold, in particular get_new_point() and the functions
+ * it calls, must therefore be safe to call concurrently. This is the case
+ * for the manifolds declared in manifold_lib.h. Derived classes that modify
+ * internal state in these functions, e.g. a cache, must protect it
+ * themselves, for example with a Threads::Mutex, or the number of threads
+ * must be limited to one with MultithreadInfo::set_thread_limit().
+ *
+ *
  * @ingroup manifold
  * @author Luca Heltai, Wolfgang Bangerth, 2014, 2016
  */
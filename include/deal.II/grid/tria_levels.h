@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1998 - 2017 by the deal.II authors
+// Copyright (C) 1998 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -24,6 +24,7 @@
 #include <deal.II/grid/tria_objects.h>
 
 #include <boost/serialization/utility.hpp>
+#include <boost/serialization/version.hpp>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -68,7 +69,7 @@ namespace internal
        * Same meaning as the one above, but specifies whether a cell must be
        * coarsened.
        */
-      std::vector<bool> coarsen_flags;
+      std::vector<unsigned char> coarsen_flags;
 
 
       /**
@@ -144,7 +145,7 @@ namespace internal
        *
        * This is only used for codim==1 meshes.
        */
-      std::vector<bool> direction_flags;
+      std::vector<unsigned char> direction_flags;
 
       /**
        * The object containing the data on lines and related functions
@@ -217,7 +218,7 @@ namespace internal
     {
     public:
       std::vector<unsigned char> refine_flags;
-      std::vector<bool> coarsen_flags;
+      std::vector<unsigned char> coarsen_flags;
       std::vector<unsigned int> active_cell_indices;
       std::vector<std::pair<int,int> > neighbors;
       std::vector<types::subdomain_id> subdomain_ids;
@@ -230,7 +231,7 @@ namespace internal
       // needed to allow
       // compilation
       // TODO[TH]: this is no longer true and might be a bug.
-      std::vector<bool> direction_flags;
+      std::vector<unsigned char> direction_flags;
 
       TriaObjectsHex cells;
 
@@ -271,9 +272,10 @@ namespace internal
     template <int dim>
     template <class Archive>
     void TriaLevel<dim>::serialize(Archive &ar,
-                                   const unsigned int)
+                                   const unsigned int version)
     {
-      ar &refine_flags &coarsen_flags;
+      ar &refine_flags;
+      serialize_flags (ar, coarsen_flags, version);
 
       // do not serialize 'active_cell_indices' here. instead of storing them
       // to the stream and re-reading them again later, we just rebuild them
@@ -283,7 +285,7 @@ namespace internal
       ar &subdomain_ids;
       ar &level_subdomain_ids;
       ar &parents;
-      ar &direction_flags;
+      serialize_flags (ar, direction_flags, version);
       ar &cells;
     }
 
@@ -291,9 +293,10 @@ namespace internal
 
     template <class Archive>
     void TriaLevel<3>::serialize(Archive &ar,
-                                 const unsigned int)
+                                 const unsigned int version)
     {
-      ar &refine_flags &coarsen_flags;
+      ar &refine_flags;
+      serialize_flags (ar, coarsen_flags, version);
 
       // do not serialize 'active_cell_indices' here. instead of storing them
       // to the stream and re-reading them again later, we just rebuild them
@@ -303,7 +306,7 @@ namespace internal
       ar &subdomain_ids;
       ar &level_subdomain_ids;
       ar &parents;
-      ar &direction_flags;
+      serialize_flags (ar, direction_flags, version);
       ar &cells;
     }
 
@@ -314,4 +317,24 @@ namespace internal
 
 DEAL_II_NAMESPACE_CLOSE
 
+#ifndef DOXYGEN
+namespace boost
+{
+  namespace serialization
+  {
+    // version 1 of the serialization format stores the coarsen and
+    // direction flags as one byte per cell, see
+    // internal::Triangulation::serialize_flags()
+    template <int dim>
+    struct version<dealii::internal::Triangulation::TriaLevel<dim> >
+    {
+      typedef mpl::int_<1> type;
+      typedef mpl::integral_c_tag tag;
+      BOOST_STATIC_CONSTANT(int, value = version::type::value);
+    };
+  }
+}
+
+#endif
+
 #endif
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2006 - 2017 by the deal.II authors
+// Copyright (C) 2006 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -23,6 +23,8 @@
 
 #include <vector>
 
+#include <boost/serialization/version.hpp>
+
 DEAL_II_NAMESPACE_OPEN
 
 //TODO: This should all be cleaned up. Currently, only a single
@@ -45,6 +47,18 @@ namespace internal
 {
   namespace Triangulation
   {
+    /**
+     * Read or write a vector of per-object flags as part of the serialization
+     * of the classes in this namespace. Up to version 0 of their
+     * serialization format, these flags were stored as
+     * <code>std::vector@<bool@></code>. When loading such an archive, the
+     * flags are converted to the current one-byte-per-object representation.
+     */
+    template <class Archive>
+    void serialize_flags (Archive                    &ar,
+                          std::vector<unsigned char> &flags,
+                          const unsigned int          version);
+
 
     /**
      * General template for information belonging to the geometrical objects
@@ -100,19 +114,25 @@ namespace internal
        * element is not needed any more (e.g. after derefinement), it is not
        * deleted from the list, but rather the according @p used flag is set
        * to @p false.
+       *
+       * The flags are stored as one byte per object rather than in a
+       * bit-packed <code>std::vector@<bool@></code>, so that reading or
+       * writing the flag of one object is a plain load or store. The same
+       * applies to the @p user_flags below and to the coarsen and direction
+       * flags in TriaLevel.
        */
-      std::vector<bool> used;
+      std::vector<unsigned char> used;
 
       /**
-       * Make available a field for user data, one bit per object. This field
-       * is usually used when an operation runs over all cells and needs
+       * Make available a field for user data, one flag per object. This
+       * field is usually used when an operation runs over all cells and needs
        * information whether another cell (e.g. a neighbor) has already been
        * processed.
        *
        * You can clear all used flags using
        * dealii::Triangulation::clear_user_flags().
        */
-      std::vector<bool> user_flags;
+      std::vector<unsigned char> user_flags;
 
 
       /**
@@ -719,15 +739,32 @@ namespace internal
 
 
 
+    template <class Archive>
+    void serialize_flags (Archive                    &ar,
+                          std::vector<unsigned char> &flags,
+                          const unsigned int          version)
+    {
+      if (Archive::is_loading::value && (version == 0))
+        {
+          std::vector<bool> old_flags;
+          ar &old_flags;
+          flags.assign (old_flags.begin(), old_flags.end());
+        }
+      else
+        ar &flags;
+    }
+
+
+
     template <typename G>
     template <class Archive>
     void TriaObjects<G>::serialize(Archive &ar,
-                                   const unsigned int)
+                                   const unsigned int version)
     {
       ar &cells &children;
       ar &refinement_cases;
-      ar &used;
-      ar &user_flags;
+      serialize_flags (ar, used, version);
+      serialize_flags (ar, user_flags, version);
       ar &boundary_or_material_id;
       ar &manifold_id;
       ar &next_free_single &next_free_pair &reverse_order_next_free_single;
@@ -875,4 +912,27 @@ namespace internal
 
 DEAL_II_NAMESPACE_CLOSE
 
+#ifndef DOXYGEN
+namespace boost
+{
+  namespace serialization
+  {
+    // version 1 of the serialization format stores the used and user flags
+    // as one byte per object, see internal::Triangulation::serialize_flags()
+    template <typename G>
+    struct version<dealii::internal::Triangulation::TriaObjects<G> >
+    {
+      typedef mpl::int_<1> type;
+      typedef mpl::integral_c_tag tag;
+      BOOST_STATIC_CONSTANT(int, value = version::type::value);
+    };
+  }
+}
+
+// the derived classes pass their own version on to TriaObjects::serialize()
+BOOST_CLASS_VERSION(dealii::internal::Triangulation::TriaObjectsHex, 1)
+BOOST_CLASS_VERSION(dealii::internal::Triangulation::TriaObjectsQuad3D, 1)
+
+#endif
+
 #endif
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2011 - 2017 by the deal.II authors
+// Copyright (C) 2011 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -405,6 +405,16 @@ public:
                     ForwardIterator end,
                     const bool      indices_are_unique_and_sorted = false);
 
+  /**
+   * Add all nonzero entries of @p other to this object. Both objects need
+   * to have the same size, and the rows stored in @p other need to be a
+   * subset of the rows stored in this object. Rows are merged in parallel,
+   * which makes this function suitable for combining patterns that have
+   * been built independently, e.g., by different threads working on
+   * different ranges of rows.
+   */
+  void add_entries_from (const DynamicSparsityPattern &other);
+
   /**
    * Check if a value at a certain position may be non-zero.
    */
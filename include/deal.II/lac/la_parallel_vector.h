@@ -742,6 +742,37 @@ namespace LinearAlgebra
       void sadd (const Number          s,
                  const Vector<Number> &V);
 
+      /**
+       * Simple addition of a multiple of a vector with possibly different
+       * number type, i.e. <tt>*this += a*V</tt>. The conversion between the
+       * number types is done on the fly within the vectorized loop, so that
+       * no temporary vector is needed. This is useful for mixed-precision
+       * algorithms that combine single and double precision vectors, e.g. a
+       * multigrid preconditioner in float within an outer solver in double.
+       */
+      template <typename Number2>
+      void add (const Number           a,
+                const Vector<Number2> &V);
+
+      /**
+       * Scaling and simple vector addition with a vector of possibly
+       * different number type, i.e. <tt>*this = s*(*this)+V</tt>. See add()
+       * for mixed-precision vectors.
+       */
+      template <typename Number2>
+      void sadd (const Number           s,
+                 const Vector<Number2> &V);
+
+      /**
+       * Scaling and simple addition of a multiple of a vector with possibly
+       * different number type, i.e. <tt>*this = s*(*this)+a*V</tt>. See
+       * add() for mixed-precision vectors.
+       */
+      template <typename Number2>
+      void sadd (const Number           s,
+                 const Number           a,
+                 const Vector<Number2> &V);
+
       /**
        * Scaling and multiple addition.
        *
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2011 - 2017 by the deal.II authors
+// Copyright (C) 2011 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -923,6 +923,68 @@ namespace LinearAlgebra
 
 
 
+    template <typename Number>
+    template <typename Number2>
+    void
+    Vector<Number>::add (const Number a,
+                         const Vector<Number2> &v)
+    {
+      AssertIsFinite(a);
+      AssertDimension (local_size(), v.local_size());
+
+      internal::VectorOperations::Vectorization_add_av<Number,Number2>
+      vector_add(values.get(), v.values.get(), a);
+      internal::VectorOperations::parallel_for(vector_add, 0, partitioner->local_size(),
+                                               thread_loop_partitioner);
+
+      if (vector_is_ghosted)
+        update_ghost_values();
+    }
+
+
+
+    template <typename Number>
+    template <typename Number2>
+    void
+    Vector<Number>::sadd (const Number x,
+                          const Vector<Number2> &v)
+    {
+      AssertIsFinite(x);
+      AssertDimension (local_size(), v.local_size());
+
+      internal::VectorOperations::Vectorization_sadd_xv<Number,Number2>
+      vector_sadd(values.get(), v.values.get(), x);
+      internal::VectorOperations::parallel_for(vector_sadd, 0, partitioner->local_size(),
+                                               thread_loop_partitioner);
+
+      if (vector_is_ghosted)
+        update_ghost_values();
+    }
+
+
+
+    template <typename Number>
+    template <typename Number2>
+    void
+    Vector<Number>::sadd (const Number x,
+                          const Number a,
+                          const Vector<Number2> &v)
+    {
+      AssertIsFinite(x);
+      AssertIsFinite(a);
+      AssertDimension (local_size(), v.local_size());
+
+      internal::VectorOperations::Vectorization_sadd_xav<Number,Number2>
+      vector_sadd(values.get(), v.values.get(), a, x);
+      internal::VectorOperations::parallel_for(vector_sadd, 0, partitioner->local_size(),
+                                               thread_loop_partitioner);
+
+      if (vector_is_ghosted)
+        update_ghost_values();
+    }
+
+
+
     template <typename Number>
     void
     Vector<Number>::sadd (const Number x,
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1999 - 2017 by the deal.II authors
+// Copyright (C) 1999 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -1796,12 +1796,19 @@ namespace internal
       VectorUpdatesRange(const VectorUpdater<Number> &updater,
                          const std::size_t size)
         :
+        VectorUpdatesRange (updater, 0, size)
+      {}
+
+      VectorUpdatesRange(const VectorUpdater<Number> &updater,
+                         const std::size_t begin,
+                         const std::size_t end)
+        :
         updater (updater)
       {
-        if (size < internal::Vector::minimum_parallel_grain_size)
-          apply_to_subrange (0, size);
+        if (end - begin < internal::Vector::minimum_parallel_grain_size)
+          apply_to_subrange (begin, end);
         else
-          apply_parallel (0, size,
+          apply_parallel (begin, end,
                           internal::Vector::minimum_parallel_grain_size);
       }
 
@@ -1857,6 +1864,55 @@ namespace internal
       VectorUpdatesRange<Number>(upd, src.local_size());
     }
 
+    // generic part of a matrix-vector product followed by the vector updates
+    template <typename MatrixType, typename VectorType, typename PreconditionerType>
+    inline
+    void
+    vmult_and_update (const MatrixType         &matrix,
+                      const PreconditionerType &preconditioner,
+                      const VectorType         &src,
+                      const double              factor1,
+                      const double              factor2,
+                      VectorType               &update1,
+                      VectorType               &update2,
+                      VectorType               &update3,
+                      VectorType               &dst,
+                      std::integral_constant<bool, false>)
+    {
+      matrix.vmult (update2, dst);
+      vector_updates (src, preconditioner, false, factor1, factor2,
+                      update1, update2, update3, dst);
+    }
+
+    // selection for matrices that can run the vector updates on a range of
+    // entries as soon as the matrix-vector product has finished there, see
+    // the SolverCG class documentation for the interface
+    template <typename MatrixType, typename Number>
+    inline
+    void
+    vmult_and_update (const MatrixType &matrix,
+                      const DiagonalMatrix<LinearAlgebra::distributed::Vector<Number> > &jacobi,
+                      const LinearAlgebra::distributed::Vector<Number> &src,
+                      const double  factor1,
+                      const double  factor2,
+                      LinearAlgebra::distributed::Vector<Number> &update1,
+                      LinearAlgebra::distributed::Vector<Number> &update2,
+                      LinearAlgebra::distributed::Vector<Number> &,
+                      LinearAlgebra::distributed::Vector<Number> &dst,
+                      std::integral_constant<bool, true>)
+    {
+      VectorUpdater<Number> upd(src.begin(), jacobi.get_vector().begin(),
+                                false, factor1, factor2,
+                                update1.begin(), update2.begin(), dst.begin());
+      matrix.vmult (update2, dst,
+                    [] (const unsigned int, const unsigned int)
+      {},
+      [&upd] (const unsigned int begin, const unsigned int end)
+      {
+        VectorUpdatesRange<Number>(upd, begin, end);
+      });
+    }
+
     template <typename MatrixType, typename VectorType, typename PreconditionerType>
     inline
     void
@@ -2148,15 +2204,23 @@ PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>
   if (std::abs(delta) < 1e-40)
     return;
 
+  // if the matrix supports it, merge the vector updates into the
+  // matrix-vector product for the combination of a diagonal preconditioner
+  // with LinearAlgebra::distributed::Vector
+  const bool fuse_updates =
+    internal::SolverCG::supports_fused_iteration<MatrixType,VectorType,
+    PreconditionerType>::value &&
+    std::is_same<PreconditionerType, PreconditionIdentity>::value == false;
+
   double rhok  = delta / theta,  sigma = theta / delta;
   for (unsigned int k=0; k<data.degree; ++k)
     {
-      matrix_ptr->vmult (update2, dst);
       const double rhokp = 1./(2.*sigma-rhok);
       const double factor1 = rhokp * rhok, factor2 = 2.*rhokp/delta;
       rhok = rhokp;
-      internal::PreconditionChebyshev::vector_updates
-      (src, *data.preconditioner, false, factor1, factor2, update1, update2, update3, dst);
+      internal::PreconditionChebyshev::vmult_and_update
+      (*matrix_ptr, *data.preconditioner, src, factor1, factor2, update1,
+       update2, update3, dst, std::integral_constant<bool, fuse_updates>());
     }
 }
 
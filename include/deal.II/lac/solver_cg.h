@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1998 - 2017 by the deal.II authors
+// Copyright (C) 1998 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -21,15 +21,195 @@
 #include <deal.II/lac/tridiagonal_matrix.h>
 #include <deal.II/lac/solver.h>
 #include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/vector_operations_internal.h>
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/logstream.h>
+#include <deal.II/base/mpi.h>
 #include <deal.II/base/subscriptor.h>
 #include <cmath>
+#include <functional>
+#include <type_traits>
 
 DEAL_II_NAMESPACE_OPEN
 
 // forward declaration
 class PreconditionIdentity;
+template <typename VectorType> class DiagonalMatrix;
+namespace LinearAlgebra
+{
+  namespace distributed
+  {
+    template <typename Number> class Vector;
+  }
+}
+
+
+namespace internal
+{
+  namespace SolverCG
+  {
+    /**
+     * A helper class to detect whether the matrix type provides a
+     * matrix-vector product with the signature <code>vmult(VectorType &dst,
+     * const VectorType &src, const std::function<void(const unsigned int,
+     * const unsigned int)> &operation_before_matrix_vector_product, const
+     * std::function<void(const unsigned int, const unsigned int)>
+     * &operation_after_matrix_vector_product) const</code> that runs the two
+     * given functions on ranges of locally owned vector entries, as
+     * implemented e.g. by MatrixFree::cell_loop.
+     */
+    template <typename MatrixType, typename VectorType>
+    class has_vmult_with_std_functions
+    {
+      template <typename T>
+      static auto
+      detect (int) ->
+      decltype(std::declval<const T &>().vmult
+               (std::declval<VectorType &>(),
+                std::declval<const VectorType &>(),
+                std::declval<const std::function<void(const unsigned int,
+                                                      const unsigned int)> &>(),
+                std::declval<const std::function<void(const unsigned int,
+                                                      const unsigned int)> &>()),
+               std::true_type());
+
+      template <typename>
+      static std::false_type detect (...);
+
+    public:
+      static const bool value = decltype(detect<MatrixType>(0))::value;
+    };
+
+    /**
+     * A helper class to detect whether the vector updates of the conjugate
+     * gradient method can be fused into the matrix-vector product, which is
+     * the case for LinearAlgebra::distributed::Vector in combination with a
+     * matrix that satisfies has_vmult_with_std_functions and the identity
+     * or a diagonal preconditioner.
+     */
+    template <typename MatrixType, typename VectorType, typename PreconditionerType>
+    struct supports_fused_iteration
+    {
+      static const bool value = false;
+    };
+
+    template <typename MatrixType, typename Number>
+    struct supports_fused_iteration<MatrixType,
+      LinearAlgebra::distributed::Vector<Number>,
+      PreconditionIdentity>
+    {
+      static const bool value =
+        has_vmult_with_std_functions<MatrixType,
+        LinearAlgebra::distributed::Vector<Number> >::value;
+    };
+
+    template <typename MatrixType, typename Number>
+    struct supports_fused_iteration<MatrixType,
+      LinearAlgebra::distributed::Vector<Number>,
+      DiagonalMatrix<LinearAlgebra::distributed::Vector<Number> > >
+    {
+      static const bool value =
+        has_vmult_with_std_functions<MatrixType,
+        LinearAlgebra::distributed::Vector<Number> >::value;
+    };
+
+    /**
+     * Return a pointer to the diagonal entries of a diagonal preconditioner,
+     * or a null pointer for the identity.
+     */
+    template <typename Number>
+    inline
+    const Number *
+    diagonal_entries (const PreconditionIdentity &)
+    {
+      return nullptr;
+    }
+
+    template <typename Number>
+    inline
+    const Number *
+    diagonal_entries (const DiagonalMatrix<LinearAlgebra::distributed::Vector<Number> > &preconditioner)
+    {
+      return preconditioner.get_vector().begin();
+    }
+
+
+    /**
+     * The vector updates of the fused conjugate gradient method that run
+     * right before the matrix-vector product reads the search direction
+     * <tt>d</tt>: update the solution by the previous search direction,
+     * <tt>x += alpha d</tt>, and compute the new search direction from the
+     * residual <tt>g</tt>, <tt>d = beta d - P g</tt>, where <tt>P</tt> is the
+     * identity in case @p diagonal is a null pointer. In the first iteration,
+     * only <tt>d = -P g</tt> is computed. The operator runs on a range of
+     * vector entries as required by internal::VectorOperations::parallel_for.
+     */
+    template <typename Number>
+    struct UpdateSolutionAndDirection
+    {
+      typedef internal::VectorOperations::size_type size_type;
+
+      UpdateSolutionAndDirection (Number       *x,
+                                  Number       *d,
+                                  const Number *g,
+                                  const Number *diagonal,
+                                  const Number  alpha,
+                                  const Number  beta,
+                                  const bool    first_iteration)
+        :
+        x(x),
+        d(d),
+        g(g),
+        diagonal(diagonal),
+        alpha(alpha),
+        beta(beta),
+        first_iteration(first_iteration)
+      {}
+
+      void operator() (const size_type begin, const size_type end) const
+      {
+        if (first_iteration && diagonal != nullptr)
+          {
+            DEAL_II_OPENMP_SIMD_PRAGMA
+            for (size_type i=begin; i<end; ++i)
+              d[i] = -diagonal[i] * g[i];
+          }
+        else if (first_iteration)
+          {
+            DEAL_II_OPENMP_SIMD_PRAGMA
+            for (size_type i=begin; i<end; ++i)
+              d[i] = -g[i];
+          }
+        else if (diagonal != nullptr)
+          {
+            DEAL_II_OPENMP_SIMD_PRAGMA
+            for (size_type i=begin; i<end; ++i)
+              {
+                x[i] += alpha * d[i];
+                d[i] = beta * d[i] - diagonal[i] * g[i];
+              }
+          }
+        else
+          {
+            DEAL_II_OPENMP_SIMD_PRAGMA
+            for (size_type i=begin; i<end; ++i)
+              {
+                x[i] += alpha * d[i];
+                d[i] = beta * d[i] - g[i];
+              }
+          }
+      }
+
+      Number       *x;
+      Number       *d;
+      const Number *g;
+      const Number *diagonal;
+      const Number  alpha;
+      const Number  beta;
+      const bool    first_iteration;
+    };
+  }
+}
 
 
 /*!@addtogroup Solvers */
@@ -85,6 +265,47 @@ class PreconditionIdentity;
  * to observe the progress of the iteration.
  *
  *
+ * <h3>Fused vector operations</h3>
+ *
+ * The conjugate gradient method is usually limited by the memory bandwidth,
+ * because every vector is read from and written to main memory several times
+ * per iteration: in the matrix-vector product, in the dot products, in the
+ * vector updates, and in the preconditioner. If the vector type is
+ * LinearAlgebra::distributed::Vector, the preconditioner is either
+ * PreconditionIdentity or a DiagonalMatrix, and the matrix provides a
+ * matrix-vector product of the form
+ * @code
+ * void vmult (VectorType &dst,
+ *             const VectorType &src,
+ *             const std::function<void(const unsigned int, const unsigned int)>
+ *               &operation_before_matrix_vector_product,
+ *             const std::function<void(const unsigned int, const unsigned int)>
+ *               &operation_after_matrix_vector_product) const;
+ * @endcode
+ * this class can use a variant of the algorithm that merges the update of the
+ * solution and of the search direction into the matrix-vector product and
+ * computes the dot product of the search direction with the matrix-vector
+ * product while the data is still in caches. The residual update and the two
+ * inner products for the residual norm and the next search direction share a
+ * single global reduction. All these vector operations use the vectorized and
+ * multithreaded kernels of internal::VectorOperations. Such a matrix-vector product overwrites @p dst
+ * and calls the first function on each range of locally owned vector entries
+ * (in the MPI-local numbering) before @p src is read there, and the second
+ * function after @p dst has been completely computed there and @p src is not
+ * accessed anymore in that range. This is what the variant of
+ * MatrixFree::cell_loop with operations before and after the loop provides.
+ * The fused variant is only used if requested through
+ * AdditionalData::fuse_vector_updates.
+ *
+ * In the fused variant, the update of the solution with the last search
+ * direction is deferred to the next matrix-vector product. As a consequence,
+ * the solution vector seen by functions connected to the Solver base class
+ * and by print_vectors() lags one update behind the residual, whereas the
+ * solution returned by solve() is complete. Since the solution is updated
+ * through its locally owned entries, its ghost values are only refreshed at
+ * the end of solve() in case the vector was passed in with ghost values.
+ *
+ *
  * @author W. Bangerth, G. Kanschat, R. Becker and F.-T. Suttmeier
  */
 template <typename VectorType = Vector<double> >
@@ -98,10 +319,27 @@ public:
 
   /**
    * Standardized data struct to pipe additional data to the solver.
-   * Here, it doesn't store anything but just exists for consistency
-   * with the other solver classes.
    */
-  struct AdditionalData {};
+  struct AdditionalData
+  {
+    /**
+     * Constructor. By default, the standard algorithm is used.
+     */
+    explicit
+    AdditionalData (const bool fuse_vector_updates = false)
+      : fuse_vector_updates (fuse_vector_updates)
+    {}
+
+    /**
+     * Use the variant of the algorithm that merges the vector updates into
+     * the matrix-vector product, see the class documentation. Since this
+     * variant updates the solution one step later, the solution vector
+     * passed to functions connected to the Solver base class lags one
+     * iteration behind. The flag is ignored if the matrix, vector, and
+     * preconditioner types do not support the fused variant.
+     */
+    bool fuse_vector_updates;
+  };
 
   /**
    * Constructor.
@@ -164,6 +402,32 @@ public:
     const bool every_iteration=false);
 
 protected:
+  /**
+   * Variant of solve() that fuses the vector updates into the matrix-vector
+   * product, see the class documentation. Selected by solve() if requested
+   * through AdditionalData::fuse_vector_updates and in case the matrix,
+   * vector, and preconditioner types support it.
+   */
+  template <typename MatrixType, typename PreconditionerType>
+  void
+  solve_fused (const MatrixType         &A,
+               VectorType               &x,
+               const VectorType         &b,
+               const PreconditionerType &preconditioner,
+               std::integral_constant<bool, true>);
+
+  /**
+   * Empty variant for types that do not support the fused algorithm. Never
+   * called.
+   */
+  template <typename MatrixType, typename PreconditionerType>
+  void
+  solve_fused (const MatrixType         &A,
+               VectorType               &x,
+               const VectorType         &b,
+               const PreconditionerType &preconditioner,
+               std::integral_constant<bool, false>);
+
   /**
    * Interface for derived class. This function gets the current iteration
    * vector, the residual and the update vector in each step. It can be used
@@ -308,6 +572,18 @@ SolverCG<VectorType>::solve (const MatrixType         &A,
                              const VectorType         &b,
                              const PreconditionerType &preconditioner)
 {
+  // use the algorithm with the vector updates merged into the matrix-vector
+  // product if requested and if the types support it
+  const bool supports_fused_iteration =
+    internal::SolverCG::supports_fused_iteration<MatrixType,VectorType,
+    PreconditionerType>::value;
+  if (supports_fused_iteration && additional_data.fuse_vector_updates)
+    {
+      solve_fused (A, x, b, preconditioner,
+                   std::integral_constant<bool, supports_fused_iteration>());
+      return;
+    }
+
   SolverControl::State conv=SolverControl::iterate;
 
   LogStream::Prefix prefix("cg");
@@ -440,6 +716,202 @@ SolverCG<VectorType>::solve (const MatrixType         &A,
 
 
 
+template <typename VectorType>
+template <typename MatrixType, typename PreconditionerType>
+void
+SolverCG<VectorType>::solve_fused (const MatrixType         &,
+                                   VectorType               &,
+                                   const VectorType         &,
+                                   const PreconditionerType &,
+                                   std::integral_constant<bool, false>)
+{
+  Assert (false, ExcInternalError());
+}
+
+
+
+template <typename VectorType>
+template <typename MatrixType, typename PreconditionerType>
+void
+SolverCG<VectorType>::solve_fused (const MatrixType         &A,
+                                   VectorType               &x,
+                                   const VectorType         &b,
+                                   const PreconditionerType &preconditioner,
+                                   std::integral_constant<bool, true>)
+{
+  typedef typename VectorType::value_type Number;
+
+  SolverControl::State conv=SolverControl::iterate;
+
+  LogStream::Prefix prefix("cg");
+
+  // Memory allocation
+  typename VectorMemory<VectorType>::Pointer g_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer d_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer h_pointer(this->memory);
+
+  // define some aliases for simpler access
+  VectorType &g = *g_pointer;
+  VectorType &d = *d_pointer;
+  VectorType &h = *h_pointer;
+
+  // Should we build the matrix for eigenvalue computations?
+  const bool do_eigenvalues = !condition_number_signal.empty()
+                              ||!all_condition_numbers_signal.empty()
+                              ||!eigenvalues_signal.empty()
+                              ||!all_eigenvalues_signal.empty();
+
+  // vectors used for eigenvalue computations
+  std::vector<double> diagonal;
+  std::vector<double> offdiagonal;
+
+  int  it=0;
+  double res = -std::numeric_limits<double>::max();
+
+  double eigen_beta_alpha = 0;
+
+  g.reinit(x, true);
+  d.reinit(x, true);
+  // h enters the computation of the initial residual norm below with a
+  // zero factor, so it must not contain arbitrary values
+  h.reinit(x);
+
+  // compute residual. if vector is zero, then short-circuit the full
+  // computation
+  if (!x.all_zero())
+    {
+      A.vmult(g,x);
+      g.add(-1.,b);
+    }
+  else
+    g.equ(-1.,b);
+
+  const Number *diagonal_entries =
+    internal::SolverCG::diagonal_entries<Number>(preconditioner);
+  const unsigned int local_size = x.local_size();
+  Number *x_values = x.begin();
+  Number *g_values = g.begin();
+  Number *d_values = d.begin();
+  const Number *h_values = h.begin();
+
+  // the vector operations below run in parallel with threads and use the
+  // vectorized kernels of the vector class. the operations around the
+  // matrix-vector product are called on the ranges of vector entries
+  // touched by a chunk of cells, or on the whole locally owned range in
+  // case the matrix-vector product itself runs with threads
+  std::shared_ptr<parallel::internal::TBBPartitioner> thread_loop_partitioner
+  (new parallel::internal::TBBPartitioner());
+
+  // update the residual, g += alpha h, and compute its norm and the product
+  // with the preconditioned residual with one global reduction
+  const auto compute_residual_products = [&] (const Number alpha)
+  {
+    Number local_products[2] = {Number(), Number()};
+    internal::VectorOperations::AddAndDot<Number>
+    add_and_dot (g_values, h_values, g_values, alpha);
+    internal::VectorOperations::parallel_reduce (add_and_dot, 0, local_size,
+                                                 local_products[0],
+                                                 thread_loop_partitioner);
+    if (diagonal_entries != nullptr)
+      {
+        internal::VectorOperations::WeightedNormSquare<Number>
+        weighted_norm (g_values, diagonal_entries);
+        internal::VectorOperations::parallel_reduce (weighted_norm, 0, local_size,
+                                                     local_products[1],
+                                                     thread_loop_partitioner);
+      }
+    else
+      local_products[1] = local_products[0];
+
+    double products[2] = {local_products[0], local_products[1]};
+    Utilities::MPI::sum (products, x.get_mpi_communicator(), products);
+    return std::make_pair(products[0], products[1]);
+  };
+
+  std::pair<double,double> products = compute_residual_products(0.);
+  res = std::sqrt(products.first);
+  double gh = products.second;
+
+  conv = this->iteration_status(0, res, x);
+  if (conv != SolverControl::iterate)
+    return;
+
+  double alpha = 0., beta = 0.;
+  while (conv == SolverControl::iterate)
+    {
+      it++;
+
+      // update the solution with the previous search direction and compute
+      // the new search direction before the matrix-vector product reads it,
+      // and compute the inner product with the result right after the
+      // matrix-vector product has written it
+      internal::SolverCG::UpdateSolutionAndDirection<Number>
+      update_vectors (x_values, d_values, g_values, diagonal_entries,
+                      alpha, beta, it == 1);
+      double local_dh = 0.;
+      A.vmult(h, d,
+              [&] (const unsigned int begin, const unsigned int end)
+      {
+        internal::VectorOperations::parallel_for (update_vectors, begin, end,
+                                                  thread_loop_partitioner);
+      },
+      [&] (const unsigned int begin, const unsigned int end)
+      {
+        Number range_dh = Number();
+        internal::VectorOperations::Dot<Number,Number> dot (d_values, h_values);
+        internal::VectorOperations::parallel_reduce (dot, begin, end, range_dh,
+                                                     thread_loop_partitioner);
+        local_dh += range_dh;
+      });
+
+      alpha = Utilities::MPI::sum(local_dh, x.get_mpi_communicator());
+      Assert(alpha != 0., ExcDivideByZero());
+      alpha = gh/alpha;
+
+      products = compute_residual_products(alpha);
+      res = std::sqrt(products.first);
+
+      print_vectors(it, x, g, d);
+
+      conv = this->iteration_status(it, res, x);
+      if (conv != SolverControl::iterate)
+        {
+          x.add(alpha, d);
+          break;
+        }
+
+      beta = gh;
+      Assert(beta != 0., ExcDivideByZero());
+      gh   = products.second;
+      beta = gh/beta;
+
+      this->coefficients_signal(alpha,beta);
+      if (do_eigenvalues)
+        {
+          diagonal.push_back(1./alpha + eigen_beta_alpha);
+          eigen_beta_alpha = beta/alpha;
+          offdiagonal.push_back(std::sqrt(beta)/alpha);
+        }
+      compute_eigs_and_cond(diagonal,offdiagonal,all_eigenvalues_signal,
+                            all_condition_numbers_signal);
+    }
+
+  compute_eigs_and_cond(diagonal,offdiagonal,eigenvalues_signal,
+                        condition_number_signal);
+
+  // the solution was updated through its local values, so the ghost values
+  // need to be refreshed in case the vector came in with ghosts
+  if (x.has_ghost_elements())
+    x.update_ghost_values();
+
+  // in case of failure: throw exception
+  if (conv != SolverControl::success)
+    AssertThrow(false, SolverControl::NoConvergence (it, res));
+  // otherwise exit as normal
+}
+
+
+
 template <typename VectorType>
 boost::signals2::connection
 SolverCG<VectorType>::connect_coefficients_slot
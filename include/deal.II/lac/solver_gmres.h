@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1998 - 2017 by the deal.II authors
+// Copyright (C) 1998 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -21,12 +21,14 @@
 #include <deal.II/base/config.h>
 #include <deal.II/base/subscriptor.h>
 #include <deal.II/base/logstream.h>
+#include <deal.II/base/mpi.h>
 #include <deal.II/lac/householder.h>
 #include <deal.II/lac/solver.h>
 #include <deal.II/lac/solver_control.h>
 #include <deal.II/lac/full_matrix.h>
 #include <deal.II/lac/lapack_full_matrix.h>
 #include <deal.II/lac/vector.h>
+#include <deal.II/lac/vector_operations_internal.h>
 
 #include <deal.II/base/std_cxx14/memory.h>
 
@@ -36,6 +38,14 @@
 
 DEAL_II_NAMESPACE_OPEN
 
+namespace LinearAlgebra
+{
+  namespace distributed
+  {
+    template <typename> class Vector;
+  }
+}
+
 /*!@addtogroup Solvers */
 /*@{*/
 
@@ -514,6 +524,145 @@ private:
   FullMatrix<double> H1;
 };
 
+
+/**
+ * Implementation of a communication-avoiding variant of the restarted GMRES
+ * method, also called s-step GMRES or CA-GMRES, see M. Hoemmen,
+ * "Communication-avoiding Krylov subspace methods", PhD thesis, UC Berkeley,
+ * 2010.
+ *
+ * SolverGMRES builds the Arnoldi basis one vector at a time and computes one
+ * inner product with each of the previous basis vectors, which results in a
+ * global reduction for each inner product in the parallel case. This class
+ * instead generates AdditionalData::s_step_size new Krylov vectors at a time
+ * with the (preconditioned) matrix, using the Newton basis
+ * <i>v<sub>i+1</sub> = (P<sup>-1</sup>A - &theta;<sub>i</sub>I)
+ * v<sub>i</sub></i>, and then orthogonalizes the whole block against the
+ * previous basis and within itself. The block orthogonalization is done by
+ * block classical Gram-Schmidt combined with a Cholesky QR factorization,
+ * where all inner products of the block are computed with a single global
+ * reduction, and the procedure is repeated once to restore orthogonality up
+ * to roundoff (BCGS2 with CholQR2). The Hessenberg matrix of the Arnoldi
+ * process is then recovered from the change of basis and the triangular
+ * factors. This reduces the number of global reductions by a factor of
+ * approximately s/2 compared to SolverGMRES.
+ *
+ * The shifts &theta;<sub>i</sub> of the Newton basis are the Ritz values of
+ * the first s steps of the first restart cycle, which is run with the
+ * standard Arnoldi process. They are ordered in the Leja ordering to keep
+ * the basis well conditioned. To stay in real arithmetic, only the real part
+ * of complex Ritz values is used. If deal.II was configured without LAPACK,
+ * the diagonal entries of the Hessenberg matrix are used instead of the Ritz
+ * values.
+ *
+ * The all-reduce of the block inner products is done by a single call to
+ * Utilities::MPI::sum() for LinearAlgebra::distributed::Vector. For other
+ * vector types, the inner products are computed by the vector class one at
+ * a time, so the algorithm works for them but does not reduce the
+ * communication.
+ *
+ * Like SolverGMRES with the default settings, the solver measures
+ * convergence by the preconditioned residual when preconditioning from the
+ * left, and by the unpreconditioned residual when preconditioning from the
+ * right. The size of the basis before a restart is given by
+ * AdditionalData::max_basis_size.
+ *
+ * If the new vectors in the block are linearly dependent, which typically
+ * happens close to convergence, the block is truncated at the first
+ * dependent vector. If the first vector is dependent, the solver falls back
+ * to a single step of the standard Arnoldi process.
+ */
+template <class VectorType = Vector<double> >
+class SolverSStepGMRES : public Solver<VectorType>
+{
+public:
+  /**
+   * Standardized data struct to pipe additional data to the solver.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor. By default, set the maximum basis size to 30, the number
+     * of vectors generated at a time to 5, and preconditioning from the left.
+     */
+    explicit
+    AdditionalData (const unsigned int max_basis_size = 30,
+                    const unsigned int s_step_size = 5,
+                    const bool         right_preconditioning = false);
+
+    /**
+     * Maximum size of the Krylov basis before a restart.
+     */
+    unsigned int max_basis_size;
+
+    /**
+     * Number of Krylov vectors generated and orthogonalized at a time.
+     */
+    unsigned int s_step_size;
+
+    /**
+     * Flag for right preconditioning.
+     */
+    bool right_preconditioning;
+  };
+
+  /**
+   * Constructor.
+   */
+  SolverSStepGMRES (SolverControl            &cn,
+                    VectorMemory<VectorType> &mem,
+                    const AdditionalData     &data=AdditionalData());
+
+  /**
+   * Constructor. Use an object of type GrowingVectorMemory as a default to
+   * allocate memory.
+   */
+  SolverSStepGMRES (SolverControl        &cn,
+                    const AdditionalData &data=AdditionalData());
+
+  /**
+   * Solve the linear system $Ax=b$ for x.
+   */
+  template <typename MatrixType, typename PreconditionerType>
+  void
+  solve (const MatrixType         &A,
+         VectorType               &x,
+         const VectorType         &b,
+         const PreconditionerType &preconditioner);
+
+  /**
+   * Return the number of global reductions done during the last call to
+   * solve(). For LinearAlgebra::distributed::Vector, the inner products of
+   * a block are computed with a single reduction, for other vector types
+   * with one reduction per inner product. The inner products of the
+   * standard Arnoldi steps and the norms of the residuals at restarts count
+   * as one reduction each.
+   */
+  unsigned int n_reductions () const;
+
+private:
+  /**
+   * Additional flags.
+   */
+  AdditionalData additional_data;
+
+  /**
+   * Projected system matrix.
+   */
+  FullMatrix<double> H;
+
+  /**
+   * Upper triangular matrix obtained from @p H by Givens rotations, for
+   * solving the least squares problem.
+   */
+  FullMatrix<double> H1;
+
+  /**
+   * Counter for the number of global reductions.
+   */
+  unsigned int reduction_counter;
+};
+
 /*@}*/
 /* --------------------- Inline and template functions ------------------- */
 
@@ -581,6 +730,136 @@ namespace internal
     {
       return x.real() < y.real() || (x.real() == y.real() && x.imag() < y.imag());
     }
+
+
+
+    // Apply the previous Givens rotations stored in ci and si to the column
+    // col of the Hessenberg matrix given in h, then compute the rotation that
+    // eliminates the subdiagonal entry h(col+1) and apply it to h and to the
+    // right hand side b of the least squares problem
+    inline
+    void
+    givens_rotation (dealii::Vector<double> &h,
+                     dealii::Vector<double> &b,
+                     dealii::Vector<double> &ci,
+                     dealii::Vector<double> &si,
+                     const int               col)
+    {
+      for (int i=0 ; i<col ; i++)
+        {
+          const double s = si(i);
+          const double c = ci(i);
+          const double dummy = h(i);
+          h(i)   =  c*dummy + s*h(i+1);
+          h(i+1) = -s*dummy + c*h(i+1);
+        };
+
+      const double r = 1./std::sqrt(h(col)*h(col) + h(col+1)*h(col+1));
+      si(col) = h(col+1) *r;
+      ci(col) = h(col)   *r;
+      h(col)  =  ci(col)*h(col) + si(col)*h(col+1);
+      b(col+1)= -si(col)*b(col);
+      b(col) *=  ci(col);
+    }
+
+
+
+    // Compute the inner products of the vectors with indices start,
+    // ..., start+n_new-1 with all the vectors 0, ..., start+n_new-1 in the
+    // given collection, i.e., result(i,j) = v[i] * v[start+j], and return
+    // the number of global reductions this took. The general version uses
+    // the inner products of the vector class, one reduction each.
+    template <typename VectorType>
+    struct BlockInnerProducts
+    {
+      static unsigned int compute (const TmpVectors<VectorType> &v,
+                                   const unsigned int            start,
+                                   const unsigned int            n_new,
+                                   FullMatrix<double>           &result)
+      {
+        result.reinit(start+n_new, n_new);
+        for (unsigned int j=0; j<n_new; ++j)
+          for (unsigned int i=0; i<start+n_new; ++i)
+            result(i,j) = v[i] * v[start+j];
+        return (start+n_new) * n_new;
+      }
+    };
+
+
+
+    // Specialization for LinearAlgebra::distributed::Vector that computes
+    // the local parts of all inner products with the vectorized and
+    // multithreaded reductions of internal::VectorOperations and then sums
+    // them up over all processors with a single reduction
+    template <typename Number>
+    struct BlockInnerProducts<LinearAlgebra::distributed::Vector<Number> >
+    {
+      static unsigned int compute (const TmpVectors<LinearAlgebra::distributed::Vector<Number> > &v,
+                                   const unsigned int start,
+                                   const unsigned int n_new,
+                                   FullMatrix<double> &result)
+      {
+        const unsigned int n_vectors = start+n_new;
+        const unsigned int local_size = v[0].local_size();
+        std::shared_ptr<parallel::internal::TBBPartitioner> thread_loop_partitioner
+        (new parallel::internal::TBBPartitioner());
+        std::vector<double> local_sums(n_vectors*n_new, 0.);
+        for (unsigned int i=0; i<n_vectors; ++i)
+          for (unsigned int j=0; j<n_new; ++j)
+            {
+              AssertDimension (v[i].local_size(), local_size);
+              Number sum = Number();
+              internal::VectorOperations::Dot<Number,Number>
+              dot (v[i].begin(), v[start+j].begin());
+              internal::VectorOperations::parallel_reduce (dot, 0, local_size, sum,
+                                                           thread_loop_partitioner);
+              local_sums[i*n_new+j] = sum;
+            }
+        std::vector<double> sums(local_sums.size());
+        Utilities::MPI::sum(local_sums, v[0].get_mpi_communicator(), sums);
+        result.reinit(n_vectors, n_new);
+        for (unsigned int i=0; i<n_vectors; ++i)
+          for (unsigned int j=0; j<n_new; ++j)
+            result(i,j) = sums[i*n_new+j];
+        return 1;
+      }
+    };
+
+
+
+    // Return the given shifts in Leja ordering, i.e., start with the shift
+    // of largest magnitude and then successively select the shift that
+    // maximizes the product of the distances to the shifts already chosen
+    inline
+    std::vector<double>
+    leja_ordering (const std::vector<double> &shifts)
+    {
+      std::vector<double> ordered;
+      std::vector<bool> taken(shifts.size(), false);
+      for (unsigned int k=0; k<shifts.size(); ++k)
+        {
+          unsigned int best = numbers::invalid_unsigned_int;
+          double best_value = -1.;
+          for (unsigned int i=0; i<shifts.size(); ++i)
+            if (!taken[i])
+              {
+                double value = 1.;
+                if (k == 0)
+                  value = std::abs(shifts[i]);
+                else
+                  for (unsigned int l=0; l<ordered.size(); ++l)
+                    value *= std::abs(shifts[i] - ordered[l]);
+                if (value > best_value)
+                  {
+                    best_value = value;
+                    best = i;
+                  }
+              }
+          taken[best] = true;
+          ordered.push_back(shifts[best]);
+        }
+      return ordered;
+    }
   }
 }
 
@@ -631,21 +910,7 @@ SolverGMRES<VectorType>::givens_rotation (Vector<double> &h,
                                           Vector<double> &si,
                                           int            col) const
 {
-  for (int i=0 ; i<col ; i++)
-    {
-      const double s = si(i);
-      const double c = ci(i);
-      const double dummy = h(i);
-      h(i)   =  c*dummy + s*h(i+1);
-      h(i+1) = -s*dummy + c*h(i+1);
-    };
-
-  const double r = 1./std::sqrt(h(col)*h(col) + h(col+1)*h(col+1));
-  si(col) = h(col+1) *r;
-  ci(col) = h(col)   *r;
-  h(col)  =  ci(col)*h(col) + si(col)*h(col+1);
-  b(col+1)= -si(col)*b(col);
-  b(col) *=  ci(col);
+  internal::SolverGMRES::givens_rotation(h, b, ci, si, col);
 }
 
 
@@ -1261,6 +1526,413 @@ SolverFGMRES<VectorType>::solve (const MatrixType         &A,
                                                      res));
 }
 
+//----------------------------------------------------------------------//
+
+template <class VectorType>
+inline
+SolverSStepGMRES<VectorType>::AdditionalData::
+AdditionalData (const unsigned int max_basis_size,
+                const unsigned int s_step_size,
+                const bool         right_preconditioning)
+  :
+  max_basis_size(max_basis_size),
+  s_step_size(s_step_size),
+  right_preconditioning(right_preconditioning)
+{}
+
+
+
+template <class VectorType>
+SolverSStepGMRES<VectorType>::SolverSStepGMRES (SolverControl            &cn,
+                                                VectorMemory<VectorType> &mem,
+                                                const AdditionalData     &data)
+  :
+  Solver<VectorType> (cn, mem),
+  additional_data(data),
+  reduction_counter(0)
+{}
+
+
+
+template <class VectorType>
+SolverSStepGMRES<VectorType>::SolverSStepGMRES (SolverControl        &cn,
+                                                const AdditionalData &data)
+  :
+  Solver<VectorType> (cn),
+  additional_data(data),
+  reduction_counter(0)
+{}
+
+
+
+template <class VectorType>
+unsigned int
+SolverSStepGMRES<VectorType>::n_reductions () const
+{
+  return reduction_counter;
+}
+
+
+
+template <class VectorType>
+template <typename MatrixType, typename PreconditionerType>
+void
+SolverSStepGMRES<VectorType>::solve (const MatrixType         &A,
+                                     VectorType               &x,
+                                     const VectorType         &b,
+                                     const PreconditionerType &preconditioner)
+{
+  LogStream::Prefix prefix("s-step GMRES");
+
+  Assert (additional_data.max_basis_size > 0,
+          ExcMessage("The basis size must be positive."));
+  Assert (additional_data.s_step_size > 0,
+          ExcMessage("The number of vectors per block must be positive."));
+
+  SolverControl::State iteration_state = SolverControl::iterate;
+
+  const unsigned int basis_size = additional_data.max_basis_size;
+  const unsigned int s_step_size = std::min(additional_data.s_step_size,
+                                            basis_size);
+  const bool left_precondition = !additional_data.right_preconditioning;
+
+  // Generate an object where basis vectors are stored.
+  internal::SolverGMRES::TmpVectors<VectorType> v (basis_size+1, this->memory);
+
+  typename VectorMemory<VectorType>::Pointer aux (this->memory);
+  typename VectorMemory<VectorType>::Pointer aux2 (this->memory);
+  aux->reinit(x);
+  aux2->reinit(x);
+
+  // apply the preconditioned operator, i.e., P^{-1} A src for left and
+  // A P^{-1} src for right preconditioning
+  const auto apply_operator = [&](VectorType &dst, const VectorType &src)
+  {
+    if (left_precondition)
+      {
+        A.vmult(*aux, src);
+        preconditioner.vmult(dst, *aux);
+      }
+    else
+      {
+        preconditioner.vmult(*aux, src);
+        A.vmult(dst, *aux);
+      }
+  };
+
+  // number of the present iteration; this number is not reset to zero upon a
+  // restart
+  unsigned int accumulated_iterations = 0;
+  reduction_counter = 0;
+
+  // shifts of the Newton basis, computed from the Ritz values of the first
+  // cycle
+  std::vector<double> shifts;
+
+  Vector<double> projected_rhs, h, ci, si;
+  Vector<double> y;
+  FullMatrix<double> inner_products, C, C_total, R_total, W, B, M, T;
+
+  double res = -std::numeric_limits<double>::max();
+
+  do
+    {
+      // compute the (preconditioned) residual
+      A.vmult(*aux2, x);
+      aux2->sadd(-1., 1., b);
+      VectorType &v0 = v(0, x);
+      if (left_precondition)
+        preconditioner.vmult(v0, *aux2);
+      else
+        v0 = *aux2;
+
+      const double beta = v0.l2_norm();
+      ++reduction_counter;
+      res = beta;
+      iteration_state = this->iteration_status(accumulated_iterations, res, x);
+      if (iteration_state != SolverControl::iterate)
+        break;
+
+      v0 *= 1./beta;
+      H.reinit(basis_size+1, basis_size);
+
+      // as in SolverGMRES, the least squares problem is updated by one
+      // Givens rotation per new column. H keeps the unrotated Hessenberg
+      // matrix, which the change of basis of the next blocks needs
+      H1.reinit(basis_size+1, basis_size);
+      projected_rhs.reinit(basis_size+1);
+      projected_rhs(0) = beta;
+      ci.reinit(basis_size);
+      si.reinit(basis_size);
+
+      // number of columns of the Hessenberg matrix computed so far, i.e.,
+      // the number of basis vectors minus one
+      unsigned int n_cols = 0;
+      unsigned int n_converged_cols = numbers::invalid_unsigned_int;
+      while (n_cols < basis_size &&
+             n_converged_cols == numbers::invalid_unsigned_int)
+        {
+          const unsigned int n_cols_before = n_cols;
+          unsigned int block_size = std::min(s_step_size, basis_size-n_cols);
+
+          if (shifts.size() > 0)
+            {
+              // generate the Newton basis
+              for (unsigned int i=0; i<block_size; ++i)
+                {
+                  VectorType &vv = v(n_cols+1+i, x);
+                  apply_operator(vv, v[n_cols+i]);
+                  vv.add(-shifts[i], v[n_cols+i]);
+                }
+
+              // block orthogonalization with two passes of block classical
+              // Gram-Schmidt and Cholesky QR, each with a single reduction.
+              // The original vectors are represented as
+              // V = Q C_total + V_new R_total
+              C_total.reinit(n_cols+1, block_size);
+              R_total.reinit(block_size, block_size);
+              for (unsigned int i=0; i<block_size; ++i)
+                R_total(i,i) = 1.;
+              for (unsigned int pass=0; pass<2 && block_size>0; ++pass)
+                {
+                  reduction_counter +=
+                    internal::SolverGMRES::BlockInnerProducts<VectorType>::
+                    compute(v, n_cols+1, block_size, inner_products);
+
+                  // project out the previous basis vectors and compute the
+                  // Gram matrix of the projected vectors
+                  C.reinit(n_cols+1, block_size);
+                  for (unsigned int i=0; i<n_cols+1; ++i)
+                    for (unsigned int j=0; j<block_size; ++j)
+                      C(i,j) = inner_products(i,j);
+                  for (unsigned int j=0; j<block_size; ++j)
+                    for (unsigned int i=0; i<n_cols+1; ++i)
+                      v[n_cols+1+j].add(-C(i,j), v[i]);
+
+                  FullMatrix<double> R(block_size, block_size);
+                  for (unsigned int i=0; i<block_size; ++i)
+                    for (unsigned int j=i; j<block_size; ++j)
+                      {
+                        double value = inner_products(n_cols+1+i,j);
+                        for (unsigned int k=0; k<n_cols+1; ++k)
+                          value -= C(k,i) * C(k,j);
+                        R(i,j) = value;
+                      }
+
+                  // Cholesky factorization R^T R of the Gram matrix. stop at
+                  // the first vector that is (numerically) linearly dependent
+                  // on the previous ones
+                  unsigned int rank = 0;
+                  for (; rank<block_size; ++rank)
+                    {
+                      const unsigned int i = rank;
+                      const double original_norm =
+                        inner_products(n_cols+1+i,i);
+                      double diagonal = R(i,i);
+                      for (unsigned int k=0; k<i; ++k)
+                        diagonal -= R(k,i) * R(k,i);
+                      if (!(diagonal > 1e-24 * original_norm) ||
+                          original_norm == 0.)
+                        break;
+                      R(i,i) = std::sqrt(diagonal);
+                      for (unsigned int j=i+1; j<block_size; ++j)
+                        {
+                          double value = R(i,j);
+                          for (unsigned int k=0; k<i; ++k)
+                            value -= R(k,i) * R(k,j);
+                          R(i,j) = value / R(i,i);
+                        }
+                    }
+
+                  // V_new = V R^{-1}
+                  for (unsigned int j=0; j<rank; ++j)
+                    {
+                      VectorType &vv = v[n_cols+1+j];
+                      for (unsigned int k=0; k<j; ++k)
+                        vv.add(-R(k,j), v[n_cols+1+k]);
+                      vv *= 1./R(j,j);
+                    }
+
+                  // accumulate the factors: C_total += C R_total, R_total =
+                  // R R_total, truncated to the rank of the block
+                  FullMatrix<double> CR(n_cols+1, rank), RR(rank, rank);
+                  for (unsigned int i=0; i<n_cols+1; ++i)
+                    for (unsigned int j=0; j<rank; ++j)
+                      {
+                        double value = C_total(i,j);
+                        for (unsigned int k=0; k<=j; ++k)
+                          value += C(i,k) * R_total(k,j);
+                        CR(i,j) = value;
+                      }
+                  for (unsigned int i=0; i<rank; ++i)
+                    for (unsigned int j=i; j<rank; ++j)
+                      {
+                        double value = 0.;
+                        for (unsigned int k=i; k<=j; ++k)
+                          value += R(i,k) * R_total(k,j);
+                        RR(i,j) = value;
+                      }
+                  C_total = CR;
+                  R_total = RR;
+                  block_size = rank;
+                }
+
+              if (block_size > 0)
+                {
+                  // coordinates of the Newton basis vectors v_0, ..., v_s in
+                  // the orthonormal basis
+                  W.reinit(n_cols+1+block_size, block_size+1);
+                  W(n_cols,0) = 1.;
+                  for (unsigned int j=0; j<block_size; ++j)
+                    {
+                      for (unsigned int i=0; i<n_cols+1; ++i)
+                        W(i,j+1) = C_total(i,j);
+                      for (unsigned int i=0; i<=j; ++i)
+                        W(n_cols+1+i,j+1) = R_total(i,j);
+                    }
+
+                  // change of basis matrix of the Newton basis, i.e.,
+                  // op(v_i) = v_{i+1} + theta_i v_i
+                  B.reinit(block_size+1, block_size);
+                  for (unsigned int i=0; i<block_size; ++i)
+                    {
+                      B(i,i) = shifts[i];
+                      B(i+1,i) = 1.;
+                    }
+
+                  // op(Q_new T) = Q W B - op(Q_old X), where T and X are the
+                  // parts of W associated with the new and old columns of the
+                  // Hessenberg matrix and op(Q_old) = Q_old H_old
+                  M.reinit(n_cols+1+block_size, block_size);
+                  W.mmult(M, B);
+                  for (unsigned int j=0; j<block_size; ++j)
+                    for (unsigned int i=0; i<n_cols+1; ++i)
+                      {
+                        double value = 0.;
+                        for (unsigned int k=0; k<n_cols; ++k)
+                          value += H(i,k) * W(k,j);
+                        M(i,j) -= value;
+                      }
+
+                  // H_new = M T^{-1} with the upper triangular matrix T
+                  T.reinit(block_size, block_size);
+                  for (unsigned int i=0; i<block_size; ++i)
+                    for (unsigned int j=i; j<block_size; ++j)
+                      T(i,j) = W(n_cols+i,j);
+                  for (unsigned int j=0; j<block_size; ++j)
+                    for (unsigned int i=0; i<n_cols+1+block_size; ++i)
+                      {
+                        double value = M(i,j);
+                        for (unsigned int k=0; k<j; ++k)
+                          value -= H(i,n_cols+k) * T(k,j);
+                        H(i,n_cols+j) = value / T(j,j);
+                      }
+                  n_cols += block_size;
+                }
+            }
+
+          // use the standard Arnoldi process with modified Gram-Schmidt for
+          // the first block, which gives the Ritz values for the shifts of
+          // the Newton basis, and as a fallback if the block degenerated
+          if (shifts.size() == 0 || block_size == 0)
+            {
+              const unsigned int n_steps = shifts.size() == 0 ? block_size : 1;
+              for (unsigned int step=0; step<n_steps; ++step, ++n_cols)
+                {
+                  VectorType &vv = v(n_cols+1, x);
+                  apply_operator(vv, v[n_cols]);
+                  H(0,n_cols) = vv * v[0];
+                  for (unsigned int i=1; i<=n_cols; ++i)
+                    H(i,n_cols) = vv.add_and_dot(-H(i-1,n_cols), v[i-1], v[i]);
+                  const double norm =
+                    std::sqrt(vv.add_and_dot(-H(n_cols,n_cols), v[n_cols], vv));
+                  H(n_cols+1,n_cols) = norm;
+                  reduction_counter += n_cols+2;
+
+                  // treat lucky breakdown
+                  if (norm != 0.)
+                    vv *= 1./norm;
+                  else
+                    vv = 0.;
+                }
+
+              if (shifts.size() == 0)
+                {
+                  shifts.resize(n_cols);
+#ifdef DEAL_II_WITH_LAPACK
+                  LAPACKFullMatrix<double> H_square(n_cols, n_cols);
+                  for (unsigned int i=0; i<n_cols; ++i)
+                    for (unsigned int j=0; j<n_cols; ++j)
+                      H_square(i,j) = H(i,j);
+                  H_square.compute_eigenvalues();
+                  for (unsigned int i=0; i<n_cols; ++i)
+                    shifts[i] = H_square.eigenvalue(i).real();
+#else
+                  for (unsigned int i=0; i<n_cols; ++i)
+                    shifts[i] = H(i,i);
+#endif
+                  shifts = internal::SolverGMRES::leja_ordering(shifts);
+
+                  // the Newton basis needs one shift per vector in a block
+                  while (shifts.size() < s_step_size)
+                    shifts.push_back(shifts[shifts.size() % n_cols]);
+                }
+            }
+
+          // rotate each of the new columns to upper triangular form and
+          // check convergence with the residual of the least squares
+          // problem. note that the vector 'x' we pass to the criterion is
+          // not the final solution
+          for (unsigned int j=n_cols_before+1; j<=n_cols; ++j)
+            {
+              h.reinit(j+1);
+              for (unsigned int i=0; i<=j; ++i)
+                h(i) = H(i,j-1);
+              internal::SolverGMRES::givens_rotation(h, projected_rhs, ci, si,
+                                                     j-1);
+              for (unsigned int i=0; i<j; ++i)
+                H1(i,j-1) = h(i);
+
+              res = std::fabs(projected_rhs(j));
+              iteration_state = this->iteration_status(++accumulated_iterations,
+                                                       res, x);
+              if (iteration_state != SolverControl::iterate)
+                {
+                  n_converged_cols = j;
+                  break;
+                }
+            }
+        }
+
+      // solve the upper triangular system for the coefficients of the update
+      const unsigned int dim = (n_converged_cols == numbers::invalid_unsigned_int ?
+                                n_cols : n_converged_cols);
+      FullMatrix<double> R(dim, dim);
+      R.fill(H1);
+      y.reinit(dim);
+      R.backward(y, projected_rhs);
+
+      // Update solution vector
+      if (left_precondition)
+        for (unsigned int j=0; j<y.size(); ++j)
+          x.add(y(j), v[j]);
+      else
+        {
+          *aux2 = 0.;
+          for (unsigned int j=0; j<y.size(); ++j)
+            aux2->add(y(j), v[j]);
+          preconditioner.vmult(*aux, *aux2);
+          x.add(1., *aux);
+        }
+    }
+  while (iteration_state == SolverControl::iterate);
+
+  // in case of failure: throw exception
+  if (iteration_state != SolverControl::success)
+    AssertThrow(false, SolverControl::NoConvergence (accumulated_iterations,
+                                                     res));
+}
+
 #endif // DOXYGEN
 
 DEAL_II_NAMESPACE_CLOSE
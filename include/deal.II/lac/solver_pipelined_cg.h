@@ -0,0 +1,552 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_solver_pipelined_cg_h
+#define dealii_solver_pipelined_cg_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/lac/solver.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/vector_operations_internal.h>
+
+#include <chrono>
+#include <cmath>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace internal
+{
+  namespace SolverPipelinedCG
+  {
+    /**
+     * A class that computes the global sum of a few numbers with a
+     * non-blocking collective operation, MPI_Iallreduce, if MPI of version
+     * 3.0 or higher is available. Otherwise, or if the communicator contains
+     * only a single process, the reduction is done when start() is called.
+     */
+    class NonBlockingSum
+    {
+    public:
+      /**
+       * Constructor.
+       */
+      NonBlockingSum ()
+        :
+        in_flight (false)
+      {}
+
+      /**
+       * Destructor. Waits for an outstanding reduction.
+       */
+      ~NonBlockingSum ()
+      {
+        finish();
+      }
+
+      /**
+       * Start summing up the @p n_values entries stored in @p values over all
+       * processes of the communicator. The result is available in @p values
+       * after finish() has returned.
+       */
+      void start (double            *values,
+                  const unsigned int n_values,
+                  const MPI_Comm    &mpi_communicator)
+      {
+        Assert (in_flight == false, ExcInternalError());
+#ifdef DEAL_II_WITH_MPI
+        if (Utilities::MPI::job_supports_mpi() &&
+            Utilities::MPI::n_mpi_processes(mpi_communicator) > 1)
+          {
+#  if MPI_VERSION >= 3
+            const int ierr = MPI_Iallreduce (MPI_IN_PLACE, values, n_values,
+                                             MPI_DOUBLE, MPI_SUM,
+                                             mpi_communicator, &request);
+            AssertThrowMPI(ierr);
+            in_flight = true;
+#  else
+            const int ierr = MPI_Allreduce (MPI_IN_PLACE, values, n_values,
+                                            MPI_DOUBLE, MPI_SUM,
+                                            mpi_communicator);
+            AssertThrowMPI(ierr);
+#  endif
+          }
+#else
+        (void)values;
+        (void)n_values;
+        (void)mpi_communicator;
+#endif
+      }
+
+      /**
+       * Return whether a non-blocking reduction has been started and not
+       * yet finished.
+       */
+      bool is_in_flight () const
+      {
+        return in_flight;
+      }
+
+      /**
+       * Wait for the completion of the reduction started by start().
+       */
+      void finish ()
+      {
+#ifdef DEAL_II_WITH_MPI
+        if (in_flight)
+          {
+            const int ierr = MPI_Wait (&request, MPI_STATUS_IGNORE);
+            AssertThrowMPI(ierr);
+            in_flight = false;
+          }
+#endif
+      }
+
+    private:
+      /**
+       * Whether a non-blocking reduction is currently outstanding.
+       */
+      bool in_flight;
+
+#ifdef DEAL_II_WITH_MPI
+      /**
+       * The request of the outstanding reduction.
+       */
+      MPI_Request request;
+#endif
+    };
+
+
+
+    /**
+     * Compute the three inner products (r,u), (w,u), (r,r) needed by the
+     * pipelined conjugate gradient method. For general vector types, the
+     * global inner products are computed in start() by the vector
+     * operations, which involve a blocking reduction each.
+     */
+    template <typename VectorType>
+    struct InnerProducts
+    {
+      static void start (const VectorType &r,
+                         const VectorType &u,
+                         const VectorType &w,
+                         double           *values,
+                         NonBlockingSum   &)
+      {
+        values[0] = r * u;
+        values[1] = w * u;
+        values[2] = r * r;
+      }
+    };
+
+
+
+    /**
+     * Specialization for LinearAlgebra::distributed::Vector. The local parts
+     * of the three inner products are computed with the vectorized and
+     * multithreaded reductions of internal::VectorOperations, and the global
+     * sum is started as a non-blocking reduction.
+     */
+    template <typename Number>
+    struct InnerProducts<LinearAlgebra::distributed::Vector<Number> >
+    {
+      static void start (const LinearAlgebra::distributed::Vector<Number> &r,
+                         const LinearAlgebra::distributed::Vector<Number> &u,
+                         const LinearAlgebra::distributed::Vector<Number> &w,
+                         double                                           *values,
+                         NonBlockingSum                                   &sum)
+      {
+        AssertDimension (r.local_size(), u.local_size());
+        AssertDimension (r.local_size(), w.local_size());
+        const unsigned int local_size = r.local_size();
+        std::shared_ptr<parallel::internal::TBBPartitioner> thread_loop_partitioner
+        (new parallel::internal::TBBPartitioner());
+
+        Number ru = Number(), wu = Number(), rr = Number();
+        internal::VectorOperations::Dot<Number,Number> dot_ru (r.begin(), u.begin());
+        internal::VectorOperations::parallel_reduce (dot_ru, 0, local_size, ru,
+                                                     thread_loop_partitioner);
+        internal::VectorOperations::Dot<Number,Number> dot_wu (w.begin(), u.begin());
+        internal::VectorOperations::parallel_reduce (dot_wu, 0, local_size, wu,
+                                                     thread_loop_partitioner);
+        internal::VectorOperations::Norm2<Number,Number> norm_r (r.begin());
+        internal::VectorOperations::parallel_reduce (norm_r, 0, local_size, rr,
+                                                     thread_loop_partitioner);
+        values[0] = ru;
+        values[1] = wu;
+        values[2] = rr;
+        sum.start (values, 3, r.get_mpi_communicator());
+      }
+    };
+  }
+}
+
+
+
+/*!@addtogroup Solvers */
+/*@{*/
+
+/**
+ * Pipelined preconditioned conjugate gradient method for symmetric positive
+ * definite matrices, following the algorithm by P. Ghysels and W. Vanroose,
+ * "Hiding global synchronization latency in the preconditioned Conjugate
+ * Gradient algorithm", Parallel Computing 40(7):224-238, 2014.
+ *
+ * The classical conjugate gradient method as implemented in SolverCG
+ * computes two inner products per iteration, each of which involves a global
+ * reduction over all processes that must be completed before the iteration
+ * can proceed. On large numbers of processes with little work per process,
+ * the latency of these reductions dominates the run time. This class
+ * rearranges the iteration by introducing additional auxiliary vectors such
+ * that all inner products of an iteration are combined into a single
+ * reduction, and the matrix-vector product and the application of the
+ * preconditioner do not depend on its result. For
+ * LinearAlgebra::distributed::Vector, the reduction is started as a
+ * non-blocking MPI_Iallreduce (requires MPI 3.0) that proceeds in the
+ * background while the preconditioner and the matrix-vector product are
+ * computed. For other vector types such as the Trilinos and PETSc vectors,
+ * the algorithm works as well, but computes the inner products with the
+ * blocking operations of the vector class.
+ *
+ * The price to pay is a higher number of vector operations (the solver uses
+ * nine auxiliary vectors instead of three) and a somewhat lower numerical
+ * stability, since the residual is not computed directly but via recurrences.
+ * In exact arithmetic, the iterates coincide with the ones of SolverCG. The
+ * method pays off if the time of the global reductions is larger than the
+ * time of the additional vector updates, which is typically the case for less
+ * than some ten thousand unknowns per process on large parallel machines.
+ *
+ * Like the other solvers, this class uses the mechanism described in the
+ * Solver base class to determine convergence. Since the residual norm of an
+ * iterate becomes available only after the next matrix-vector product has
+ * been computed, the solver performs one more matrix-vector product than
+ * SolverCG.
+ *
+ * <h3>Statistics on the hidden latency</h3>
+ *
+ * The solver records the time spent in computations while a reduction is
+ * outstanding and the time it had to wait for the reduction to complete
+ * afterwards. They are available through get_reduction_statistics() after
+ * solve() has returned. A small waiting time compared to the time spent in
+ * computations means that the latency of the reductions has been hidden
+ * almost completely.
+ */
+template <typename VectorType = Vector<double> >
+class SolverPipelinedCG : public Solver<VectorType>
+{
+public:
+  /**
+   * Standardized data struct to pipe additional data to the solver.
+   * Here, it doesn't store anything but just exists for consistency
+   * with the other solver classes.
+   */
+  struct AdditionalData {};
+
+  /**
+   * Statistics of the global reductions of the last call to solve().
+   */
+  struct ReductionStatistics
+  {
+    /**
+     * Constructor.
+     */
+    ReductionStatistics ();
+
+    /**
+     * The number of times the inner products of an iteration were computed.
+     * For LinearAlgebra::distributed::Vector, each of them is one global
+     * reduction. For other vector types, each of them consists of three
+     * blocking reductions of the vector class.
+     */
+    unsigned int n_reductions;
+
+    /**
+     * The accumulated wall time in seconds spent in the preconditioner and
+     * the matrix-vector product while a non-blocking reduction was
+     * outstanding. Iterations in which the reduction was already complete
+     * before these computations, i.e., for vector types other than
+     * LinearAlgebra::distributed::Vector, on a single process, or without
+     * MPI 3.0, do not contribute.
+     */
+    double overlapped_compute_time;
+
+    /**
+     * The accumulated wall time in seconds spent waiting for the completion
+     * of the non-blocking reductions after the overlapped computations had
+     * finished.
+     */
+    double wait_time;
+
+    /**
+     * The fraction of the time in which reductions were outstanding that
+     * was used for computations, i.e.,
+     * overlapped_compute_time/(overlapped_compute_time+wait_time). A value
+     * close to one means that the latency of the reductions was hidden
+     * behind computations.
+     */
+    double hidden_fraction () const;
+  };
+
+  /**
+   * Constructor.
+   */
+  SolverPipelinedCG (SolverControl            &cn,
+                     VectorMemory<VectorType> &mem,
+                     const AdditionalData     &data = AdditionalData());
+
+  /**
+   * Constructor. Use an object of type GrowingVectorMemory as a default to
+   * allocate memory.
+   */
+  SolverPipelinedCG (SolverControl        &cn,
+                     const AdditionalData &data=AdditionalData());
+
+  /**
+   * Virtual destructor.
+   */
+  virtual ~SolverPipelinedCG () = default;
+
+  /**
+   * Solve the linear system $Ax=b$ for x.
+   */
+  template <typename MatrixType, typename PreconditionerType>
+  void
+  solve (const MatrixType         &A,
+         VectorType               &x,
+         const VectorType         &b,
+         const PreconditionerType &preconditioner);
+
+  /**
+   * Return the statistics on the global reductions collected during the
+   * last call to solve().
+   */
+  const ReductionStatistics &
+  get_reduction_statistics () const;
+
+protected:
+  /**
+   * Additional parameters.
+   */
+  AdditionalData additional_data;
+
+  /**
+   * Statistics of the last call to solve().
+   */
+  ReductionStatistics statistics;
+};
+
+/*@}*/
+
+/*------------------------- Implementation ----------------------------*/
+
+#ifndef DOXYGEN
+
+template <typename VectorType>
+SolverPipelinedCG<VectorType>::ReductionStatistics::ReductionStatistics ()
+  :
+  n_reductions (0),
+  overlapped_compute_time (0.),
+  wait_time (0.)
+{}
+
+
+
+template <typename VectorType>
+double
+SolverPipelinedCG<VectorType>::ReductionStatistics::hidden_fraction () const
+{
+  const double total_time = overlapped_compute_time + wait_time;
+  return total_time > 0. ? overlapped_compute_time / total_time : 0.;
+}
+
+
+
+template <typename VectorType>
+SolverPipelinedCG<VectorType>::SolverPipelinedCG (SolverControl            &cn,
+                                                  VectorMemory<VectorType> &mem,
+                                                  const AdditionalData     &data)
+  :
+  Solver<VectorType>(cn,mem),
+  additional_data(data)
+{}
+
+
+
+template <typename VectorType>
+SolverPipelinedCG<VectorType>::SolverPipelinedCG (SolverControl        &cn,
+                                                  const AdditionalData &data)
+  :
+  Solver<VectorType>(cn),
+  additional_data(data)
+{}
+
+
+
+template <typename VectorType>
+const typename SolverPipelinedCG<VectorType>::ReductionStatistics &
+SolverPipelinedCG<VectorType>::get_reduction_statistics () const
+{
+  return statistics;
+}
+
+
+
+template <typename VectorType>
+template <typename MatrixType, typename PreconditionerType>
+void
+SolverPipelinedCG<VectorType>::solve (const MatrixType         &A,
+                                      VectorType               &x,
+                                      const VectorType         &b,
+                                      const PreconditionerType &preconditioner)
+{
+  SolverControl::State conv=SolverControl::iterate;
+
+  LogStream::Prefix prefix("pipelined cg");
+
+  statistics = ReductionStatistics();
+
+  // Memory allocation. The vectors follow the notation of Algorithm 4 in the
+  // paper by Ghysels and Vanroose
+  typename VectorMemory<VectorType>::Pointer r_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer u_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer w_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer m_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer n_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer z_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer q_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer s_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer p_pointer(this->memory);
+
+  // define some aliases for simpler access
+  VectorType &r = *r_pointer;
+  VectorType &u = *u_pointer;
+  VectorType &w = *w_pointer;
+  VectorType &m = *m_pointer;
+  VectorType &n = *n_pointer;
+  VectorType &z = *z_pointer;
+  VectorType &q = *q_pointer;
+  VectorType &s = *s_pointer;
+  VectorType &p = *p_pointer;
+
+  // the vectors that are computed by recurrences must start at zero, the
+  // others are overwritten before use
+  r.reinit(x, true);
+  u.reinit(x, true);
+  w.reinit(x, true);
+  m.reinit(x, true);
+  n.reinit(x, true);
+  z.reinit(x);
+  q.reinit(x);
+  s.reinit(x);
+  p.reinit(x);
+
+  // compute residual r = b - A x. if vector is zero, then short-circuit the
+  // full computation
+  if (!x.all_zero())
+    {
+      A.vmult(r,x);
+      r.sadd(-1.,1.,b);
+    }
+  else
+    r = b;
+
+  preconditioner.vmult(u,r);
+  A.vmult(w,u);
+
+  internal::SolverPipelinedCG::NonBlockingSum reduction;
+  double inner_products[3];
+  double gamma_old = 0., alpha_old = 0.;
+  double res = -std::numeric_limits<double>::max();
+  unsigned int it = 0;
+
+  while (true)
+    {
+      internal::SolverPipelinedCG::InnerProducts<VectorType>::
+      start(r, u, w, inner_products, reduction);
+      ++statistics.n_reductions;
+
+      // overlap the reduction with the application of the preconditioner and
+      // the matrix-vector product. only record the times if the reduction is
+      // actually outstanding during these computations
+      const bool overlapped = reduction.is_in_flight();
+      const auto time_start = std::chrono::steady_clock::now();
+      preconditioner.vmult(m,w);
+      A.vmult(n,m);
+      const auto time_compute = std::chrono::steady_clock::now();
+      reduction.finish();
+      const auto time_finish = std::chrono::steady_clock::now();
+      if (overlapped)
+        {
+          statistics.overlapped_compute_time +=
+            std::chrono::duration<double>(time_compute-time_start).count();
+          statistics.wait_time +=
+            std::chrono::duration<double>(time_finish-time_compute).count();
+        }
+
+      const double gamma = inner_products[0];
+      const double delta = inner_products[1];
+      res = std::sqrt(inner_products[2]);
+
+      conv = this->iteration_status(it, res, x);
+      if (conv != SolverControl::iterate)
+        break;
+
+      double alpha, beta;
+      if (it == 0)
+        {
+          beta = 0.;
+          Assert(delta != 0., ExcDivideByZero());
+          alpha = gamma/delta;
+        }
+      else
+        {
+          Assert(gamma_old != 0., ExcDivideByZero());
+          beta = gamma/gamma_old;
+          const double denominator = delta - beta*gamma/alpha_old;
+          Assert(denominator != 0., ExcDivideByZero());
+          alpha = gamma/denominator;
+        }
+
+      z.sadd(beta,1.,n);
+      q.sadd(beta,1.,m);
+      s.sadd(beta,1.,w);
+      p.sadd(beta,1.,u);
+
+      x.add(alpha,p);
+      r.add(-alpha,s);
+      u.add(-alpha,q);
+      w.add(-alpha,z);
+
+      gamma_old = gamma;
+      alpha_old = alpha;
+      ++it;
+    }
+
+  // in case of failure: throw exception
+  if (conv != SolverControl::success)
+    AssertThrow(false, SolverControl::NoConvergence (it, res));
+  // otherwise exit as normal
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2002 - 2017 by the deal.II authors
+// Copyright (C) 2002 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -17,6 +17,8 @@
 #define dealii_sparse_decomposition_h
 
 #include <deal.II/base/config.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/lac/sparse_matrix.h>
 
 #include <cmath>
@@ -93,6 +95,25 @@ DEAL_II_NAMESPACE_OPEN
  * restrictions on the sparsity see section `Fill-in' above).
  *
  *
+ * <h3>Parallelization</h3>
+ *
+ * The forward and backward substitutions with the triangular factors are
+ * inherently sequential, since every row depends on the rows before (or
+ * after) it. However, a row only depends on the rows that appear in its
+ * lower (or upper) triangular part. When the decomposition is set up, this
+ * class therefore groups the rows into levels, also called wavefronts, such
+ * that the rows of a level only depend on rows of earlier levels. All rows
+ * within a level can then be worked on in parallel with
+ * parallel::apply_to_subranges(). Derived classes use these level schedules
+ * in the substitutions and, if possible, in the factorization itself. The
+ * amount of parallelism depends on the numbering of the unknowns: for a
+ * Cuthill-McKee numbering of a two-dimensional mesh with <i>N</i> unknowns,
+ * the levels contain on the order of <i>sqrt(N)</i> rows each. Levels with
+ * few rows as well as runs with a single thread are processed serially in
+ * the original order of the rows, so the results do not depend on the
+ * number of threads.
+ *
+ *
  * <h3>Particular implementations</h3>
  *
  * It is enough to override the initialize() and vmult() methods to implement
@@ -313,10 +334,53 @@ protected:
   std::vector<const size_type *> prebuilt_lower_bound;
 
   /**
-   * Fills the #prebuilt_lower_bound array.
+   * Fills the #prebuilt_lower_bound array and computes the level schedules
+   * of the forward and backward substitutions, see the section on
+   * parallelization in the general documentation of this class.
    */
   void prebuild_lower_bound ();
 
+  /**
+   * Call the function @p row_operation for all rows of the matrix such that
+   * each row is visited after all the rows it depends on in a forward
+   * substitution with the lower triangular part (if @p backward is false)
+   * or in a backward substitution with the upper triangular part (if
+   * @p backward is true). Rows within the same level of the respective
+   * schedule are visited in parallel, so @p row_operation must only write
+   * to data associated with the row passed to it.
+   */
+  template <typename RowOperation>
+  void apply_in_level_order (const bool          backward,
+                             const RowOperation &row_operation) const;
+
+  /**
+   * The rows of the matrix grouped by the levels of the forward
+   * substitution: the rows of level <i>l</i> are stored in the positions
+   * <code>forward_level_start[l]</code> to
+   * <code>forward_level_start[l+1]</code> of #forward_level_rows and only
+   * depend on rows of earlier levels through the lower triangular part of
+   * the matrix.
+   */
+  std::vector<size_type> forward_level_start;
+
+  /**
+   * The rows of the matrix sorted by their level in the forward
+   * substitution, see #forward_level_start.
+   */
+  std::vector<size_type> forward_level_rows;
+
+  /**
+   * Same as #forward_level_start for the backward substitution with the
+   * upper triangular part of the matrix.
+   */
+  std::vector<size_type> backward_level_start;
+
+  /**
+   * The rows of the matrix sorted by their level in the backward
+   * substitution, see #backward_level_start.
+   */
+  std::vector<size_type> backward_level_rows;
+
 private:
 
   /**
@@ -402,6 +466,56 @@ SparseLUDecomposition<number>::Tvmult_add (OutVector &dst,
   dst += tmp;
 }
 
+
+
+template <typename number>
+template <typename RowOperation>
+inline void
+SparseLUDecomposition<number>::apply_in_level_order (const bool          backward,
+                                                     const RowOperation &row_operation) const
+{
+  const size_type N = this->m();
+  const std::vector<size_type> &level_start = backward ? backward_level_start :
+                                              forward_level_start;
+  const std::vector<size_type> &level_rows = backward ? backward_level_rows :
+                                             forward_level_rows;
+  Assert (level_rows.size() == N, ExcNotInitialized());
+
+  // minimal number of rows in a level such that we work on it in parallel
+  const size_type minimum_parallel_grain_size = 256;
+
+  // if there is not enough parallelism, just go through the rows in their
+  // natural order, which has better data locality
+  if (MultithreadInfo::n_threads() == 1 ||
+      level_start.size() > N/minimum_parallel_grain_size)
+    {
+      if (backward)
+        for (size_type row=N; row>0; --row)
+          row_operation (row-1);
+      else
+        for (size_type row=0; row<N; ++row)
+          row_operation (row);
+      return;
+    }
+
+  for (unsigned int level=0; level+1<level_start.size(); ++level)
+    {
+      const size_type begin = level_start[level], end = level_start[level+1];
+      if (end - begin < 2*minimum_parallel_grain_size)
+        for (size_type i=begin; i<end; ++i)
+          row_operation (level_rows[i]);
+      else
+        parallel::apply_to_subranges (begin, end,
+                                      [&] (const size_type range_begin,
+                                           const size_type range_end)
+      {
+        for (size_type i=range_begin; i<range_end; ++i)
+          row_operation (level_rows[i]);
+      },
+      minimum_parallel_grain_size);
+    }
+}
+
 //---------------------------------------------------------------------------
 
 
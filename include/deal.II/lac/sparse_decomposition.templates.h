@@ -52,6 +52,10 @@ void SparseLUDecomposition<number>::clear()
 {
   std::vector<const size_type *> tmp;
   tmp.swap (prebuilt_lower_bound);
+  forward_level_start.clear();
+  forward_level_rows.clear();
+  backward_level_start.clear();
+  backward_level_rows.clear();
 
   SparseMatrix<number>::clear();
 
@@ -152,6 +156,46 @@ SparseLUDecomposition<number>::prebuild_lower_bound()
                                   &column_numbers[rowstart_indices[row+1]],
                                   row);
     }
+
+  // compute the level schedules of the forward and backward substitution.
+  // the level of a row is one more than the maximal level of the rows it
+  // depends on. since these rows come before (after) the current row in the
+  // forward (backward) substitution, a single sweep suffices
+  std::vector<unsigned int> level (N);
+  for (unsigned int direction=0; direction<2; ++direction)
+    {
+      const bool backward = (direction == 1);
+      unsigned int n_levels = 0;
+      for (size_type step=0; step<N; ++step)
+        {
+          const size_type row = backward ? N-1-step : step;
+          const size_type *begin = backward ? prebuilt_lower_bound[row] :
+                                   &column_numbers[rowstart_indices[row]+1];
+          const size_type *end = backward ? &column_numbers[rowstart_indices[row+1]] :
+                                 prebuilt_lower_bound[row];
+          unsigned int my_level = 0;
+          for (const size_type *col=begin; col!=end; ++col)
+            my_level = std::max (my_level, level[*col]+1);
+          level[row] = my_level;
+          n_levels = std::max (n_levels, my_level+1);
+        }
+
+      // sort the rows by levels, keeping the natural order within levels
+      std::vector<size_type> &level_start = backward ? backward_level_start :
+                                            forward_level_start;
+      std::vector<size_type> &level_rows = backward ? backward_level_rows :
+                                           forward_level_rows;
+      level_start.clear ();
+      level_start.resize (n_levels+1, 0);
+      for (size_type row=0; row<N; ++row)
+        ++level_start[level[row]+1];
+      for (unsigned int l=0; l<n_levels; ++l)
+        level_start[l+1] += level_start[l];
+      level_rows.resize (N);
+      std::vector<size_type> position (level_start.begin(), level_start.end()-1);
+      for (size_type row=0; row<N; ++row)
+        level_rows[position[level[row]]++] = row;
+    }
 }
 
 template <typename number>
@@ -231,7 +275,11 @@ std::size_t
 SparseLUDecomposition<number>::memory_consumption () const
 {
   return (SparseMatrix<number>::memory_consumption () +
-          MemoryConsumption::memory_consumption(prebuilt_lower_bound));
+          MemoryConsumption::memory_consumption(prebuilt_lower_bound) +
+          MemoryConsumption::memory_consumption(forward_level_start) +
+          MemoryConsumption::memory_consumption(forward_level_rows) +
+          MemoryConsumption::memory_consumption(backward_level_start) +
+          MemoryConsumption::memory_consumption(backward_level_rows));
 }
 
 
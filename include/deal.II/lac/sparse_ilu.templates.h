@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1999 - 2017 by the deal.II authors
+// Copyright (C) 1999 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -50,84 +50,60 @@ void SparseILU<number>::initialize (const SparseMatrix<somenumber> &matrix,
   if (data.strengthen_diagonal>0)
     this->strengthen_diagonal_impl();
 
-  // in the following, we implement algorithm 10.4 in the book by Saad by
-  // translating in essence the algorithm given at the end of section 10.3.2,
-  // using the names of variables used there
+  // in the following, we implement algorithm 10.4 in the book by Saad,
+  // using the names of variables used there. the book uses a dense work
+  // array 'iw' to find the entries of row k that match the column indices of
+  // row jrow. since both rows are sorted (apart from the diagonal entry of
+  // row k that we store at the front), we can merge them instead, which
+  // needs no work array and allows to factorize the rows of a level of the
+  // forward substitution in parallel: row k only depends on the rows jrow<k
+  // with an entry in the lower part of row k
   const SparsityPattern     &sparsity = this->get_sparsity_pattern();
   const std::size_t *const ia    = sparsity.rowstart.get();
   const size_type *const ja      = sparsity.colnums.get();
 
   number *luval = this->SparseMatrix<number>::val.get();
 
-  const size_type N = this->m();
-  size_type jrow = 0;
+  const auto factorize_row = [&] (const size_type k)
+  {
+    const std::size_t first_after_diagonal = this->prebuilt_lower_bound[k] - ja;
+    const std::size_t row_end = ia[k+1];
 
-  std::vector<size_type> iw (N, numbers::invalid_size_type);
-
-  for (size_type k=0; k<N; ++k)
-    {
-      const size_type j1 = ia[k],
-                      j2 = ia[k+1]-1;
-
-      for (size_type j=j1; j<=j2; ++j)
-        iw[ja[j]] = j;
-
-      // the algorithm in the book works on the elements of row k left of the
-      // diagonal. however, since we store the diagonal element at the first
-      // position, start at the element after the diagonal and run as long as
-      // we don't walk into the right half
-      size_type j = j1+1;
-
-      // pathological case: the current row of the matrix has only the
-      // diagonal entry. then we have nothing to do.
-      if (j > j2)
-        goto label_200;
-
-label_150:
-
-      jrow = ja[j];
-      if (jrow >= k)
-        goto label_200;
-
-      // actual computations:
+    // loop over the elements of row k left of the diagonal, skipping the
+    // diagonal stored at the first position
+    for (std::size_t j=ia[k]+1; j<first_after_diagonal; ++j)
       {
-        number t1 = luval[j] * luval[ia[jrow]];
+        const size_type jrow = ja[j];
+        const number t1 = luval[j] * luval[ia[jrow]];
         luval[j] = t1;
 
-        // jj runs from just right of the diagonal to the end of the row
-        size_type jj = ia[jrow]+1;
-        while (ja[jj] < jrow)
-          ++jj;
-        for (; jj<ia[jrow+1]; ++jj)
+        // jj runs from just right of the diagonal to the end of row jrow,
+        // jw through the off-diagonal entries of row k
+        std::size_t jw = j+1;
+        for (std::size_t jj=this->prebuilt_lower_bound[jrow]-ja; jj<ia[jrow+1]; ++jj)
           {
-            const size_type jw = iw[ja[jj]];
-            if (jw != numbers::invalid_size_type)
-              luval[jw] -= t1 * luval[jj];
+            const size_type column = ja[jj];
+            if (column == k)
+              luval[ia[k]] -= t1 * luval[jj];
+            else
+              {
+                while (jw < row_end && ja[jw] < column)
+                  ++jw;
+                if (jw < row_end && ja[jw] == column)
+                  luval[jw] -= t1 * luval[jj];
+              }
           }
-
-        ++j;
-        if (j<=j2)
-          goto label_150;
       }
 
-label_200:
-
-      // in the book there is an assertion that we have hit the diagonal
-      // element, i.e. that jrow==k. however, we store the diagonal element at
-      // the front, so jrow must actually be larger than k or j is already in
-      // the next row
-      Assert ((jrow > k) || (j==ia[k+1]), ExcInternalError());
-
-      // now we have to deal with the diagonal element. in the book it is
-      // located at position 'j', but here we use the convention of storing
-      // the diagonal element first, so instead of j we use uptr[k]=ia[k]
-      Assert (luval[ia[k]] != 0, ExcZeroPivot(k));
+    // now we have to deal with the diagonal element. in the book it is
+    // located at position 'j', but here we use the convention of storing
+    // the diagonal element first, so instead of j we use uptr[k]=ia[k]
+    Assert (luval[ia[k]] != 0, ExcZeroPivot(k));
 
-      luval[ia[k]] = 1./luval[ia[k]];
+    luval[ia[k]] = 1./luval[ia[k]];
+  };
 
-      for (size_type j=j1; j<=j2; ++j)
-        iw[ja[j]] = numbers::invalid_size_type;
-    }
+  this->apply_in_level_order (false, factorize_row);
 }
 
 
@@ -140,7 +116,6 @@ void SparseILU<number>::vmult (Vector<somenumber>       &dst,
   Assert (dst.size() == src.size(), ExcDimensionMismatch(dst.size(), src.size()));
   Assert (dst.size() == this->m(), ExcDimensionMismatch(dst.size(), this->m()));
 
-  const size_type N=dst.size();
   const std::size_t *const rowstart_indices
     = this->get_sparsity_pattern().rowstart.get();
   const size_type *const column_numbers
@@ -158,23 +133,27 @@ void SparseILU<number>::vmult (Vector<somenumber>       &dst,
   // we split the y_i = b_i off and
   // perform it at the outset of the
   // loop
+  //
+  // the rows are visited in the order of the level schedule of the
+  // decomposition, which allows to work on the rows of a level in parallel
   dst = src;
-  for (size_type row=0; row<N; ++row)
-    {
-      // get start of this row. skip the
-      // diagonal element
-      const size_type *const rowstart = &column_numbers[rowstart_indices[row]+1];
-      // find the position where the part
-      // right of the diagonal starts
-      const size_type *const first_after_diagonal = this->prebuilt_lower_bound[row];
-
-      somenumber dst_row = dst(row);
-      const number *luval = this->SparseMatrix<number>::val.get() +
-                            (rowstart - column_numbers);
-      for (const size_type *col=rowstart; col!=first_after_diagonal; ++col, ++luval)
-        dst_row -= *luval * dst(*col);
-      dst(row) = dst_row;
-    }
+  const auto forward_row = [&] (const size_type row)
+  {
+    // get start of this row. skip the
+    // diagonal element
+    const size_type *const rowstart = &column_numbers[rowstart_indices[row]+1];
+    // find the position where the part
+    // right of the diagonal starts
+    const size_type *const first_after_diagonal = this->prebuilt_lower_bound[row];
+
+    somenumber dst_row = dst(row);
+    const number *luval = this->SparseMatrix<number>::val.get() +
+                          (rowstart - column_numbers);
+    for (const size_type *col=rowstart; col!=first_after_diagonal; ++col, ++luval)
+      dst_row -= *luval * dst(*col);
+    dst(row) = dst_row;
+  };
+  this->apply_in_level_order (false, forward_row);
 
   // now the backward solve. same
   // procedure, but we need not set
@@ -184,25 +163,26 @@ void SparseILU<number>::vmult (Vector<somenumber>       &dst,
   // note that we need to scale now,
   // since the diagonal is not equal to
   // one now
-  for (int row=N-1; row>=0; --row)
-    {
-      // get end of this row
-      const size_type *const rowend = &column_numbers[rowstart_indices[row+1]];
-      // find the position where the part
-      // right of the diagonal starts
-      const size_type *const first_after_diagonal = this->prebuilt_lower_bound[row];
-
-      somenumber dst_row = dst(row);
-      const number *luval = this->SparseMatrix<number>::val.get() +
-                            (first_after_diagonal - column_numbers);
-      for (const size_type *col=first_after_diagonal; col!=rowend; ++col, ++luval)
-        dst_row -= *luval * dst(*col);
-
-      // scale by the diagonal element.
-      // note that the diagonal element
-      // was stored inverted
-      dst(row) = dst_row * this->diag_element(row);
-    }
+  const auto backward_row = [&] (const size_type row)
+  {
+    // get end of this row
+    const size_type *const rowend = &column_numbers[rowstart_indices[row+1]];
+    // find the position where the part
+    // right of the diagonal starts
+    const size_type *const first_after_diagonal = this->prebuilt_lower_bound[row];
+
+    somenumber dst_row = dst(row);
+    const number *luval = this->SparseMatrix<number>::val.get() +
+                          (first_after_diagonal - column_numbers);
+    for (const size_type *col=first_after_diagonal; col!=rowend; ++col, ++luval)
+      dst_row -= *luval * dst(*col);
+
+    // scale by the diagonal element.
+    // note that the diagonal element
+    // was stored inverted
+    dst(row) = dst_row * this->diag_element(row);
+  };
+  this->apply_in_level_order (true, backward_row);
 }
 
 
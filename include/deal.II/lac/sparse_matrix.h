@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1999 - 2017 by the deal.II authors
+// Copyright (C) 1999 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -1092,6 +1092,63 @@ public:
   void Tvmult_add (OutVector      &dst,
                    const InVector &src) const;
 
+  /**
+   * Matrix-vector multiplication with several vectors at once: let
+   * <i>dst = M*src</i>, where the columns of the dense matrices @p src and
+   * @p dst are the individual vectors. Since FullMatrix stores its entries
+   * row by row, the entries of all vectors that belong to the same index
+   * are contiguous in memory. This function reads every entry of the sparse
+   * matrix only once for all vectors and applies it to the vector entries
+   * with SIMD instructions, which makes it considerably faster than calling
+   * vmult() once per vector: the latter is limited by the memory bandwidth
+   * needed to load the matrix.
+   *
+   * The matrix @p src must have n() rows, the matrix @p dst must have m()
+   * rows and the same number of columns as @p src.
+   *
+   * Source and destination must not be the same object.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  template <typename somenumber>
+  void vmult (FullMatrix<somenumber>       &dst,
+              const FullMatrix<somenumber> &src) const;
+
+  /**
+   * Transpose matrix-vector multiplication with several vectors at once:
+   * let <i>dst = M<sup>T</sup>*src</i> for each column of the dense
+   * matrices @p src and @p dst. See the vmult() function taking FullMatrix
+   * arguments for the storage format.
+   */
+  template <typename somenumber>
+  void Tvmult (FullMatrix<somenumber>       &dst,
+               const FullMatrix<somenumber> &src) const;
+
+  /**
+   * Matrix-vector multiplication with several vectors at once: let
+   * <i>dst[i] = M*src[i]</i> for all vectors in @p src. The vectors are
+   * copied into an interleaved format before the multiplication and the
+   * results are copied back, see the vmult() function taking FullMatrix
+   * arguments. For more than a few vectors, this is much faster than
+   * separate calls to vmult() because the matrix is only loaded once.
+   *
+   * The vectors in @p dst are resized as necessary.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  template <typename somenumber>
+  void vmult (std::vector<Vector<somenumber> >       &dst,
+              const std::vector<Vector<somenumber> > &src) const;
+
+  /**
+   * Transpose matrix-vector multiplication with several vectors at once:
+   * let <i>dst[i] = M<sup>T</sup>*src[i]</i> for all vectors in @p src. The
+   * vectors in @p dst are resized as necessary.
+   */
+  template <typename somenumber>
+  void Tvmult (std::vector<Vector<somenumber> >       &dst,
+               const std::vector<Vector<somenumber> > &src) const;
+
   /**
    * Return the square of the norm of the vector $v$ with respect to the norm
    * induced by this matrix, i.e. $\left(v,Mv\right)$. This is useful, e.g. in
@@ -850,6 +850,222 @@ SparseMatrix<number>::Tvmult_add (OutVector &dst,
 }
 
 
+namespace internal
+{
+  namespace SparseMatrix
+  {
+    /**
+     * Perform a vmult on several vectors at once using the SparseMatrix data
+     * structures, but only using a subinterval for the row indices. The
+     * vectors are stored in interleaved format, i.e., the @p n_vectors
+     * entries of all vectors that belong to the same index are contiguous in
+     * memory. This allows to load each matrix entry once and apply it to all
+     * vectors with SIMD instructions.
+     */
+    template <typename number,
+              typename somenumber>
+    void vmult_multiple_on_subrange (const size_type    begin_row,
+                                     const size_type    end_row,
+                                     const number      *values,
+                                     const std::size_t *rowstart,
+                                     const size_type   *colnums,
+                                     const unsigned int n_vectors,
+                                     const somenumber  *src,
+                                     somenumber        *dst)
+    {
+      for (size_type row=begin_row; row<end_row; ++row)
+        {
+          somenumber *dst_row = dst + row*n_vectors;
+          for (unsigned int v=0; v<n_vectors; ++v)
+            dst_row[v] = somenumber();
+          for (std::size_t index=rowstart[row]; index<rowstart[row+1]; ++index)
+            {
+              const somenumber matrix_entry = values[index];
+              const somenumber *src_row = src + colnums[index]*n_vectors;
+              DEAL_II_OPENMP_SIMD_PRAGMA
+              for (unsigned int v=0; v<n_vectors; ++v)
+                dst_row[v] += matrix_entry * src_row[v];
+            }
+        }
+    }
+
+
+
+    /**
+     * Same as vmult_multiple_on_subrange() but multiplying with the
+     * transpose matrix. Since this operation writes into the destination
+     * rows given by the column indices, it is performed serially on all rows.
+     */
+    template <typename number,
+              typename somenumber>
+    void Tvmult_multiple (const size_type    n_rows,
+                          const size_type    n_cols,
+                          const number      *values,
+                          const std::size_t *rowstart,
+                          const size_type   *colnums,
+                          const unsigned int n_vectors,
+                          const somenumber  *src,
+                          somenumber        *dst)
+    {
+      std::fill (dst, dst + n_cols*n_vectors, somenumber());
+      for (size_type row=0; row<n_rows; ++row)
+        {
+          const somenumber *src_row = src + row*n_vectors;
+          for (std::size_t index=rowstart[row]; index<rowstart[row+1]; ++index)
+            {
+              const somenumber matrix_entry = values[index];
+              somenumber *dst_row = dst + colnums[index]*n_vectors;
+              DEAL_II_OPENMP_SIMD_PRAGMA
+              for (unsigned int v=0; v<n_vectors; ++v)
+                dst_row[v] += matrix_entry * src_row[v];
+            }
+        }
+    }
+  }
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::vmult (FullMatrix<somenumber>       &dst,
+                             const FullMatrix<somenumber> &src) const
+{
+  Assert (cols != nullptr, ExcNotInitialized());
+  Assert (val != nullptr, ExcNotInitialized());
+  Assert(m() == dst.m(), ExcDimensionMismatch(m(),dst.m()));
+  Assert(n() == src.m(), ExcDimensionMismatch(n(),src.m()));
+  Assert(src.n() == dst.n(), ExcDimensionMismatch(src.n(),dst.n()));
+
+  Assert (!PointerComparison::equal(&src, &dst), ExcSourceEqualsDestination());
+
+  if (dst.m() == 0 || dst.n() == 0)
+    return;
+  if (src.m() == 0)
+    {
+      dst = 0;
+      return;
+    }
+
+  parallel::apply_to_subranges (0U, m(),
+                                std::bind (&internal::SparseMatrix::vmult_multiple_on_subrange
+                                           <number,somenumber>,
+                                           std::placeholders::_1, std::placeholders::_2,
+                                           val.get(),
+                                           cols->rowstart.get(),
+                                           cols->colnums.get(),
+                                           src.n(),
+                                           &src(0,0),
+                                           &dst(0,0)),
+                                internal::SparseMatrix::minimum_parallel_grain_size);
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::Tvmult (FullMatrix<somenumber>       &dst,
+                              const FullMatrix<somenumber> &src) const
+{
+  Assert (cols != nullptr, ExcNotInitialized());
+  Assert (val != nullptr, ExcNotInitialized());
+  Assert(n() == dst.m(), ExcDimensionMismatch(n(),dst.m()));
+  Assert(m() == src.m(), ExcDimensionMismatch(m(),src.m()));
+  Assert(src.n() == dst.n(), ExcDimensionMismatch(src.n(),dst.n()));
+
+  Assert (!PointerComparison::equal(&src, &dst), ExcSourceEqualsDestination());
+
+  if (dst.m() == 0 || dst.n() == 0)
+    return;
+  if (src.m() == 0)
+    {
+      dst = 0;
+      return;
+    }
+
+  internal::SparseMatrix::Tvmult_multiple (m(), n(),
+                                           val.get(),
+                                           cols->rowstart.get(),
+                                           cols->colnums.get(),
+                                           src.n(),
+                                           &src(0,0),
+                                           &dst(0,0));
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::vmult (std::vector<Vector<somenumber> >       &dst,
+                             const std::vector<Vector<somenumber> > &src) const
+{
+  const unsigned int n_vectors = src.size();
+  if (n_vectors == 0)
+    {
+      dst.clear();
+      return;
+    }
+
+  // copy the vectors into an interleaved format, multiply, and copy back
+  FullMatrix<somenumber> src_interleaved (n(), n_vectors);
+  for (unsigned int v=0; v<n_vectors; ++v)
+    {
+      AssertDimension (src[v].size(), n());
+      for (size_type i=0; i<n(); ++i)
+        src_interleaved(i,v) = src[v](i);
+    }
+
+  FullMatrix<somenumber> dst_interleaved (m(), n_vectors);
+  vmult (dst_interleaved, src_interleaved);
+
+  dst.resize (n_vectors);
+  for (unsigned int v=0; v<n_vectors; ++v)
+    {
+      dst[v].reinit (m(), true);
+      for (size_type i=0; i<m(); ++i)
+        dst[v](i) = dst_interleaved(i,v);
+    }
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::Tvmult (std::vector<Vector<somenumber> >       &dst,
+                              const std::vector<Vector<somenumber> > &src) const
+{
+  const unsigned int n_vectors = src.size();
+  if (n_vectors == 0)
+    {
+      dst.clear();
+      return;
+    }
+
+  FullMatrix<somenumber> src_interleaved (m(), n_vectors);
+  for (unsigned int v=0; v<n_vectors; ++v)
+    {
+      AssertDimension (src[v].size(), m());
+      for (size_type i=0; i<m(); ++i)
+        src_interleaved(i,v) = src[v](i);
+    }
+
+  FullMatrix<somenumber> dst_interleaved (n(), n_vectors);
+  Tvmult (dst_interleaved, src_interleaved);
+
+  dst.resize (n_vectors);
+  for (unsigned int v=0; v<n_vectors; ++v)
+    {
+      dst[v].reinit (n(), true);
+      for (size_type i=0; i<n(); ++i)
+        dst[v](i) = dst_interleaved(i,v);
+    }
+}
+
+
 namespace internal
 {
   namespace SparseMatrix
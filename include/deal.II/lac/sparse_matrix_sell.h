@@ -0,0 +1,892 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_sparse_matrix_sell_h
+#define dealii_sparse_matrix_sell_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/base/vectorization.h>
+#include <deal.II/lac/exceptions.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/vector_memory.h>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+/*! @addtogroup Matrix1
+ *@{
+ */
+
+/**
+ * A sparse matrix stored in the sliced ELLPACK format with sorting, also
+ * known as SELL-C-sigma. The rows of the matrix are grouped into chunks of
+ * <i>C</i> rows, where <i>C</i> is the number of lanes in a
+ * VectorizedArray<number>. Within each chunk, the entries are stored column
+ * by column, i.e., the <i>j</i>-th entries of all <i>C</i> rows are
+ * contiguous in memory, and all rows are padded with zeros to the length of
+ * the longest row in the chunk. A matrix-vector product then works on all
+ * rows of a chunk simultaneously with SIMD instructions, where the entries
+ * of the source vector are collected with gather operations. To keep the
+ * amount of padding small, the rows are sorted by their length within
+ * windows of <i>sigma</i> consecutive rows before they are grouped into
+ * chunks. Sorting only within a window keeps the access to the destination
+ * vector local.
+ *
+ * For sparse matrices that are limited by the memory bandwidth, the plain
+ * compressed row storage of SparseMatrix cannot be vectorized because rows
+ * have different lengths and are processed one at a time. This class
+ * achieves a considerably higher throughput on hardware with wide SIMD
+ * units at the price of some padding, whose amount is reported by
+ * n_padding_entries().
+ *
+ * This class is not meant to assemble matrices. Rather, a SparseMatrix is
+ * assembled as usual and then converted, either with the constructor or the
+ * reinit() function taking a SparseMatrix, or by first setting up the
+ * storage layout from a SparsityPattern and then filling in the values with
+ * copy_from(). The latter is useful if the same sparsity pattern is used
+ * for several matrices or if the values change in the course of a
+ * computation.
+ *
+ * The class offers the interface required by the iterative solvers,
+ * PreconditionJacobi, PreconditionChebyshev, and the relaxation smoothers
+ * of the multigrid framework, i.e., the functions m(), n(), el(), vmult(),
+ * Tvmult(), precondition_Jacobi(), and Jacobi_step(). It can therefore
+ * replace SparseMatrix as the template argument @p MatrixType of these
+ * classes. The vectors used in the multiplications need to store their
+ * elements contiguously and provide access to them via a pointer returned
+ * by <tt>begin()</tt>, which is the case for Vector, LinearAlgebra::Vector,
+ * and LinearAlgebra::distributed::Vector when run on a single processor.
+ *
+ * The matrix-vector product is parallelized over chunks with
+ * parallel::apply_to_subranges(). The transpose product is performed
+ * serially.
+ *
+ * @ingroup Matrix1
+ */
+template <typename number>
+class SparseMatrixSELL : public virtual Subscriptor
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  typedef types::global_dof_index size_type;
+
+  /**
+   * Type of the matrix entries.
+   */
+  typedef number value_type;
+
+  /**
+   * Constructor. Initialize an empty matrix.
+   */
+  SparseMatrixSELL ();
+
+  /**
+   * Constructor. Convert the given matrix into the SELL-C-sigma format
+   * with the sorting window @p sigma, see reinit().
+   */
+  template <typename somenumber>
+  explicit SparseMatrixSELL (const SparseMatrix<somenumber> &matrix,
+                             const unsigned int              sigma = 128);
+
+  /**
+   * Set up the storage layout for matrices with the given sparsity pattern
+   * and set all entries to zero. The rows are sorted by their length within
+   * windows of @p sigma rows, which is rounded up to the next multiple of
+   * the chunk size <i>C</i>. A value of one means that the rows are not
+   * sorted at all, whereas a value of at least the number of rows sorts all
+   * rows, which gives the least padding but also the least locality in the
+   * access to the destination vector.
+   */
+  void reinit (const SparsityPattern &sparsity,
+               const unsigned int     sigma = 128);
+
+  /**
+   * Set up the storage layout for the sparsity pattern of the given matrix
+   * and copy its entries.
+   */
+  template <typename somenumber>
+  void reinit (const SparseMatrix<somenumber> &matrix,
+               const unsigned int              sigma = 128);
+
+  /**
+   * Copy the entries of the given matrix into this object. The sparsity
+   * pattern of @p matrix must be the one this object was initialized with.
+   */
+  template <typename somenumber>
+  void copy_from (const SparseMatrix<somenumber> &matrix);
+
+  /**
+   * Release all memory and return to a state just like after having called
+   * the default constructor.
+   */
+  void clear ();
+
+  /**
+   * Return whether the object is empty.
+   */
+  bool empty () const;
+
+  /**
+   * Return the dimension of the codomain (or range) space.
+   */
+  size_type m () const;
+
+  /**
+   * Return the dimension of the domain space.
+   */
+  size_type n () const;
+
+  /**
+   * Return the number of entries of the underlying sparsity pattern, not
+   * counting the padding.
+   */
+  size_type n_nonzero_elements () const;
+
+  /**
+   * Return the number of zero entries that are stored in addition to the
+   * entries of the sparsity pattern in order to give all rows of a chunk
+   * the same length.
+   */
+  size_type n_padding_entries () const;
+
+  /**
+   * Return the value of the entry (<i>i,j</i>), or zero if it is not part
+   * of the sparsity pattern. This function needs to search through the
+   * row and is therefore slow.
+   */
+  number el (const size_type i,
+             const size_type j) const;
+
+  /**
+   * Return the main diagonal element in the <i>i</i>th row. The matrix
+   * needs to be quadratic.
+   */
+  number diag_element (const size_type i) const;
+
+  /**
+   * Matrix-vector multiplication: let <i>dst = M*src</i> with <i>M</i>
+   * being this matrix.
+   *
+   * Source and destination must not be the same vector.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  template <class OutVector, class InVector>
+  void vmult (OutVector      &dst,
+              const InVector &src) const;
+
+  /**
+   * Matrix-vector multiplication: let <i>dst = M<sup>T</sup>*src</i> with
+   * <i>M</i> being this matrix.
+   *
+   * Source and destination must not be the same vector.
+   */
+  template <class OutVector, class InVector>
+  void Tvmult (OutVector      &dst,
+               const InVector &src) const;
+
+  /**
+   * Adding matrix-vector multiplication. Add <i>M*src</i> on <i>dst</i>.
+   *
+   * Source and destination must not be the same vector.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  template <class OutVector, class InVector>
+  void vmult_add (OutVector      &dst,
+                  const InVector &src) const;
+
+  /**
+   * Adding matrix-vector multiplication. Add <i>M<sup>T</sup>*src</i> to
+   * <i>dst</i>.
+   *
+   * Source and destination must not be the same vector.
+   */
+  template <class OutVector, class InVector>
+  void Tvmult_add (OutVector      &dst,
+                   const InVector &src) const;
+
+  /**
+   * Apply the Jacobi preconditioner, which multiplies every element of the
+   * @p src vector by the inverse of the respective diagonal element and
+   * multiplies the result with the relaxation factor @p omega.
+   */
+  template <class VectorType>
+  void precondition_Jacobi (VectorType       &dst,
+                            const VectorType &src,
+                            const number      omega = 1.) const;
+
+  /**
+   * Do one Jacobi step on @p v, i.e., <i>v = v - omega D<sup>-1</sup>(Av -
+   * b)</i>, where <i>D</i> is the diagonal of this matrix.
+   */
+  template <class VectorType>
+  void Jacobi_step (VectorType       &v,
+                    const VectorType &b,
+                    const number      omega = 1.) const;
+
+  /**
+   * Determine an estimate for the memory consumption (in bytes) of this
+   * object.
+   */
+  std::size_t memory_consumption () const;
+
+  /**
+   * Exception
+   */
+  DeclExceptionMsg (ExcNonContiguousVector,
+                    "The vectors passed to this class need to store all their "
+                    "entries contiguously in memory on the current processor.");
+
+  /**
+   * Exception
+   */
+  DeclExceptionMsg (ExcSourceEqualsDestination,
+                    "You are attempting an operation on two vectors that "
+                    "are the same object, but the operation requires that the "
+                    "two objects are in fact different.");
+
+private:
+  /**
+   * Number of rows in a chunk, given by the width of the SIMD registers.
+   */
+  static const unsigned int chunk_size = VectorizedArray<number>::n_array_elements;
+
+  /**
+   * Number of rows of the matrix.
+   */
+  size_type n_rows;
+
+  /**
+   * Number of columns of the matrix.
+   */
+  size_type n_cols;
+
+  /**
+   * Number of entries of the sparsity pattern the layout was created from.
+   */
+  size_type n_entries;
+
+  /**
+   * For each slot of a chunk, i.e., the index <tt>chunk*C+lane</tt>, the
+   * row of the matrix stored there. Padding slots at the end of the last
+   * chunk hold numbers::invalid_unsigned_int.
+   */
+  std::vector<unsigned int> row_of_slot;
+
+  /**
+   * The slot each row of the matrix is stored in, i.e., the inverse of
+   * row_of_slot.
+   */
+  std::vector<unsigned int> slot_of_row;
+
+  /**
+   * The offset of the first entry of each chunk in the arrays values and
+   * (divided by the chunk size) column_indices, with one additional
+   * element at the end.
+   */
+  std::vector<unsigned int> chunk_start;
+
+  /**
+   * The entries of the matrix, where the <i>j</i>th entries of all rows in
+   * a chunk are stored in one VectorizedArray.
+   */
+  AlignedVector<VectorizedArray<number> > values;
+
+  /**
+   * The column indices of the entries, stored in the same order as the
+   * values. Padding entries repeat the last valid column of the row to
+   * keep the access to the source vector local.
+   */
+  std::vector<unsigned int> column_indices;
+
+  /**
+   * The inverse of the diagonal of the matrix in the original numbering of
+   * rows, used by precondition_Jacobi().
+   */
+  AlignedVector<number> inverse_diagonal;
+
+  /**
+   * Check that the given vector provides contiguous storage of all its
+   * elements and return a pointer to them.
+   */
+  template <class VectorType>
+  static
+  typename VectorType::value_type *
+  get_pointer (VectorType &vector);
+
+  /**
+   * Same as above for constant vectors.
+   */
+  template <class VectorType>
+  static
+  const typename VectorType::value_type *
+  get_pointer (const VectorType &vector);
+};
+
+/*@}*/
+
+
+#ifndef DOXYGEN
+
+namespace internal
+{
+  namespace SparseMatrixSELLImplementation
+  {
+    // Minimal number of chunks to be worked on by a single task
+    const unsigned int minimum_parallel_grain_size = 64;
+
+    // Compute the product of the given range of chunks with the source
+    // vector with SIMD instructions for the case that the vectors have the
+    // same number type as the matrix
+    template <typename number>
+    void
+    vmult_on_chunks (const unsigned int               begin_chunk,
+                     const unsigned int               end_chunk,
+                     const VectorizedArray<number>   *values,
+                     const unsigned int              *column_indices,
+                     const unsigned int              *chunk_start,
+                     const unsigned int              *row_of_slot,
+                     const number                    *src,
+                     number                          *dst,
+                     const bool                       add)
+    {
+      const unsigned int n_lanes = VectorizedArray<number>::n_array_elements;
+      for (unsigned int c=begin_chunk; c<end_chunk; ++c)
+        {
+          VectorizedArray<number> sum = VectorizedArray<number>();
+          for (unsigned int j=chunk_start[c]; j<chunk_start[c+1]; ++j)
+            {
+              VectorizedArray<number> src_values;
+              src_values.gather(src, column_indices + std::size_t(j)*n_lanes);
+              sum += values[j] * src_values;
+            }
+          const unsigned int *rows = row_of_slot + c*n_lanes;
+          for (unsigned int v=0; v<n_lanes; ++v)
+            if (rows[v] != numbers::invalid_unsigned_int)
+              {
+                if (add)
+                  dst[rows[v]] += sum[v];
+                else
+                  dst[rows[v]] = sum[v];
+              }
+        }
+    }
+
+    // Same as above for vectors with a different number type than the
+    // matrix, where we convert the entries lane by lane
+    template <typename number, typename number2, typename number3>
+    void
+    vmult_on_chunks (const unsigned int               begin_chunk,
+                     const unsigned int               end_chunk,
+                     const VectorizedArray<number>   *values,
+                     const unsigned int              *column_indices,
+                     const unsigned int              *chunk_start,
+                     const unsigned int              *row_of_slot,
+                     const number2                   *src,
+                     number3                         *dst,
+                     const bool                       add)
+    {
+      const unsigned int n_lanes = VectorizedArray<number>::n_array_elements;
+      for (unsigned int c=begin_chunk; c<end_chunk; ++c)
+        {
+          number3 sum[n_lanes];
+          for (unsigned int v=0; v<n_lanes; ++v)
+            sum[v] = number3();
+          for (unsigned int j=chunk_start[c]; j<chunk_start[c+1]; ++j)
+            for (unsigned int v=0; v<n_lanes; ++v)
+              sum[v] += number3(values[j][v]) *
+                        number3(src[column_indices[std::size_t(j)*n_lanes+v]]);
+          const unsigned int *rows = row_of_slot + c*n_lanes;
+          for (unsigned int v=0; v<n_lanes; ++v)
+            if (rows[v] != numbers::invalid_unsigned_int)
+              {
+                if (add)
+                  dst[rows[v]] += sum[v];
+                else
+                  dst[rows[v]] = sum[v];
+              }
+        }
+    }
+  }
+}
+
+
+
+template <typename number>
+SparseMatrixSELL<number>::SparseMatrixSELL ()
+  :
+  n_rows (0),
+  n_cols (0),
+  n_entries (0)
+{}
+
+
+
+template <typename number>
+template <typename somenumber>
+SparseMatrixSELL<number>::SparseMatrixSELL (const SparseMatrix<somenumber> &matrix,
+                                            const unsigned int              sigma)
+  :
+  n_rows (0),
+  n_cols (0),
+  n_entries (0)
+{
+  reinit (matrix, sigma);
+}
+
+
+
+template <typename number>
+void
+SparseMatrixSELL<number>::reinit (const SparsityPattern &sparsity,
+                                  const unsigned int     sigma)
+{
+  Assert (sparsity.is_compressed(), SparsityPattern::ExcNotCompressed());
+  AssertThrow (sparsity.n_cols() < numbers::invalid_unsigned_int &&
+               sparsity.n_rows() < numbers::invalid_unsigned_int,
+               ExcMessage("This class uses 32 bit integers for indices and "
+                          "can not represent the given sparsity pattern."));
+
+  n_rows = sparsity.n_rows();
+  n_cols = sparsity.n_cols();
+  n_entries = sparsity.n_nonzero_elements();
+
+  // sort the rows by their length within windows of sigma rows, longest rows
+  // first
+  const unsigned int window = std::max(1U, (sigma + chunk_size - 1) /
+                                       chunk_size) * chunk_size;
+  const unsigned int n_chunks = (n_rows + chunk_size - 1) / chunk_size;
+  row_of_slot.resize (n_chunks * chunk_size);
+  std::iota (row_of_slot.begin(), row_of_slot.begin() + n_rows, 0U);
+  std::fill (row_of_slot.begin() + n_rows, row_of_slot.end(),
+             numbers::invalid_unsigned_int);
+  if (window > chunk_size)
+    for (unsigned int start=0; start<n_rows; start+=window)
+      std::stable_sort (row_of_slot.begin() + start,
+                        row_of_slot.begin() + std::min<size_type>(start+window, n_rows),
+                        [&sparsity] (const unsigned int a, const unsigned int b)
+      {
+        return sparsity.row_length(a) > sparsity.row_length(b);
+      });
+
+  slot_of_row.resize (n_rows);
+  for (unsigned int s=0; s<n_rows; ++s)
+    slot_of_row[row_of_slot[s]] = s;
+
+  // the length of each chunk is given by its longest row
+  chunk_start.resize (n_chunks + 1);
+  chunk_start[0] = 0;
+  for (unsigned int c=0; c<n_chunks; ++c)
+    {
+      unsigned int length = 0;
+      for (unsigned int v=0; v<chunk_size; ++v)
+        if (row_of_slot[c*chunk_size+v] != numbers::invalid_unsigned_int)
+          length = std::max<unsigned int>(length,
+                                          sparsity.row_length(row_of_slot[c*chunk_size+v]));
+      chunk_start[c+1] = chunk_start[c] + length;
+    }
+
+  // fill in the column indices, padding the rows with the last valid column
+  // index
+  column_indices.resize (std::size_t(chunk_start[n_chunks]) * chunk_size);
+  for (unsigned int c=0; c<n_chunks; ++c)
+    for (unsigned int v=0; v<chunk_size; ++v)
+      {
+        const unsigned int row = row_of_slot[c*chunk_size+v];
+        unsigned int last_column = 0;
+        unsigned int j = chunk_start[c];
+        if (row != numbers::invalid_unsigned_int)
+          for (SparsityPattern::iterator it=sparsity.begin(row);
+               it != sparsity.end(row); ++it, ++j)
+            {
+              last_column = it->column();
+              column_indices[std::size_t(j)*chunk_size+v] = last_column;
+            }
+        for ( ; j<chunk_start[c+1]; ++j)
+          column_indices[std::size_t(j)*chunk_size+v] = last_column;
+      }
+
+  values.resize_fast (chunk_start[n_chunks]);
+  values.fill (VectorizedArray<number>());
+  inverse_diagonal.clear ();
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrixSELL<number>::reinit (const SparseMatrix<somenumber> &matrix,
+                                  const unsigned int              sigma)
+{
+  reinit (matrix.get_sparsity_pattern(), sigma);
+  copy_from (matrix);
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrixSELL<number>::copy_from (const SparseMatrix<somenumber> &matrix)
+{
+  AssertDimension (matrix.m(), m());
+  AssertDimension (matrix.n(), n());
+  AssertDimension (matrix.n_nonzero_elements(), n_entries);
+
+  const unsigned int n_chunks = chunk_start.size() - 1;
+  for (unsigned int c=0; c<n_chunks; ++c)
+    for (unsigned int v=0; v<chunk_size; ++v)
+      {
+        const unsigned int row = row_of_slot[c*chunk_size+v];
+        if (row == numbers::invalid_unsigned_int)
+          continue;
+        unsigned int j = chunk_start[c];
+        for (typename SparseMatrix<somenumber>::const_iterator it=matrix.begin(row);
+             it != matrix.end(row); ++it, ++j)
+          {
+            Assert (column_indices[std::size_t(j)*chunk_size+v] == it->column(),
+                    ExcMessage("The sparsity pattern of the given matrix does "
+                               "not match the one this object was initialized "
+                               "with."));
+            values[j][v] = it->value();
+          }
+      }
+
+  // the inverse diagonal is only available for quadratic matrices, where
+  // the SparsityPattern stores the diagonal entry first in each row
+  if (n_rows == n_cols)
+    {
+      inverse_diagonal.resize_fast (n_rows);
+      for (size_type i=0; i<n_rows; ++i)
+        {
+          const number diagonal = diag_element(i);
+          // precondition_Jacobi() checks for zeros on the diagonal
+          inverse_diagonal[i] = (diagonal != number() ? number(1.)/diagonal :
+                                 number());
+        }
+    }
+}
+
+
+
+template <typename number>
+void
+SparseMatrixSELL<number>::clear ()
+{
+  n_rows = 0;
+  n_cols = 0;
+  n_entries = 0;
+  row_of_slot.clear();
+  slot_of_row.clear();
+  chunk_start.clear();
+  values.clear();
+  column_indices.clear();
+  inverse_diagonal.clear();
+}
+
+
+
+template <typename number>
+inline
+bool
+SparseMatrixSELL<number>::empty () const
+{
+  return n_rows == 0 || n_cols == 0;
+}
+
+
+
+template <typename number>
+inline
+typename SparseMatrixSELL<number>::size_type
+SparseMatrixSELL<number>::m () const
+{
+  return n_rows;
+}
+
+
+
+template <typename number>
+inline
+typename SparseMatrixSELL<number>::size_type
+SparseMatrixSELL<number>::n () const
+{
+  return n_cols;
+}
+
+
+
+template <typename number>
+inline
+typename SparseMatrixSELL<number>::size_type
+SparseMatrixSELL<number>::n_nonzero_elements () const
+{
+  return n_entries;
+}
+
+
+
+template <typename number>
+inline
+typename SparseMatrixSELL<number>::size_type
+SparseMatrixSELL<number>::n_padding_entries () const
+{
+  return (chunk_start.empty() ? 0 :
+          size_type(chunk_start.back()) * chunk_size - n_entries);
+}
+
+
+
+template <typename number>
+number
+SparseMatrixSELL<number>::el (const size_type i,
+                              const size_type j) const
+{
+  AssertIndexRange (i, m());
+  AssertIndexRange (j, n());
+
+  // the padding entries come after the actual entries of the row and are
+  // zero, so the first match is the one we are looking for
+  const unsigned int slot = slot_of_row[i];
+  const unsigned int c = slot / chunk_size, v = slot % chunk_size;
+  for (unsigned int k=chunk_start[c]; k<chunk_start[c+1]; ++k)
+    if (column_indices[std::size_t(k)*chunk_size+v] == j)
+      return values[k][v];
+  return number();
+}
+
+
+
+template <typename number>
+inline
+number
+SparseMatrixSELL<number>::diag_element (const size_type i) const
+{
+  AssertDimension (m(), n());
+  AssertIndexRange (i, m());
+
+  // the diagonal entry is stored first in each row of a quadratic matrix
+  const unsigned int slot = slot_of_row[i];
+  return values[chunk_start[slot/chunk_size]][slot%chunk_size];
+}
+
+
+
+template <typename number>
+template <class VectorType>
+inline
+typename VectorType::value_type *
+SparseMatrixSELL<number>::get_pointer (VectorType &vector)
+{
+  Assert (vector.locally_owned_elements().n_elements() == vector.size(),
+          ExcNonContiguousVector());
+  return vector.size() > 0 ? &*vector.begin() : nullptr;
+}
+
+
+
+template <typename number>
+template <class VectorType>
+inline
+const typename VectorType::value_type *
+SparseMatrixSELL<number>::get_pointer (const VectorType &vector)
+{
+  Assert (vector.locally_owned_elements().n_elements() == vector.size(),
+          ExcNonContiguousVector());
+  return vector.size() > 0 ? &*vector.begin() : nullptr;
+}
+
+
+
+template <typename number>
+template <class OutVector, class InVector>
+void
+SparseMatrixSELL<number>::vmult (OutVector      &dst,
+                                 const InVector &src) const
+{
+  Assert (!PointerComparison::equal(&src, &dst), ExcSourceEqualsDestination());
+  dst = 0;
+  vmult_add (dst, src);
+}
+
+
+
+template <typename number>
+template <class OutVector, class InVector>
+void
+SparseMatrixSELL<number>::vmult_add (OutVector      &dst,
+                                     const InVector &src) const
+{
+  AssertDimension (m(), dst.size());
+  AssertDimension (n(), src.size());
+  Assert (!PointerComparison::equal(&src, &dst), ExcSourceEqualsDestination());
+
+  if (empty())
+    return;
+
+  const auto *src_ptr = get_pointer(src);
+  auto *dst_ptr = get_pointer(dst);
+  parallel::apply_to_subranges
+  (0U, static_cast<unsigned int>(chunk_start.size() - 1),
+   [&] (const unsigned int begin, const unsigned int end)
+  {
+    internal::SparseMatrixSELLImplementation::vmult_on_chunks
+    (begin, end, values.begin(), column_indices.data(), chunk_start.data(),
+     row_of_slot.data(), src_ptr, dst_ptr, true);
+  },
+  internal::SparseMatrixSELLImplementation::minimum_parallel_grain_size);
+}
+
+
+
+template <typename number>
+template <class OutVector, class InVector>
+void
+SparseMatrixSELL<number>::Tvmult (OutVector      &dst,
+                                  const InVector &src) const
+{
+  Assert (!PointerComparison::equal(&src, &dst), ExcSourceEqualsDestination());
+  dst = 0;
+  Tvmult_add (dst, src);
+}
+
+
+
+template <typename number>
+template <class OutVector, class InVector>
+void
+SparseMatrixSELL<number>::Tvmult_add (OutVector      &dst,
+                                      const InVector &src) const
+{
+  AssertDimension (n(), dst.size());
+  AssertDimension (m(), src.size());
+  Assert (!PointerComparison::equal(&src, &dst), ExcSourceEqualsDestination());
+
+  if (empty())
+    return;
+
+  typedef typename OutVector::value_type Number;
+  const auto *src_ptr = get_pointer(src);
+  Number *dst_ptr = get_pointer(dst);
+
+  // padding entries are zero and do not contribute
+  const unsigned int n_chunks = chunk_start.size() - 1;
+  for (unsigned int c=0; c<n_chunks; ++c)
+    for (unsigned int v=0; v<chunk_size; ++v)
+      {
+        const unsigned int row = row_of_slot[c*chunk_size+v];
+        if (row == numbers::invalid_unsigned_int)
+          continue;
+        const Number src_value = src_ptr[row];
+        for (unsigned int j=chunk_start[c]; j<chunk_start[c+1]; ++j)
+          dst_ptr[column_indices[std::size_t(j)*chunk_size+v]] +=
+            Number(values[j][v]) * src_value;
+      }
+}
+
+
+
+template <typename number>
+template <class VectorType>
+void
+SparseMatrixSELL<number>::precondition_Jacobi (VectorType       &dst,
+                                               const VectorType &src,
+                                               const number      omega) const
+{
+  AssertDimension (m(), n());
+  AssertDimension (dst.size(), n());
+  AssertDimension (src.size(), n());
+  AssertDimension (inverse_diagonal.size(), n());
+#ifdef DEBUG
+  for (size_type row=0; row<m(); ++row)
+    Assert (inverse_diagonal[row] != number(),
+            ExcMessage("There is a zero on the diagonal of this matrix "
+                       "in row "
+                       +
+                       Utilities::to_string(row)
+                       +
+                       ". The preconditioner you selected cannot work if that "
+                       "is the case because one of its steps requires "
+                       "division by the diagonal elements of the matrix."));
+#endif
+
+  typedef typename VectorType::value_type Number;
+  const Number *src_ptr = get_pointer(src);
+  Number *dst_ptr = get_pointer(dst);
+  const size_type n_rows = m();
+  DEAL_II_OPENMP_SIMD_PRAGMA
+  for (size_type i=0; i<n_rows; ++i)
+    dst_ptr[i] = Number(omega * inverse_diagonal[i]) * src_ptr[i];
+}
+
+
+
+template <typename number>
+template <class VectorType>
+void
+SparseMatrixSELL<number>::Jacobi_step (VectorType       &v,
+                                       const VectorType &b,
+                                       const number      omega) const
+{
+  AssertDimension (m(), n());
+  AssertDimension (v.size(), n());
+  AssertDimension (b.size(), n());
+
+  GrowingVectorMemory<VectorType> mem;
+  typename VectorMemory<VectorType>::Pointer w(mem);
+  w->reinit(v, true);
+
+  vmult (*w, v);
+  *w -= b;
+  precondition_Jacobi (*w, *w, omega);
+  v -= *w;
+}
+
+
+
+template <typename number>
+std::size_t
+SparseMatrixSELL<number>::memory_consumption () const
+{
+  return (sizeof(*this) +
+          MemoryConsumption::memory_consumption(row_of_slot) +
+          MemoryConsumption::memory_consumption(slot_of_row) +
+          MemoryConsumption::memory_consumption(chunk_start) +
+          values.memory_consumption() +
+          MemoryConsumption::memory_consumption(column_indices) +
+          inverse_diagonal.memory_consumption());
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -194,7 +194,10 @@ namespace internal
 
 
     // Define the functors necessary to use SIMD with TBB. we also include the
-    // simple copy and set operations
+    // simple copy and set operations. The functors that read from a second
+    // vector are templated on its number type as well, which allows to
+    // combine vectors of different precision (e.g. float and double) without
+    // going through a temporary vector
 
     template <typename Number>
     struct Vector_set
@@ -279,10 +282,10 @@ namespace internal
       Number factor;
     };
 
-    template <typename Number>
+    template <typename Number, typename OtherNumber = Number>
     struct Vectorization_add_av
     {
-      Vectorization_add_av(Number *val, Number *v_val, Number factor)
+      Vectorization_add_av(Number *val, OtherNumber *v_val, Number factor)
         :
         val(val),
         v_val(v_val),
@@ -305,14 +308,14 @@ namespace internal
       }
 
       Number *val;
-      Number *v_val;
+      OtherNumber *v_val;
       Number factor;
     };
 
-    template <typename Number>
+    template <typename Number, typename OtherNumber = Number>
     struct Vectorization_sadd_xav
     {
-      Vectorization_sadd_xav(Number *val, Number *v_val, Number a, Number x)
+      Vectorization_sadd_xav(Number *val, OtherNumber *v_val, Number a, Number x)
         :
         val(val),
         v_val(v_val),
@@ -336,7 +339,7 @@ namespace internal
       }
 
       Number *val;
-      Number *v_val;
+      OtherNumber *v_val;
       Number a;
       Number x;
     };
@@ -397,10 +400,10 @@ namespace internal
       Number factor;
     };
 
-    template <typename Number>
+    template <typename Number, typename OtherNumber = Number>
     struct Vectorization_add_v
     {
-      Vectorization_add_v(Number *val, Number *v_val)
+      Vectorization_add_v(Number *val, OtherNumber *v_val)
         :
         val(val),
         v_val(v_val)
@@ -422,7 +425,7 @@ namespace internal
       }
 
       Number *val;
-      Number *v_val;
+      OtherNumber *v_val;
     };
 
     template <typename Number>
@@ -459,10 +462,10 @@ namespace internal
       Number b;
     };
 
-    template <typename Number>
+    template <typename Number, typename OtherNumber = Number>
     struct Vectorization_sadd_xv
     {
-      Vectorization_sadd_xv(Number *val, Number *v_val, Number x)
+      Vectorization_sadd_xv(Number *val, OtherNumber *v_val, Number x)
         :
         val(val),
         v_val(v_val),
@@ -485,7 +488,7 @@ namespace internal
       }
 
       Number *val;
-      Number *v_val;
+      OtherNumber *v_val;
       Number x;
     };
 
@@ -847,6 +850,39 @@ namespace internal
       const Number *X;
     };
 
+    template <typename Number>
+    struct WeightedNormSquare
+    {
+      static const bool vectorizes = VectorizedArray<Number>::n_array_elements > 1;
+
+      WeightedNormSquare(const Number *X, const Number *W)
+        :
+        X(X),
+        W(W)
+      {}
+
+      Number
+      operator() (const size_type i) const
+      {
+        return X[i] * W[i] * Number(numbers::NumberTraits<Number>::conjugate(X[i]));
+      }
+
+      VectorizedArray<Number>
+      do_vectorized(const size_type i) const
+      {
+        VectorizedArray<Number> x, w;
+        x.load(X+i);
+        w.load(W+i);
+        static_assert (numbers::NumberTraits<Number>::is_complex == false,
+                       "This operation is not correctly implemented for "
+                       "complex-valued objects.");
+        return x * w * x;
+      }
+
+      const Number *X;
+      const Number *W;
+    };
+
     template <typename Number>
     struct AddAndDot
     {
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2011 - 2017 by the deal.II authors
+// Copyright (C) 2011 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -269,6 +269,19 @@ namespace internal
                                const bool                       do_blocking,
                                DynamicSparsityPattern &connectivity) const;
 
+      /**
+       * Computes the ranges of locally owned degrees of freedom that are
+       * accessed for the first and for the last time in each chunk of
+       * macro cells given by @p cell_chunk_starts, filling the fields @p
+       * cell_loop_pre_list and @p cell_loop_post_list. Indices that are not
+       * touched by any cell are assigned to the first chunk for the
+       * operation before the loop and to the last chunk for the operation
+       * after the loop. Indices that are exchanged with other processors
+       * are not contained in the lists, as they must be processed before
+       * starting and after finishing the data exchange, respectively.
+       */
+      void compute_vector_access_ranges (const std::vector<unsigned int> &cell_chunk_starts);
+
       /**
        * Renumbers the degrees of freedom to give good access for this class.
        */
@@ -412,6 +425,34 @@ namespace internal
        */
       std::vector<std::pair<unsigned int,unsigned int> > fe_index_conversion;
 
+      /**
+       * Stores the ranges of locally owned degrees of freedom (in MPI-local
+       * index space) that are read for the first time in a chunk of cells
+       * of the cell loop, in compressed row storage with the row starts
+       * given by @p cell_loop_pre_list_index.
+       */
+      std::vector<std::pair<unsigned int,unsigned int> > cell_loop_pre_list;
+
+      /**
+       * Row starts into the field @p cell_loop_pre_list for each chunk of
+       * cells.
+       */
+      std::vector<unsigned int> cell_loop_pre_list_index;
+
+      /**
+       * Stores the ranges of locally owned degrees of freedom (in MPI-local
+       * index space) that are written for the last time in a chunk of cells
+       * of the cell loop, in compressed row storage with the row starts
+       * given by @p cell_loop_post_list_index.
+       */
+      std::vector<std::pair<unsigned int,unsigned int> > cell_loop_post_list;
+
+      /**
+       * Row starts into the field @p cell_loop_post_list for each chunk of
+       * cells.
+       */
+      std::vector<unsigned int> cell_loop_post_list_index;
+
       /**
        * Temporarily stores the numbers of ghosts during setup. Cleared when
        * calling @p assign_ghosts. Then, all information is collected by the
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2011 - 2017 by the deal.II authors
+// Copyright (C) 2011 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -149,6 +149,10 @@ namespace internal
       cell_active_fe_index.clear();
       max_fe_index = 0;
       fe_index_conversion.clear();
+      cell_loop_pre_list.clear();
+      cell_loop_pre_list_index.clear();
+      cell_loop_post_list.clear();
+      cell_loop_post_list_index.clear();
     }
 
 
@@ -1849,6 +1853,93 @@ not_connect:
 
 
 
+    void
+    DoFInfo::compute_vector_access_ranges (const std::vector<unsigned int> &cell_chunk_starts)
+    {
+      Assert (cell_chunk_starts.size() > 1, ExcInternalError());
+      const unsigned int n_chunks = cell_chunk_starts.size()-1;
+      const unsigned int n_owned  = vector_partitioner->local_size();
+
+      // find the first and the last chunk that touches a locally owned index,
+      // also considering the indices without resolved constraints that are
+      // read by FEEvaluation::read_dof_values_plain
+      std::vector<unsigned int> first_access (n_owned, numbers::invalid_unsigned_int);
+      std::vector<unsigned int> last_access (n_owned, numbers::invalid_unsigned_int);
+      for (unsigned int chunk=0; chunk<n_chunks; ++chunk)
+        for (unsigned int row=cell_chunk_starts[chunk];
+             row<cell_chunk_starts[chunk+1]; ++row)
+          {
+            for (const unsigned int *ptr = begin_indices(row);
+                 ptr != end_indices(row); ++ptr)
+              if (*ptr < n_owned)
+                {
+                  if (first_access[*ptr] == numbers::invalid_unsigned_int)
+                    first_access[*ptr] = chunk;
+                  last_access[*ptr] = chunk;
+                }
+            if (store_plain_indices == true && row_length_indicators(row) > 0)
+              for (const unsigned int *ptr = begin_indices_plain(row);
+                   ptr != end_indices_plain(row); ++ptr)
+                if (*ptr < n_owned)
+                  {
+                    if (first_access[*ptr] == numbers::invalid_unsigned_int)
+                      first_access[*ptr] = chunk;
+                    last_access[*ptr] = chunk;
+                  }
+          }
+
+      // indices not touched by any cell are put into the first and last
+      // chunk, respectively
+      for (unsigned int i=0; i<n_owned; ++i)
+        if (first_access[i] == numbers::invalid_unsigned_int)
+          {
+            first_access[i] = 0;
+            last_access[i] = n_chunks-1;
+          }
+
+      // the indices sent to other processors must be available before the
+      // ghost exchange and are only complete after compress() has finished,
+      // so exclude them from the lists
+      const std::vector<std::pair<unsigned int,unsigned int> > &import_indices =
+        vector_partitioner->import_indices();
+      for (unsigned int r=0; r<import_indices.size(); ++r)
+        for (unsigned int i=import_indices[r].first; i<import_indices[r].second; ++i)
+          first_access[i] = last_access[i] = n_chunks;
+
+      // compress the indices into ranges and collect them in a compressed row
+      // storage format
+      const auto fill_ranges =
+        [&] (const std::vector<unsigned int> &access,
+             std::vector<std::pair<unsigned int,unsigned int> > &list,
+             std::vector<unsigned int> &list_index)
+      {
+        std::vector<std::vector<std::pair<unsigned int,unsigned int> > >
+        ranges (n_chunks);
+        for (unsigned int i=0; i<n_owned; ++i)
+          if (access[i] < n_chunks)
+            {
+              std::vector<std::pair<unsigned int,unsigned int> > &my_ranges =
+                ranges[access[i]];
+              if (my_ranges.empty() || my_ranges.back().second != i)
+                my_ranges.emplace_back(i, i+1);
+              else
+                ++my_ranges.back().second;
+            }
+        list.clear();
+        list_index.resize(n_chunks+1);
+        list_index[0] = 0;
+        for (unsigned int chunk=0; chunk<n_chunks; ++chunk)
+          {
+            list.insert(list.end(), ranges[chunk].begin(), ranges[chunk].end());
+            list_index[chunk+1] = list.size();
+          }
+      };
+      fill_ranges (first_access, cell_loop_pre_list, cell_loop_pre_list_index);
+      fill_ranges (last_access, cell_loop_post_list, cell_loop_post_list_index);
+    }
+
+
+
     void DoFInfo::renumber_dofs (std::vector<types::global_dof_index> &renumbering)
     {
       // first renumber all locally owned degrees of freedom
@@ -1907,6 +1998,10 @@ not_connect:
       memory += MemoryConsumption::memory_consumption (row_starts_plain_indices);
       memory += MemoryConsumption::memory_consumption (plain_dof_indices);
       memory += MemoryConsumption::memory_consumption (constraint_indicator);
+      memory += MemoryConsumption::memory_consumption (cell_loop_pre_list);
+      memory += MemoryConsumption::memory_consumption (cell_loop_pre_list_index);
+      memory += MemoryConsumption::memory_consumption (cell_loop_post_list);
+      memory += MemoryConsumption::memory_consumption (cell_loop_post_list_index);
       memory += MemoryConsumption::memory_consumption (*vector_partitioner);
       return memory;
     }
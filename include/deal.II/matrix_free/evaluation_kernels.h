@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2017 by the deal.II authors
+// Copyright (C) 2017 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -139,8 +139,11 @@ namespace internal
     if (evaluate_values == false && evaluate_gradients == false && evaluate_hessians == false)
       return;
 
+    // for degrees only known at run time, use the even-odd decomposition
+    // for symmetric shape functions as it halves the work in the loops
+    // with variable bounds
     const EvaluatorVariant variant =
-      EvaluatorSelector<type,(fe_degree+n_q_points_1d>4)>::variant;
+      EvaluatorSelector<type,(fe_degree+n_q_points_1d>4 || fe_degree==-1)>::variant;
     typedef EvaluatorTensorProduct<variant, dim, fe_degree, n_q_points_1d,
             VectorizedArray<Number> > Eval;
     Eval eval (variant == evaluate_evenodd ? shape_info.shape_values_eo :
@@ -352,8 +355,11 @@ namespace internal
                const bool               integrate_values,
                const bool               integrate_gradients)
   {
+    // for degrees only known at run time, use the even-odd decomposition
+    // for symmetric shape functions as it halves the work in the loops
+    // with variable bounds
     const EvaluatorVariant variant =
-      EvaluatorSelector<type,(fe_degree+n_q_points_1d>4)>::variant;
+      EvaluatorSelector<type,(fe_degree+n_q_points_1d>4 || fe_degree==-1)>::variant;
     typedef EvaluatorTensorProduct<variant, dim, fe_degree, n_q_points_1d,
             VectorizedArray<Number> > Eval;
     Eval eval (variant == evaluate_evenodd ? shape_info.shape_values_eo :
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2017 by the deal.II authors
+// Copyright (C) 2017 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -21,6 +21,9 @@
 
 DEAL_II_NAMESPACE_OPEN
 
+template <int dim, int fe_degree, int n_q_points_1d, int n_components, typename Number>
+struct SelectEvaluator;
+
 #ifndef DOXYGEN
 namespace
 {
@@ -31,12 +34,16 @@ namespace
 // 1. Start with fe_degree=0, n_q_points_1d=0 and DEPTH=0.
 // 2. If the current assumption on fe_degree doesn't match the runtime
 //    parameter, increase fe_degree  by one and try again.
-//    If fe_degree==10 use the class Default which serves as a fallback.
+//    If fe_degree==13 use the class Default which serves as a fallback.
 // 3. After fixing the fe_degree, DEPTH is increased (DEPTH=1) and we start with
 //    n_q_points=fe_degree+1.
 // 4. If the current assumption on n_q_points_1d doesn't match the runtime
 //    parameter, increase n_q_points_1d by one and try again.
 //    If n_q_points_1d==degree+3 use the class Default which serves as a fallback.
+// 5. Once both parameters are matched, SelectEvaluator with fixed template
+//    parameters picks the kernel according to the element type, i.e., the
+//    even-odd decomposition or collocation for symmetric shape functions and
+//    the general kernels with compile-time loop bounds otherwise.
 
   /**
    * This class serves as a fallback in case we don't have the appropriate template
@@ -55,11 +62,31 @@ namespace
                                  const bool               evaluate_gradients,
                                  const bool               evaluate_hessians)
     {
-      internal::FEEvaluationImpl<internal::MatrixFreeFunctions::tensor_general,
-               dim, -1, 0, n_components, Number>
-               ::evaluate(shape_info, values_dofs_actual, values_quad,
-                          gradients_quad, hessians_quad, scratch_data,
-                          evaluate_values, evaluate_gradients, evaluate_hessians);
+      if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_plus_dg0)
+        internal::FEEvaluationImpl<internal::MatrixFreeFunctions::tensor_symmetric_plus_dg0,
+                 dim, -1, 0, n_components, Number>
+                 ::evaluate(shape_info, values_dofs_actual, values_quad,
+                            gradients_quad, hessians_quad, scratch_data,
+                            evaluate_values, evaluate_gradients, evaluate_hessians);
+      else if (shape_info.element_type == internal::MatrixFreeFunctions::truncated_tensor)
+        internal::FEEvaluationImpl<internal::MatrixFreeFunctions::truncated_tensor,
+                 dim, -1, 0, n_components, Number>
+                 ::evaluate(shape_info, values_dofs_actual, values_quad,
+                            gradients_quad, hessians_quad, scratch_data,
+                            evaluate_values, evaluate_gradients, evaluate_hessians);
+      else if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_general)
+        internal::FEEvaluationImpl<internal::MatrixFreeFunctions::tensor_general,
+                 dim, -1, 0, n_components, Number>
+                 ::evaluate(shape_info, values_dofs_actual, values_quad,
+                            gradients_quad, hessians_quad, scratch_data,
+                            evaluate_values, evaluate_gradients, evaluate_hessians);
+      else
+        // even-odd decomposition with variable loop bounds
+        internal::FEEvaluationImpl<internal::MatrixFreeFunctions::tensor_symmetric,
+                 dim, -1, 0, n_components, Number>
+                 ::evaluate(shape_info, values_dofs_actual, values_quad,
+                            gradients_quad, hessians_quad, scratch_data,
+                            evaluate_values, evaluate_gradients, evaluate_hessians);
     }
 
     static inline void integrate (const internal::MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number> > &shape_info,
@@ -70,11 +97,31 @@ namespace
                                   const bool               integrate_values,
                                   const bool               integrate_gradients)
     {
-      internal::FEEvaluationImpl<internal::MatrixFreeFunctions::tensor_general,
-               dim, -1, 0, n_components, Number>
-               ::integrate(shape_info, values_dofs_actual, values_quad,
-                           gradients_quad, scratch_data,
-                           integrate_values, integrate_gradients);
+      if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_plus_dg0)
+        internal::FEEvaluationImpl<internal::MatrixFreeFunctions::tensor_symmetric_plus_dg0,
+                 dim, -1, 0, n_components, Number>
+                 ::integrate(shape_info, values_dofs_actual, values_quad,
+                             gradients_quad, scratch_data,
+                             integrate_values, integrate_gradients);
+      else if (shape_info.element_type == internal::MatrixFreeFunctions::truncated_tensor)
+        internal::FEEvaluationImpl<internal::MatrixFreeFunctions::truncated_tensor,
+                 dim, -1, 0, n_components, Number>
+                 ::integrate(shape_info, values_dofs_actual, values_quad,
+                             gradients_quad, scratch_data,
+                             integrate_values, integrate_gradients);
+      else if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_general)
+        internal::FEEvaluationImpl<internal::MatrixFreeFunctions::tensor_general,
+                 dim, -1, 0, n_components, Number>
+                 ::integrate(shape_info, values_dofs_actual, values_quad,
+                             gradients_quad, scratch_data,
+                             integrate_values, integrate_gradients);
+      else
+        // even-odd decomposition with variable loop bounds
+        internal::FEEvaluationImpl<internal::MatrixFreeFunctions::tensor_symmetric,
+                 dim, -1, 0, n_components, Number>
+                 ::integrate(shape_info, values_dofs_actual, values_quad,
+                             gradients_quad, scratch_data,
+                             integrate_values, integrate_gradients);
     }
   };
 
@@ -91,7 +138,7 @@ namespace
    * which we want to determine the correct template parameters based at runtime.
    */
   template<int n_q_points_1d, int dim, int n_components, typename Number>
-  struct Factory<dim, n_components, Number, 0, 10, n_q_points_1d> : Default<dim, n_components, Number> {};
+  struct Factory<dim, n_components, Number, 0, 13, n_q_points_1d> : Default<dim, n_components, Number> {};
 
   /**
    * This specialization sets the maximal number of n_q_points_1d for
@@ -153,7 +200,9 @@ namespace
   };
 
   /**
-   * This class chooses the correct template n_q_points_1d after degree was chosen.
+   * This class chooses the correct template n_q_points_1d after degree was
+   * chosen and passes the now known template parameters on to
+   * SelectEvaluator.
    */
   template<int degree, int n_q_points_1d, int dim, int n_components, typename Number>
   struct Factory<dim, n_components, Number, 1, degree, n_q_points_1d, typename std::enable_if<(n_q_points_1d<degree+3)>::type>
@@ -167,118 +216,41 @@ namespace
                                  const bool               evaluate_values,
                                  const bool               evaluate_gradients,
                                  const bool               evaluate_hessians)
-  {
-    const int runtime_n_q_points_1d = shape_info.n_q_points_1d;
-    if (runtime_n_q_points_1d == n_q_points_1d)
-      {
-        if (n_q_points_1d == degree+1)
-          {
-            if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_collocation)
-              internal::FEEvaluationImplCollocation<dim, degree, n_components, Number>
-              ::evaluate(shape_info, values_dofs_actual, values_quad,
-                         gradients_quad, hessians_quad, scratch_data,
-                         evaluate_values, evaluate_gradients, evaluate_hessians);
-            else
-              internal::FEEvaluationImplTransformToCollocation<dim, degree, n_components, Number>
-              ::evaluate(shape_info, values_dofs_actual, values_quad,
-                         gradients_quad, hessians_quad, scratch_data,
-                         evaluate_values, evaluate_gradients, evaluate_hessians);
-          }
-        else
-          internal::FEEvaluationImpl<internal::MatrixFreeFunctions::tensor_symmetric, dim, degree, n_q_points_1d, n_components, Number>
-          ::evaluate(shape_info, values_dofs_actual, values_quad,
-                     gradients_quad, hessians_quad, scratch_data,
-                     evaluate_values, evaluate_gradients, evaluate_hessians);
-      }
-    else
-      Factory<dim, n_components, Number, 1, degree, n_q_points_1d+1>::evaluate (shape_info, values_dofs_actual, values_quad,
-          gradients_quad, hessians_quad, scratch_data,
-          evaluate_values, evaluate_gradients, evaluate_hessians);
-  }
-
-  static inline void integrate (const internal::MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number> > &shape_info,
-                                VectorizedArray<Number> *values_dofs_actual[],
-                                VectorizedArray<Number> *values_quad[],
-                                VectorizedArray<Number> *gradients_quad[][dim],
-                                VectorizedArray<Number> *scratch_data,
-                                const bool               integrate_values,
-                                const bool               integrate_gradients)
-  {
-    const int runtime_n_q_points_1d = shape_info.n_q_points_1d;
-    if (runtime_n_q_points_1d == n_q_points_1d)
-      {
-        if (n_q_points_1d == degree+1)
-          {
-            if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_collocation)
-              internal::FEEvaluationImplCollocation<dim, degree, n_components, Number>
-              ::integrate(shape_info, values_dofs_actual, values_quad,
-                          gradients_quad, scratch_data,
-                          integrate_values, integrate_gradients);
-            else
-              internal::FEEvaluationImplTransformToCollocation<dim, degree, n_components, Number>
-              ::integrate(shape_info, values_dofs_actual, values_quad,
-                          gradients_quad, scratch_data,
-                          integrate_values, integrate_gradients);
-          }
-        else
-          internal::FEEvaluationImpl<internal::MatrixFreeFunctions::tensor_symmetric, dim, degree, n_q_points_1d, n_components, Number>
-          ::integrate(shape_info, values_dofs_actual, values_quad, gradients_quad,
-                      scratch_data, integrate_values, integrate_gradients);
-      }
-    else
-      Factory<dim, n_components, Number, 1, degree, n_q_points_1d+1>
-      ::integrate (shape_info, values_dofs_actual, values_quad, gradients_quad,
-                   scratch_data, integrate_values, integrate_gradients);
-  }
-  };
-
-
+    {
+      const int runtime_n_q_points_1d = shape_info.n_q_points_1d;
+      if (runtime_n_q_points_1d == n_q_points_1d)
+        SelectEvaluator<dim, degree, n_q_points_1d, n_components, Number>
+        ::evaluate(shape_info, values_dofs_actual, values_quad,
+                   gradients_quad, hessians_quad, scratch_data,
+                   evaluate_values, evaluate_gradients, evaluate_hessians);
+      else
+        Factory<dim, n_components, Number, 1, degree, n_q_points_1d+1>::evaluate (shape_info, values_dofs_actual, values_quad,
+            gradients_quad, hessians_quad, scratch_data,
+            evaluate_values, evaluate_gradients, evaluate_hessians);
+    }
 
-  /**
-   * This is the entry point for choosing the correct runtime parameters
-   * for the 'evaluate' function.
-   */
-  template<int dim, int n_components, typename Number>
-  void symmetric_selector_evaluate (const internal::MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number> > &shape_info,
-                                    VectorizedArray<Number> *values_dofs_actual[],
-                                    VectorizedArray<Number> *values_quad[],
-                                    VectorizedArray<Number> *gradients_quad[][dim],
-                                    VectorizedArray<Number> *hessians_quad[][(dim*(dim+1))/2],
-                                    VectorizedArray<Number> *scratch_data,
-                                    const bool               evaluate_values,
-                                    const bool               evaluate_gradients,
-                                    const bool               evaluate_hessians)
-  {
-    Assert(shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric||
-           shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_collocation,
-           ExcInternalError());
-    Factory<dim, n_components, Number>::evaluate
-    (shape_info, values_dofs_actual, values_quad, gradients_quad, hessians_quad,
-     scratch_data, evaluate_values, evaluate_gradients, evaluate_hessians);
-  }
+    static inline void integrate (const internal::MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number> > &shape_info,
+                                  VectorizedArray<Number> *values_dofs_actual[],
+                                  VectorizedArray<Number> *values_quad[],
+                                  VectorizedArray<Number> *gradients_quad[][dim],
+                                  VectorizedArray<Number> *scratch_data,
+                                  const bool               integrate_values,
+                                  const bool               integrate_gradients)
+    {
+      const int runtime_n_q_points_1d = shape_info.n_q_points_1d;
+      if (runtime_n_q_points_1d == n_q_points_1d)
+        SelectEvaluator<dim, degree, n_q_points_1d, n_components, Number>
+        ::integrate(shape_info, values_dofs_actual, values_quad, gradients_quad,
+                    scratch_data, integrate_values, integrate_gradients);
+      else
+        Factory<dim, n_components, Number, 1, degree, n_q_points_1d+1>
+        ::integrate (shape_info, values_dofs_actual, values_quad, gradients_quad,
+                     scratch_data, integrate_values, integrate_gradients);
+    }
+  };
 
 
 
-  /**
-   * This is the entry point for choosing the correct runtime parameters
-   * for the 'integrate' function.
-   */
-  template<int dim, int n_components, typename Number>
-  void symmetric_selector_integrate (const internal::MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number> > &shape_info,
-                                     VectorizedArray<Number> *values_dofs_actual[],
-                                     VectorizedArray<Number> *values_quad[],
-                                     VectorizedArray<Number> *gradients_quad[][dim],
-                                     VectorizedArray<Number> *scratch_data,
-                                     const bool               integrate_values,
-                                     const bool               integrate_gradients)
-  {
-    Assert(shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric||
-           shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_collocation,
-           ExcInternalError());
-    Factory<dim, n_components, Number>::integrate
-    (shape_info, values_dofs_actual, values_quad, gradients_quad,
-     scratch_data, integrate_values, integrate_gradients);
-  }
 }
 #endif
 
@@ -291,7 +263,10 @@ namespace
  * pass these values to the respective template specializations.
  * Otherwise, we perform a runtime matching of the runtime parameters to find
  * the correct specialization. This matching currently supports
- * $0\leq fe\_degree \leq 9$ and $degree+1\leq n\_q\_points\_1d\leq fe\_degree+2$.
+ * $0\leq fe\_degree \leq 12$ and $degree+1\leq n\_q\_points\_1d\leq
+ * fe\_degree+2$ for all element types. For other combinations, kernels with
+ * variable loop bounds are used, which still apply the even-odd decomposition
+ * in case the shape functions are symmetric.
  */
 template <int dim, int fe_degree, int n_q_points_1d, int n_components, typename Number>
 struct SelectEvaluator
@@ -335,9 +310,9 @@ struct SelectEvaluator
  * the selection is done based on the shape_info variable which contains
  * the relevant runtime parameters.
  * In case these parameters do not satisfy
- * $0\leq fe\_degree \leq 9$ and
- * $degree+1\leq n\_q\_points\_1d\leq fe\_degree+2$, a non-optimized fallback
- * is used.
+ * $0\leq fe\_degree \leq 12$ and
+ * $degree+1\leq n\_q\_points\_1d\leq fe\_degree+2$, a fallback with
+ * variable loop bounds is used.
  */
 template <int dim, int n_q_points_1d, int n_components, typename Number>
 struct SelectEvaluator<dim, -1, n_q_points_1d, n_components, Number>
@@ -405,14 +380,16 @@ SelectEvaluator<dim, fe_degree, n_q_points_1d, n_components, Number>::evaluate
                  evaluate_values, evaluate_gradients, evaluate_hessians);
     }
   else if (fe_degree+1 == n_q_points_1d &&
-           shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric)
+           (shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric ||
+            shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_hermite))
     {
       internal::FEEvaluationImplTransformToCollocation<dim, fe_degree, n_components, Number>
       ::evaluate(shape_info, values_dofs_actual, values_quad,
                  gradients_quad, hessians_quad, scratch_data,
                  evaluate_values, evaluate_gradients, evaluate_hessians);
     }
-  else if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric)
+  else if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric ||
+           shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_hermite)
     {
       internal::FEEvaluationImpl<internal::MatrixFreeFunctions::tensor_symmetric,
                dim, fe_degree, n_q_points_1d, n_components, Number>
@@ -473,14 +450,16 @@ SelectEvaluator<dim, fe_degree, n_q_points_1d, n_components, Number>::integrate
                   integrate_values, integrate_gradients);
     }
   else if (fe_degree+1 == n_q_points_1d &&
-           shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric)
+           (shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric ||
+            shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_hermite))
     {
       internal::FEEvaluationImplTransformToCollocation<dim, fe_degree, n_components, Number>
       ::integrate(shape_info, values_dofs_actual, values_quad,
                   gradients_quad, scratch_data,
                   integrate_values, integrate_gradients);
     }
-  else if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric)
+  else if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric ||
+           shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_hermite)
     {
       internal::FEEvaluationImpl<internal::MatrixFreeFunctions::tensor_symmetric,
                dim, fe_degree, n_q_points_1d, n_components, Number>
@@ -532,33 +511,9 @@ SelectEvaluator<dim, -1, dummy, n_components, Number>::evaluate
  const bool               evaluate_gradients,
  const bool               evaluate_hessians)
 {
-  if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_plus_dg0)
-    {
-      internal::FEEvaluationImpl<internal::MatrixFreeFunctions::tensor_symmetric_plus_dg0,
-               dim, -1, 0, n_components, Number>
-               ::evaluate(shape_info, values_dofs_actual, values_quad,
-                          gradients_quad, hessians_quad, scratch_data,
-                          evaluate_values, evaluate_gradients, evaluate_hessians);
-    }
-  else if (shape_info.element_type == internal::MatrixFreeFunctions::truncated_tensor)
-    {
-      internal::FEEvaluationImpl<internal::MatrixFreeFunctions::truncated_tensor,
-               dim, -1, 0, n_components, Number>
-               ::evaluate(shape_info, values_dofs_actual, values_quad,
-                          gradients_quad, hessians_quad, scratch_data,
-                          evaluate_values, evaluate_gradients, evaluate_hessians);
-    }
-  else if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_general)
-    internal::FEEvaluationImpl<internal::MatrixFreeFunctions::tensor_general,
-             dim, -1, 0, n_components, Number>
-             ::evaluate(shape_info, values_dofs_actual, values_quad,
-                        gradients_quad, hessians_quad, scratch_data,
-                        evaluate_values, evaluate_gradients, evaluate_hessians);
-  else
-    symmetric_selector_evaluate<dim, n_components, Number>
-    (shape_info, values_dofs_actual, values_quad,
-     gradients_quad, hessians_quad, scratch_data,
-     evaluate_values, evaluate_gradients, evaluate_hessians);
+  Factory<dim, n_components, Number>::evaluate
+  (shape_info, values_dofs_actual, values_quad, gradients_quad, hessians_quad,
+   scratch_data, evaluate_values, evaluate_gradients, evaluate_hessians);
 }
 
 
@@ -575,33 +530,9 @@ SelectEvaluator<dim, -1, dummy, n_components, Number>::integrate
  const bool               integrate_values,
  const bool               integrate_gradients)
 {
-  if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_plus_dg0)
-    {
-      internal::FEEvaluationImpl<internal::MatrixFreeFunctions::tensor_symmetric_plus_dg0,
-               dim, -1, 0, n_components, Number>
-               ::integrate(shape_info, values_dofs_actual, values_quad,
-                           gradients_quad, scratch_data,
-                           integrate_values, integrate_gradients);
-    }
-  else if (shape_info.element_type == internal::MatrixFreeFunctions::truncated_tensor)
-    {
-      internal::FEEvaluationImpl<internal::MatrixFreeFunctions::truncated_tensor,
-               dim, -1, 0, n_components, Number>
-               ::integrate(shape_info, values_dofs_actual, values_quad,
-                           gradients_quad, scratch_data,
-                           integrate_values, integrate_gradients);
-    }
-  else if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_general)
-    internal::FEEvaluationImpl<internal::MatrixFreeFunctions::tensor_general,
-             dim, -1, 0, n_components, Number>
-             ::integrate(shape_info, values_dofs_actual, values_quad,
-                         gradients_quad, scratch_data,
-                         integrate_values, integrate_gradients);
-  else
-    symmetric_selector_integrate<dim, n_components, Number>
-    (shape_info, values_dofs_actual, values_quad,
-     gradients_quad, scratch_data,
-     integrate_values, integrate_gradients);
+  Factory<dim, n_components, Number>::integrate
+  (shape_info, values_dofs_actual, values_quad, gradients_quad,
+   scratch_data, integrate_values, integrate_gradients);
 }
 #endif //DOXYGEN
 
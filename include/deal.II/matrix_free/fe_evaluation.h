@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2011 - 2017 by the deal.II authors
+// Copyright (C) 2011 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -611,13 +611,17 @@ protected:
    * class. Takes all data stored in MatrixFree. If applied to problems with
    * more than one finite element or more than one quadrature formula selected
    * during construction of @p matrix_free, @p fe_no and @p quad_no allow to
-   * select the appropriate components.
+   * select the appropriate components. In case the polynomial degree is not
+   * known at compile time, i.e., @p fe_degree is numbers::invalid_unsigned_int,
+   * @p active_fe_index selects the element within an hp::FECollection and
+   * the quadrature formula with the same index within the hp::QCollection.
    */
   FEEvaluationBase (const MatrixFree<dim,Number> &matrix_free,
                     const unsigned int            fe_no,
                     const unsigned int            quad_no,
                     const unsigned int            fe_degree,
-                    const unsigned int            n_q_points);
+                    const unsigned int            n_q_points,
+                    const unsigned int            active_fe_index = numbers::invalid_unsigned_int);
 
   /**
    * Constructor that comes with reduced functionality and works similar as
@@ -990,7 +994,8 @@ protected:
                       const unsigned int            fe_no,
                       const unsigned int            quad_no,
                       const unsigned int            fe_degree,
-                      const unsigned int            n_q_points);
+                      const unsigned int            n_q_points,
+                      const unsigned int            active_fe_index = numbers::invalid_unsigned_int);
 
   /**
    * Constructor with reduced functionality for similar usage of FEEvaluation
@@ -1092,7 +1097,8 @@ protected:
                       const unsigned int            fe_no,
                       const unsigned int            quad_no,
                       const unsigned int            fe_degree,
-                      const unsigned int            n_q_points);
+                      const unsigned int            n_q_points,
+                      const unsigned int            active_fe_index = numbers::invalid_unsigned_int);
 
   /**
    * Constructor with reduced functionality for similar usage of FEEvaluation
@@ -1231,7 +1237,8 @@ protected:
                       const unsigned int            fe_no,
                       const unsigned int            quad_no,
                       const unsigned int            dofs_per_cell,
-                      const unsigned int            n_q_points);
+                      const unsigned int            n_q_points,
+                      const unsigned int            active_fe_index = numbers::invalid_unsigned_int);
 
   /**
    * Constructor with reduced functionality for similar usage of FEEvaluation
@@ -1332,7 +1339,8 @@ protected:
                       const unsigned int          fe_no,
                       const unsigned int          quad_no,
                       const unsigned int          fe_degree,
-                      const unsigned int          n_q_points);
+                      const unsigned int          n_q_points,
+                      const unsigned int          active_fe_index = numbers::invalid_unsigned_int);
 
   /**
    * Constructor with reduced functionality for similar usage of FEEvaluation
@@ -1927,6 +1935,25 @@ public:
                 const unsigned int            fe_no   = 0,
                 const unsigned int            quad_no = 0);
 
+  /**
+   * Constructor for hp adaptive computations where the element in the
+   * hp::FECollection is selected from the batch of cells in @p cell_range,
+   * as passed to the cell operation of MatrixFree::cell_loop() and
+   * restricted to a single element with
+   * MatrixFree::create_cell_subrange_hp_by_index(). Together with the
+   * template argument <code>fe_degree=-1</code>, this allows to use the same
+   * FEEvaluation code for all polynomial degrees in the collection, with the
+   * kernels for the degree of each range of cells chosen at run time. The
+   * quadrature formula is the one with the same index as the element, i.e.,
+   * the hp::QCollection given to MatrixFree::reinit() must contain one formula
+   * per element of the hp::FECollection, which is checked in debug mode. For
+   * a fixed template degree, this constructor is equivalent to the other one.
+   */
+  FEEvaluation (const MatrixFree<dim,Number>               &matrix_free,
+                const std::pair<unsigned int,unsigned int> &cell_range,
+                const unsigned int                          fe_no   = 0,
+                const unsigned int                          quad_no = 0);
+
   /**
    * Constructor that comes with reduced functionality and works similar as
    * FEValues. The arguments are similar to the ones passed to the constructor
@@ -2083,6 +2110,32 @@ namespace internal
     {
       static constexpr unsigned int value = degree+1;
     };
+
+
+
+    // a helper function to select the quadrature formula within an
+    // hp::QCollection for a given active FE index. MappingInfo evaluates the
+    // cells of active FE index k with the k-th formula of the collection, so
+    // the two collections must be indexed in the same way
+    template <int dim, typename Number>
+    inline
+    unsigned int
+    get_active_quad_index_hp (const dealii::MatrixFree<dim,Number> &matrix_free,
+                              const unsigned int                    quad_no,
+                              const unsigned int                    active_fe_index)
+    {
+      (void)matrix_free;
+      (void)quad_no;
+      Assert (active_fe_index < matrix_free.get_mapping_info().
+              mapping_data_gen[quad_no].n_q_points.size(),
+              ExcMessage ("The active FE index " +
+                          Utilities::to_string(active_fe_index) +
+                          " has no associated quadrature formula. In hp "
+                          "computations, the hp::QCollection passed to "
+                          "MatrixFree::reinit() must contain one formula for "
+                          "each element of the hp::FECollection."));
+      return active_fe_index;
+    }
   }
 }
 
@@ -2102,7 +2155,8 @@ FEEvaluationBase<dim,n_components_,Number>
                     const unsigned int fe_no_in,
                     const unsigned int quad_no_in,
                     const unsigned int fe_degree,
-                    const unsigned int n_q_points)
+                    const unsigned int n_q_points,
+                    const unsigned int active_fe_index_in)
   :
   scratch_data_array (data_in.acquire_scratch_data()),
   quad_no            (quad_no_in),
@@ -2110,13 +2164,16 @@ FEEvaluationBase<dim,n_components_,Number>
   active_fe_index    (fe_degree != numbers::invalid_unsigned_int ?
                       data_in.get_dof_info(fe_no_in).fe_index_from_degree(fe_degree)
                       :
-                      0),
+                      (active_fe_index_in != numbers::invalid_unsigned_int ?
+                       active_fe_index_in : 0)),
   active_quad_index  (fe_degree != numbers::invalid_unsigned_int ?
                       data_in.get_mapping_info().
                       mapping_data_gen[quad_no_in].
                       quad_index_from_n_q_points(n_q_points)
                       :
-                      0),
+                      (active_fe_index_in != numbers::invalid_unsigned_int ?
+                       internal::MatrixFreeFunctions::get_active_quad_index_hp
+                       (data_in, quad_no_in, active_fe_index_in) : 0)),
   matrix_info        (&data_in),
   dof_info           (&data_in.get_dof_info(fe_no_in)),
   mapping_info       (&data_in.get_mapping_info()),
@@ -4177,10 +4234,11 @@ FEEvaluationAccess<dim,n_components_,Number>
                       const unsigned int fe_no,
                       const unsigned int quad_no_in,
                       const unsigned int fe_degree,
-                      const unsigned int n_q_points)
+                      const unsigned int n_q_points,
+                      const unsigned int active_fe_index)
   :
   FEEvaluationBase <dim,n_components_,Number>
-  (data_in, fe_no, quad_no_in, fe_degree, n_q_points)
+  (data_in, fe_no, quad_no_in, fe_degree, n_q_points, active_fe_index)
 {}
 
 
@@ -4234,10 +4292,11 @@ FEEvaluationAccess<dim,1,Number>
                       const unsigned int fe_no,
                       const unsigned int quad_no_in,
                       const unsigned int fe_degree,
-                      const unsigned int n_q_points)
+                      const unsigned int n_q_points,
+                      const unsigned int active_fe_index)
   :
   FEEvaluationBase <dim,1,Number>
-  (data_in, fe_no, quad_no_in, fe_degree, n_q_points)
+  (data_in, fe_no, quad_no_in, fe_degree, n_q_points, active_fe_index)
 {}
 
 
@@ -4485,10 +4544,11 @@ FEEvaluationAccess<dim,dim,Number>
                       const unsigned int fe_no,
                       const unsigned int quad_no_in,
                       const unsigned int fe_degree,
-                      const unsigned int n_q_points)
+                      const unsigned int n_q_points,
+                      const unsigned int active_fe_index)
   :
   FEEvaluationBase <dim,dim,Number>
-  (data_in, fe_no, quad_no_in, fe_degree, n_q_points)
+  (data_in, fe_no, quad_no_in, fe_degree, n_q_points, active_fe_index)
 {}
 
 
@@ -4857,10 +4917,11 @@ FEEvaluationAccess<1,1,Number>
                       const unsigned int fe_no,
                       const unsigned int quad_no_in,
                       const unsigned int fe_degree,
-                      const unsigned int n_q_points)
+                      const unsigned int n_q_points,
+                      const unsigned int active_fe_index)
   :
   FEEvaluationBase <1,1,Number>
-  (data_in, fe_no, quad_no_in, fe_degree, n_q_points)
+  (data_in, fe_no, quad_no_in, fe_degree, n_q_points, active_fe_index)
 {}
 
 
@@ -5108,6 +5169,26 @@ FEEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
 
 
 
+template <int dim, int fe_degree,  int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+FEEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::FEEvaluation (const MatrixFree<dim,Number>               &data_in,
+                const std::pair<unsigned int,unsigned int> &cell_range,
+                const unsigned int                          fe_no,
+                const unsigned int                          quad_no)
+  :
+  BaseClass (data_in, fe_no, quad_no, fe_degree, static_n_q_points,
+             data_in.get_cell_active_fe_index(cell_range, fe_no)),
+  dofs_per_component (this->data->dofs_per_component_on_cell),
+  dofs_per_cell (this->data->dofs_per_component_on_cell *n_components_),
+  n_q_points (this->data->n_q_points)
+{
+  check_template_arguments(fe_no, 0);
+}
+
+
+
 template <int dim, int fe_degree,  int n_q_points_1d, int n_components_,
           typename Number>
 inline
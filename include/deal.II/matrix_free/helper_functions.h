@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2011 - 2017 by the deal.II authors
+// Copyright (C) 2011 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -62,6 +62,7 @@ namespace internal
       bool use_multithreading;
       bool use_partition_partition;
       bool use_coloring_only;
+      bool overlap_communication_computation;
 
       std::vector<unsigned int> partition_color_blocks_row_index;
       std::vector<unsigned int> partition_color_blocks_data;
@@ -74,6 +75,15 @@ namespace internal
       std::vector<unsigned int> partition_odds;
       std::vector<unsigned int> partition_n_blocked_workers;
       std::vector<unsigned int> partition_n_workers;
+
+      /**
+       * Subdivision of the macro cells into chunks for the cell loop without
+       * threads that runs operations on vector entries before and after the
+       * cells in a chunk. The entries are the first macro cell of each chunk,
+       * with the last entry being the number of macro cells. The chunks do
+       * not cross the limits of the range of boundary cells.
+       */
+      std::vector<unsigned int> cell_chunk_starts;
     };
 
 
@@ -104,12 +114,16 @@ namespace internal
 
       /**
        * Determines the position of cells with ghosts for distributed-memory
-       * calculations.
+       * calculations. If @p overlap_communication_computation is false, all
+       * cells are marked as boundary cells in order to keep the original
+       * ordering of cells and to exchange ghost data before and after the
+       * whole loop.
        */
       void make_layout (const unsigned int n_active_cells_in,
                         const unsigned int vectorization_length_in,
                         std::vector<unsigned int> &boundary_cells,
-                        std::vector<unsigned int> &irregular_cells);
+                        std::vector<unsigned int> &irregular_cells,
+                        const bool overlap_communication_computation = true);
 
       unsigned int n_active_cells;
       unsigned int n_macro_cells;
@@ -175,7 +175,8 @@ public:
                     const unsigned int level_mg_handler = numbers::invalid_unsigned_int,
                     const bool                store_plain_indices = true,
                     const bool                initialize_indices = true,
-                    const bool                initialize_mapping = true)
+                    const bool                initialize_mapping = true,
+                    const bool                overlap_communication_computation = true)
       :
       tasks_parallel_scheme (tasks_parallel_scheme),
       tasks_block_size      (tasks_block_size),
@@ -183,7 +184,8 @@ public:
       level_mg_handler      (level_mg_handler),
       store_plain_indices   (store_plain_indices),
       initialize_indices    (initialize_indices),
-      initialize_mapping    (initialize_mapping)
+      initialize_mapping    (initialize_mapping),
+      overlap_communication_computation (overlap_communication_computation)
     {};
 
 
@@ -276,6 +278,33 @@ public:
      * independent cells should be computed).
      */
     bool                initialize_mapping;
+
+    /**
+     * Controls whether the cell loop should overlap the MPI data exchange of
+     * the source and destination vectors with computations. If set to true
+     * (the default), the cells that access ghosted vector entries are
+     * collected in a separate range in the middle of the cell numbering. The
+     * cell loop then starts the ghost exchange with
+     * LinearAlgebra::distributed::Vector::update_ghost_values_start(), works
+     * on the cells that only touch locally owned degrees of freedom, waits
+     * for the ghost exchange to finish before working on the boundary cells,
+     * and finally starts the compress() operation while the remaining inner
+     * cells are processed.
+     *
+     * If set to false, the cells are not reordered in terms of boundary and
+     * inner cells. The cell loop then waits for the ghost exchange before
+     * processing any cell and starts compress() only once all cells have
+     * been processed. This can be beneficial when the MPI implementation
+     * does not make progress in the background or when the cell ordering
+     * should be kept for better cache locality.
+     *
+     * This flag only affects the loop without task parallelism, i.e., when
+     * @p tasks_parallel_scheme is set to @p none or only a single thread is
+     * available. The task-parallel schemes always place the cells with
+     * ghosts into the first partition and overlap the communication with
+     * the work on the remaining partitions.
+     */
+    bool                overlap_communication_computation;
   };
 
   /**
@@ -449,6 +478,10 @@ public:
    * a pointer to an object in this place if it has an <code>operator()</code>
    * with the correct set of arguments since such a pointer can be converted
    * to the function object.
+   *
+   * Whether the data exchange is overlapped with the work on cells that do
+   * not access ghosted vector entries is controlled by the flag
+   * AdditionalData::overlap_communication_computation.
    */
   template <typename OutVector, typename InVector>
   void cell_loop (const std::function<void (const MatrixFree<dim,Number> &,
@@ -491,6 +524,77 @@ public:
                   OutVector      &dst,
                   const InVector &src) const;
 
+  /**
+   * This is a variant of the loop over all cells that additionally runs
+   * operations on ranges of the locally owned vector entries, given by the
+   * arguments @p operation_before_loop and @p operation_after_loop. The
+   * two functions get passed a half-open range <code>[begin, end)</code> of
+   * indices in the MPI-local index space of the vector layout associated
+   * with the DoFHandler @p dof_handler_index_pre_post, i.e., numbers between
+   * zero and the locally owned size of vectors initialized with
+   * initialize_dof_vector(). Each locally owned index is passed exactly once
+   * to each of the two functions.
+   *
+   * The loop calls @p operation_before_loop on a range of vector entries
+   * right before the first cell that reads from these entries is processed,
+   * and @p operation_after_loop right after the last cell that writes into
+   * these entries has been processed. This makes it possible to fuse vector
+   * updates, e.g. in the conjugate gradient method, with the matrix-vector
+   * product while the data is still in caches, instead of streaming all
+   * vectors from main memory several times. A typical use is to update the
+   * entries of the source vector @p src in @p operation_before_loop and
+   * to compute the contributions of the entries of @p dst to a dot product
+   * in @p operation_after_loop. Since a cell reads from @p src at the same
+   * indices it writes into @p dst for the same DoFHandler, the entries of
+   * @p src in the range passed to @p operation_after_loop are also not
+   * accessed by the loop anymore and can be modified.
+   *
+   * Vector entries that are sent to other MPI processes during the ghost
+   * exchange are passed to @p operation_before_loop before the exchange is
+   * started, and to @p operation_after_loop once the compress() operation
+   * on @p dst has finished. Entries that are not accessed by any cell, like
+   * constrained degrees of freedom, are processed before the first and
+   * after the last chunk of cells, respectively.
+   *
+   * The interleaving of the operations with the cells is only done for the
+   * loop without task parallelism. With task parallelism enabled, the two
+   * operations are called on the whole locally owned range before and
+   * after the cell loop, respectively.
+   */
+  template <typename OutVector, typename InVector>
+  void cell_loop (const std::function<void (const MatrixFree<dim,Number> &,
+                                            OutVector &,
+                                            const InVector &,
+                                            const std::pair<unsigned int,
+                                            unsigned int> &)> &cell_operation,
+                  OutVector      &dst,
+                  const InVector &src,
+                  const std::function<void (const unsigned int,
+                                            const unsigned int)> &operation_before_loop,
+                  const std::function<void (const unsigned int,
+                                            const unsigned int)> &operation_after_loop,
+                  const unsigned int dof_handler_index_pre_post = 0) const;
+
+  /**
+   * Same as above, but for a class member function with the signature
+   * <code>cell_operation (const MatrixFree<dim,Number> &, OutVector &,
+   * InVector &, std::pair<unsigned int,unsigned int>&)const</code>.
+   */
+  template <typename CLASS, typename OutVector, typename InVector>
+  void cell_loop (void (CLASS::*function_pointer)(const MatrixFree &,
+                                                  OutVector &,
+                                                  const InVector &,
+                                                  const std::pair<unsigned int,
+                                                  unsigned int> &)const,
+                  const CLASS    *owning_class,
+                  OutVector      &dst,
+                  const InVector &src,
+                  const std::function<void (const unsigned int,
+                                            const unsigned int)> &operation_before_loop,
+                  const std::function<void (const unsigned int,
+                                            const unsigned int)> &operation_after_loop,
+                  const unsigned int dof_handler_index_pre_post = 0) const;
+
   /**
    * In the hp adaptive case, a subrange of cells as computed during the cell
    * loop might contain elements of different degrees. Use this function to
@@ -715,6 +819,31 @@ public:
   unsigned int
   n_components_filled (const unsigned int macro_cell_number) const;
 
+  /**
+   * Return the number of cells in the batch of cells (macro cell) with the
+   * given number that correspond to actual cells of the mesh, i.e., the
+   * number of filled lanes of the vectorized data types. This is the same
+   * as n_components_filled(). Since the cells of a batch must share the same
+   * element, hp adaptive meshes may contain a batch that is not completely
+   * filled for each element in the hp::FECollection and each partition of
+   * cells. The overall fill ratio is reported by
+   * print_cell_batch_statistics(), which is useful as a performance
+   * diagnostic.
+   */
+  unsigned int
+  n_active_entries_per_cell_batch (const unsigned int cell_batch_number) const;
+
+  /**
+   * Return the index of the element in the hp::FECollection of the given
+   * vector component used on the cells in the range @p range. All cells in
+   * the range must use the same element, which is the case for the ranges
+   * returned by create_cell_subrange_hp_by_index(). Returns zero if this
+   * class was not initialized with an hp::DoFHandler.
+   */
+  unsigned int
+  get_cell_active_fe_index (const std::pair<unsigned int,unsigned int> &range,
+                            const unsigned int vector_component = 0) const;
+
   /**
    * Return the number of degrees of freedom per cell for a given hp index.
    */
@@ -784,6 +913,15 @@ public:
   template <typename StreamType>
   void print_memory_consumption(StreamType &out) const;
 
+  /**
+   * Prints statistics about how well the batches of cells fill the lanes of
+   * the vectorized data types, separately for each element in the
+   * hp::FECollection of the first DoFHandler. Partially filled batches waste
+   * a part of the arithmetic throughput of the SIMD instructions.
+   */
+  template <typename StreamType>
+  void print_cell_batch_statistics(StreamType &out) const;
+
   /**
    * Prints a summary of this class to the given output stream. It is focused
    * on the indices, and does not print all the data stored.
@@ -1369,8 +1507,19 @@ inline
 unsigned int
 MatrixFree<dim,Number>::n_components_filled (const unsigned int macro_cell) const
 {
-  AssertIndexRange (macro_cell, size_info.n_macro_cells);
-  const unsigned int n_filled = dof_info[0].row_starts[macro_cell][2];
+  return n_active_entries_per_cell_batch(macro_cell);
+}
+
+
+
+template <int dim, typename Number>
+inline
+unsigned int
+MatrixFree<dim,Number>::n_active_entries_per_cell_batch
+(const unsigned int cell_batch_number) const
+{
+  AssertIndexRange (cell_batch_number, size_info.n_macro_cells);
+  const unsigned int n_filled = dof_info[0].row_starts[cell_batch_number][2];
   if (n_filled == 0)
     return VectorizedArray<Number>::n_array_elements;
   else
@@ -1379,6 +1528,30 @@ MatrixFree<dim,Number>::n_components_filled (const unsigned int macro_cell) cons
 
 
 
+template <int dim, typename Number>
+inline
+unsigned int
+MatrixFree<dim,Number>::get_cell_active_fe_index
+(const std::pair<unsigned int,unsigned int> &range,
+ const unsigned int vector_component) const
+{
+  AssertIndexRange (vector_component, dof_info.size());
+  const std::vector<unsigned int> &fe_indices =
+    dof_info[vector_component].cell_active_fe_index;
+  if (fe_indices.empty() || range.second == range.first)
+    return 0;
+
+  AssertIndexRange (range.first, fe_indices.size());
+  AssertIndexRange (range.second, fe_indices.size()+1);
+  Assert (fe_indices[range.first] == fe_indices[range.second-1],
+          ExcMessage ("The cells in the given range use different elements of "
+                      "the hp::FECollection. Use create_cell_subrange_hp_by_index() "
+                      "to split the range."));
+  return fe_indices[range.first];
+}
+
+
+
 template <int dim, typename Number>
 inline
 unsigned int
@@ -2690,6 +2863,127 @@ MatrixFree<dim,Number>::cell_loop
 }
 
 
+template <int dim, typename Number>
+template <typename OutVector, typename InVector>
+inline
+void
+MatrixFree<dim, Number>::cell_loop
+(const std::function<void (const MatrixFree<dim,Number> &,
+                           OutVector &,
+                           const InVector &,
+                           const std::pair<unsigned int,
+                           unsigned int> &)> &cell_operation,
+ OutVector       &dst,
+ const InVector  &src,
+ const std::function<void (const unsigned int,
+                           const unsigned int)> &operation_before_loop,
+ const std::function<void (const unsigned int,
+                           const unsigned int)> &operation_after_loop,
+ const unsigned int dof_handler_index_pre_post) const
+{
+  AssertIndexRange (dof_handler_index_pre_post, dof_info.size());
+  const internal::MatrixFreeFunctions::DoFInfo &info =
+    dof_info[dof_handler_index_pre_post];
+  const unsigned int n_owned = info.vector_partitioner->local_size();
+
+  // with threads, run the operations on the whole range before and after
+  // the loop
+  if (task_info.use_multithreading == true ||
+      task_info.cell_chunk_starts.size() < 2)
+    {
+      if (n_owned > 0)
+        operation_before_loop (0, n_owned);
+      cell_loop (cell_operation, dst, src);
+      if (n_owned > 0)
+        operation_after_loop (0, n_owned);
+      return;
+    }
+
+  AssertDimension (info.cell_loop_pre_list_index.size(),
+                   task_info.cell_chunk_starts.size());
+
+  // the entries exchanged with other processors must be ready before
+  // starting the ghost exchange
+  const std::vector<std::pair<unsigned int,unsigned int> > &import_indices =
+    info.vector_partitioner->import_indices();
+  for (unsigned int i=0; i<import_indices.size(); ++i)
+    operation_before_loop (import_indices[i].first, import_indices[i].second);
+
+  bool ghosts_were_not_set = internal::update_ghost_values_start (src);
+
+  const std::vector<unsigned int> &chunks = task_info.cell_chunk_starts;
+  unsigned int chunk = 0;
+  const auto run_chunks_until = [&] (const unsigned int end_cell)
+  {
+    for ( ; chunk+1 < chunks.size() && chunks[chunk+1] <= end_cell; ++chunk)
+      {
+        for (unsigned int i=info.cell_loop_pre_list_index[chunk];
+             i<info.cell_loop_pre_list_index[chunk+1]; ++i)
+          operation_before_loop (info.cell_loop_pre_list[i].first,
+                                 info.cell_loop_pre_list[i].second);
+
+        cell_operation (*this, dst, src,
+                        std::make_pair(chunks[chunk], chunks[chunk+1]));
+
+        for (unsigned int i=info.cell_loop_post_list_index[chunk];
+             i<info.cell_loop_post_list_index[chunk+1]; ++i)
+          operation_after_loop (info.cell_loop_post_list[i].first,
+                                info.cell_loop_post_list[i].second);
+      }
+  };
+
+  // same order as in the loop without additional operations: inner cells,
+  // boundary cells after finishing the ghost exchange, and again inner cells
+  // while the compress operation is in flight
+  run_chunks_until (size_info.boundary_cells_start);
+  internal::update_ghost_values_finish(src);
+  run_chunks_until (size_info.boundary_cells_end);
+  internal::compress_start(dst);
+  run_chunks_until (size_info.n_macro_cells);
+  internal::compress_finish(dst);
+  internal::reset_ghost_values(src, ghosts_were_not_set);
+
+  for (unsigned int i=0; i<import_indices.size(); ++i)
+    operation_after_loop (import_indices[i].first, import_indices[i].second);
+}
+
+
+
+template <int dim, typename Number>
+template <typename CLASS, typename OutVector, typename InVector>
+inline
+void
+MatrixFree<dim,Number>::cell_loop
+(void (CLASS::*function_pointer)(const MatrixFree<dim,Number> &,
+                                 OutVector &,
+                                 const InVector &,
+                                 const std::pair<unsigned int,
+                                 unsigned int> &)const,
+ const CLASS    *owning_class,
+ OutVector      &dst,
+ const InVector &src,
+ const std::function<void (const unsigned int,
+                           const unsigned int)> &operation_before_loop,
+ const std::function<void (const unsigned int,
+                           const unsigned int)> &operation_after_loop,
+ const unsigned int dof_handler_index_pre_post) const
+{
+  std::function<void (const MatrixFree<dim,Number> &,
+                      OutVector &,
+                      const InVector &,
+                      const std::pair<unsigned int,
+                      unsigned int> &)>
+  function = std::bind<void>(function_pointer,
+                             owning_class,
+                             std::placeholders::_1,
+                             std::placeholders::_2,
+                             std::placeholders::_3,
+                             std::placeholders::_4);
+  cell_loop (function, dst, src, operation_before_loop, operation_after_loop,
+             dof_handler_index_pre_post);
+}
+
+
 #endif  // ifndef DOXYGEN
 
 
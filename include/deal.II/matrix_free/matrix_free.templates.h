@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2011 - 2017 by the deal.II authors
+// Copyright (C) 2011 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -32,6 +32,9 @@
 #include <deal.II/matrix_free/mapping_info.templates.h>
 #include <deal.II/matrix_free/dof_info.templates.h>
 
+#include <iomanip>
+#include <numeric>
+
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -152,6 +155,8 @@ internal_reinit(const Mapping<dim>                          &mapping,
       else
 #endif
         task_info.use_multithreading = false;
+      task_info.overlap_communication_computation =
+        additional_data.overlap_communication_computation;
 
       // set dof_indices together with constraint_indicator and
       // constraint_pool_data. It also reorders the way cells are gone through
@@ -286,6 +291,8 @@ internal_reinit(const Mapping<dim>                            &mapping,
       else
 #endif
         task_info.use_multithreading = false;
+      task_info.overlap_communication_computation =
+        additional_data.overlap_communication_computation;
 
       // set dof_indices together with constraint_indicator and
       // constraint_pool_data. It also reorders the way cells are gone through
@@ -662,7 +669,9 @@ void MatrixFree<dim,Number>::initialize_indices
     VectorizedArray<Number>::n_array_elements;
   std::vector<unsigned int> irregular_cells;
   size_info.make_layout (n_active_cells, vectorization_length, boundary_cells,
-                         irregular_cells);
+                         irregular_cells,
+                         task_info.overlap_communication_computation ||
+                         task_info.use_multithreading);
 
   for (unsigned int no=0; no<n_fe; ++no)
     dof_info[no].assign_ghosts (boundary_cells);
@@ -765,6 +774,38 @@ void MatrixFree<dim,Number>::initialize_indices
                                constraint_pool_row_index,
                                irregular_cells, vectorization_length);
 
+  // subdivide the cells into chunks for the loop without threads that runs
+  // operations on vector entries before and after the cells that access
+  // them. the chunks should be small enough to keep the vector entries they
+  // touch in caches and must not cross the limits of the boundary cells
+  if (task_info.use_multithreading == false)
+    {
+      unsigned int max_dofs_per_cell = 1;
+      for (unsigned int no=0; no<n_fe; ++no)
+        for (unsigned int i=0; i<dof_info[no].dofs_per_cell.size(); ++i)
+          max_dofs_per_cell = std::max(max_dofs_per_cell,
+                                       dof_info[no].dofs_per_cell[i]);
+      const unsigned int chunk_size =
+        std::max(1U, 4096U/(max_dofs_per_cell*vectorization_length));
+
+      task_info.cell_chunk_starts.clear();
+      task_info.cell_chunk_starts.push_back(0);
+      const unsigned int range_ends[3] = {size_info.boundary_cells_start,
+                                          size_info.boundary_cells_end,
+                                          size_info.n_macro_cells
+                                         };
+      for (unsigned int r=0; r<3; ++r)
+        while (task_info.cell_chunk_starts.back() < range_ends[r])
+          task_info.cell_chunk_starts.push_back
+          (std::min(task_info.cell_chunk_starts.back()+chunk_size,
+                    range_ends[r]));
+      if (task_info.cell_chunk_starts.size() == 1)
+        task_info.cell_chunk_starts.push_back(0);
+
+      for (unsigned int no=0; no<n_fe; ++no)
+        dof_info[no].compute_vector_access_ranges(task_info.cell_chunk_starts);
+    }
+
   indices_are_initialized = true;
 }
 
@@ -832,6 +873,52 @@ void MatrixFree<dim,Number>::print_memory_consumption (StreamType &out) const
 
 
 
+template <int dim, typename Number>
+template <typename StreamType>
+void MatrixFree<dim,Number>::print_cell_batch_statistics (StreamType &out) const
+{
+  const unsigned int vectorization_length =
+    VectorizedArray<Number>::n_array_elements;
+  const std::vector<unsigned int> &fe_indices = dof_info[0].cell_active_fe_index;
+  const unsigned int n_fe_indices = std::max(1U, dof_info[0].max_fe_index);
+
+  std::vector<unsigned int> n_batches(n_fe_indices), n_partial(n_fe_indices),
+      n_cells(n_fe_indices);
+  for (unsigned int cell=0; cell<size_info.n_macro_cells; ++cell)
+    {
+      const unsigned int index = fe_indices.empty() ? 0 : fe_indices[cell];
+      const unsigned int n_filled = n_active_entries_per_cell_batch(cell);
+      ++n_batches[index];
+      n_cells[index] += n_filled;
+      if (n_filled < vectorization_length)
+        ++n_partial[index];
+    }
+
+  const auto print_line = [&](const unsigned int batches,
+                              const unsigned int partial,
+                              const unsigned int cells)
+  {
+    out << batches << " cell batches, " << partial
+        << " partially filled, SIMD lanes filled: "
+        << (batches > 0 ?
+            100. * cells / (batches * vectorization_length) :
+            100.)
+        << "%" << std::endl;
+  };
+  out << "   Cell batches total:               ";
+  print_line(std::accumulate(n_batches.begin(), n_batches.end(), 0U),
+             std::accumulate(n_partial.begin(), n_partial.end(), 0U),
+             std::accumulate(n_cells.begin(), n_cells.end(), 0U));
+  if (fe_indices.size() > 0)
+    for (unsigned int i=0; i<n_fe_indices; ++i)
+      {
+        out << "   Cell batches fe index " << std::setw(3) << i << ":       ";
+        print_line(n_batches[i], n_partial[i], n_cells[i]);
+      }
+}
+
+
+
 template <int dim, typename Number>
 void MatrixFree<dim,Number>::print (std::ostream &out) const
 {
@@ -869,6 +956,7 @@ namespace internal
       use_multithreading = false;
       use_partition_partition = false;
       use_coloring_only = false;
+      overlap_communication_computation = true;
       partition_color_blocks_row_index.clear();
       partition_color_blocks_data.clear();
       evens = 0;
@@ -879,6 +967,7 @@ namespace internal
       partition_odds.clear();
       partition_n_blocked_workers.clear();
       partition_n_workers.clear();
+      cell_chunk_starts.clear();
     }
 
 
@@ -892,7 +981,8 @@ namespace internal
               MemoryConsumption::memory_consumption (partition_evens) +
               MemoryConsumption::memory_consumption (partition_odds) +
               MemoryConsumption::memory_consumption (partition_n_blocked_workers) +
-              MemoryConsumption::memory_consumption (partition_n_workers));
+              MemoryConsumption::memory_consumption (partition_n_workers) +
+              MemoryConsumption::memory_consumption (cell_chunk_starts));
     }
 
 
@@ -939,11 +1029,24 @@ namespace internal
     void SizeInfo::make_layout (const unsigned int n_active_cells_in,
                                 const unsigned int vectorization_length_in,
                                 std::vector<unsigned int> &boundary_cells,
-                                std::vector<unsigned int> &irregular_cells)
+                                std::vector<unsigned int> &irregular_cells,
+                                const bool overlap_communication_computation)
     {
       vectorization_length = vectorization_length_in;
       n_active_cells = n_active_cells_in;
 
+      // without overlap of communication and computation, all cells are
+      // treated as boundary cells: this keeps the cells in their original
+      // order and makes the cell loop exchange the ghosts before and after
+      // working on all cells
+      if (overlap_communication_computation == false && n_procs > 1 &&
+          boundary_cells.size() > 0)
+        {
+          boundary_cells.resize(n_active_cells);
+          for (unsigned int i=0; i<n_active_cells; ++i)
+            boundary_cells[i] = i;
+        }
+
       unsigned int n_max_boundary_cells = boundary_cells.size();
       unsigned int n_boundary_cells = n_max_boundary_cells;
 
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2003 - 2017 by the deal.II authors
+// Copyright (C) 2003 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -517,6 +517,16 @@ MGLevelGlobalTransfer<LinearAlgebra::distributed::Vector<Number> >::copy_from_mg
  LinearAlgebra::distributed::Vector<Number2>                      &dst,
  const MGLevelObject<LinearAlgebra::distributed::Vector<Number> > &src) const
 {
+  if (perform_plain_copy)
+    {
+      // In this case, we can simply add the local range, converting between
+      // the number types of the level and global vectors on the fly
+      dst.zero_out_ghosts();
+      AssertDimension(src[src.max_level()].local_size(), dst.local_size());
+      dst.add(Number2(1.), src[src.max_level()]);
+      return;
+    }
+
   // For non-DG: degrees of freedom in the refinement face may need special
   // attention, since they belong to the coarse level, but have fine level
   // basis functions
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1999 - 2017 by the deal.II authors
+// Copyright (C) 1999 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -357,6 +357,16 @@ private:
  * use of a separate DoFHandler for each block, this class also allows
  * to be initialized with a separate DoFHandler for each block.
  *
+ * The vector type OtherVectorType of the vmult() functions does not need to
+ * coincide with the level vector type VectorType, as long as the TRANSFER
+ * object can copy between the two. For example, the level vectors can be of
+ * type LinearAlgebra::distributed::Vector<float> within an outer solver
+ * working on LinearAlgebra::distributed::Vector<double>. Since the
+ * computations in the multigrid cycle are typically limited by the memory
+ * bandwidth, this mixed-precision setup almost halves the cost of the
+ * preconditioner, while the outer solver still converges to double
+ * precision accuracy.
+ *
  * @author Guido Kanschat, Daniel Arndt, 1999, 2000, 2001, 2002, 2017
  */
 template <int dim, typename VectorType, class TRANSFER>
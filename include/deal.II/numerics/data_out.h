@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1999 - 2017 by the deal.II authors
+// Copyright (C) 1999 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -21,6 +21,7 @@
 #include <deal.II/base/config.h>
 #include <deal.II/numerics/data_out_dof_data.h>
 
+#include <functional>
 #include <memory>
 
 DEAL_II_NAMESPACE_OPEN
@@ -286,6 +287,58 @@ public:
                               const unsigned int n_subdivisions = 0,
                               const CurvedCellRegion curved_region = curved_boundary);
 
+  /**
+   * Build the patches of this object in chunks of @p n_cells_per_chunk cells
+   * and write each chunk to @p out in VTU format right away, rather than
+   * first building the patches for all cells as build_patches() does and
+   * then writing them with DataOutInterface::write_vtu(). Only the patches
+   * of one chunk are held in memory at any given time, so the memory used
+   * for output is bounded by the chunk size instead of growing with the
+   * number of cells times the number of subdivisions. This is important for
+   * three-dimensional computations with higher order elements, for which
+   * the patches of the whole mesh can be several times larger than the
+   * solution vector.
+   *
+   * The patches of each chunk are built in parallel just as in
+   * build_patches() and are written as a separate <code>Piece</code> of the
+   * VTU file, using the flags set through DataOutInterface::set_flags() (in
+   * particular, the data is compressed if deal.II was configured with zlib).
+   * Visualization programs such as Paraview and VisIt read all pieces of a
+   * file and show them as one data set. Since vertices shared between
+   * patches are duplicated in VTU output anyway, the result is the same
+   * data as written by write_vtu(), merely grouped differently.
+   *
+   * If DataOutBase::VtkFlags::appended_raw_data is set, the compressed data
+   * of all chunks is kept in memory until it is written at the end of the
+   * file.
+   *
+   * This function does not leave any patches in this object, i.e., calling
+   * it is not a substitute for build_patches() if output in other formats
+   * is desired as well.
+   *
+   * @param out The stream to which the VTU data is written.
+   * @param n_subdivisions The number of subdivisions of each cell, with the
+   * same meaning as for build_patches().
+   * @param n_cells_per_chunk The number of cells whose patches are built
+   * before they are written to @p out. Larger values increase the
+   * parallelism available in building the patches and reduce the overhead
+   * per piece in the output file, at the cost of more memory.
+   */
+  void write_vtu_in_chunks (std::ostream       &out,
+                            const unsigned int  n_subdivisions = 0,
+                            const unsigned int  n_cells_per_chunk = 4096);
+
+  /**
+   * Same as above, except that the additional parameters @p mapping and
+   * @p curved_region define the mapping used to generate the output, with
+   * the same meaning as for the corresponding variant of build_patches().
+   */
+  void write_vtu_in_chunks (std::ostream                                                             &out,
+                            const Mapping<DoFHandlerType::dimension, DoFHandlerType::space_dimension> &mapping,
+                            const unsigned int                                                        n_subdivisions = 0,
+                            const CurvedCellRegion                                                    curved_region = curved_boundary,
+                            const unsigned int                                                        n_cells_per_chunk = 4096);
+
   /**
    * Return the first cell which we want output for. The default
    * implementation returns the first active cell, but you might want to
@@ -322,6 +375,21 @@ private:
    */
   virtual cell_iterator next_locally_owned_cell (const cell_iterator &cell);
 
+  /**
+   * The function doing the work of build_patches() and
+   * write_vtu_in_chunks(). It builds the patches of the selected cells in
+   * chunks of @p n_cells_per_chunk cells, storing each chunk in the patches
+   * array of this object before calling @p process_chunk (if non-empty) on
+   * it. With @p n_cells_per_chunk equal to numbers::invalid_unsigned_int,
+   * all patches are built at once.
+   */
+  void build_patches_in_chunks
+  (const Mapping<DoFHandlerType::dimension, DoFHandlerType::space_dimension> &mapping,
+   const unsigned int                                                        n_subdivisions,
+   const CurvedCellRegion                                                    curved_region,
+   const unsigned int                                                        n_cells_per_chunk,
+   const std::function<void ()>                                              &process_chunk);
+
   /**
    * Build one patch. This function is called in a WorkStream context.
    *
@@ -329,13 +397,15 @@ private:
    * object. All following are tied to particular values when calling
    * WorkStream::run(). The function does not take a CopyData object but
    * rather allocates one on its own stack for memory access efficiency
-   * reasons.
+   * reasons. The patch is stored at position <code>patch_index -
+   * first_patch_index</code> of the patches array.
    */
   void build_one_patch
   (const std::pair<cell_iterator, unsigned int>                 *cell_and_index,
    internal::DataOut::ParallelData<DoFHandlerType::dimension, DoFHandlerType::space_dimension>  &scratch_data,
    const unsigned int                                            n_subdivisions,
-   const CurvedCellRegion                                        curved_cell_region);
+   const CurvedCellRegion                                        curved_cell_region,
+   const unsigned int                                            first_patch_index);
 };
 
 
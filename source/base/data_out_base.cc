@@ -35,8 +35,10 @@
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/parameter_handler.h>
 #include <deal.II/base/thread_management.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/mpi.h>
+#include <deal.II/base/timer.h>
 
 #include <cstring>
 #include <algorithm>
@@ -47,6 +49,8 @@
 #include <sstream>
 #include <fstream>
 #include <memory>
+#include <numeric>
+#include <cstdint>
 
 // we use uint32_t and uint8_t below, which are declared here:
 #include <stdint.h>
@@ -251,6 +255,119 @@ namespace
       }
   }
 
+  /**
+   * Do a base64 encoding of the given data and write it to the given
+   * stream. The data is split into segments whose lengths are multiples of
+   * three bytes, so that each segment maps to a separate range of the
+   * encoded output and the segments can be encoded in parallel.
+   */
+  void write_encoded_block (const char        *data,
+                            const std::size_t  data_size,
+                            std::ostream      &output_stream)
+  {
+    const std::size_t segment_size = 3*(1<<16);
+    const std::size_t n_segments = (data_size + segment_size - 1) / segment_size;
+
+    // every three bytes are encoded by four characters, with the last
+    // incomplete group padded
+    std::vector<char> encoded_data (4*((data_size+2)/3) + 1);
+    parallel::apply_to_subranges
+    (static_cast<std::size_t>(0), n_segments,
+     [&] (const std::size_t begin, const std::size_t end)
+    {
+      for (std::size_t segment=begin; segment<end; ++segment)
+        {
+          const std::size_t offset = segment*segment_size;
+          base64::base64_encodestate state;
+          base64::base64_init_encodestate(&state);
+          char *encoded_segment = &encoded_data[offset/3*4];
+          const int encoded_length
+            = base64::base64_encode_block (data + offset,
+                                           std::min (segment_size, data_size-offset),
+                                           encoded_segment, &state);
+          if (segment == n_segments-1)
+            base64::base64_encode_blockend (encoded_segment + encoded_length,
+                                            &state);
+        }
+    },
+    1);
+
+    output_stream.write (encoded_data.data(), encoded_data.size()-1);
+  }
+
+
+  /**
+   * Do a zlib compression of the given data and return the compression
+   * header of the VTK file format in @p compression_header and the
+   * compressed data in @p compressed_data.
+   *
+   * The data is split into blocks of 1 MiB that are compressed
+   * independently and in parallel, using the multi-block compression
+   * header of the VTK file format. Data that fits into one block results
+   * in the same output as compressing it in one piece.
+   */
+  template <typename T>
+  void compress_data (const std::vector<T>        &data,
+                      const DataOutBase::VtkFlags &flags,
+                      std::vector<uint32_t>       &compression_header,
+                      std::vector<char>           &compressed_data)
+  {
+    const std::size_t n_bytes = data.size() * sizeof(T);
+    const std::size_t block_size = 1<<20;
+    const std::size_t n_blocks = (n_bytes + block_size - 1) / block_size;
+    const char *uncompressed_data = reinterpret_cast<const char *>(data.data());
+
+    // compress the blocks in parallel
+    std::vector<std::vector<char> > compressed_blocks (n_blocks);
+    parallel::apply_to_subranges
+    (static_cast<std::size_t>(0), n_blocks,
+     [&] (const std::size_t begin, const std::size_t end)
+    {
+      for (std::size_t block=begin; block<end; ++block)
+        {
+          const std::size_t this_block_size
+            = std::min (block_size, n_bytes - block*block_size);
+          uLongf compressed_data_length = compressBound (this_block_size);
+          compressed_blocks[block].resize (compressed_data_length);
+          int err = compress2 ((Bytef *) compressed_blocks[block].data(),
+                               &compressed_data_length,
+                               (const Bytef *) (uncompressed_data + block*block_size),
+                               this_block_size,
+                               get_zlib_compression_level(flags.compression_level));
+          (void)err;
+          Assert (err == Z_OK, ExcInternalError());
+          compressed_blocks[block].resize (compressed_data_length);
+        }
+    },
+    1);
+
+    // the compression header consists of the number of blocks, the size of
+    // a block, the size of the last block, and the list of compressed sizes
+    // of blocks
+    compression_header.resize (3+n_blocks);
+    compression_header[0] = n_blocks;
+    compression_header[1] = std::min (block_size, n_bytes);
+    compression_header[2] = n_bytes - (n_blocks-1)*block_size;
+    std::size_t compressed_data_length = 0;
+    for (std::size_t block=0; block<n_blocks; ++block)
+      {
+        compression_header[3+block] = compressed_blocks[block].size();
+        compressed_data_length += compressed_blocks[block].size();
+      }
+
+    // the blocks form one contiguous stream of data
+    compressed_data.clear ();
+    compressed_data.reserve (compressed_data_length);
+    for (std::size_t block=0; block<n_blocks; ++block)
+      {
+        compressed_data.insert (compressed_data.end(),
+                                compressed_blocks[block].begin(),
+                                compressed_blocks[block].end());
+        std::vector<char>().swap (compressed_blocks[block]);
+      }
+  }
+
+
   /**
    * Do a zlib compression followed
    * by a base64 encoding of the
@@ -264,40 +381,54 @@ namespace
   {
     if (data.size() != 0)
       {
-        // allocate a buffer for compressing
-        // data and do so
-        uLongf compressed_data_length
-          = compressBound (data.size() * sizeof(T));
-        char *compressed_data = new char[compressed_data_length];
-        int err = compress2 ((Bytef *) compressed_data,
-                             &compressed_data_length,
-                             (const Bytef *) data.data(),
-                             data.size() * sizeof(T),
-                             get_zlib_compression_level(flags.compression_level));
-        (void)err;
-        Assert (err == Z_OK, ExcInternalError());
-
-        // now encode the compression header
-        const uint32_t compression_header[4]
-          = { 1,                                   /* number of blocks */
-              (uint32_t)(data.size() * sizeof(T)), /* size of block */
-              (uint32_t)(data.size() * sizeof(T)), /* size of last block */
-              (uint32_t)compressed_data_length
-            }; /* list of compressed sizes of blocks */
-
-        char *encoded_header = encode_block ((char *)&compression_header[0],
-                                             4 * sizeof(compression_header[0]));
+        std::vector<uint32_t> compression_header;
+        std::vector<char> compressed_data;
+        compress_data (data, flags, compression_header, compressed_data);
+
+        char *encoded_header = encode_block ((char *)compression_header.data(),
+                                             compression_header.size() * sizeof(compression_header[0]));
         output_stream << encoded_header;
         delete[] encoded_header;
 
-        // next do the compressed
-        // data encoding in base64
-        char *encoded_data = encode_block (compressed_data,
-                                           compressed_data_length);
-        delete[] compressed_data;
+        // the compressed data has to be encoded as a whole, separately from
+        // the header
+        write_encoded_block (compressed_data.data(), compressed_data.size(),
+                             output_stream);
+      }
+  }
+
 
-        output_stream << encoded_data;
-        delete[] encoded_data;
+  /**
+   * Do a zlib compression of the given data and append the compression
+   * header and the compressed data, without any encoding, to @p
+   * appended_data, as used for the raw encoding of the
+   * <tt>&lt;AppendedData&gt;</tt> section of VTU files.
+   */
+  template <typename T>
+  void append_compressed_block (const std::vector<T>        &data,
+                                const DataOutBase::VtkFlags &flags,
+                                std::vector<char>           &appended_data)
+  {
+    if (data.size() != 0)
+      {
+        std::vector<uint32_t> compression_header;
+        std::vector<char> compressed_data;
+        compress_data (data, flags, compression_header, compressed_data);
+
+        const char *header = reinterpret_cast<const char *>(compression_header.data());
+        appended_data.insert (appended_data.end(), header,
+                              header + compression_header.size() * sizeof(compression_header[0]));
+        appended_data.insert (appended_data.end(), compressed_data.begin(),
+                              compressed_data.end());
+      }
+    else
+      {
+        // the readers expect a header for every array in the appended
+        // section, even an empty one
+        const uint32_t compression_header[3] = {0, 0, 0};
+        const char *header = reinterpret_cast<const char *>(compression_header);
+        appended_data.insert (appended_data.end(), header,
+                              header + sizeof(compression_header));
       }
   }
 #endif
@@ -1105,8 +1236,14 @@ namespace
   class VtuStream : public StreamBase<DataOutBase::VtkFlags>
   {
   public:
+    /**
+     * Constructor. If @p appended_data is not a null pointer, the data
+     * blocks are not written to @p stream but appended, in raw binary
+     * form, to the given array.
+     */
     VtuStream (std::ostream &stream,
-               const DataOutBase::VtkFlags &flags);
+               const DataOutBase::VtkFlags &flags,
+               std::vector<char> *appended_data = nullptr);
 
     template <int dim>
     void write_point (const unsigned int index,
@@ -1165,6 +1302,12 @@ namespace
      */
     std::vector<float>  vertices;
     std::vector<int32_t> cells;
+
+    /**
+     * The array to which the data blocks are appended, or a null pointer
+     * if they are written to the stream.
+     */
+    std::vector<char> *appended_data;
   };
 
 
@@ -1507,9 +1650,11 @@ namespace
 
 
   VtuStream::VtuStream (std::ostream &out,
-                        const DataOutBase::VtkFlags &f)
+                        const DataOutBase::VtkFlags &f,
+                        std::vector<char> *appended_data)
     :
-    StreamBase<DataOutBase::VtkFlags> (out, f)
+    StreamBase<DataOutBase::VtkFlags> (out, f),
+    appended_data (appended_data)
   {}
 
 
@@ -1622,8 +1767,12 @@ namespace
     // compress the data we have in
     // memory and write them to the
     // stream. then release the data
-    write_compressed_block (data, flags, stream);
+    if (appended_data != nullptr)
+      append_compressed_block (data, flags, *appended_data);
+    else
+      write_compressed_block (data, flags, stream);
 #else
+    (void)appended_data;
     for (unsigned int i=0; i<data.size(); ++i)
       stream << data[i] << ' ';
 #endif
@@ -2286,16 +2435,35 @@ namespace DataOutBase
   VtkFlags::VtkFlags (const double time,
                       const unsigned int cycle,
                       const bool print_date_and_time,
-                      const VtkFlags::ZlibCompressionLevel compression_level)
+                      const VtkFlags::ZlibCompressionLevel compression_level,
+                      const bool appended_raw_data)
     :
     time (time),
     cycle (cycle),
     print_date_and_time (print_date_and_time),
-    compression_level (compression_level)
+    compression_level (compression_level),
+    appended_raw_data (appended_raw_data)
   {}
 
 
 
+  ParallelWriteStatistics::ParallelWriteStatistics ()
+    :
+    n_bytes (0),
+    n_aggregators (0),
+    wall_time (0.)
+  {}
+
+
+
+  double
+  ParallelWriteStatistics::bandwidth () const
+  {
+    return (wall_time > 0. ? n_bytes / wall_time : 0.);
+  }
+
+
+
   OutputFormat
   parse_output_format (const std::string &format_name)
   {
@@ -5192,9 +5360,24 @@ namespace DataOutBase
 
 
   void write_vtu_footer (std::ostream &out)
+  {
+    write_vtu_footer (out, std::vector<char>());
+  }
+
+
+
+  void write_vtu_footer (std::ostream            &out,
+                         const std::vector<char> &appended_data)
   {
     AssertThrow (out, ExcIO());
     out << " </UnstructuredGrid>\n";
+    if (appended_data.size() > 0)
+      {
+        // the raw data starts right after the underscore
+        out << "<AppendedData encoding=\"raw\">\n_";
+        out.write (appended_data.data(), appended_data.size());
+        out << "\n</AppendedData>\n";
+      }
     out << "</VTKFile>\n";
   }
 
@@ -5208,9 +5391,11 @@ namespace DataOutBase
              const VtkFlags                          &flags,
              std::ostream                            &out)
   {
+    std::vector<char> appended_data;
     write_vtu_header(out, flags);
-    write_vtu_main (patches, data_names, vector_data_ranges, flags, out);
-    write_vtu_footer(out);
+    write_vtu_main (patches, data_names, vector_data_ranges, flags, out,
+                    appended_data);
+    write_vtu_footer(out, appended_data);
 
     out << std::flush;
   }
@@ -5222,6 +5407,25 @@ namespace DataOutBase
                        const std::vector<std::tuple<unsigned int, unsigned int, std::string> > &vector_data_ranges,
                        const VtkFlags                          &flags,
                        std::ostream                            &out)
+  {
+    AssertThrow (flags.appended_raw_data == false,
+                 ExcMessage ("With VtkFlags::appended_raw_data set, the data "
+                             "has to be collected with the variant of "
+                             "write_vtu_main() that takes an array for the "
+                             "appended data."));
+    std::vector<char> appended_data;
+    write_vtu_main (patches, data_names, vector_data_ranges, flags, out,
+                    appended_data);
+  }
+
+
+  template <int dim, int spacedim>
+  void write_vtu_main (const std::vector<Patch<dim,spacedim> > &patches,
+                       const std::vector<std::string>          &data_names,
+                       const std::vector<std::tuple<unsigned int, unsigned int, std::string> > &vector_data_ranges,
+                       const VtkFlags                          &flags,
+                       std::ostream                            &out,
+                       std::vector<char>                       &appended_data)
   {
     AssertThrow (out, ExcIO());
 
@@ -5330,7 +5534,12 @@ namespace DataOutBase
     }
 
 
-    VtuStream vtu_out(out, flags);
+#ifdef DEAL_II_WITH_ZLIB
+    const bool append_data = flags.appended_raw_data;
+#else
+    const bool append_data = false;
+#endif
+    VtuStream vtu_out(out, flags, append_data ? &appended_data : nullptr);
 
     const unsigned int n_data_sets = data_names.size();
     // check against # of data sets in
@@ -5352,6 +5561,17 @@ namespace DataOutBase
     const char *ascii_or_binary = "ascii";
 #endif
 
+    // the format attribute of a data array. appended data is referenced by
+    // its offset in the appended section, which is where the next block
+    // will go
+    const auto data_format = [&] () -> std::string
+    {
+      if (append_data)
+        return "appended\" offset=\"" + Utilities::to_string (appended_data.size());
+      else
+        return ascii_or_binary;
+    };
+
 
     // first count the number of cells
     // and cells for later use
@@ -5399,7 +5619,7 @@ namespace DataOutBase
         <<"\" NumberOfCells=\"" << n_cells << "\" >\n";
     out << "  <Points>\n";
     out << "    <DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\""
-        << ascii_or_binary << "\">\n";
+        << data_format() << "\">\n";
     write_nodes(patches, vtu_out);
     out << "    </DataArray>\n";
     out << "  </Points>\n\n";
@@ -5407,7 +5627,7 @@ namespace DataOutBase
     // now for the cells
     out << "  <Cells>\n";
     out << "    <DataArray type=\"Int32\" Name=\"connectivity\" format=\""
-        << ascii_or_binary << "\">\n";
+        << data_format() << "\">\n";
     write_cells(patches, vtu_out);
     out << "    </DataArray>\n";
 
@@ -5416,7 +5636,7 @@ namespace DataOutBase
     // puts the number of nodes per cell in
     // front of the connectivity list.
     out << "    <DataArray type=\"Int32\" Name=\"offsets\" format=\""
-        << ascii_or_binary << "\">\n";
+        << data_format() << "\">\n";
 
     std::vector<int32_t> offsets (n_cells);
     for (unsigned int i=0; i<n_cells; ++i)
@@ -5429,7 +5649,7 @@ namespace DataOutBase
     // cells. since all cells are
     // the same, this is simple
     out << "    <DataArray type=\"UInt8\" Name=\"types\" format=\""
-        << ascii_or_binary << "\">\n";
+        << data_format() << "\">\n";
 
     {
       // uint8_t might be a typedef to unsigned
@@ -5511,7 +5731,7 @@ namespace DataOutBase
           }
 
         out << "\" NumberOfComponents=\"3\" format=\""
-            << ascii_or_binary << "\">\n";
+            << data_format() << "\">\n";
 
         // now write data. pad all
         // vectors to have three
@@ -5562,7 +5782,7 @@ namespace DataOutBase
           out << "    <DataArray type=\"Float32\" Name=\""
               << data_names[data_set]
               << "\" format=\""
-              << ascii_or_binary << "\">\n";
+              << data_format() << "\">\n";
 
           std::vector<float> data (data_vectors[data_set].begin(),
                                    data_vectors[data_set].end());
@@ -6606,22 +6826,164 @@ void DataOutInterface<dim,spacedim>::write_svg (std::ostream &out) const
 }
 
 template <int dim, int spacedim>
-void DataOutInterface<dim,spacedim>::write_vtu_in_parallel (const char *filename, MPI_Comm comm) const
+DataOutBase::ParallelWriteStatistics
+DataOutInterface<dim,spacedim>::write_vtu_in_parallel (const char        *filename,
+                                                       MPI_Comm           comm,
+                                                       const unsigned int n_aggregators) const
 {
+  DataOutBase::ParallelWriteStatistics statistics;
+
 #ifndef DEAL_II_WITH_MPI
   //without MPI fall back to the normal way to write a vtu file:
   (void)comm;
+  (void)n_aggregators;
 
+  std::ostringstream ss;
+  write_vtu (ss);
+
+  Timer timer;
   std::ofstream f(filename);
-  write_vtu (f);
+  f << ss.str();
+  f.close();
+  AssertThrow (f, ExcIO());
+  timer.stop();
+
+  statistics.n_bytes = ss.str().size();
+  statistics.n_aggregators = 1;
+  statistics.wall_time = timer.wall_time();
 #else
 
-  int myrank, nproc;
-  int ierr = MPI_Comm_rank(comm, &myrank);
+  AssertThrow (vtk_flags.appended_raw_data == false,
+               ExcMessage ("Appended data is not supported when writing "
+                           "one file from several processes."));
+
+  const unsigned int myrank = Utilities::MPI::this_mpi_process(comm);
+  const unsigned int nproc = Utilities::MPI::n_mpi_processes(comm);
+
+  // first generate this process's part of the file. the first process also
+  // writes the header and the last one the footer
+  std::string local_data;
+  {
+    std::ostringstream ss;
+    if (myrank == 0)
+      DataOutBase::write_vtu_header(ss, vtk_flags);
+    DataOutBase::write_vtu_main (get_patches(), get_dataset_names(),
+                                 get_vector_data_ranges(),
+                                 vtk_flags, ss);
+    if (myrank == nproc-1)
+      DataOutBase::write_vtu_footer(ss);
+    local_data = ss.str();
+  }
+
+  int ierr = MPI_Barrier(comm);
+  AssertThrowMPI(ierr);
+  Timer timer;
+
+  // the offset of each part in the file is the sum of the sizes of the parts
+  // of all processes before it
+  const std::uint64_t local_size = local_data.size();
+  std::uint64_t local_offset = 0;
+  ierr = MPI_Exscan (&local_size, &local_offset, 1, MPI_UINT64_T, MPI_SUM, comm);
+  AssertThrowMPI(ierr);
+  if (myrank == 0)
+    local_offset = 0;
+  const std::uint64_t total_size = Utilities::MPI::sum (local_size, comm);
+
+  // split the processes into contiguous groups, each with one aggregator
+  // that collects the data of its group. since the groups are contiguous,
+  // so is the data of each group in the file
+  const unsigned int n_groups = std::min (nproc,
+                                          (n_aggregators == 0 ?
+                                           std::max (nproc/16, 1U) :
+                                           n_aggregators));
+  const unsigned int my_group
+    = static_cast<unsigned int>(static_cast<std::uint64_t>(myrank) * n_groups / nproc);
+  MPI_Comm group_comm;
+  ierr = MPI_Comm_split (comm, my_group, myrank, &group_comm);
+  AssertThrowMPI(ierr);
+  const unsigned int group_rank = Utilities::MPI::this_mpi_process(group_comm);
+  const unsigned int group_size = Utilities::MPI::n_mpi_processes(group_comm);
+
+  // MPI_Gatherv counts and displacements are ints, so the data of a group
+  // is sent in rounds. in each round, every process sends at most
+  // max_round_size bytes of its part, which keeps the sum over the whole
+  // group, and so every displacement, below the largest int. all rounds end
+  // up one after the other in the aggregator's buffer
+  const std::uint64_t max_message_size = std::numeric_limits<int>::max();
+  const std::uint64_t max_round_size
+    = std::max<std::uint64_t> (max_message_size / group_size, 1);
+  const unsigned int n_rounds
+    = Utilities::MPI::max (static_cast<unsigned int>((local_size + max_round_size - 1) /
+                                                     max_round_size),
+                           group_comm);
+  std::vector<std::uint64_t> group_sizes (group_rank == 0 ? group_size : 0);
+  ierr = MPI_Gather (&local_size, 1, MPI_UINT64_T,
+                     group_sizes.data(), 1, MPI_UINT64_T, 0, group_comm);
+  AssertThrowMPI(ierr);
+
+  std::vector<char> group_data;
+  if (group_rank == 0)
+    {
+      std::uint64_t group_total = 0;
+      for (unsigned int p=0; p<group_size; ++p)
+        group_total += group_sizes[p];
+      group_data.resize (group_total);
+    }
+  std::vector<std::uint64_t> group_offsets (group_sizes.size());
+  for (unsigned int p=1; p<group_sizes.size(); ++p)
+    group_offsets[p] = group_offsets[p-1] + group_sizes[p-1];
+
+  std::vector<int> counts (group_sizes.size()), displacements (group_sizes.size());
+  for (unsigned int round=0; round<n_rounds; ++round)
+    {
+      // the part of each process sent in this round
+      const auto round_begin = [&] (const std::uint64_t size)
+      {
+        return std::min (size, round*max_round_size);
+      };
+      const auto round_end = [&] (const std::uint64_t size)
+      {
+        return std::min (size, (round+1)*max_round_size);
+      };
+
+      if (group_rank == 0)
+        {
+          std::uint64_t displacement = 0;
+          for (unsigned int p=0; p<group_size; ++p)
+            {
+              counts[p] = round_end(group_sizes[p]) - round_begin(group_sizes[p]);
+              displacements[p] = displacement;
+              displacement += counts[p];
+            }
+          Assert (displacement <= max_message_size, ExcInternalError());
+        }
+      std::vector<char> round_data (group_rank == 0 ?
+                                    std::accumulate (counts.begin(), counts.end(), std::uint64_t(0)) :
+                                    0);
+      ierr = MPI_Gatherv (const_cast<char *>(local_data.data()) + round_begin(local_size),
+                          round_end(local_size) - round_begin(local_size), MPI_CHAR,
+                          round_data.data(), counts.data(), displacements.data(), MPI_CHAR,
+                          0, group_comm);
+      AssertThrowMPI(ierr);
+
+      if (group_rank == 0)
+        for (unsigned int p=0; p<group_size; ++p)
+          std::copy (round_data.begin() + displacements[p],
+                     round_data.begin() + displacements[p] + counts[p],
+                     group_data.begin() + group_offsets[p] + round_begin(group_sizes[p]));
+    }
+  std::string().swap (local_data);
+
+  // the data of the group starts where the data of its first process goes
+  std::uint64_t group_offset = local_offset;
+  ierr = MPI_Bcast (&group_offset, 1, MPI_UINT64_T, 0, group_comm);
   AssertThrowMPI(ierr);
-  ierr = MPI_Comm_size(comm, &nproc);
+  ierr = MPI_Comm_free (&group_comm);
   AssertThrowMPI(ierr);
 
+  // now let the aggregators write their data. the other processes take part
+  // in the collective calls without writing anything. the number of bytes
+  // in a call is an int, so large buffers are written in several calls
   MPI_Info info;
   ierr = MPI_Info_create(&info);
   AssertThrowMPI(ierr);
@@ -6629,6 +6991,8 @@ void DataOutInterface<dim,spacedim>::write_vtu_in_parallel (const char *filename
   ierr = MPI_File_open(comm, const_cast<char *>(filename),
                        MPI_MODE_CREATE | MPI_MODE_WRONLY, info, &fh);
   AssertThrowMPI(ierr);
+  ierr = MPI_Info_free(&info);
+  AssertThrowMPI(ierr);
 
   ierr = MPI_File_set_size(fh, 0); // delete the file contents
   AssertThrowMPI(ierr);
@@ -6636,53 +7000,37 @@ void DataOutInterface<dim,spacedim>::write_vtu_in_parallel (const char *filename
   // write while one core is still setting the size to zero.
   ierr = MPI_Barrier(comm);
   AssertThrowMPI(ierr);
-  ierr = MPI_Info_free(&info);
-  AssertThrowMPI(ierr);
-
-  unsigned int header_size;
 
-  //write header
-  if (myrank==0)
+  const unsigned int n_writes
+    = Utilities::MPI::max (static_cast<unsigned int>((group_data.size() + max_message_size - 1) /
+                                                     max_message_size),
+                           comm);
+  for (unsigned int write=0; write<n_writes; ++write)
     {
-      std::stringstream ss;
-      DataOutBase::write_vtu_header(ss, vtk_flags);
-      header_size = ss.str().size();
-      ierr = MPI_File_write(fh, const_cast<char *>(ss.str().c_str()), header_size,
-                            MPI_CHAR, MPI_STATUS_IGNORE);
+      const std::uint64_t begin = std::min<std::uint64_t> (group_data.size(),
+                                                           write*max_message_size);
+      const std::uint64_t end = std::min<std::uint64_t> (group_data.size(),
+                                                         (write+1)*max_message_size);
+      ierr = MPI_File_write_at_all (fh, group_offset + begin,
+                                    group_data.data() + begin, end - begin,
+                                    MPI_CHAR, MPI_STATUS_IGNORE);
       AssertThrowMPI(ierr);
     }
 
-  ierr = MPI_Bcast(&header_size, 1, MPI_UNSIGNED, 0, comm);
-  AssertThrowMPI(ierr);
-
-  ierr = MPI_File_seek_shared( fh, header_size, MPI_SEEK_SET );
-  AssertThrowMPI(ierr);
-  {
-    std::stringstream ss;
-    DataOutBase::write_vtu_main (get_patches(), get_dataset_names(),
-                                 get_vector_data_ranges(),
-                                 vtk_flags, ss);
-    ierr = MPI_File_write_ordered(fh, const_cast<char *>(ss.str().c_str()),
-                                  ss.str().size(), MPI_CHAR, MPI_STATUS_IGNORE);
-    AssertThrowMPI(ierr);
-  }
-
-  //write footer
-  if (myrank==0)
-    {
-      std::stringstream ss;
-      DataOutBase::write_vtu_footer(ss);
-      unsigned int footer_size = ss.str().size();
-      ierr = MPI_File_write_shared(fh, const_cast<char *>(ss.str().c_str()),
-                                   footer_size, MPI_CHAR, MPI_STATUS_IGNORE);
-      AssertThrowMPI(ierr);
-    }
   ierr = MPI_File_close( &fh );
   AssertThrowMPI(ierr);
+  timer.stop();
+
+  statistics.n_bytes = total_size;
+  statistics.n_aggregators = n_groups;
+  statistics.wall_time = Utilities::MPI::max (timer.wall_time(), comm);
 #endif
+
+  return statistics;
 }
 
 
+
 template <int dim, int spacedim>
 void
 DataOutInterface<dim,spacedim>::write_pvtu_record (std::ostream &out,
@@ -6777,6 +7125,36 @@ create_xdmf_entry (const DataOutBase::DataOutFilter &data_filter,
     }
 }
 
+namespace
+{
+  /**
+   * Write the lines of an XDMF file that precede the entries of the time
+   * steps.
+   */
+  void write_xdmf_header (std::ostream &xdmf_file)
+  {
+    xdmf_file << "<?xml version=\"1.0\" ?>\n";
+    xdmf_file << "<!DOCTYPE Xdmf SYSTEM \"Xdmf.dtd\" []>\n";
+    xdmf_file << "<Xdmf Version=\"2.0\">\n";
+    xdmf_file << "  <Domain>\n";
+    xdmf_file << "    <Grid Name=\"CellTime\" GridType=\"Collection\" CollectionType=\"Temporal\">\n";
+  }
+
+
+
+  /**
+   * Write the closing tags of an XDMF file.
+   */
+  void write_xdmf_footer (std::ostream &xdmf_file)
+  {
+    xdmf_file << "    </Grid>\n";
+    xdmf_file << "  </Domain>\n";
+    xdmf_file << "</Xdmf>\n";
+  }
+}
+
+
+
 template <int dim, int spacedim>
 void DataOutInterface<dim,spacedim>::
 write_xdmf_file (const std::vector<XDMFEntry> &entries,
@@ -6799,19 +7177,13 @@ write_xdmf_file (const std::vector<XDMFEntry> &entries,
       std::ofstream                               xdmf_file(filename.c_str());
       std::vector<XDMFEntry>::const_iterator      it;
 
-      xdmf_file << "<?xml version=\"1.0\" ?>\n";
-      xdmf_file << "<!DOCTYPE Xdmf SYSTEM \"Xdmf.dtd\" []>\n";
-      xdmf_file << "<Xdmf Version=\"2.0\">\n";
-      xdmf_file << "  <Domain>\n";
-      xdmf_file << "    <Grid Name=\"CellTime\" GridType=\"Collection\" CollectionType=\"Temporal\">\n";
+      write_xdmf_header(xdmf_file);
 
       // Write out all the entries indented
       for (it=entries.begin(); it!=entries.end(); ++it)
         xdmf_file << it->get_xdmf_content(3);
 
-      xdmf_file << "    </Grid>\n";
-      xdmf_file << "  </Domain>\n";
-      xdmf_file << "</Xdmf>\n";
+      write_xdmf_footer(xdmf_file);
 
       xdmf_file.close();
     }
@@ -7495,6 +7867,15 @@ DataOutInterface<dim,spacedim>::get_vector_data_ranges () const
 }
 
 
+template <int dim, int spacedim>
+const DataOutBase::VtkFlags &
+DataOutInterface<dim,spacedim>::get_vtk_flags () const
+{
+  return vtk_flags;
+}
+
+
+
 template <int dim, int spacedim>
 void
 DataOutInterface<dim,spacedim>::
@@ -7833,6 +8214,20 @@ XDMFEntry::add_attribute(const std::string &attr_name, const unsigned int dimens
 
 
 
+void
+XDMFEntry::set_hdf5_groups(const std::string &mesh_group,
+                           const std::string &solution_group)
+{
+  Assert (mesh_group.empty() || mesh_group[0] == '/',
+          ExcMessage ("HDF5 group names need to start with a slash."));
+  Assert (solution_group.empty() || solution_group[0] == '/',
+          ExcMessage ("HDF5 group names need to start with a slash."));
+  h5_mesh_group = mesh_group;
+  h5_sol_group = solution_group;
+}
+
+
+
 namespace
 {
   /**
@@ -7859,7 +8254,7 @@ std::string XDMFEntry::get_xdmf_content(const unsigned int indent_level) const
   ss << indent(indent_level+1) << "<Time Value=\"" << entry_time << "\"/>\n";
   ss << indent(indent_level+1) << "<Geometry GeometryType=\"" << (space_dimension <= 2 ? "XY" : "XYZ" ) << "\">\n";
   ss << indent(indent_level+2) << "<DataItem Dimensions=\"" << num_nodes << " " << (space_dimension <= 2 ? 2 : space_dimension) << "\" NumberType=\"Float\" Precision=\"8\" Format=\"HDF\">\n";
-  ss << indent(indent_level+3) << h5_mesh_filename << ":/nodes\n";
+  ss << indent(indent_level+3) << h5_mesh_filename << ":" << h5_mesh_group << "/nodes\n";
   ss << indent(indent_level+2) << "</DataItem>\n";
   ss << indent(indent_level+1) << "</Geometry>\n";
   // If we have cells defined, use the topology corresponding to the dimension
@@ -7875,7 +8270,7 @@ std::string XDMFEntry::get_xdmf_content(const unsigned int indent_level) const
         ss << indent(indent_level+1) << "<Topology TopologyType=\"" << "Hexahedron"   << "\" NumberOfElements=\"" << num_cells << "\">\n";
 
       ss << indent(indent_level+2) << "<DataItem Dimensions=\"" << num_cells << " " << (1 << dimension) << "\" NumberType=\"UInt\" Format=\"HDF\">\n";
-      ss << indent(indent_level+3) << h5_mesh_filename << ":/cells\n";
+      ss << indent(indent_level+3) << h5_mesh_filename << ":" << h5_mesh_group << "/cells\n";
       ss << indent(indent_level+2) << "</DataItem>\n";
       ss << indent(indent_level+1) << "</Topology>\n";
     }
@@ -7892,7 +8287,7 @@ std::string XDMFEntry::get_xdmf_content(const unsigned int indent_level) const
       ss << indent(indent_level+1) << "<Attribute Name=\"" << it->first << "\" AttributeType=\"" << (it->second > 1 ? "Vector" : "Scalar") << "\" Center=\"Node\">\n";
       // Vectors must have 3 elements even for 2D models
       ss << indent(indent_level+2) << "<DataItem Dimensions=\"" << num_nodes << " " << (it->second > 1 ? 3 : 1) << "\" NumberType=\"Float\" Precision=\"8\" Format=\"HDF\">\n";
-      ss << indent(indent_level+3) << h5_sol_filename << ":/" << it->first << "\n";
+      ss << indent(indent_level+3) << h5_sol_filename << ":" << h5_sol_group << "/" << it->first << "\n";
       ss << indent(indent_level+2) << "</DataItem>\n";
       ss << indent(indent_level+1) << "</Attribute>\n";
     }
@@ -7904,6 +8299,358 @@ std::string XDMFEntry::get_xdmf_content(const unsigned int indent_level) const
 
 
 
+// ---------------------------------------------- HDF5TimeSeriesWriter ----------
+
+HDF5TimeSeriesWriter::AdditionalData::AdditionalData (const unsigned int compression_level,
+                                                      const bool         shuffle,
+                                                      const unsigned int chunk_size,
+                                                      const bool         filter_duplicate_vertices)
+  :
+  compression_level (compression_level),
+  shuffle (shuffle),
+  chunk_size (chunk_size),
+  filter_duplicate_vertices (filter_duplicate_vertices)
+{}
+
+
+
+HDF5TimeSeriesWriter::HDF5TimeSeriesWriter (const std::string    &h5_filename,
+                                            const std::string    &xdmf_filename,
+                                            const MPI_Comm       &comm,
+                                            const AdditionalData &additional_data)
+  :
+  h5_filename (h5_filename),
+  xdmf_filename (xdmf_filename),
+  comm (comm),
+  additional_data (additional_data),
+  n_written_steps (0),
+  xdmf_footer_position (0),
+  n_written_meshes (0),
+  last_mesh_hash (0)
+{
+  AssertThrow (additional_data.compression_level <= 9,
+               ExcMessage ("The compression level of the deflate filter must be "
+                           "between 0 (no compression) and 9."));
+  AssertThrow (additional_data.chunk_size > 0,
+               ExcMessage ("The chunk size must be positive."));
+}
+
+
+
+unsigned int
+HDF5TimeSeriesWriter::n_time_steps () const
+{
+  return n_written_steps;
+}
+
+
+
+unsigned int
+HDF5TimeSeriesWriter::n_meshes () const
+{
+  return n_written_meshes;
+}
+
+
+
+#ifdef DEAL_II_WITH_HDF5
+namespace
+{
+  /**
+   * Combine the bytes of the given array into the hash value @p seed,
+   * using the FNV-1a algorithm.
+   */
+  template <typename T>
+  void hash_combine_array (std::size_t          &seed,
+                           const std::vector<T> &values)
+  {
+    std::uint64_t hash = 14695981039346656037ULL ^ seed ^ values.size();
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(values.data());
+    for (std::size_t i=0; i<values.size()*sizeof(T); ++i)
+      {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+      }
+    seed = static_cast<std::size_t>(hash);
+  }
+
+
+
+  /**
+   * Create a two-dimensional data set of size @p global_rows times
+   * @p n_columns with the given @p name at @p location, and write the
+   * @p local_rows rows in @p data owned by the current process into it,
+   * starting at row @p row_offset. The data set is chunked and filtered as
+   * requested in @p additional_data unless @p use_filters is false.
+   */
+  void write_hdf5_data_set (const hid_t                                  location,
+                            const std::string                           &name,
+                            const hid_t                                  type,
+                            const hsize_t                                global_rows,
+                            const hsize_t                                local_rows,
+                            const hsize_t                                row_offset,
+                            const hsize_t                                n_columns,
+                            const void                                  *data,
+                            const HDF5TimeSeriesWriter::AdditionalData &additional_data,
+                            const bool                                   use_filters,
+                            const hid_t                                  transfer_plist_id)
+  {
+    herr_t status;
+
+    // Chunks are only allowed for non-empty data sets, and they are a
+    // prerequisite for any filters
+    const hid_t create_plist_id = H5Pcreate(H5P_DATASET_CREATE);
+    AssertThrow(create_plist_id >= 0, ExcIO());
+    if (global_rows > 0)
+      {
+        const hsize_t chunk_dims[2] = { std::min<hsize_t>(additional_data.chunk_size, global_rows),
+                                        n_columns
+                                      };
+        status = H5Pset_chunk(create_plist_id, 2, chunk_dims);
+        AssertThrow(status >= 0, ExcIO());
+
+        if (use_filters && additional_data.compression_level > 0)
+          {
+            if (additional_data.shuffle)
+              {
+                status = H5Pset_shuffle(create_plist_id);
+                AssertThrow(status >= 0, ExcIO());
+              }
+            status = H5Pset_deflate(create_plist_id, additional_data.compression_level);
+            AssertThrow(status >= 0, ExcIO());
+          }
+      }
+
+    const hsize_t dims[2] = { global_rows, n_columns };
+    const hid_t file_dataspace = H5Screate_simple(2, dims, nullptr);
+    AssertThrow(file_dataspace >= 0, ExcIO());
+
+#if H5Gcreate_vers == 1
+    const hid_t dataset = H5Dcreate(location, name.c_str(), type, file_dataspace, create_plist_id);
+#else
+    const hid_t dataset = H5Dcreate(location, name.c_str(), type, file_dataspace, H5P_DEFAULT, create_plist_id, H5P_DEFAULT);
+#endif
+    AssertThrow(dataset >= 0, ExcIO());
+
+    // Select the rows of this process in the file. Processes without any
+    // rows still need to take part in the collective write, with an empty
+    // selection
+    const hsize_t count[2] = { local_rows, n_columns };
+    const hsize_t offset[2] = { row_offset, 0 };
+    const hid_t memory_dataspace = H5Screate_simple(2, count, nullptr);
+    AssertThrow(memory_dataspace >= 0, ExcIO());
+    if (local_rows > 0)
+      status = H5Sselect_hyperslab(file_dataspace, H5S_SELECT_SET, offset, nullptr, count, nullptr);
+    else
+      {
+        status = H5Sselect_none(file_dataspace);
+        AssertThrow(status >= 0, ExcIO());
+        status = H5Sselect_none(memory_dataspace);
+      }
+    AssertThrow(status >= 0, ExcIO());
+
+    status = H5Dwrite(dataset, type, memory_dataspace, file_dataspace, transfer_plist_id, data);
+    AssertThrow(status >= 0, ExcIO());
+
+    status = H5Sclose(memory_dataspace);
+    AssertThrow(status >= 0, ExcIO());
+    status = H5Sclose(file_dataspace);
+    AssertThrow(status >= 0, ExcIO());
+    status = H5Dclose(dataset);
+    AssertThrow(status >= 0, ExcIO());
+    status = H5Pclose(create_plist_id);
+    AssertThrow(status >= 0, ExcIO());
+  }
+
+
+
+  /**
+   * Create a group with the given name in the HDF5 file @p file_id.
+   */
+  hid_t create_hdf5_group (const hid_t        file_id,
+                           const std::string &name)
+  {
+#if H5Gcreate_vers == 1
+    const hid_t group_id = H5Gcreate(file_id, name.c_str(), 0);
+#else
+    const hid_t group_id = H5Gcreate(file_id, name.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+#endif
+    AssertThrow(group_id >= 0, ExcIO());
+    return group_id;
+  }
+}
+#endif
+
+
+
+template <int dim, int spacedim>
+void
+HDF5TimeSeriesWriter::write_time_step (const DataOutInterface<dim,spacedim> &data_out,
+                                       const double                          time)
+{
+  AssertThrow(spacedim>=2,
+              ExcMessage("HDF5TimeSeriesWriter was asked to write HDF5 output for a space dimension of 1. "
+                         "HDF5 only supports datasets that live in 2 or 3 dimensions."));
+
+#ifndef DEAL_II_WITH_HDF5
+  // throw an exception, but first make sure the compiler does not warn about
+  // the now unused function arguments
+  (void)data_out;
+  (void)time;
+  AssertThrow(false, ExcMessage ("HDF5 support is disabled."));
+#else
+  DataOutBase::DataOutFilter data_filter
+  (DataOutBase::DataOutFilterFlags(additional_data.filter_duplicate_vertices, true));
+  data_out.write_filtered_data(data_filter);
+
+  const unsigned int n_processes = Utilities::MPI::n_mpi_processes(comm);
+
+  // If HDF5 is not parallel and we're using multiple processes, abort
+#ifndef H5_HAVE_PARALLEL
+  AssertThrow (n_processes <= 1,
+               ExcMessage ("Serial HDF5 output on multiple processes is not yet supported."));
+#endif
+
+  // Filters require chunked data sets, which older versions of HDF5 cannot
+  // write in parallel. Fall back to uncompressed data sets in that case
+#if defined(DEAL_II_WITH_MPI) && defined(H5_HAVE_PARALLEL) && !H5_VERSION_GE(1,10,2)
+  const bool use_filters = (n_processes == 1);
+#else
+  const bool use_filters = true;
+  (void)n_processes;
+#endif
+
+  // Compute the global number of nodes and cells and the offsets of the
+  // data of this process
+  unsigned int local_node_cell_count[2], global_node_cell_count[2], global_node_cell_offsets[2];
+  local_node_cell_count[0] = data_filter.n_nodes();
+  local_node_cell_count[1] = data_filter.n_cells();
+#ifdef DEAL_II_WITH_MPI
+  int ierr = MPI_Allreduce(local_node_cell_count, global_node_cell_count, 2, MPI_UNSIGNED, MPI_SUM, comm);
+  AssertThrowMPI(ierr);
+  ierr = MPI_Scan(local_node_cell_count, global_node_cell_offsets, 2, MPI_UNSIGNED, MPI_SUM, comm);
+  AssertThrowMPI(ierr);
+  global_node_cell_offsets[0] -= local_node_cell_count[0];
+  global_node_cell_offsets[1] -= local_node_cell_count[1];
+#else
+  global_node_cell_count[0] = local_node_cell_count[0];
+  global_node_cell_count[1] = local_node_cell_count[1];
+  global_node_cell_offsets[0] = global_node_cell_offsets[1] = 0;
+#endif
+
+  // Determine whether the mesh has changed since the last step on any
+  // process. The connectivity is hashed with local vertex numbers so that
+  // changes on other processes do not affect the hash on this one
+  std::vector<double>       node_data_vec;
+  std::vector<unsigned int> cell_data_vec;
+  data_filter.fill_node_data(node_data_vec);
+  data_filter.fill_cell_data(0, cell_data_vec);
+
+  std::size_t mesh_hash = 0;
+  hash_combine_array(mesh_hash, node_data_vec);
+  hash_combine_array(mesh_hash, cell_data_vec);
+  const bool write_mesh
+    = (n_written_meshes == 0)
+      ||
+      (Utilities::MPI::max(mesh_hash != last_mesh_hash ? 1U : 0U, comm) == 1);
+  last_mesh_hash = mesh_hash;
+
+  herr_t status;
+
+  // Create the file at the first step, and add to it afterwards
+  const hid_t file_plist_id = H5Pcreate(H5P_FILE_ACCESS);
+  AssertThrow(file_plist_id >= 0, ExcIO());
+  const hid_t transfer_plist_id = H5Pcreate(H5P_DATASET_XFER);
+  AssertThrow(transfer_plist_id >= 0, ExcIO());
+#ifdef DEAL_II_WITH_MPI
+#ifdef H5_HAVE_PARALLEL
+  status = H5Pset_fapl_mpio(file_plist_id, comm, MPI_INFO_NULL);
+  AssertThrow(status >= 0, ExcIO());
+  status = H5Pset_dxpl_mpio(transfer_plist_id, H5FD_MPIO_COLLECTIVE);
+  AssertThrow(status >= 0, ExcIO());
+#endif
+#endif
+
+  const hid_t file_id = (n_written_steps == 0
+                         ?
+                         H5Fcreate(h5_filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, file_plist_id)
+                         :
+                         H5Fopen(h5_filename.c_str(), H5F_ACC_RDWR, file_plist_id));
+  AssertThrow(file_id >= 0, ExcIO());
+
+  if (write_mesh)
+    {
+      const hid_t mesh_group_id = create_hdf5_group(file_id, "/mesh_" + Utilities::int_to_string(n_written_meshes));
+
+      // HDF5 only supports 2- or 3-dimensional coordinates
+      write_hdf5_data_set(mesh_group_id, "nodes", H5T_NATIVE_DOUBLE,
+                          global_node_cell_count[0], local_node_cell_count[0],
+                          global_node_cell_offsets[0], (spacedim<2) ? 2 : spacedim,
+                          node_data_vec.data(), additional_data, use_filters,
+                          transfer_plist_id);
+
+      data_filter.fill_cell_data(global_node_cell_offsets[0], cell_data_vec);
+      write_hdf5_data_set(mesh_group_id, "cells", H5T_NATIVE_UINT,
+                          global_node_cell_count[1], local_node_cell_count[1],
+                          global_node_cell_offsets[1], GeometryInfo<dim>::vertices_per_cell,
+                          cell_data_vec.data(), additional_data, use_filters,
+                          transfer_plist_id);
+
+      status = H5Gclose(mesh_group_id);
+      AssertThrow(status >= 0, ExcIO());
+      ++n_written_meshes;
+    }
+  node_data_vec.clear();
+  cell_data_vec.clear();
+
+  const std::string step_group = "/step_" + Utilities::int_to_string(n_written_steps);
+  const hid_t step_group_id = create_hdf5_group(file_id, step_group);
+  for (unsigned int i=0; i<data_filter.n_data_sets(); ++i)
+    write_hdf5_data_set(step_group_id, data_filter.get_data_set_name(i), H5T_NATIVE_DOUBLE,
+                        global_node_cell_count[0], local_node_cell_count[0],
+                        global_node_cell_offsets[0], data_filter.get_data_set_dim(i),
+                        data_filter.get_data_set(i), additional_data, use_filters,
+                        transfer_plist_id);
+
+  status = H5Gclose(step_group_id);
+  AssertThrow(status >= 0, ExcIO());
+  status = H5Pclose(transfer_plist_id);
+  AssertThrow(status >= 0, ExcIO());
+  status = H5Pclose(file_plist_id);
+  AssertThrow(status >= 0, ExcIO());
+  status = H5Fclose(file_id);
+  AssertThrow(status >= 0, ExcIO());
+
+  // Finally, add the step to the XDMF file. The entry replaces the closing
+  // tags, which are written again after it, so that the file is complete at
+  // any time without rewriting the entries of the previous steps
+  XDMFEntry entry = data_out.create_xdmf_entry(data_filter, h5_filename, time, comm);
+  entry.set_hdf5_groups("/mesh_" + Utilities::int_to_string(n_written_meshes-1), step_group);
+  if (Utilities::MPI::this_mpi_process(comm) == 0)
+    {
+      std::fstream xdmf_file;
+      if (n_written_steps == 0)
+        {
+          xdmf_file.open(xdmf_filename.c_str(), std::ios::out | std::ios::trunc);
+          write_xdmf_header(xdmf_file);
+        }
+      else
+        {
+          xdmf_file.open(xdmf_filename.c_str(), std::ios::in | std::ios::out);
+          xdmf_file.seekp(xdmf_footer_position);
+        }
+      xdmf_file << entry.get_xdmf_content(3);
+      xdmf_footer_position = xdmf_file.tellp();
+      write_xdmf_footer(xdmf_file);
+      xdmf_file.close();
+      AssertThrow(xdmf_file, ExcIO());
+    }
+  ++n_written_steps;
+#endif
+}
+
+
+
 namespace DataOutBase
 {
   template <int dim, int spacedim>
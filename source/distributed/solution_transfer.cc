@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2009 - 2017 by the deal.II authors
+// Copyright (C) 2009 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -35,6 +35,7 @@
 #include <deal.II/grid/tria_iterator.h>
 
 #include <functional>
+#include <cstring>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -147,6 +148,77 @@ namespace parallel
     }
 
 
+    template <int dim, typename VectorType, typename DoFHandlerType>
+    void
+    SolutionTransfer<dim, VectorType, DoFHandlerType>::
+    prepare_checkpoint (const std::vector<const VectorType *> &all_in)
+    {
+      Assert(all_in.size() > 0, ExcMessage("Please transfer at least one vector!"));
+      input_vectors = all_in;
+
+//TODO: casting away constness is bad
+      parallel::distributed::Triangulation<dim,DoFHandlerType::space_dimension> *tria
+        = (dynamic_cast<parallel::distributed::Triangulation<dim,DoFHandlerType::space_dimension>*>
+           (const_cast<dealii::Triangulation<dim,DoFHandlerType::space_dimension>*>
+            (&dof_handler->get_triangulation())));
+      Assert (tria != nullptr, ExcInternalError());
+
+      tria->register_checkpoint_data_attach(std::bind(&SolutionTransfer<dim, VectorType,
+                                                      DoFHandlerType>::pack_checkpoint_callback,
+                                                      this,
+                                                      std::placeholders::_1,
+                                                      std::placeholders::_2));
+    }
+
+
+
+    template <int dim, typename VectorType, typename DoFHandlerType>
+    void
+    SolutionTransfer<dim, VectorType, DoFHandlerType>::prepare_checkpoint (const VectorType &in)
+    {
+      std::vector<const VectorType *> all_in(1, &in);
+      prepare_checkpoint(all_in);
+    }
+
+
+
+    template <int dim, typename VectorType, typename DoFHandlerType>
+    void
+    SolutionTransfer<dim, VectorType, DoFHandlerType>::restore_checkpoint (std::vector<VectorType *> &all_out)
+    {
+//TODO: casting away constness is bad
+      parallel::distributed::Triangulation<dim,DoFHandlerType::space_dimension> *tria
+        = (dynamic_cast<parallel::distributed::Triangulation<dim,DoFHandlerType::space_dimension>*>
+           (const_cast<dealii::Triangulation<dim,DoFHandlerType::space_dimension>*>
+            (&dof_handler->get_triangulation())));
+      Assert (tria != nullptr, ExcInternalError());
+
+      tria->notify_ready_to_unpack_checkpoint(std::bind(&SolutionTransfer<dim, VectorType,
+                                                        DoFHandlerType>::unpack_checkpoint_callback,
+                                                        this,
+                                                        std::placeholders::_1,
+                                                        std::placeholders::_2,
+                                                        std::placeholders::_3,
+                                                        std::ref(all_out)));
+
+      for (typename std::vector<VectorType *>::iterator it=all_out.begin();
+           it !=all_out.end();
+           ++it)
+        (*it)->compress(::dealii::VectorOperation::insert);
+    }
+
+
+
+    template <int dim, typename VectorType, typename DoFHandlerType>
+    void
+    SolutionTransfer<dim, VectorType, DoFHandlerType>::restore_checkpoint (VectorType &out)
+    {
+      std::vector<VectorType *> all_out(1, &out);
+      restore_checkpoint(all_out);
+    }
+
+
+
     template <int dim, typename VectorType, typename DoFHandlerType>
     void
     SolutionTransfer<dim, VectorType, DoFHandlerType>::interpolate (std::vector<VectorType *> &all_out)
@@ -249,6 +321,58 @@ namespace parallel
     }
 
 
+
+    template <int dim, typename VectorType, typename DoFHandlerType>
+    void
+    SolutionTransfer<dim, VectorType, DoFHandlerType>::
+    pack_checkpoint_callback(const typename Triangulation<dim,DoFHandlerType::space_dimension>::cell_iterator &cell_,
+                             std::vector<char> &data)
+    {
+      typename DoFHandlerType::cell_iterator cell(*cell_, dof_handler);
+
+      // only store as many values as the element on this cell has
+      const unsigned int dofs_per_cell=cell->get_fe().dofs_per_cell;
+      const std::size_t bytes_per_vector = sizeof(typename VectorType::value_type)*dofs_per_cell;
+      const std::size_t start = data.size();
+      data.resize (start + bytes_per_vector * input_vectors.size());
+
+      ::dealii::Vector<typename VectorType::value_type> dofvalues(dofs_per_cell);
+      for (unsigned int i=0; i<input_vectors.size(); ++i)
+        {
+          cell->get_interpolated_dof_values(*input_vectors[i], dofvalues);
+          std::memcpy(data.data() + start + i*bytes_per_vector, dofvalues.begin(), bytes_per_vector);
+        }
+    }
+
+
+
+    template <int dim, typename VectorType, typename DoFHandlerType>
+    void
+    SolutionTransfer<dim, VectorType, DoFHandlerType>::unpack_checkpoint_callback
+    (const typename Triangulation<dim,DoFHandlerType::space_dimension>::cell_iterator &cell_,
+     const char                                           *begin,
+     const char                                           *end,
+     std::vector<VectorType *>                            &all_out)
+    {
+      typename DoFHandlerType::cell_iterator
+      cell(*cell_, dof_handler);
+
+      const unsigned int dofs_per_cell=cell->get_fe().dofs_per_cell;
+      const std::size_t bytes_per_vector = sizeof(typename VectorType::value_type)*dofs_per_cell;
+      AssertThrow(static_cast<std::size_t>(end - begin) == bytes_per_vector * all_out.size(),
+                  ExcMessage("The data stored in the checkpoint for a cell does not match the "
+                             "number of vectors to be restored and the number of degrees of "
+                             "freedom on this cell."));
+
+      ::dealii::Vector<typename VectorType::value_type> dofvalues(dofs_per_cell);
+      for (unsigned int i=0; i<all_out.size(); ++i)
+        {
+          std::memcpy(dofvalues.begin(), begin + i*bytes_per_vector, bytes_per_vector);
+          cell->set_dof_values_by_interpolation(dofvalues, *all_out[i]);
+        }
+    }
+
+
   }
 }
 
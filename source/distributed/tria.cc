@@ -26,10 +26,13 @@
 #include <deal.II/distributed/tria.h>
 #include <deal.II/distributed/p4est_wrappers.h>
 
+#include <boost/crc.hpp>
+
 #include <algorithm>
 #include <numeric>
 #include <iostream>
 #include <fstream>
+#include <cstring>
 
 
 DEAL_II_NAMESPACE_OPEN
@@ -1261,6 +1264,156 @@ namespace
     // get the weight, increment the pointer, and return the weight
     return *this_object->current_pointer++;
   }
+
+
+
+  /**
+   * Collect the locally owned active cells in the subtree of @p cell, in the
+   * order in which p4est stores the corresponding quadrants. Since the
+   * children of a quadrant in p4est are numbered in the same way as the
+   * children of a cell in deal.II, this is simply a depth-first traversal.
+   */
+  template <int dim, int spacedim>
+  void
+  get_locally_owned_cells_recursively (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                       std::vector<typename Triangulation<dim,spacedim>::cell_iterator> &cells)
+  {
+    if (cell->has_children())
+      for (unsigned int c=0; c<GeometryInfo<dim>::max_children_per_cell; ++c)
+        get_locally_owned_cells_recursively<dim,spacedim> (cell->child(c), cells);
+    else if (cell->is_locally_owned())
+      cells.push_back (cell);
+  }
+
+
+
+  /**
+   * Return the locally owned active cells of @p triangulation in the order
+   * in which p4est stores the corresponding quadrants.
+   */
+  template <int dim, int spacedim>
+  std::vector<typename Triangulation<dim,spacedim>::cell_iterator>
+  get_locally_owned_cells_in_forest_order (const parallel::distributed::Triangulation<dim,spacedim> &triangulation)
+  {
+    const std::vector<types::global_dof_index> &tree_to_coarse_cell
+      = triangulation.get_p4est_tree_to_coarse_cell_permutation();
+
+    std::vector<typename Triangulation<dim,spacedim>::cell_iterator> cells;
+    cells.reserve (triangulation.n_locally_owned_active_cells());
+    for (unsigned int tree=0; tree<tree_to_coarse_cell.size(); ++tree)
+      get_locally_owned_cells_recursively<dim,spacedim>
+      (typename Triangulation<dim,spacedim>::cell_iterator (&triangulation, 0, tree_to_coarse_cell[tree]),
+       cells);
+    return cells;
+  }
+
+
+
+  /**
+   * The header at the beginning of a file written by
+   * parallel::distributed::Triangulation::save_checkpoint(). It is
+   * followed by the offsets of the data of every cell and registered
+   * function relative to the beginning of the data, stored as
+   * <tt>n_cells*n_attachments+1</tt> unsigned 64-bit integers, and by the
+   * data itself.
+   */
+  struct CheckpointHeader
+  {
+    char          magic[16];
+    std::uint64_t version;
+    std::uint64_t dimension;
+    std::uint64_t space_dimension;
+    std::uint64_t n_processes;
+    std::uint64_t n_coarse_cells;
+    std::uint64_t n_cells;
+    std::uint64_t n_attachments;
+    std::uint64_t mesh_checksum;
+    std::uint64_t data_checksum;
+  };
+
+  const char          checkpoint_magic[16] = "deal.II ckpt";
+  const std::uint64_t checkpoint_version = 1;
+
+  /**
+   * The maximal number of bytes a process reads or writes in one collective
+   * MPI-IO call, since the number of elements is passed as an int.
+   */
+  const std::uint64_t checkpoint_max_io_size = std::uint64_t(1) << 30;
+
+
+
+  /**
+   * Return the contribution of the data in <tt>[begin,end)</tt>, stored at
+   * position @p index of the offset table, to the check sum of a checkpoint.
+   * The contributions are summed up over all positions, which makes the
+   * check sum independent of the partition of the cells among the processes
+   * while still detecting data that has been swapped between positions.
+   */
+  std::uint64_t
+  checkpoint_checksum (const std::uint64_t  index,
+                       const char          *begin,
+                       const char          *end)
+  {
+    boost::crc_32_type crc;
+    crc.process_block (begin, end);
+    return (static_cast<std::uint64_t>(crc.checksum()) + 1) * (2*index + 1);
+  }
+
+
+
+  /**
+   * Write @p size bytes at the given offset of a file, using as many
+   * collective calls as the process with the most data needs.
+   */
+  void
+  checkpoint_write_at_all (MPI_File             fh,
+                           const MPI_Offset     offset,
+                           const char          *data,
+                           const std::uint64_t  size,
+                           const MPI_Comm       comm)
+  {
+    const std::uint64_t n_rounds
+      = Utilities::MPI::max (static_cast<unsigned int>((size + checkpoint_max_io_size - 1) /
+                                                       checkpoint_max_io_size),
+                             comm);
+    for (std::uint64_t round=0; round<n_rounds; ++round)
+      {
+        const std::uint64_t begin = std::min (size, round*checkpoint_max_io_size);
+        const std::uint64_t end = std::min (size, begin+checkpoint_max_io_size);
+        const int ierr = MPI_File_write_at_all (fh, offset + begin,
+                                                const_cast<char *>(data) + begin, end - begin,
+                                                MPI_CHAR, MPI_STATUS_IGNORE);
+        AssertThrowMPI(ierr);
+      }
+  }
+
+
+
+  /**
+   * Read @p size bytes at the given offset of a file, using as many
+   * collective calls as the process with the most data needs.
+   */
+  void
+  checkpoint_read_at_all (MPI_File             fh,
+                          const MPI_Offset     offset,
+                          char                *data,
+                          const std::uint64_t  size,
+                          const MPI_Comm       comm)
+  {
+    const std::uint64_t n_rounds
+      = Utilities::MPI::max (static_cast<unsigned int>((size + checkpoint_max_io_size - 1) /
+                                                       checkpoint_max_io_size),
+                             comm);
+    for (std::uint64_t round=0; round<n_rounds; ++round)
+      {
+        const std::uint64_t begin = std::min (size, round*checkpoint_max_io_size);
+        const std::uint64_t end = std::min (size, begin+checkpoint_max_io_size);
+        const int ierr = MPI_File_read_at_all (fh, offset + begin,
+                                               data + begin, end - begin,
+                                               MPI_CHAR, MPI_STATUS_IGNORE);
+        AssertThrowMPI(ierr);
+      }
+  }
 }
 
 
@@ -1294,7 +1447,9 @@ namespace parallel
       parallel_forest (nullptr),
       attached_data_size(0),
       n_attached_datas(0),
-      n_attached_deserialize(0)
+      n_attached_deserialize(0),
+      n_checkpoint_attachments(0),
+      n_checkpoint_attachments_unpacked(0)
     {
       parallel_ghost = nullptr;
     }
@@ -1906,6 +2061,307 @@ namespace parallel
 
 
 
+    template <int dim, int spacedim>
+    void
+    Triangulation<dim,spacedim>::
+    register_checkpoint_data_attach (const std::function<void (const cell_iterator &,
+                                                               std::vector<char> &)> &pack_callback)
+    {
+      checkpoint_pack_callbacks.push_back (pack_callback);
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    Triangulation<dim,spacedim>::
+    save_checkpoint (const std::string &filename) const
+    {
+      Assert (n_checkpoint_attachments_unpacked == n_checkpoint_attachments,
+              ExcMessage ("Not all data of the last checkpoint has been unpacked "
+                          "after the last call to load_checkpoint()."));
+      Assert (this->n_cells()>0,
+              ExcMessage("Can not save a checkpoint of an empty Triangulation."));
+
+      // signal that serialization is going to happen
+      this->signals.pre_distributed_save();
+
+      // the refinement information is stored by p4est, without any data
+      // attached to the quadrants
+      dealii::internal::p4est::functions<dim>::save((filename+".mesh").c_str(),
+                                                    parallel_forest, false);
+
+      // collect the data of the locally owned cells, in the order of the
+      // forest, by letting the callbacks append to a single buffer. the
+      // offsets are relative to the data of this process for now
+      const std::vector<cell_iterator> cells
+        = get_locally_owned_cells_in_forest_order (*this);
+
+      const std::uint64_t n_attachments = checkpoint_pack_callbacks.size();
+      const std::uint64_t first_index
+        = parallel_forest->global_first_quadrant[this->my_subdomain] * n_attachments;
+      std::vector<std::uint64_t> offsets (cells.size()*n_attachments+1, 0);
+      std::vector<char>          data;
+      std::uint64_t              local_data_checksum = 0;
+      for (unsigned int c=0; c<cells.size(); ++c)
+        for (unsigned int a=0; a<n_attachments; ++a)
+          {
+            const std::uint64_t index = c*n_attachments + a;
+            checkpoint_pack_callbacks[a] (cells[c], data);
+            Assert (data.size() >= offsets[index],
+                    ExcMessage ("The callback must not remove data from the buffer."));
+            local_data_checksum += checkpoint_checksum (first_index + index,
+                                                        data.data() + offsets[index],
+                                                        data.data() + data.size());
+            offsets[index+1] = data.size();
+          }
+
+      // shift the offsets to the position of the data of this process among
+      // the data of all processes
+      const std::uint64_t local_size = data.size();
+      std::uint64_t data_offset = 0, data_checksum = 0;
+      int ierr = MPI_Exscan (&local_size, &data_offset, 1, MPI_UINT64_T, MPI_SUM,
+                             this->mpi_communicator);
+      AssertThrowMPI(ierr);
+      if (this->my_subdomain == 0)
+        data_offset = 0;
+      for (unsigned int i=0; i<offsets.size(); ++i)
+        offsets[i] += data_offset;
+      ierr = MPI_Allreduce (&local_data_checksum, &data_checksum, 1, MPI_UINT64_T, MPI_SUM,
+                            this->mpi_communicator);
+      AssertThrowMPI(ierr);
+
+      // this is a collective operation whose result is only valid on the
+      // first process, which is the one writing the header
+      const unsigned int mesh_checksum = get_checksum();
+
+      CheckpointHeader header;
+      std::memset (&header, 0, sizeof(header));
+      std::memcpy (header.magic, checkpoint_magic, sizeof(checkpoint_magic));
+      header.version = checkpoint_version;
+      header.dimension = dim;
+      header.space_dimension = spacedim;
+      header.n_processes = Utilities::MPI::n_mpi_processes (this->mpi_communicator);
+      header.n_coarse_cells = this->n_cells(0);
+      header.n_cells = this->n_global_active_cells();
+      header.n_attachments = n_attachments;
+      header.mesh_checksum = mesh_checksum;
+      header.data_checksum = data_checksum;
+
+      const MPI_Offset table_start = sizeof(CheckpointHeader);
+      const MPI_Offset data_start = table_start +
+                                    (header.n_cells*n_attachments+1) * sizeof(std::uint64_t);
+
+      MPI_File fh;
+      ierr = MPI_File_open (this->mpi_communicator, const_cast<char *>(filename.c_str()),
+                            MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh);
+      AssertThrowMPI(ierr);
+      // delete the file contents before anybody writes into it
+      ierr = MPI_File_set_size (fh, 0);
+      AssertThrowMPI(ierr);
+      ierr = MPI_Barrier (this->mpi_communicator);
+      AssertThrowMPI(ierr);
+
+      if (this->my_subdomain == 0)
+        {
+          ierr = MPI_File_write_at (fh, 0, &header, sizeof(header), MPI_CHAR, MPI_STATUS_IGNORE);
+          AssertThrowMPI(ierr);
+        }
+
+      // every process writes the offsets of its cells, and the last one
+      // also the end of the data of all cells
+      const bool write_last_offset
+        = (this->my_subdomain == Utilities::MPI::n_mpi_processes (this->mpi_communicator)-1);
+      checkpoint_write_at_all (fh, table_start + first_index*sizeof(std::uint64_t),
+                               reinterpret_cast<const char *>(offsets.data()),
+                               (offsets.size() - (write_last_offset ? 0 : 1)) * sizeof(std::uint64_t),
+                               this->mpi_communicator);
+      checkpoint_write_at_all (fh, data_start + data_offset,
+                               data.data(), data.size(),
+                               this->mpi_communicator);
+
+      ierr = MPI_File_close (&fh);
+      AssertThrowMPI(ierr);
+
+      const_cast<dealii::parallel::distributed::Triangulation<dim, spacedim>*>(this)
+      ->checkpoint_pack_callbacks.clear();
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    Triangulation<dim,spacedim>::
+    load_checkpoint (const std::string &filename,
+                     const bool         autopartition)
+    {
+      Assert(this->n_cells()>0, ExcMessage("load_checkpoint() only works if the Triangulation already contains a coarse mesh!"));
+      Assert(this->n_levels()==1, ExcMessage("Triangulation may only contain coarse cells when calling load_checkpoint()."));
+
+      MPI_File fh;
+      int ierr = MPI_File_open (this->mpi_communicator, const_cast<char *>(filename.c_str()),
+                                MPI_MODE_RDONLY, MPI_INFO_NULL, &fh);
+      AssertThrowMPI(ierr);
+
+      CheckpointHeader header;
+      checkpoint_read_at_all (fh, 0, reinterpret_cast<char *>(&header), sizeof(header),
+                              this->mpi_communicator);
+      AssertThrow (std::memcmp (header.magic, checkpoint_magic, sizeof(checkpoint_magic)) == 0,
+                   ExcMessage ("The file <" + filename + "> is not a checkpoint written "
+                               "by save_checkpoint()."));
+      AssertThrow (header.version == checkpoint_version,
+                   ExcMessage ("Incompatible version found in checkpoint file."));
+      AssertThrow (header.dimension == dim && header.space_dimension == spacedim,
+                   ExcMessage ("The checkpoint was written for a triangulation of "
+                               "different dimensions."));
+      AssertThrow (header.n_coarse_cells == this->n_cells(0),
+                   ExcMessage ("Number of coarse cells differ!"));
+
+      if (parallel_ghost != nullptr)
+        {
+          dealii::internal::p4est::functions<dim>::ghost_destroy (parallel_ghost);
+          parallel_ghost = nullptr;
+        }
+      dealii::internal::p4est::functions<dim>::destroy (parallel_forest);
+      parallel_forest = nullptr;
+      dealii::internal::p4est::functions<dim>::connectivity_destroy (connectivity);
+      connectivity = nullptr;
+
+#if DEAL_II_P4EST_VERSION_GTE(0,3,4,3)
+      parallel_forest = dealii::internal::p4est::functions<dim>::load_ext (
+                          (filename+".mesh").c_str(), this->mpi_communicator,
+                          0, false,
+                          autopartition, 0,
+                          this,
+                          &connectivity);
+#else
+      AssertThrow(header.n_processes <= Utilities::MPI::n_mpi_processes (this->mpi_communicator),
+                  ExcMessage("parallel::distributed::Triangulation::load_checkpoint() only supports "
+                             "loading checkpoints with a greater or equal number of processes than "
+                             "were used to save_checkpoint() when using p4est 0.3.4.2."));
+      (void)autopartition;
+      parallel_forest = dealii::internal::p4est::functions<dim>::load (
+                          (filename+".mesh").c_str(), this->mpi_communicator,
+                          0, false,
+                          this,
+                          &connectivity);
+#endif
+      if (header.n_processes != Utilities::MPI::n_mpi_processes (this->mpi_communicator))
+        // see the comment in load()
+        repartition();
+
+      try
+        {
+          copy_local_forest_to_triangulation ();
+        }
+      catch (const typename Triangulation<dim>::DistortedCellList &)
+        {
+          // the underlying
+          // triangulation should not
+          // be checking for
+          // distorted cells
+          Assert (false, ExcInternalError());
+        }
+
+      this->update_number_cache ();
+
+      AssertThrow (header.n_cells == this->n_global_active_cells(),
+                   ExcMessage ("The number of cells in the checkpoint does not match "
+                               "the number of cells of the loaded mesh."));
+      AssertThrow (header.mesh_checksum == Utilities::MPI::max (get_checksum(),
+                                                                 this->mpi_communicator),
+                   ExcMessage ("The check sum of the loaded mesh does not match the "
+                               "one stored in the checkpoint."));
+
+      // read the offsets of the data of the locally owned cells, including
+      // the end of the data of the last one, and then the data itself. both
+      // are contiguous parts of the file
+      const std::vector<cell_iterator> cells
+        = get_locally_owned_cells_in_forest_order (*this);
+
+      const std::uint64_t n_attachments = header.n_attachments;
+      const std::uint64_t first_index
+        = parallel_forest->global_first_quadrant[this->my_subdomain] * n_attachments;
+      const MPI_Offset table_start = sizeof(CheckpointHeader);
+      const MPI_Offset data_start = table_start +
+                                    (header.n_cells*n_attachments+1) * sizeof(std::uint64_t);
+
+      checkpoint_data_offsets.resize (cells.size()*n_attachments+1);
+      checkpoint_read_at_all (fh, table_start + first_index*sizeof(std::uint64_t),
+                              reinterpret_cast<char *>(checkpoint_data_offsets.data()),
+                              checkpoint_data_offsets.size() * sizeof(std::uint64_t),
+                              this->mpi_communicator);
+
+      const std::uint64_t data_offset = checkpoint_data_offsets[0];
+      for (unsigned int i=0; i<checkpoint_data_offsets.size(); ++i)
+        checkpoint_data_offsets[i] -= data_offset;
+      checkpoint_data.resize (checkpoint_data_offsets.back());
+      checkpoint_read_at_all (fh, data_start + data_offset,
+                              checkpoint_data.data(), checkpoint_data.size(),
+                              this->mpi_communicator);
+
+      ierr = MPI_File_close (&fh);
+      AssertThrowMPI(ierr);
+
+      std::uint64_t local_data_checksum = 0, data_checksum = 0;
+      for (unsigned int i=0; i<checkpoint_data_offsets.size()-1; ++i)
+        local_data_checksum += checkpoint_checksum (first_index + i,
+                                                    checkpoint_data.data() + checkpoint_data_offsets[i],
+                                                    checkpoint_data.data() + checkpoint_data_offsets[i+1]);
+      ierr = MPI_Allreduce (&local_data_checksum, &data_checksum, 1, MPI_UINT64_T, MPI_SUM,
+                            this->mpi_communicator);
+      AssertThrowMPI(ierr);
+      AssertThrow (data_checksum == header.data_checksum,
+                   ExcMessage ("The check sum of the data read from the checkpoint does "
+                               "not match the one stored in the file."));
+
+      n_checkpoint_attachments = n_attachments;
+      n_checkpoint_attachments_unpacked = 0;
+
+      // signal that de-serialization is finished
+      this->signals.post_distributed_load();
+
+      this->update_periodic_face_map();
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    Triangulation<dim,spacedim>::
+    notify_ready_to_unpack_checkpoint (const std::function<void (const cell_iterator &,
+                                                                 const char *,
+                                                                 const char *)> &unpack_callback)
+    {
+      Assert (n_checkpoint_attachments_unpacked < n_checkpoint_attachments,
+              ExcMessage ("The data of all functions stored in the checkpoint "
+                          "has already been unpacked."));
+
+      const std::vector<cell_iterator> cells
+        = get_locally_owned_cells_in_forest_order (*this);
+      Assert (checkpoint_data_offsets.size() == cells.size()*n_checkpoint_attachments+1,
+              ExcMessage ("The mesh must not be changed between load_checkpoint() "
+                          "and unpacking the data."));
+
+      for (unsigned int c=0; c<cells.size(); ++c)
+        {
+          const std::size_t index = c*n_checkpoint_attachments + n_checkpoint_attachments_unpacked;
+          unpack_callback (cells[c],
+                           checkpoint_data.data() + checkpoint_data_offsets[index],
+                           checkpoint_data.data() + checkpoint_data_offsets[index+1]);
+        }
+
+      // release the memory once everything has been unpacked
+      ++n_checkpoint_attachments_unpacked;
+      if (n_checkpoint_attachments_unpacked == n_checkpoint_attachments)
+        {
+          std::vector<char>().swap (checkpoint_data);
+          std::vector<std::uint64_t>().swap (checkpoint_data_offsets);
+        }
+    }
+
+
+
     template <int dim, int spacedim>
     unsigned int
     Triangulation<dim,spacedim>::get_checksum () const
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1998 - 2017 by the deal.II authors
+// Copyright (C) 1998 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -19,6 +19,8 @@
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/thread_management.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/base/partitioner.h>
 #include <deal.II/grid/grid_tools.h>
 #include <deal.II/grid/tria.h>
@@ -45,6 +47,8 @@ DEAL_II_ENABLE_EXTRA_DIAGNOSTICS
 #include <set>
 #include <algorithm>
 #include <numeric>
+#include <atomic>
+#include <memory>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -1201,6 +1205,233 @@ namespace internal
 
 
 
+        /**
+         * Return the first dof index on the given quad of a cell. Quads are
+         * only faces of cells in 3d, so this function must not be called in
+         * lower dimensions; the second overload only exists so that the
+         * calling code compiles in all dimensions.
+         */
+        template <typename CellIterator>
+        static
+        types::global_dof_index
+        first_dof_on_quad (const CellIterator                   &cell,
+                           const unsigned int                    q,
+                           const std::integral_constant<int, 3> &)
+        {
+          return cell->quad(q)->dof_index(0);
+        }
+
+
+
+        template <typename CellIterator, int dim>
+        static
+        types::global_dof_index
+        first_dof_on_quad (const CellIterator                     &,
+                           const unsigned int                      ,
+                           const std::integral_constant<int, dim> &)
+        {
+          Assert (false, ExcInternalError());
+          return numbers::invalid_dof_index;
+        }
+
+
+
+        /**
+         * Distribute degrees of freedom on the given list of cells, in the
+         * order in which the cells appear in the list and starting with
+         * index zero. Return the number of degrees of freedom distributed.
+         *
+         * For the hp::DoFHandler, this function simply calls
+         * distribute_dofs_on_cell() for one cell after the other.
+         */
+        template <int dim, int spacedim>
+        static
+        types::global_dof_index
+        distribute_dofs_on_cells (const hp::DoFHandler<dim,spacedim>                                            &dof_handler,
+                                  const std::vector<typename hp::DoFHandler<dim,spacedim>::active_cell_iterator> &cells)
+        {
+          types::global_dof_index next_free_dof = 0;
+          for (unsigned int c=0; c<cells.size(); ++c)
+            next_free_dof = distribute_dofs_on_cell (dof_handler, cells[c], next_free_dof);
+          return next_free_dof;
+        }
+
+
+
+        /**
+         * Same function as above for the non-hp DoFHandler. On large meshes,
+         * the work is split among several threads in a way that produces
+         * exactly the same numbering as calling distribute_dofs_on_cell()
+         * for one cell after the other:
+         *
+         * - In a first pass, we determine for every vertex, line and quad
+         *   that does not yet have degrees of freedom the first cell in the
+         *   list that contains it. This is the cell that would number the
+         *   degrees of freedom on this object in the serial algorithm.
+         * - In a second pass, every cell counts the degrees of freedom it
+         *   owns in this sense. A prefix sum over the cells then yields the
+         *   first index each cell has to assign.
+         * - In a third pass, every cell numbers the degrees of freedom it
+         *   owns, in the same order as distribute_dofs_on_cell() does.
+         *
+         * All three passes work on disjoint chunks of cells in parallel; the
+         * only shared data are the owners computed in the first pass, which
+         * are determined by an atomic minimum and therefore do not depend on
+         * the order in which the threads happen to run.
+         */
+        template <int dim, int spacedim>
+        static
+        types::global_dof_index
+        distribute_dofs_on_cells (const dealii::DoFHandler<dim,spacedim>                                            &dof_handler,
+                                  const std::vector<typename dealii::DoFHandler<dim,spacedim>::active_cell_iterator> &cells)
+        {
+          const unsigned int n_cells = cells.size();
+          const unsigned int grain_size = 256;
+
+          // setting up the parallel algorithm does not pay off for small
+          // meshes or if there is only one thread anyway
+          if (MultithreadInfo::n_threads() == 1 || n_cells < 4*grain_size)
+            {
+              types::global_dof_index next_free_dof = 0;
+              for (unsigned int c=0; c<n_cells; ++c)
+                next_free_dof = distribute_dofs_on_cell (dof_handler, cells[c], next_free_dof);
+              return next_free_dof;
+            }
+
+          const FiniteElement<dim,spacedim> &fe = dof_handler.get_fe();
+          const dealii::Triangulation<dim,spacedim> &tria = dof_handler.get_triangulation();
+
+          // in 1d the lines, and in 2d the quads, are the cells themselves
+          // and are always owned by the cell. only allocate owner fields for
+          // objects that actually carry degrees of freedom
+          const unsigned int n_vertices = (fe.dofs_per_vertex > 0 ? tria.n_vertices() : 0);
+          const unsigned int n_lines    = (dim > 1 && fe.dofs_per_line > 0 ? tria.n_raw_lines() : 0);
+          const unsigned int n_quads    = (dim > 2 && fe.dofs_per_quad > 0 ? tria.n_raw_quads() : 0);
+          const unsigned int n_dofs_per_cell_interior = fe.template n_dofs_per_object<dim>();
+
+          std::unique_ptr<std::atomic<unsigned int>[]>
+          vertex_owner (new std::atomic<unsigned int>[n_vertices]),
+                       line_owner (new std::atomic<unsigned int>[n_lines]),
+                       quad_owner (new std::atomic<unsigned int>[n_quads]);
+          for (unsigned int i=0; i<n_vertices; ++i)
+            vertex_owner[i] = numbers::invalid_unsigned_int;
+          for (unsigned int i=0; i<n_lines; ++i)
+            line_owner[i] = numbers::invalid_unsigned_int;
+          for (unsigned int i=0; i<n_quads; ++i)
+            quad_owner[i] = numbers::invalid_unsigned_int;
+
+          const auto claim = [] (std::atomic<unsigned int> &owner,
+                                 const unsigned int         c)
+          {
+            unsigned int current = owner.load();
+            while (c < current && !owner.compare_exchange_weak (current, c))
+              ;
+          };
+
+          // pass 1: find the first cell that contains each object. (as in
+          // the serial algorithm, checking the first dof on each object is
+          // good enough to find out whether it has been numbered before)
+          parallel::apply_to_subranges
+          (0U, n_cells,
+           [&] (const unsigned int begin, const unsigned int end)
+          {
+            for (unsigned int c=begin; c<end; ++c)
+              {
+                const typename dealii::DoFHandler<dim,spacedim>::active_cell_iterator &cell = cells[c];
+                if (n_vertices > 0)
+                  for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+                    if (cell->vertex_dof_index(v, 0) == numbers::invalid_dof_index)
+                      claim (vertex_owner[cell->vertex_index(v)], c);
+                if (n_lines > 0)
+                  for (unsigned int l=0; l<GeometryInfo<dim>::lines_per_cell; ++l)
+                    if (cell->line(l)->dof_index(0) == numbers::invalid_dof_index)
+                      claim (line_owner[cell->line_index(l)], c);
+                if (n_quads > 0)
+                  for (unsigned int q=0; q<GeometryInfo<dim>::quads_per_cell; ++q)
+                    if (first_dof_on_quad (cell, q, std::integral_constant<int,dim>())
+                        == numbers::invalid_dof_index)
+                      claim (quad_owner[cell->quad_index(q)], c);
+              }
+          },
+          grain_size);
+
+          // pass 2: count the dofs each cell has to number and compute the
+          // first index of each cell by a prefix sum
+          std::vector<types::global_dof_index> first_dof_on_cell (n_cells+1, 0);
+          parallel::apply_to_subranges
+          (0U, n_cells,
+           [&] (const unsigned int begin, const unsigned int end)
+          {
+            for (unsigned int c=begin; c<end; ++c)
+              {
+                const typename dealii::DoFHandler<dim,spacedim>::active_cell_iterator &cell = cells[c];
+                types::global_dof_index n_owned_dofs = n_dofs_per_cell_interior;
+                if (n_vertices > 0)
+                  for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+                    if (vertex_owner[cell->vertex_index(v)] == c)
+                      n_owned_dofs += fe.dofs_per_vertex;
+                if (n_lines > 0)
+                  for (unsigned int l=0; l<GeometryInfo<dim>::lines_per_cell; ++l)
+                    if (line_owner[cell->line_index(l)] == c)
+                      n_owned_dofs += fe.dofs_per_line;
+                if (n_quads > 0)
+                  for (unsigned int q=0; q<GeometryInfo<dim>::quads_per_cell; ++q)
+                    if (quad_owner[cell->quad_index(q)] == c)
+                      n_owned_dofs += fe.dofs_per_quad;
+                first_dof_on_cell[c+1] = n_owned_dofs;
+              }
+          },
+          grain_size);
+          std::partial_sum (first_dof_on_cell.begin(), first_dof_on_cell.end(),
+                            first_dof_on_cell.begin());
+
+          // pass 3: number the dofs in the same order as
+          // distribute_dofs_on_cell(). every cell only writes to the objects
+          // it owns, so there are no conflicts between threads
+          parallel::apply_to_subranges
+          (0U, n_cells,
+           [&] (const unsigned int begin, const unsigned int end)
+          {
+            for (unsigned int c=begin; c<end; ++c)
+              {
+                const typename dealii::DoFHandler<dim,spacedim>::active_cell_iterator &cell = cells[c];
+                types::global_dof_index next_free_dof = first_dof_on_cell[c];
+                if (n_vertices > 0)
+                  for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+                    if (vertex_owner[cell->vertex_index(v)] == c)
+                      for (unsigned int d=0; d<fe.dofs_per_vertex; ++d)
+                        cell->set_vertex_dof_index (v, d, next_free_dof++);
+                if (n_lines > 0)
+                  for (unsigned int l=0; l<GeometryInfo<dim>::lines_per_cell; ++l)
+                    if (line_owner[cell->line_index(l)] == c)
+                      {
+                        const typename dealii::DoFHandler<dim,spacedim>::line_iterator
+                        line = cell->line(l);
+                        for (unsigned int d=0; d<fe.dofs_per_line; ++d)
+                          line->set_dof_index (d, next_free_dof++);
+                      }
+                if (n_quads > 0)
+                  for (unsigned int q=0; q<GeometryInfo<dim>::quads_per_cell; ++q)
+                    if (quad_owner[cell->quad_index(q)] == c)
+                      {
+                        const typename dealii::DoFHandler<dim,spacedim>::quad_iterator
+                        quad = cell->quad(q);
+                        for (unsigned int d=0; d<fe.dofs_per_quad; ++d)
+                          quad->set_dof_index (d, next_free_dof++);
+                      }
+                for (unsigned int d=0; d<n_dofs_per_cell_interior; ++d)
+                  cell->set_dof_index (d, next_free_dof++);
+
+                Assert (next_free_dof == first_dof_on_cell[c+1], ExcInternalError());
+              }
+          },
+          grain_size);
+
+          return first_dof_on_cell[n_cells];
+        }
+
+
+
         /**
          * Distribute degrees of freedom on all cells, or on cells with the
          * correct subdomain_id if the corresponding argument is not equal to
@@ -1218,20 +1449,19 @@ namespace internal
 
           // Step 1: distribute dofs on all cells, but definitely
           // exclude artificial cells
-          types::global_dof_index next_free_dof = 0;
-          typename DoFHandlerType::active_cell_iterator
-          cell = dof_handler.begin_active(),
-          endc = dof_handler.end();
-
-          for (; cell != endc; ++cell)
+          std::vector<typename DoFHandlerType::active_cell_iterator> cells;
+          cells.reserve (dof_handler.get_triangulation().n_active_cells());
+          for (typename DoFHandlerType::active_cell_iterator
+               cell = dof_handler.begin_active();
+               cell != dof_handler.end(); ++cell)
             if (! cell->is_artificial())
               if ((subdomain_id == numbers::invalid_subdomain_id)
                   ||
                   (cell->subdomain_id() == subdomain_id))
-                next_free_dof
-                  = Implementation::distribute_dofs_on_cell (dof_handler,
-                                                             cell,
-                                                             next_free_dof);
+                cells.push_back (cell);
+
+          types::global_dof_index next_free_dof
+            = Implementation::distribute_dofs_on_cells (dof_handler, cells);
 
           // Step 2: unify dof indices in case this is an hp DoFHandler
           //
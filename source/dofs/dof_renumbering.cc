@@ -39,6 +39,8 @@
 
 #include <deal.II/multigrid/mg_tools.h>
 
+#include <deal.II/matrix_free/matrix_free.h>
+
 #include <deal.II/distributed/tria.h>
 
 #include <boost/config.hpp>
@@ -56,6 +58,8 @@ DEAL_II_ENABLE_EXTRA_DIAGNOSTICS
 #include <vector>
 #include <map>
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <cmath>
 #include <functional>
 
@@ -1984,6 +1988,249 @@ namespace DoFRenumbering
 
 
 
+  namespace internal
+  {
+    /**
+     * Return the position of the point with the given integer coordinates,
+     * each of which has @p n_bits bits, along the Hilbert curve through the
+     * cube $[0,2^{n\_bits})^{dim}$. The implementation follows J. Skilling,
+     * "Programming the Hilbert curve", AIP Conference Proceedings 707
+     * (2004), which first transforms the coordinates and then interleaves
+     * their bits.
+     */
+    template <int dim>
+    std::uint64_t
+    hilbert_index (std::array<std::uint64_t,dim> x,
+                   const unsigned int            n_bits)
+    {
+      Assert (dim*n_bits <= 64, ExcInternalError());
+
+      if (dim == 1)
+        return x[0];
+
+      const std::uint64_t m = std::uint64_t(1) << (n_bits-1);
+
+      // undo excess work of the Gray code
+      for (std::uint64_t q=m; q>1; q >>= 1)
+        {
+          const std::uint64_t p = q-1;
+          for (unsigned int i=0; i<dim; ++i)
+            if (x[i] & q)
+              x[0] ^= p;
+            else
+              {
+                const std::uint64_t t = (x[0] ^ x[i]) & p;
+                x[0] ^= t;
+                x[i] ^= t;
+              }
+        }
+
+      // Gray encode
+      for (unsigned int i=1; i<dim; ++i)
+        x[i] ^= x[i-1];
+      std::uint64_t t = 0;
+      for (std::uint64_t q=m; q>1; q >>= 1)
+        if (x[dim-1] & q)
+          t ^= q-1;
+      for (unsigned int i=0; i<dim; ++i)
+        x[i] ^= t;
+
+      // interleave the bits, starting with the most significant bit of
+      // the first coordinate
+      std::uint64_t index = 0;
+      for (int b=n_bits-1; b>=0; --b)
+        for (unsigned int i=0; i<dim; ++i)
+          index = (index << 1) | ((x[i] >> b) & 1);
+      return index;
+    }
+
+
+
+    /**
+     * Number the locally owned degrees of freedom of @p dof_handler in the
+     * order in which they are first encountered on the given cells, which
+     * need to include all locally owned cells. The new indices are taken from
+     * the set of locally owned indices, in ascending order.
+     */
+    template <typename DoFHandlerType, typename CellIterator>
+    void
+    compute_first_touch_numbering (std::vector<types::global_dof_index> &new_indices,
+                                   const DoFHandlerType                 &dof_handler,
+                                   const std::vector<CellIterator>      &cells)
+    {
+      const IndexSet &locally_owned_dofs = dof_handler.locally_owned_dofs();
+      const types::global_dof_index n_owned_dofs = locally_owned_dofs.n_elements();
+      Assert (new_indices.size() == n_owned_dofs,
+              ExcDimensionMismatch (new_indices.size(), n_owned_dofs));
+
+      std::vector<bool> already_numbered (n_owned_dofs, false);
+      std::vector<types::global_dof_index> cell_dofs;
+      types::global_dof_index next_index = 0;
+      for (unsigned int c=0; c<cells.size(); ++c)
+        {
+          cell_dofs.resize (cells[c]->get_fe().dofs_per_cell);
+          cells[c]->get_dof_indices (cell_dofs);
+
+          // keep the relative order of the degrees of freedom numbered on
+          // the same cell, as done by cell_wise()
+          std::sort (cell_dofs.begin(), cell_dofs.end());
+          for (unsigned int i=0; i<cell_dofs.size(); ++i)
+            if (locally_owned_dofs.is_element (cell_dofs[i]))
+              {
+                const types::global_dof_index local_index
+                  = locally_owned_dofs.index_within_set (cell_dofs[i]);
+                if (already_numbered[local_index] == false)
+                  {
+                    already_numbered[local_index] = true;
+                    new_indices[local_index]
+                      = locally_owned_dofs.nth_index_in_set (next_index++);
+                  }
+              }
+        }
+      AssertThrow (next_index == n_owned_dofs,
+                   ExcMessage ("Not all locally owned degrees of freedom "
+                               "were found on the given cells."));
+    }
+  }
+
+
+
+  template <typename DoFHandlerType>
+  void
+  hilbert_curve (DoFHandlerType &dof_handler)
+  {
+    std::vector<types::global_dof_index>
+    renumbering (dof_handler.locally_owned_dofs().n_elements(),
+                 numbers::invalid_dof_index);
+    compute_hilbert_curve (renumbering, dof_handler);
+
+    dof_handler.renumber_dofs (renumbering);
+  }
+
+
+
+  template <typename DoFHandlerType>
+  void
+  compute_hilbert_curve (std::vector<types::global_dof_index> &new_indices,
+                         const DoFHandlerType                 &dof_handler)
+  {
+    const int spacedim = DoFHandlerType::space_dimension;
+    const Triangulation<DoFHandlerType::dimension,spacedim> &tria
+      = dof_handler.get_triangulation();
+
+    // map the bounding box of the mesh to the cube [0,2^n_bits)^spacedim.
+    // as the box is spanned by vertices, the centers of the cells of a
+    // uniformly refined mesh on a cube fall onto the dyadic points the
+    // Hilbert curve passes through in order
+    Point<spacedim> lower, upper;
+    bool first_vertex = true;
+    for (unsigned int v=0; v<tria.n_vertices(); ++v)
+      if (tria.get_used_vertices()[v])
+        {
+          const Point<spacedim> &vertex = tria.get_vertices()[v];
+          for (unsigned int d=0; d<spacedim; ++d)
+            {
+              lower[d] = first_vertex ? vertex[d] : std::min (lower[d], vertex[d]);
+              upper[d] = first_vertex ? vertex[d] : std::max (upper[d], vertex[d]);
+            }
+          first_vertex = false;
+        }
+
+    const unsigned int n_bits = (spacedim == 1 ? 63 : 64/spacedim);
+    const double scaling = static_cast<double>(std::uint64_t(1) << n_bits);
+    const std::uint64_t max_coordinate = (std::uint64_t(1) << n_bits) - 1;
+
+    std::vector<std::pair<std::uint64_t, typename DoFHandlerType::active_cell_iterator> >
+    indexed_cells;
+    indexed_cells.reserve (tria.n_active_cells());
+    for (typename DoFHandlerType::active_cell_iterator cell = dof_handler.begin_active();
+         cell != dof_handler.end(); ++cell)
+      if (cell->is_locally_owned())
+        {
+          const Point<spacedim> center = cell->center();
+          std::array<std::uint64_t,spacedim> coordinates;
+          for (unsigned int d=0; d<spacedim; ++d)
+            {
+              const double extent = upper[d] - lower[d];
+              const double relative = (extent > 0 ?
+                                       (center[d] - lower[d]) / extent :
+                                       0.);
+              coordinates[d] = std::min (static_cast<std::uint64_t>(std::max (relative, 0.) * scaling),
+                                         max_coordinate);
+            }
+          indexed_cells.emplace_back (internal::hilbert_index<spacedim>(coordinates, n_bits),
+                                      cell);
+        }
+
+    // sort by the position along the curve, keeping the order of the
+    // triangulation for cells at the same position
+    std::stable_sort (indexed_cells.begin(), indexed_cells.end(),
+                      [] (const std::pair<std::uint64_t, typename DoFHandlerType::active_cell_iterator> &a,
+                          const std::pair<std::uint64_t, typename DoFHandlerType::active_cell_iterator> &b)
+    {
+      return a.first < b.first;
+    });
+
+    std::vector<typename DoFHandlerType::active_cell_iterator> ordered_cells;
+    ordered_cells.reserve (indexed_cells.size());
+    for (unsigned int c=0; c<indexed_cells.size(); ++c)
+      ordered_cells.push_back (indexed_cells[c].second);
+
+    internal::compute_first_touch_numbering (new_indices, dof_handler,
+                                             ordered_cells);
+  }
+
+
+
+  template <int dim, typename Number>
+  void
+  matrix_free_data_locality (DoFHandler<dim>              &dof_handler,
+                             const MatrixFree<dim,Number> &matrix_free)
+  {
+    std::vector<types::global_dof_index>
+    renumbering (dof_handler.locally_owned_dofs().n_elements(),
+                 numbers::invalid_dof_index);
+    compute_matrix_free_data_locality (renumbering, dof_handler, matrix_free);
+
+    dof_handler.renumber_dofs (renumbering);
+  }
+
+
+
+  template <int dim, typename Number>
+  void
+  compute_matrix_free_data_locality (std::vector<types::global_dof_index> &new_indices,
+                                     const DoFHandler<dim>                &dof_handler,
+                                     const MatrixFree<dim,Number>         &matrix_free)
+  {
+    unsigned int dof_handler_index = numbers::invalid_unsigned_int;
+    for (unsigned int i=0; i<matrix_free.n_components(); ++i)
+      if (&matrix_free.get_dof_handler(i) == &dof_handler)
+        dof_handler_index = i;
+    AssertThrow (dof_handler_index != numbers::invalid_unsigned_int,
+                 ExcMessage ("The MatrixFree object must have been "
+                             "initialized with the given DoFHandler."));
+
+    std::vector<typename DoFHandler<dim>::active_cell_iterator> cells;
+    cells.reserve (matrix_free.n_macro_cells() *
+                   VectorizedArray<Number>::n_array_elements);
+    for (unsigned int macro_cell=0; macro_cell<matrix_free.n_macro_cells(); ++macro_cell)
+      for (unsigned int v=0; v<matrix_free.n_components_filled(macro_cell); ++v)
+        {
+          const typename DoFHandler<dim>::cell_iterator cell =
+            matrix_free.get_cell_iterator (macro_cell, v, dof_handler_index);
+          Assert (cell->active(),
+                  ExcMessage ("This function only works for MatrixFree objects "
+                              "that loop over the active cells, not for ones "
+                              "set up on a multigrid level."));
+          cells.push_back (cell);
+        }
+
+    internal::compute_first_touch_numbering (new_indices, dof_handler, cells);
+  }
+
+
+
   template <typename DoFHandlerType>
   void
   random (DoFHandlerType &dof_handler)
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1999 - 2017 by the deal.II authors
+// Copyright (C) 1999 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -14,6 +14,7 @@
 // ---------------------------------------------------------------------
 
 #include <deal.II/base/thread_management.h>
+#include <deal.II/base/multithread_info.h>
 #include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/table.h>
 #include <deal.II/base/template_constraints.h>
@@ -49,6 +50,105 @@ DEAL_II_NAMESPACE_OPEN
 
 namespace DoFTools
 {
+  namespace internal
+  {
+    namespace
+    {
+      /**
+       * Add the entries that couple the degrees of freedom on each of the
+       * cells in the range [begin,end) of a list of cell iterators to the
+       * sparsity pattern, taking
+       * into account the given constraints.
+       */
+      template <typename Iterator, typename SparsityPatternType>
+      void
+      add_entries_on_cells (const Iterator         &begin,
+                            const Iterator         &end,
+                            const ConstraintMatrix &constraints,
+                            const bool              keep_constrained_dofs,
+                            SparsityPatternType    &sparsity)
+      {
+        std::vector<types::global_dof_index> dofs_on_this_cell;
+        for (Iterator cell = begin; cell != end; ++cell)
+          {
+            const unsigned int dofs_per_cell = (*cell)->get_fe().dofs_per_cell;
+            dofs_on_this_cell.resize (dofs_per_cell);
+            (*cell)->get_dof_indices (dofs_on_this_cell);
+
+            // make sparsity pattern for this cell. if no constraints pattern
+            // was given, then the following call acts as if simply no
+            // constraints existed
+            constraints.add_entries_local_to_global (dofs_on_this_cell,
+                                                     sparsity,
+                                                     keep_constrained_dofs);
+          }
+      }
+
+
+
+      /**
+       * Same as above for DynamicSparsityPattern, where the work is split
+       * among several threads if there are enough cells. Every thread works
+       * on a contiguous range of the cells. The first thread writes into the
+       * final pattern, all others into private patterns that store the same
+       * rows, and the private patterns are then merged into the final one,
+       * row by row in parallel. Since the cells of one range share most of
+       * their degrees of freedom, every private pattern holds about its
+       * share of the final entries, and it is freed right after being
+       * merged. At any time, the memory in addition to the final pattern is
+       * thus about that of one share plus one empty row per stored row and
+       * private pattern. The result does not depend on the number of
+       * threads.
+       */
+      template <typename Iterator>
+      void
+      add_entries_on_cells (const Iterator         &begin,
+                            const Iterator         &end,
+                            const ConstraintMatrix &constraints,
+                            const bool              keep_constrained_dofs,
+                            DynamicSparsityPattern &sparsity)
+      {
+        // every private pattern allocates all stored rows, so only split
+        // the work if there are enough cells to make up for this
+        const unsigned int min_cells_per_chunk = 1000;
+        const std::size_t n_cells = end - begin;
+        const unsigned int n_chunks
+          = std::min<std::size_t> (MultithreadInfo::n_threads(),
+                                   n_cells / min_cells_per_chunk);
+
+        if (n_chunks <= 1)
+          {
+            add_entries_on_cells<Iterator,DynamicSparsityPattern>
+            (begin, end, constraints, keep_constrained_dofs, sparsity);
+            return;
+          }
+
+        std::vector<DynamicSparsityPattern> chunk_sparsity (n_chunks-1);
+        for (unsigned int c=0; c<n_chunks-1; ++c)
+          chunk_sparsity[c].reinit (sparsity.n_rows(), sparsity.n_cols(),
+                                    sparsity.row_index_set());
+
+        Threads::TaskGroup<> tasks;
+        for (unsigned int c=0; c<n_chunks; ++c)
+          tasks += Threads::new_task ([&,c] ()
+        {
+          add_entries_on_cells<Iterator,DynamicSparsityPattern>
+          (begin + n_cells*c/n_chunks, begin + n_cells*(c+1)/n_chunks,
+           constraints, keep_constrained_dofs,
+           (c == 0 ? sparsity : chunk_sparsity[c-1]));
+        });
+        tasks.join_all ();
+
+        for (unsigned int c=0; c<n_chunks-1; ++c)
+          {
+            sparsity.add_entries_from (chunk_sparsity[c]);
+            chunk_sparsity[c].reinit (0, 0);
+          }
+      }
+    }
+  }
+
+
 
   template <typename DoFHandlerType, typename SparsityPatternType>
   void
@@ -79,32 +179,23 @@ namespace DoFTools
                   "associated DoF handler objects, asking for any subdomain other "
                   "than the locally owned one does not make sense."));
 
-    std::vector<types::global_dof_index> dofs_on_this_cell;
-    dofs_on_this_cell.reserve (max_dofs_per_cell(dof));
-    typename DoFHandlerType::active_cell_iterator cell = dof.begin_active(),
-                                                  endc = dof.end();
+    typedef typename DoFHandlerType::active_cell_iterator active_cell_iterator;
+    std::vector<active_cell_iterator> cells;
 
     // In case we work with a distributed sparsity pattern of Trilinos
     // type, we only have to do the work if the current cell is owned by
     // the calling processor. Otherwise, just continue.
-    for (; cell!=endc; ++cell)
+    for (active_cell_iterator cell = dof.begin_active(); cell!=dof.end(); ++cell)
       if (((subdomain_id == numbers::invalid_subdomain_id)
            ||
            (subdomain_id == cell->subdomain_id()))
           &&
           cell->is_locally_owned())
-        {
-          const unsigned int dofs_per_cell = cell->get_fe().dofs_per_cell;
-          dofs_on_this_cell.resize (dofs_per_cell);
-          cell->get_dof_indices (dofs_on_this_cell);
+        cells.push_back (cell);
 
-          // make sparsity pattern for this cell. if no constraints pattern
-          // was given, then the following call acts as if simply no
-          // constraints existed
-          constraints.add_entries_local_to_global (dofs_on_this_cell,
-                                                   sparsity,
-                                                   keep_constrained_dofs);
-        }
+    internal::add_entries_on_cells (cells.cbegin(), cells.cend(),
+                                    constraints, keep_constrained_dofs,
+                                    sparsity);
   }
 
 
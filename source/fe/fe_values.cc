@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1998 - 2017 by the deal.II authors
+// Copyright (C) 1998 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -2687,6 +2687,7 @@ FEValuesBase<dim,spacedim>::FEValuesBase (const unsigned int n_q_points,
   dofs_per_cell (dofs_per_cell),
   mapping(&mapping, typeid(*this).name()),
   fe(&fe, typeid(*this).name()),
+  cell_similarity_with_threads (false),
   fe_values_views_cache (*this)
 {
   Assert (n_q_points > 0,
@@ -3846,9 +3847,11 @@ FEValuesBase<dim,spacedim>::check_cell_similarity
   // multithreading is disabled on default, but in many other situations
   // because we rarely explicitly set the number of threads.
   //
-  // TODO: Is it reasonable to introduce a flag "unsafe" in the constructor of
-  // FEValues to re-enable this feature?
-  if (MultithreadInfo::n_threads() > 1)
+  // Users who can live with these differences can re-enable the feature by
+  // calling allow_cell_similarity_with_threads(). This is safe with respect
+  // to concurrency since every FEValues object tracks its own previous cell
+  // and keeps its own mapping and finite element data.
+  if (MultithreadInfo::n_threads() > 1 && !cell_similarity_with_threads)
     {
       cell_similarity = CellSimilarity::none;
       return;
@@ -3891,6 +3894,15 @@ FEValuesBase<dim,spacedim>::get_cell_similarity () const
 }
 
 
+
+template <int dim, int spacedim>
+void
+FEValuesBase<dim,spacedim>::allow_cell_similarity_with_threads (const bool allow)
+{
+  cell_similarity_with_threads = allow;
+}
+
+
 template <int dim, int spacedim>
 const unsigned int FEValuesBase<dim,spacedim>::dimension;
 
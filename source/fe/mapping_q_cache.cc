@@ -0,0 +1,171 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/fe/mapping_q_cache.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/tria_accessor.h>
+
+#include <algorithm>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <int dim, int spacedim>
+MappingQCache<dim,spacedim>::MappingQCache (const unsigned int polynomial_degree)
+  :
+  MappingQGeneric<dim,spacedim> (polynomial_degree),
+  support_point_cache (std::make_shared<std::vector<std::vector<std::vector<Point<spacedim> > > > >()),
+  triangulation (nullptr)
+{}
+
+
+
+template <int dim, int spacedim>
+MappingQCache<dim,spacedim>::MappingQCache (const MappingQCache<dim,spacedim> &mapping)
+  :
+  MappingQGeneric<dim,spacedim> (mapping),
+  support_point_cache (mapping.support_point_cache),
+  triangulation (mapping.triangulation)
+{
+  if (triangulation != nullptr)
+    connect_to_triangulation ();
+}
+
+
+
+template <int dim, int spacedim>
+MappingQCache<dim,spacedim>::~MappingQCache ()
+{
+  clear_on_change.disconnect ();
+}
+
+
+
+template <int dim, int spacedim>
+Mapping<dim,spacedim> *
+MappingQCache<dim,spacedim>::clone () const
+{
+  return new MappingQCache<dim,spacedim>(*this);
+}
+
+
+
+template <int dim, int spacedim>
+void
+MappingQCache<dim,spacedim>::connect_to_triangulation ()
+{
+  clear_on_change.disconnect ();
+
+  // capture the shared pointer rather than 'this', since the cache may be
+  // shared with copies of this object
+  const std::shared_ptr<std::vector<std::vector<std::vector<Point<spacedim> > > > >
+  cache = support_point_cache;
+  clear_on_change
+    = triangulation->signals.any_change.connect ([cache] ()
+  {
+    cache->clear ();
+  });
+}
+
+
+
+template <int dim, int spacedim>
+void
+MappingQCache<dim,spacedim>::initialize (const Triangulation<dim,spacedim> &tria)
+{
+  // stop using the cache while it is being rebuilt so that
+  // compute_mapping_support_points() below computes the points from
+  // scratch
+  support_point_cache->clear ();
+
+  triangulation = &tria;
+  connect_to_triangulation ();
+
+  std::vector<typename Triangulation<dim,spacedim>::cell_iterator> cells;
+  cells.reserve (tria.n_cells());
+  for (typename Triangulation<dim,spacedim>::cell_iterator cell = tria.begin();
+       cell != tria.end(); ++cell)
+    cells.push_back (cell);
+
+  std::vector<std::vector<std::vector<Point<spacedim> > > >
+  new_cache (tria.n_levels());
+  for (unsigned int level=0; level<tria.n_levels(); ++level)
+    new_cache[level].resize (tria.n_raw_cells(level));
+
+  // the support points of different cells are independent of each other,
+  // and the entries of the cache that each cell writes to are distinct
+  parallel::apply_to_subranges
+  (0U, static_cast<unsigned int>(cells.size()),
+   [&] (const unsigned int begin, const unsigned int end)
+  {
+    for (unsigned int c=begin; c<end; ++c)
+      new_cache[cells[c]->level()][cells[c]->index()]
+        = this->MappingQGeneric<dim,spacedim>::compute_mapping_support_points (cells[c]);
+  },
+  /* grain size */ 32);
+
+  support_point_cache->swap (new_cache);
+}
+
+
+
+template <int dim, int spacedim>
+bool
+MappingQCache<dim,spacedim>::is_initialized () const
+{
+  return !support_point_cache->empty();
+}
+
+
+
+template <int dim, int spacedim>
+std::vector<Point<spacedim> >
+MappingQCache<dim,spacedim>::compute_mapping_support_points
+(const typename Triangulation<dim,spacedim>::cell_iterator &cell) const
+{
+  if (support_point_cache->empty())
+    return this->MappingQGeneric<dim,spacedim>::compute_mapping_support_points (cell);
+
+  Assert (&cell->get_triangulation() == triangulation,
+          ExcMessage ("The cache of this mapping has been computed for "
+                      "a different triangulation."));
+  AssertIndexRange (static_cast<unsigned int>(cell->level()),
+                    support_point_cache->size());
+  AssertIndexRange (static_cast<unsigned int>(cell->index()),
+                    (*support_point_cache)[cell->level()].size());
+  return (*support_point_cache)[cell->level()][cell->index()];
+}
+
+
+
+template <int dim, int spacedim>
+std::size_t
+MappingQCache<dim,spacedim>::memory_consumption () const
+{
+  return (sizeof (*this) +
+          MemoryConsumption::memory_consumption (*support_point_cache));
+}
+
+
+
+//--------------------------- Explicit instantiations -----------------------
+#include "mapping_q_cache.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
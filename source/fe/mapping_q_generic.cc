@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2000 - 2017 by the deal.II authors
+// Copyright (C) 2000 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -64,6 +64,69 @@ namespace internal
           dpo[i]=dpo[i-1]*(degree-1);
         return dpo;
       }
+
+
+
+      /**
+       * Return the number of derivatives (including the zeroth one, i.e.,
+       * the values) of the mapping that need to be evaluated for the given
+       * update flags, or zero if the mapping does not need to be evaluated
+       * in the quadrature points at all.
+       */
+      unsigned int
+      n_tensor_product_derivatives (const UpdateFlags update_flags)
+      {
+        if (update_flags & (update_jacobian_3rd_derivatives |
+                            update_jacobian_pushed_forward_3rd_derivatives))
+          return 5;
+        else if (update_flags & (update_jacobian_2nd_derivatives |
+                                 update_jacobian_pushed_forward_2nd_derivatives))
+          return 4;
+        else if (update_flags & (update_jacobian_grads |
+                                 update_jacobian_pushed_forward_grads))
+          return 3;
+        else if (update_flags & update_contravariant_transformation)
+          return 2;
+        else if (update_flags & update_quadrature_points)
+          return 1;
+        else
+          return 0;
+      }
+
+
+
+      /**
+       * Evaluate the first @p n_derivatives derivatives of the
+       * one-dimensional Lagrange polynomials of the given degree on
+       * Gauss-Lobatto points in the points of the given one-dimensional
+       * quadrature formulas.
+       */
+      template <int dim>
+      std::array<dealii::Table<3,double>,dim>
+      compute_shape_data_1d (const unsigned int                   polynomial_degree,
+                             const std::array<Quadrature<1>,dim> &quadratures_1d,
+                             const unsigned int                   n_derivatives)
+      {
+        const std::vector<Polynomials::Polynomial<double> > polynomials
+          = Polynomials::generate_complete_Lagrange_basis
+            (QGaussLobatto<1>(polynomial_degree+1).get_points());
+
+        std::array<dealii::Table<3,double>,dim> shape_data;
+        std::vector<double> values (n_derivatives);
+        for (unsigned int d=0; d<dim; ++d)
+          {
+            const unsigned int n_points = quadratures_1d[d].size();
+            shape_data[d].reinit (TableIndices<3>(n_derivatives, polynomials.size(), n_points));
+            for (unsigned int i=0; i<polynomials.size(); ++i)
+              for (unsigned int q=0; q<n_points; ++q)
+                {
+                  polynomials[i].value (quadratures_1d[d].point(q)[0], values);
+                  for (unsigned int k=0; k<n_derivatives; ++k)
+                    shape_data[d](k,i,q) = values[k];
+                }
+          }
+        return shape_data;
+      }
     }
   }
 
@@ -696,6 +759,9 @@ initialize (const UpdateFlags      update_flags,
 
   tensor_product_quadrature = q.is_tensor_product();
 
+  if (dim>1 && tensor_product_quadrature)
+    initialize_tensor_product_data (q.get_tensor_basis());
+
   if (dim>1)
     {
       // find out if the one-dimensional formula is the same
@@ -748,6 +814,102 @@ initialize (const UpdateFlags      update_flags,
 
 
 
+template <int dim, int spacedim>
+void
+MappingQGeneric<dim,spacedim>::InternalData::
+initialize_tensor_product_data (const std::array<Quadrature<1>,dim> &quadratures_1d)
+{
+  const unsigned int n_derivatives =
+    internal::MappingQGeneric::n_tensor_product_derivatives (this->update_each);
+  if (n_derivatives == 0)
+    return;
+
+  lexicographic_support_points
+    = FETools::lexicographic_to_hierarchic_numbering
+      (FiniteElementData<dim> (internal::MappingQGeneric::get_dpo_vector<dim>
+                               (polynomial_degree), 1, polynomial_degree));
+
+  shape_data_1d.resize (1);
+  shape_data_1d[0] = internal::MappingQGeneric::compute_shape_data_1d<dim>
+                     (polynomial_degree, quadratures_1d, n_derivatives);
+
+  // the points of a tensor product quadrature formula are already in
+  // lexicographic order
+  unsigned int n_points = 1;
+  for (unsigned int d=0; d<dim; ++d)
+    n_points *= quadratures_1d[d].size();
+  tensor_point_numbering.resize (1);
+  tensor_point_numbering[0].resize (n_points);
+  std::iota (tensor_point_numbering[0].begin(), tensor_point_numbering[0].end(),
+             0U);
+}
+
+
+
+template <int dim, int spacedim>
+void
+MappingQGeneric<dim,spacedim>::InternalData::
+initialize_tensor_product_face_data (const std::array<Quadrature<1>,dim-1> &face_quadratures_1d)
+{
+  const unsigned int n_derivatives =
+    internal::MappingQGeneric::n_tensor_product_derivatives (this->update_each);
+  if (dim == 1 || n_derivatives == 0)
+    return;
+
+  lexicographic_support_points
+    = FETools::lexicographic_to_hierarchic_numbering
+      (FiniteElementData<dim> (internal::MappingQGeneric::get_dpo_vector<dim>
+                               (polynomial_degree), 1, polynomial_degree));
+
+  shape_data_1d.resize (GeometryInfo<dim>::faces_per_cell);
+  tensor_point_numbering.resize (GeometryInfo<dim>::faces_per_cell);
+  for (unsigned int face=0; face<GeometryInfo<dim>::faces_per_cell; ++face)
+    {
+      // the direction normal to the face gets a single point at the
+      // position of the face, whereas coordinate k of the face runs along
+      // direction (normal+1+k)%dim of the cell, see
+      // QProjector::project_to_face()
+      const unsigned int normal_direction = face/2;
+      std::array<Quadrature<1>,dim> quadratures_1d;
+      quadratures_1d[normal_direction]
+        = Quadrature<1> (std::vector<Point<1> > (1, Point<1>(face%2)),
+                         std::vector<double> (1, 1.));
+      std::array<unsigned int,dim> face_direction = {{}};
+      for (unsigned int k=0; k<dim-1; ++k)
+        {
+          const unsigned int d = (normal_direction+1+k)%dim;
+          quadratures_1d[d] = face_quadratures_1d[k];
+          face_direction[d] = k;
+        }
+
+      shape_data_1d[face] = internal::MappingQGeneric::compute_shape_data_1d<dim>
+                            (polynomial_degree, quadratures_1d, n_derivatives);
+
+      // translate the lexicographic numbering of the points on the cell to
+      // the numbering of the points of the face quadrature
+      unsigned int n_points = 1;
+      for (unsigned int d=0; d<dim; ++d)
+        n_points *= quadratures_1d[d].size();
+      tensor_point_numbering[face].resize (n_points);
+      for (unsigned int q=0; q<n_points; ++q)
+        {
+          std::array<unsigned int,dim-1> face_index;
+          for (unsigned int d=0, remainder=q; d<dim; ++d)
+            {
+              if (d != normal_direction)
+                face_index[face_direction[d]] = remainder % quadratures_1d[d].size();
+              remainder /= quadratures_1d[d].size();
+            }
+          unsigned int face_point = 0;
+          for (int k=dim-2; k>=0; --k)
+            face_point = face_point * face_quadratures_1d[k].size() + face_index[k];
+          tensor_point_numbering[face][q] = face_point;
+        }
+    }
+}
+
+
+
 template <int dim, int spacedim>
 void
 MappingQGeneric<dim,spacedim>::InternalData::
@@ -1578,6 +1740,327 @@ namespace internal
       }
 
 
+      /**
+       * Evaluate the derivative of the mapping with the given orders in the
+       * coordinate directions in all points of the tensor product data set
+       * @p data_set, see InternalData::shape_data_1d. This is done by sum
+       * factorization: the mapping support points are contracted with the
+       * one-dimensional shape data of one coordinate direction at a time,
+       * which costs $\mathcal O((p+1)^{\text{dim}+1})$ operations rather than
+       * the $\mathcal O((p+1)^{2\,\text{dim}})$ operations of the evaluation
+       * with the full shape function arrays. The result is given in the
+       * numbering of the quadrature points.
+       */
+      template <int dim, int spacedim>
+      void
+      evaluate_tensor_product_derivative
+      (const typename dealii::MappingQGeneric<dim,spacedim>::InternalData &data,
+       const unsigned int                                                  data_set,
+       const std::array<unsigned int,dim>                                 &derivative_orders,
+       std::vector<Tensor<1,spacedim> >                                   &result)
+      {
+        AssertIndexRange (data_set, data.shape_data_1d.size());
+        const std::array<dealii::Table<3,double>,dim> &shape_data = data.shape_data_1d[data_set];
+        const unsigned int n_1d = data.polynomial_degree+1;
+
+        std::vector<Tensor<1,spacedim> > &in = data.tensor_values_in;
+        std::vector<Tensor<1,spacedim> > &out = data.tensor_values_out;
+        in.resize (data.n_shape_functions);
+        for (unsigned int i=0; i<data.n_shape_functions; ++i)
+          in[i] = data.mapping_support_points[data.lexicographic_support_points[i]];
+
+        // when contracting direction d, the input is indexed as
+        // [b + n_before*(k + n_1d*a)], where k runs over the polynomials in
+        // direction d, b over the points in the directions already
+        // contracted, and a over the polynomials in the remaining directions
+        unsigned int n_before = 1;
+        unsigned int n_after = data.n_shape_functions/n_1d;
+        for (unsigned int d=0; d<dim; ++d)
+          {
+            AssertIndexRange (derivative_orders[d], shape_data[d].size(0));
+            const unsigned int n_points = shape_data[d].size(2);
+            const double *shape = &shape_data[d](derivative_orders[d],0,0);
+
+            out.resize (n_before*n_points*n_after);
+            for (unsigned int a=0; a<n_after; ++a)
+              for (unsigned int q=0; q<n_points; ++q)
+                for (unsigned int b=0; b<n_before; ++b)
+                  {
+                    const Tensor<1,spacedim> *in_ptr = &in[b+n_before*n_1d*a];
+                    Tensor<1,spacedim> sum = shape[q] * in_ptr[0];
+                    for (unsigned int k=1; k<n_1d; ++k)
+                      sum += shape[k*n_points+q] * in_ptr[k*n_before];
+                    out[b+n_before*(q+n_points*a)] = sum;
+                  }
+            in.swap (out);
+
+            n_before *= n_points;
+            if (d+1 < dim)
+              n_after /= n_1d;
+          }
+
+        const std::vector<unsigned int> &numbering
+          = data.tensor_point_numbering[data_set];
+        Assert (numbering.size() == n_before,
+                ExcDimensionMismatch (numbering.size(), n_before));
+        result.resize (n_before);
+        for (unsigned int q=0; q<n_before; ++q)
+          result[numbering[q]] = in[q];
+      }
+
+
+
+      /**
+       * Evaluate all derivatives of order @p order of the mapping in the
+       * points of the tensor product data set @p data_set. Since the
+       * derivatives are symmetric, evaluate_tensor_product_derivative() is
+       * only called once for each combination of derivative orders in the
+       * coordinate directions.
+       */
+      template <int order, int dim, int spacedim>
+      void
+      evaluate_tensor_product_derivatives
+      (const typename dealii::MappingQGeneric<dim,spacedim>::InternalData &data,
+       const unsigned int                                                  data_set,
+       std::vector<DerivativeForm<order,dim,spacedim> >                   &derivatives)
+      {
+        const auto count_directions = [] (const TableIndices<order> &indices)
+        {
+          std::array<unsigned int,dim> derivative_orders = {{}};
+          for (unsigned int k=0; k<order; ++k)
+            ++derivative_orders[indices[k]];
+          return derivative_orders;
+        };
+
+        std::vector<Tensor<1,spacedim> > &result = data.tensor_values_result;
+        const unsigned int n_components = Utilities::fixed_power<order>(dim);
+        for (unsigned int c=0; c<n_components; ++c)
+          {
+            const TableIndices<order> indices
+              = Tensor<order,dim>::unrolled_to_component_indices (c);
+            bool is_sorted = true;
+            for (unsigned int k=1; k<order; ++k)
+              if (indices[k] < indices[k-1])
+                is_sorted = false;
+            if (is_sorted == false)
+              continue;
+
+            const std::array<unsigned int,dim> derivative_orders
+              = count_directions (indices);
+            evaluate_tensor_product_derivative<dim,spacedim>
+            (data, data_set, derivative_orders, result);
+            Assert (result.size() == derivatives.size(),
+                    ExcDimensionMismatch (result.size(), derivatives.size()));
+
+            for (unsigned int c2=0; c2<n_components; ++c2)
+              {
+                const TableIndices<order> other_indices
+                  = Tensor<order,dim>::unrolled_to_component_indices (c2);
+                if (count_directions (other_indices) == derivative_orders)
+                  for (unsigned int point=0; point<result.size(); ++point)
+                    for (unsigned int i=0; i<spacedim; ++i)
+                      derivatives[point][i][other_indices] = result[point][i];
+              }
+          }
+      }
+
+
+
+      /**
+       * Push forward a derivative of the mapping to the real cell, i.e.,
+       * transform each of its indices by the covariant matrix, one index at
+       * a time.
+       */
+      template <int order, int dim, int spacedim>
+      void
+      push_forward_derivative (const DerivativeForm<order,dim,spacedim> &derivative,
+                               const DerivativeForm<1,dim,spacedim>     &covariant,
+                               Tensor<order+1,spacedim>                 &result)
+      {
+        const unsigned int n_components = Utilities::fixed_power<order>(spacedim);
+        const unsigned int n_reference_components = Utilities::fixed_power<order>(dim);
+        for (unsigned int i=0; i<spacedim; ++i)
+          {
+            // the entries with index k already transformed run up to
+            // spacedim, all others still run up to dim<=spacedim
+            Tensor<order,spacedim> current;
+            for (unsigned int c=0; c<n_reference_components; ++c)
+              {
+                const TableIndices<order> indices
+                  = Tensor<order,dim>::unrolled_to_component_indices (c);
+                current[indices] = derivative[i][indices];
+              }
+
+            for (unsigned int k=0; k<order; ++k)
+              {
+                Tensor<order,spacedim> next;
+                for (unsigned int c=0; c<n_components; ++c)
+                  {
+                    TableIndices<order> indices
+                      = Tensor<order,spacedim>::unrolled_to_component_indices (c);
+                    bool is_active = true;
+                    for (unsigned int m=k+1; m<order; ++m)
+                      if (indices[m] >= dim)
+                        is_active = false;
+                    if (is_active == false)
+                      continue;
+
+                    const unsigned int j = indices[k];
+                    double sum = 0;
+                    for (unsigned int r=0; r<dim; ++r)
+                      {
+                        indices[k] = r;
+                        sum += current[indices] * covariant[j][r];
+                      }
+                    indices[k] = j;
+                    next[indices] = sum;
+                  }
+                current = next;
+              }
+            result[i] = current;
+          }
+      }
+
+
+
+      /**
+       * In case the quadrature formula is a tensor product of possibly
+       * different one-dimensional formulas, this is a replacement for
+       * maybe_compute_q_points(), maybe_update_Jacobians() and
+       * maybe_update_jacobian_grads() that uses sum factorization with the
+       * data set @p data_set of InternalData::shape_data_1d.
+       */
+      template <int dim, int spacedim>
+      void
+      maybe_update_q_points_Jacobians_and_grads_sum_factorized
+      (const CellSimilarity::Similarity                                    cell_similarity,
+       const unsigned int                                                  data_set,
+       const typename dealii::MappingQGeneric<dim,spacedim>::InternalData &data,
+       std::vector<Point<spacedim> >                                      &quadrature_points,
+       std::vector<DerivativeForm<2,dim,spacedim> >                       &jacobian_grads)
+      {
+        const UpdateFlags update_flags = data.update_each;
+
+        if (update_flags & update_quadrature_points)
+          {
+            std::vector<Tensor<1,spacedim> > &values = data.tensor_values_result;
+            evaluate_tensor_product_derivative<dim,spacedim>
+            (data, data_set, std::array<unsigned int,dim>(), values);
+            Assert (values.size() == quadrature_points.size(),
+                    ExcDimensionMismatch (values.size(), quadrature_points.size()));
+            for (unsigned int point=0; point<values.size(); ++point)
+              quadrature_points[point] = Point<spacedim>(values[point]);
+          }
+
+        if (cell_similarity == CellSimilarity::translation)
+          return;
+
+        if (update_flags & update_contravariant_transformation)
+          evaluate_tensor_product_derivatives<1,dim,spacedim>
+          (data, data_set, data.contravariant);
+
+        if (update_flags & update_covariant_transformation)
+          for (unsigned int point=0; point<data.contravariant.size(); ++point)
+            data.covariant[point] = (data.contravariant[point]).covariant_form();
+
+        if (update_flags & update_volume_elements)
+          for (unsigned int point=0; point<data.contravariant.size(); ++point)
+            data.volume_elements[point] = data.contravariant[point].determinant();
+
+        if (update_flags & update_jacobian_grads)
+          evaluate_tensor_product_derivatives<2,dim,spacedim>
+          (data, data_set, jacobian_grads);
+      }
+
+
+
+      /**
+       * Compute the derivatives of order @p order of the mapping with sum
+       * factorization if @p derivative_flag is set, and push them forward
+       * to the real cell if @p pushed_forward_flag is set. If @p
+       * derivatives_available is true, the derivatives have already been
+       * computed by the caller.
+       */
+      template <int order, int dim, int spacedim>
+      void
+      maybe_update_derivatives_sum_factorized
+      (const unsigned int                                                  data_set,
+       const typename dealii::MappingQGeneric<dim,spacedim>::InternalData &data,
+       const UpdateFlags                                                   derivative_flag,
+       const UpdateFlags                                                   pushed_forward_flag,
+       const bool                                                          derivatives_available,
+       std::vector<DerivativeForm<order,dim,spacedim> >                   &derivatives,
+       std::vector<Tensor<order+1,spacedim> >                             &pushed_forward_derivatives)
+      {
+        const UpdateFlags update_flags = data.update_each;
+        if (!(update_flags & (derivative_flag | pushed_forward_flag)))
+          return;
+
+        std::vector<DerivativeForm<order,dim,spacedim> > &local_derivatives
+          = std::get<order-2>(data.tensor_derivatives);
+        const std::vector<DerivativeForm<order,dim,spacedim> > *computed_derivatives
+          = &derivatives;
+        if (update_flags & derivative_flag)
+          {
+            if (derivatives_available == false)
+              evaluate_tensor_product_derivatives<order,dim,spacedim>
+              (data, data_set, derivatives);
+          }
+        else
+          {
+            local_derivatives.resize (pushed_forward_derivatives.size());
+            evaluate_tensor_product_derivatives<order,dim,spacedim>
+            (data, data_set, local_derivatives);
+            computed_derivatives = &local_derivatives;
+          }
+
+        if (update_flags & pushed_forward_flag)
+          for (unsigned int point=0; point<pushed_forward_derivatives.size(); ++point)
+            push_forward_derivative<order,dim,spacedim>
+            ((*computed_derivatives)[point], data.covariant[point],
+             pushed_forward_derivatives[point]);
+      }
+
+
+
+      /**
+       * In case InternalData::shape_data_1d is available, this is a
+       * replacement for the functions computing the higher derivatives of
+       * the mapping, from maybe_update_jacobian_pushed_forward_grads() to
+       * maybe_update_jacobian_pushed_forward_3rd_derivatives(). It expects
+       * the Jacobian gradients to be already computed if requested by the
+       * update flags.
+       */
+      template <int dim, int spacedim>
+      void
+      maybe_update_higher_derivatives_sum_factorized
+      (const CellSimilarity::Similarity                                    cell_similarity,
+       const unsigned int                                                  data_set,
+       const typename dealii::MappingQGeneric<dim,spacedim>::InternalData &data,
+       internal::FEValues::MappingRelatedData<dim,spacedim>              &output_data)
+      {
+        if (cell_similarity == CellSimilarity::translation)
+          return;
+
+        maybe_update_derivatives_sum_factorized<2,dim,spacedim>
+        (data_set, data,
+         update_jacobian_grads, update_jacobian_pushed_forward_grads, true,
+         output_data.jacobian_grads,
+         output_data.jacobian_pushed_forward_grads);
+        maybe_update_derivatives_sum_factorized<3,dim,spacedim>
+        (data_set, data,
+         update_jacobian_2nd_derivatives, update_jacobian_pushed_forward_2nd_derivatives, false,
+         output_data.jacobian_2nd_derivatives,
+         output_data.jacobian_pushed_forward_2nd_derivatives);
+        maybe_update_derivatives_sum_factorized<4,dim,spacedim>
+        (data_set, data,
+         update_jacobian_3rd_derivatives, update_jacobian_pushed_forward_3rd_derivatives, false,
+         output_data.jacobian_3rd_derivatives,
+         output_data.jacobian_pushed_forward_3rd_derivatives);
+      }
+
+
+
       /**
        * Compute the locations of quadrature points on the object described by
        * the first argument (and the cell for which the mapping support points
@@ -2592,6 +3075,8 @@ MappingQGeneric<dim,spacedim>::get_face_data (const UpdateFlags        update_fl
   data->initialize_face (this->requires_update_flags(update_flags),
                          QProjector<dim>::project_to_all_faces(quadrature),
                          quadrature.size());
+  if (dim>1 && quadrature.is_tensor_product())
+    data->initialize_tensor_product_face_data (quadrature.get_tensor_basis());
 
   return data;
 }
@@ -2657,6 +3142,15 @@ fill_fe_values (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
        output_data.quadrature_points,
        output_data.jacobian_grads);
     }
+  else if (!data.shape_data_1d.empty())
+    {
+      internal::MappingQGeneric::maybe_update_q_points_Jacobians_and_grads_sum_factorized<dim,spacedim>
+      (computed_cell_similarity,
+       0,
+       data,
+       output_data.quadrature_points,
+       output_data.jacobian_grads);
+    }
   else
     {
       internal::MappingQGeneric::maybe_compute_q_points<dim,spacedim>
@@ -2676,35 +3170,44 @@ fill_fe_values (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
        output_data.jacobian_grads);
     }
 
-  internal::MappingQGeneric::maybe_update_jacobian_pushed_forward_grads<dim,spacedim>
-  (computed_cell_similarity,
-   QProjector<dim>::DataSetDescriptor::cell (),
-   data,
-   output_data.jacobian_pushed_forward_grads);
+  if (!data.shape_data_1d.empty())
+    internal::MappingQGeneric::maybe_update_higher_derivatives_sum_factorized<dim,spacedim>
+    (computed_cell_similarity,
+     0,
+     data,
+     output_data);
+  else
+    {
+      internal::MappingQGeneric::maybe_update_jacobian_pushed_forward_grads<dim,spacedim>
+      (computed_cell_similarity,
+       QProjector<dim>::DataSetDescriptor::cell (),
+       data,
+       output_data.jacobian_pushed_forward_grads);
 
-  internal::MappingQGeneric::maybe_update_jacobian_2nd_derivatives<dim,spacedim>
-  (computed_cell_similarity,
-   QProjector<dim>::DataSetDescriptor::cell (),
-   data,
-   output_data.jacobian_2nd_derivatives);
+      internal::MappingQGeneric::maybe_update_jacobian_2nd_derivatives<dim,spacedim>
+      (computed_cell_similarity,
+       QProjector<dim>::DataSetDescriptor::cell (),
+       data,
+       output_data.jacobian_2nd_derivatives);
 
-  internal::MappingQGeneric::maybe_update_jacobian_pushed_forward_2nd_derivatives<dim,spacedim>
-  (computed_cell_similarity,
-   QProjector<dim>::DataSetDescriptor::cell (),
-   data,
-   output_data.jacobian_pushed_forward_2nd_derivatives);
+      internal::MappingQGeneric::maybe_update_jacobian_pushed_forward_2nd_derivatives<dim,spacedim>
+      (computed_cell_similarity,
+       QProjector<dim>::DataSetDescriptor::cell (),
+       data,
+       output_data.jacobian_pushed_forward_2nd_derivatives);
 
-  internal::MappingQGeneric::maybe_update_jacobian_3rd_derivatives<dim,spacedim>
-  (computed_cell_similarity,
-   QProjector<dim>::DataSetDescriptor::cell (),
-   data,
-   output_data.jacobian_3rd_derivatives);
+      internal::MappingQGeneric::maybe_update_jacobian_3rd_derivatives<dim,spacedim>
+      (computed_cell_similarity,
+       QProjector<dim>::DataSetDescriptor::cell (),
+       data,
+       output_data.jacobian_3rd_derivatives);
 
-  internal::MappingQGeneric::maybe_update_jacobian_pushed_forward_3rd_derivatives<dim,spacedim>
-  (computed_cell_similarity,
-   QProjector<dim>::DataSetDescriptor::cell (),
-   data,
-   output_data.jacobian_pushed_forward_3rd_derivatives);
+      internal::MappingQGeneric::maybe_update_jacobian_pushed_forward_3rd_derivatives<dim,spacedim>
+      (computed_cell_similarity,
+       QProjector<dim>::DataSetDescriptor::cell (),
+       data,
+       output_data.jacobian_pushed_forward_3rd_derivatives);
+    }
 
   const UpdateFlags update_flags = data.update_each;
   const std::vector<double> &weights=quadrature.get_weights();
@@ -3002,6 +3505,17 @@ namespace internal
                               const typename dealii::MappingQGeneric<dim,spacedim>::InternalData      &data,
                               internal::FEValues::MappingRelatedData<dim,spacedim>              &output_data)
       {
+        // faces in standard orientation can be evaluated by sum
+        // factorization if the face quadrature is a tensor product
+        const bool use_sum_factorization
+          = (dim>1 &&
+             !data.shape_data_1d.empty() &&
+             subface_no == numbers::invalid_unsigned_int &&
+             static_cast<unsigned int>(data_set) ==
+             static_cast<unsigned int>(QProjector<dim>::DataSetDescriptor::face
+                                       (face_no, true, false, false,
+                                        quadrature.size())));
+
         if (dim>1 && data.tensor_product_quadrature)
           {
             maybe_update_q_points_Jacobians_and_grads_tensor<dim, spacedim>
@@ -3010,6 +3524,15 @@ namespace internal
              output_data.quadrature_points,
              output_data.jacobian_grads);
           }
+        else if (use_sum_factorization)
+          {
+            maybe_update_q_points_Jacobians_and_grads_sum_factorized<dim,spacedim>
+            (CellSimilarity::none,
+             face_no,
+             data,
+             output_data.quadrature_points,
+             output_data.jacobian_grads);
+          }
         else
           {
             maybe_compute_q_points<dim,spacedim> (data_set,
@@ -3023,26 +3546,36 @@ namespace internal
                                                        data,
                                                        output_data.jacobian_grads);
           }
-        maybe_update_jacobian_pushed_forward_grads<dim,spacedim> (CellSimilarity::none,
-                                                                  data_set,
-                                                                  data,
-                                                                  output_data.jacobian_pushed_forward_grads);
-        maybe_update_jacobian_2nd_derivatives<dim,spacedim> (CellSimilarity::none,
-                                                             data_set,
-                                                             data,
-                                                             output_data.jacobian_2nd_derivatives);
-        maybe_update_jacobian_pushed_forward_2nd_derivatives<dim,spacedim> (CellSimilarity::none,
-            data_set,
-            data,
-            output_data.jacobian_pushed_forward_2nd_derivatives);
-        maybe_update_jacobian_3rd_derivatives<dim,spacedim> (CellSimilarity::none,
-                                                             data_set,
-                                                             data,
-                                                             output_data.jacobian_3rd_derivatives);
-        maybe_update_jacobian_pushed_forward_3rd_derivatives<dim,spacedim> (CellSimilarity::none,
-            data_set,
-            data,
-            output_data.jacobian_pushed_forward_3rd_derivatives);
+
+        if (use_sum_factorization)
+          maybe_update_higher_derivatives_sum_factorized<dim,spacedim>
+          (CellSimilarity::none,
+           face_no,
+           data,
+           output_data);
+        else
+          {
+            maybe_update_jacobian_pushed_forward_grads<dim,spacedim> (CellSimilarity::none,
+                                                                      data_set,
+                                                                      data,
+                                                                      output_data.jacobian_pushed_forward_grads);
+            maybe_update_jacobian_2nd_derivatives<dim,spacedim> (CellSimilarity::none,
+                                                                 data_set,
+                                                                 data,
+                                                                 output_data.jacobian_2nd_derivatives);
+            maybe_update_jacobian_pushed_forward_2nd_derivatives<dim,spacedim> (CellSimilarity::none,
+                data_set,
+                data,
+                output_data.jacobian_pushed_forward_2nd_derivatives);
+            maybe_update_jacobian_3rd_derivatives<dim,spacedim> (CellSimilarity::none,
+                                                                 data_set,
+                                                                 data,
+                                                                 output_data.jacobian_3rd_derivatives);
+            maybe_update_jacobian_pushed_forward_3rd_derivatives<dim,spacedim> (CellSimilarity::none,
+                data_set,
+                data,
+                output_data.jacobian_pushed_forward_3rd_derivatives);
+          }
 
         maybe_compute_face_data (mapping,
                                  cell, face_no, subface_no, quadrature.size(),
@@ -18,6 +18,7 @@
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/table.h>
 #include <deal.II/base/geometry_info.h>
+#include <deal.II/base/parallel.h>
 
 #include <deal.II/grid/tria.h>
 #include <deal.II/grid/tria_levels.h>
@@ -4270,6 +4271,88 @@ namespace internal
 
 
 
+      /**
+       * A line that is refined, together with the index of the vertex at its
+       * midpoint and the first of the two lines that become its children.
+       * The first pass of the refinement of lines only reserves these
+       * objects; create_children_of_lines() then sets them up.
+       */
+      template <int dim, int spacedim>
+      struct RefinedLine
+      {
+        typename Triangulation<dim,spacedim>::line_iterator     line;
+        unsigned int                                            new_vertex;
+        typename Triangulation<dim,spacedim>::raw_line_iterator first_child;
+      };
+
+
+
+      /**
+       * Set up the midpoint vertices and the children of the lines collected
+       * in @p refined_lines, whose vertex and line slots have already been
+       * reserved and marked as used. The lines are worked on in parallel:
+       * asking a curved manifold for a new point is usually the most
+       * expensive part of the refinement of lines, and every line only
+       * writes to its own vertex and its own two children. The result is
+       * therefore the same as if the lines had been refined one after the
+       * other. This requires the manifolds to be thread-safe, see the
+       * documentation of the Manifold class.
+       *
+       * The function object @p compute_point returns the location of the
+       * new vertex for a given line.
+       */
+      template <int dim, int spacedim, typename PointFunction>
+      static
+      void
+      create_children_of_lines (Triangulation<dim,spacedim>                  &triangulation,
+                                const std::vector<RefinedLine<dim,spacedim> > &refined_lines,
+                                const PointFunction                          &compute_point)
+      {
+        parallel::apply_to_subranges
+        (0U, static_cast<unsigned int>(refined_lines.size()),
+         [&] (const unsigned int begin, const unsigned int end)
+        {
+          for (unsigned int i=begin; i<end; ++i)
+            {
+              const typename Triangulation<dim,spacedim>::line_iterator
+              &line = refined_lines[i].line;
+              const unsigned int new_vertex = refined_lines[i].new_vertex;
+
+              triangulation.vertices[new_vertex] = compute_point (line);
+
+              // the children of a line are consecutive
+              line->set_children (0, refined_lines[i].first_child->index());
+
+              typename Triangulation<dim,spacedim>::raw_line_iterator
+              children[2] = { refined_lines[i].first_child,
+                              refined_lines[i].first_child
+                            };
+              ++children[1];
+
+              children[0]->set (internal::Triangulation
+                                ::TriaObject<1>(line->vertex_index(0),
+                                                new_vertex));
+              children[1]->set (internal::Triangulation
+                                ::TriaObject<1>(new_vertex,
+                                                line->vertex_index(1)));
+
+              for (unsigned int c=0; c<2; ++c)
+                {
+                  children[c]->clear_children();
+                  children[c]->clear_user_data();
+                  children[c]->set_boundary_id_internal(line->boundary_id());
+                  children[c]->set_manifold_id (line->manifold_id());
+                }
+
+              // finally clear flag indicating the need for refinement
+              line->clear_user_flag ();
+            }
+        },
+        /* grain size */ 64);
+      }
+
+
+
       /**
        * A function that performs the
        * refinement of a triangulation in 1d.
@@ -4709,45 +4792,50 @@ namespace internal
             typename Triangulation<dim,spacedim>::raw_line_iterator
             next_unused_line = triangulation.begin_raw_line ();
 
+            // the manifold that provides the new vertex of a line, and the
+            // location of that vertex
+            const auto line_manifold =
+              [&triangulation] (const typename Triangulation<dim,spacedim>::line_iterator &line)
+              -> const Manifold<dim,spacedim> &
+            {
+              // for the case of a domain in an equal-dimensional space we
+              // use the manifold of the line. however, if spacedim>dim, we
+              // always have to ask the boundary object for its answer. We
+              // use the same object of the cell (which was stored in
+              // line->user_index() before) unless a manifold_id has been
+              // set on this very line.
+              if ((spacedim != dim) &&
+                  (line->manifold_id() == numbers::invalid_manifold_id))
+                return triangulation.get_manifold(line->user_index());
+              else
+                return line->get_manifold();
+            };
+            const auto new_line_midpoint =
+              [&line_manifold] (const typename Triangulation<dim,spacedim>::line_iterator &line)
+            {
+              if ((spacedim != dim) &&
+                  (line->manifold_id() == numbers::invalid_manifold_id))
+                return line_manifold(line).get_new_point_on_line (line);
+              else
+                return line->center(true);
+            };
+
+            std::vector<RefinedLine<dim,spacedim> > refined_lines;
+
             for (; line!=endl; ++line)
               if (line->user_flag_set())
                 {
                   // this line needs to be refined
 
-                  // find the next unused vertex and set it
-                  // appropriately
+                  // find the next unused vertex and reserve it
                   while (triangulation.vertices_used[next_unused_vertex] == true)
                     ++next_unused_vertex;
                   Assert (next_unused_vertex < triangulation.vertices.size(),
                           ExcMessage("Internal error: During refinement, the triangulation wants to access an element of the 'vertices' array but it turns out that the array is not large enough."));
                   triangulation.vertices_used[next_unused_vertex] = true;
 
-                  if (spacedim == dim)
-                    {
-                      // for the case of a domain in an
-                      // equal-dimensional space we only have to treat
-                      // boundary lines differently; for interior
-                      // lines we can compute the midpoint as the mean
-                      // of the two vertices: if (line->at_boundary())
-                      triangulation.vertices[next_unused_vertex]
-                        = line->center(true);
-                    }
-                  else
-                    // however, if spacedim>dim, we always have to ask
-                    // the boundary object for its answer. We use the
-                    // same object of the cell (which was stored in
-                    // line->user_index() before) unless a manifold_id
-                    // has been set on this very line.
-                    if (line->manifold_id() == numbers::invalid_manifold_id)
-                      triangulation.vertices[next_unused_vertex]
-                        = triangulation.get_manifold(line->user_index()).get_new_point_on_line (line);
-                    else
-                      triangulation.vertices[next_unused_vertex]
-                        = line->center(true);
-
-                  // now that we created the right point, make up the
-                  // two child lines.  To this end, find a pair of
-                  // unused lines
+                  // then find a pair of unused lines for the two child
+                  // lines
                   bool pair_found=false;
                   (void)pair_found;
                   for (; next_unused_line!=endl; ++next_unused_line)
@@ -4764,46 +4852,30 @@ namespace internal
 
                   // there are now two consecutive unused lines, such
                   // that the children of a line will be consecutive.
-                  // then set the child pointer of the present line
-                  line->set_children (0, next_unused_line->index());
-
-                  // set the two new lines
+                  // reserve them; the location of the new vertex and the
+                  // child lines are set up for all lines at once after
+                  // this loop
                   const typename Triangulation<dim,spacedim>::raw_line_iterator
                   children[2] = { next_unused_line,
                                   ++next_unused_line
                                 };
-                  // some tests; if any of the iterators should be
-                  // invalid, then already dereferencing will fail
-                  Assert (children[0]->used() == false, ExcMessage("Internal error: We want to use a cell during refinement that should be unused, but turns out not to be."));
-                  Assert (children[1]->used() == false, ExcMessage("Internal error: We want to use a cell during refinement that should be unused, but turns out not to be."));
-
-                  children[0]->set (internal::Triangulation
-                                    ::TriaObject<1>(line->vertex_index(0),
-                                                    next_unused_vertex));
-                  children[1]->set (internal::Triangulation
-                                    ::TriaObject<1>(next_unused_vertex,
-                                                    line->vertex_index(1)));
-
-                  children[0]->set_used_flag();
-                  children[1]->set_used_flag();
-                  children[0]->clear_children();
-                  children[1]->clear_children();
-                  children[0]->clear_user_data();
-                  children[1]->clear_user_data();
-                  children[0]->clear_user_flag();
-                  children[1]->clear_user_flag();
-
-
-                  children[0]->set_boundary_id_internal(line->boundary_id());
-                  children[1]->set_boundary_id_internal(line->boundary_id());
-
-                  children[0]->set_manifold_id (line->manifold_id());
-                  children[1]->set_manifold_id (line->manifold_id());
-
-                  // finally clear flag indicating the need for
-                  // refinement
-                  line->clear_user_flag ();
+                  for (unsigned int c=0; c<2; ++c)
+                    {
+                      // some tests; if any of the iterators should be
+                      // invalid, then already dereferencing will fail
+                      Assert (children[c]->used() == false, ExcMessage("Internal error: We want to use a cell during refinement that should be unused, but turns out not to be."));
+                      children[c]->set_used_flag();
+
+                      // the loop over lines may also visit the new lines,
+                      // which must not be refined
+                      children[c]->clear_user_flag();
+                    }
+
+                  refined_lines.push_back (RefinedLine<dim,spacedim> {line, next_unused_vertex, children[0]});
                 }
+
+            create_children_of_lines (triangulation, refined_lines,
+                                      new_line_midpoint);
           }
 
 
@@ -5178,72 +5250,54 @@ namespace internal
             typename Triangulation<dim,spacedim>::raw_line_iterator
             next_unused_line = triangulation.begin_raw_line ();
 
+            std::vector<RefinedLine<dim,spacedim> > refined_lines;
+
             for (; line!=endl; ++line)
               if (line->user_flag_set())
                 {
                   // this line needs to be refined
 
-                  // find the next unused vertex and set it
-                  // appropriately
+                  // find the next unused vertex and reserve it
                   while (triangulation.vertices_used[next_unused_vertex] == true)
                     ++next_unused_vertex;
                   Assert (next_unused_vertex < triangulation.vertices.size(),
                           ExcMessage("Internal error: During refinement, the triangulation wants to access an element of the 'vertices' array but it turns out that the array is not large enough."));
                   triangulation.vertices_used[next_unused_vertex] = true;
 
-                  triangulation.vertices[next_unused_vertex]
-                    = line->center(true);
-
-                  // now that we created the right point, make up the
-                  // two child lines (++ takes care of the end of the
-                  // vector)
+                  // then find two consecutive unused lines for the two
+                  // child lines (++ takes care of the end of the vector)
                   next_unused_line=triangulation.faces->lines.next_free_pair_object(triangulation);
                   Assert(next_unused_line.state() == IteratorState::valid,
                          ExcInternalError());
 
-                  // now we found two consecutive unused lines, such
-                  // that the children of a line will be consecutive.
-                  // then set the child pointer of the present line
-                  line->set_children (0, next_unused_line->index());
-
-                  // set the two new lines
+                  // reserve them; the location of the new vertex and the
+                  // child lines are set up for all lines at once after
+                  // this loop
                   const typename Triangulation<dim,spacedim>::raw_line_iterator
                   children[2] = { next_unused_line,
                                   ++next_unused_line
                                 };
+                  for (unsigned int c=0; c<2; ++c)
+                    {
+                      // some tests; if any of the iterators should be
+                      // invalid, then already dereferencing will fail
+                      Assert (children[c]->used() == false, ExcMessage("Internal error: We want to use a cell during refinement that should be unused, but turns out not to be."));
+                      children[c]->set_used_flag();
+
+                      // the loop over lines may also visit the new lines,
+                      // which must not be refined
+                      children[c]->clear_user_flag();
+                    }
 
-                  // some tests; if any of the iterators should be
-                  // invalid, then already dereferencing will fail
-                  Assert (children[0]->used() == false, ExcMessage("Internal error: We want to use a cell during refinement that should be unused, but turns out not to be."));
-                  Assert (children[1]->used() == false, ExcMessage("Internal error: We want to use a cell during refinement that should be unused, but turns out not to be."));
-
-                  children[0]->set (internal::Triangulation
-                                    ::TriaObject<1>(line->vertex_index(0),
-                                                    next_unused_vertex));
-                  children[1]->set (internal::Triangulation
-                                    ::TriaObject<1>(next_unused_vertex,
-                                                    line->vertex_index(1)));
-
-                  children[0]->set_used_flag();
-                  children[1]->set_used_flag();
-                  children[0]->clear_children();
-                  children[1]->clear_children();
-                  children[0]->clear_user_data();
-                  children[1]->clear_user_data();
-                  children[0]->clear_user_flag();
-                  children[1]->clear_user_flag();
-
-                  children[0]->set_boundary_id_internal(line->boundary_id());
-                  children[1]->set_boundary_id_internal(line->boundary_id());
-
-                  children[0]->set_manifold_id (line->manifold_id());
-                  children[1]->set_manifold_id (line->manifold_id());
-
-                  // finally clear flag
-                  // indicating the need
-                  // for refinement
-                  line->clear_user_flag ();
+                  refined_lines.push_back (RefinedLine<dim,spacedim> {line, next_unused_vertex, children[0]});
                 }
+
+            create_children_of_lines
+            (triangulation, refined_lines,
+             [] (const typename Triangulation<dim,spacedim>::line_iterator &line)
+            {
+              return line->center(true);
+            });
           }
 
 
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1998 - 2017 by the deal.II authors
+// Copyright (C) 1998 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -17,6 +17,7 @@
 #include <deal.II/lac/constraint_matrix.templates.h>
 
 #include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/lac/dynamic_sparsity_pattern.h>
 #include <deal.II/lac/block_vector.h>
 #include <deal.II/lac/block_sparse_matrix.h>
@@ -225,16 +226,29 @@ void ConstraintMatrix::close ()
       Assert (i == calculate_line_index(lines[lines_cache[i]].index),
               ExcInternalError());
 
+  // the lines are independent of each other in all of the steps below
+  // except for the resolution of chains of constraints. do these steps in
+  // parallel, using chunks of lines that are large enough to make the
+  // spawning of tasks worthwhile
+  const size_type grain_size = 1000;
+
   // first, strip zero entries, as we have to do that only once
-  for (std::vector<ConstraintLine>::iterator line = lines.begin();
-       line!=lines.end(); ++line)
-    // first remove zero entries. that would mean that in the linear
-    // constraint for a node, x_i = ax_1 + bx_2 + ..., another node times 0
-    // appears. obviously, 0*something can be omitted
-    line->entries.erase (std::remove_if (line->entries.begin(),
-                                         line->entries.end(),
-                                         &check_zero_weight),
-                         line->entries.end());
+  parallel::apply_to_subranges
+  (lines.begin(), lines.end(),
+   [] (const std::vector<ConstraintLine>::iterator &begin,
+       const std::vector<ConstraintLine>::iterator &end)
+  {
+    for (std::vector<ConstraintLine>::iterator line = begin;
+         line!=end; ++line)
+      // first remove zero entries. that would mean that in the linear
+      // constraint for a node, x_i = ax_1 + bx_2 + ..., another node times 0
+      // appears. obviously, 0*something can be omitted
+      line->entries.erase (std::remove_if (line->entries.begin(),
+                                           line->entries.end(),
+                                           &check_zero_weight),
+                           line->entries.end());
+  },
+  grain_size);
 
 
 
@@ -269,8 +283,40 @@ void ConstraintMatrix::close ()
   // we sort the list so that throwing out duplicates becomes much more
   // efficient. also, we have to do it only once, rather than in each
   // iteration
+  //
+  // in many cases (e.g., hanging nodes in 2d without boundary values),
+  // there are no such chains at all. finding out about this only requires
+  // reading the constraints and can be done in parallel, whereas the loop
+  // below has to run serially since it modifies lines that other lines
+  // read from. we skip the loop if there is nothing to do
+  const auto count_chained_lines
+    = [this] (const std::vector<ConstraintLine>::const_iterator &begin,
+              const std::vector<ConstraintLine>::const_iterator &end)
+  {
+    size_type n_chained = 0;
+    for (std::vector<ConstraintLine>::const_iterator line = begin;
+         line!=end; ++line)
+      for (size_type entry=0; entry<line->entries.size(); ++entry)
+        if (((local_lines.size() == 0)
+             ||
+             (local_lines.is_element(line->entries[entry].first)))
+            &&
+            is_constrained (line->entries[entry].first))
+          {
+            ++n_chained;
+            break;
+          }
+    return n_chained;
+  };
+  const bool has_chained_constraints
+    = (parallel::accumulate_from_subranges<size_type> (count_chained_lines,
+                                                       lines.cbegin(),
+                                                       lines.cend(),
+                                                       grain_size)
+       > 0);
+
   size_type iteration = 0;
-  while (true)
+  while (has_chained_constraints)
     {
       bool chained_constraint_replaced = false;
 
@@ -385,82 +431,89 @@ void ConstraintMatrix::close ()
   // we also throw out duplicates as mentioned above. moreover, as some
   // entries might have had zero weights, we replace them by a vector with
   // sharp sizes.
-  for (std::vector<ConstraintLine>::iterator line = lines.begin();
-       line!=lines.end(); ++line)
-    {
-      std::sort (line->entries.begin(), line->entries.end());
-
-      // loop over the now sorted list and see whether any of the entries
-      // references the same dofs more than once in order to find how many
-      // non-duplicate entries we have. This lets us allocate the correct
-      // amount of memory for the constraint entries.
-      size_type duplicates = 0;
-      for (size_type i=1; i<line->entries.size(); ++i)
-        if (line->entries[i].first == line->entries[i-1].first)
-          duplicates++;
-
-      if (duplicates > 0 || line->entries.size() < line->entries.capacity())
-        {
-          ConstraintLine::Entries new_entries;
+  parallel::apply_to_subranges
+  (lines.begin(), lines.end(),
+   [] (const std::vector<ConstraintLine>::iterator &begin,
+       const std::vector<ConstraintLine>::iterator &end)
+  {
+    for (std::vector<ConstraintLine>::iterator line = begin;
+         line!=end; ++line)
+      {
+        std::sort (line->entries.begin(), line->entries.end());
+
+        // loop over the now sorted list and see whether any of the entries
+        // references the same dofs more than once in order to find how many
+        // non-duplicate entries we have. This lets us allocate the correct
+        // amount of memory for the constraint entries.
+        size_type duplicates = 0;
+        for (size_type i=1; i<line->entries.size(); ++i)
+          if (line->entries[i].first == line->entries[i-1].first)
+            duplicates++;
+
+        if (duplicates > 0 || line->entries.size() < line->entries.capacity())
+          {
+            ConstraintLine::Entries new_entries;
 
-          // if we have no duplicates, copy verbatim the entries. this way,
-          // the final size is of the vector is correct.
-          if (duplicates == 0)
-            new_entries = line->entries;
-          else
-            {
-              // otherwise, we need to go through the list by and and
-              // resolve the duplicates
-              new_entries.reserve (line->entries.size() - duplicates);
-              new_entries.push_back(line->entries[0]);
-              for (size_type j=1; j<line->entries.size(); ++j)
-                if (line->entries[j].first == line->entries[j-1].first)
+            // if we have no duplicates, copy verbatim the entries. this way,
+            // the final size is of the vector is correct.
+            if (duplicates == 0)
+              new_entries = line->entries;
+            else
+              {
+                // otherwise, we need to go through the list by and and
+                // resolve the duplicates
+                new_entries.reserve (line->entries.size() - duplicates);
+                new_entries.push_back(line->entries[0]);
+                for (size_type j=1; j<line->entries.size(); ++j)
+                  if (line->entries[j].first == line->entries[j-1].first)
+                    {
+                      Assert (new_entries.back().first == line->entries[j].first,
+                              ExcInternalError());
+                      new_entries.back().second += line->entries[j].second;
+                    }
+                  else
+                    new_entries.push_back (line->entries[j]);
+
+                Assert (new_entries.size() == line->entries.size() - duplicates,
+                        ExcInternalError());
+
+                // make sure there are really no duplicates left and that the
+                // list is still sorted
+                for (size_type j=1; j<new_entries.size(); ++j)
                   {
-                    Assert (new_entries.back().first == line->entries[j].first,
+                    Assert (new_entries[j].first != new_entries[j-1].first,
+                            ExcInternalError());
+                    Assert (new_entries[j].first > new_entries[j-1].first,
                             ExcInternalError());
-                    new_entries.back().second += line->entries[j].second;
                   }
-                else
-                  new_entries.push_back (line->entries[j]);
-
-              Assert (new_entries.size() == line->entries.size() - duplicates,
-                      ExcInternalError());
-
-              // make sure there are really no duplicates left and that the
-              // list is still sorted
-              for (size_type j=1; j<new_entries.size(); ++j)
-                {
-                  Assert (new_entries[j].first != new_entries[j-1].first,
-                          ExcInternalError());
-                  Assert (new_entries[j].first > new_entries[j-1].first,
-                          ExcInternalError());
-                }
-            }
+              }
 
-          // replace old list of constraints for this dof by the new one
-          line->entries.swap (new_entries);
-        }
+            // replace old list of constraints for this dof by the new one
+            line->entries.swap (new_entries);
+          }
 
-      // finally do the following check: if the sum of weights for the
-      // constraints is close to one, but not exactly one, then rescale all
-      // the weights so that they sum up to 1. this adds a little numerical
-      // stability and avoids all sorts of problems where the actual value
-      // is close to, but not quite what we expected
-      //
-      // the case where the weights don't quite sum up happens when we
-      // compute the interpolation weights "on the fly", i.e. not from
-      // precomputed tables. in this case, the interpolation weights are
-      // also subject to round-off
-      double sum = 0;
-      for (size_type i=0; i<line->entries.size(); ++i)
-        sum += line->entries[i].second;
-      if ((sum != 1.0) && (std::fabs (sum-1.) < 1.e-13))
-        {
-          for (size_type i=0; i<line->entries.size(); ++i)
-            line->entries[i].second /= sum;
-          line->inhomogeneity /= sum;
-        }
-    } // end of loop over all constraint lines
+        // finally do the following check: if the sum of weights for the
+        // constraints is close to one, but not exactly one, then rescale all
+        // the weights so that they sum up to 1. this adds a little numerical
+        // stability and avoids all sorts of problems where the actual value
+        // is close to, but not quite what we expected
+        //
+        // the case where the weights don't quite sum up happens when we
+        // compute the interpolation weights "on the fly", i.e. not from
+        // precomputed tables. in this case, the interpolation weights are
+        // also subject to round-off
+        double sum = 0;
+        for (size_type i=0; i<line->entries.size(); ++i)
+          sum += line->entries[i].second;
+        if ((sum != 1.0) && (std::fabs (sum-1.) < 1.e-13))
+          {
+            for (size_type i=0; i<line->entries.size(); ++i)
+              line->entries[i].second /= sum;
+            line->inhomogeneity /= sum;
+          }
+      } // end of loop over all constraint lines
+  },
+  grain_size);
 
 #ifdef DEBUG
   // if in debug mode: check that no dof is constrained to another dof that
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2008 - 2017 by the deal.II authors
+// Copyright (C) 2008 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -16,6 +16,7 @@
 #include <deal.II/lac/dynamic_sparsity_pattern.h>
 #include <deal.II/lac/sparsity_pattern.h>
 #include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/parallel.h>
 
 #include <algorithm>
 #include <cmath>
@@ -353,6 +354,46 @@ DynamicSparsityPattern::max_entries_per_row () const
 
 
 
+void
+DynamicSparsityPattern::add_entries_from (const DynamicSparsityPattern &other)
+{
+  AssertDimension (rows, other.rows);
+  AssertDimension (cols, other.cols);
+  Assert (rowset.size() == 0 ||
+          (other.rowset.size() > 0 && (other.rowset & rowset) == other.rowset),
+          ExcMessage ("The rows stored in the other sparsity pattern need to "
+                      "be a subset of the rows stored in this one."));
+
+  if (!other.have_entries)
+    return;
+
+  have_entries = true;
+
+  // the rows are independent of each other, so merge them in parallel
+  parallel::apply_to_subranges
+  (static_cast<size_type>(0), static_cast<size_type>(other.lines.size()),
+   [this,&other] (const size_type begin, const size_type end)
+  {
+    for (size_type other_row=begin; other_row<end; ++other_row)
+      if (other.lines[other_row].entries.size() > 0)
+        {
+          const size_type row = (other.rowset.size() == 0 ?
+                                 other_row :
+                                 other.rowset.nth_index_in_set (other_row));
+          const size_type rowindex = (rowset.size() == 0 ?
+                                      row :
+                                      rowset.index_within_set (row));
+          lines[rowindex].add_entries (other.lines[other_row].entries.data(),
+                                       other.lines[other_row].entries.data() +
+                                       other.lines[other_row].entries.size(),
+                                       true);
+        }
+  },
+  1000);
+}
+
+
+
 bool
 DynamicSparsityPattern::exists (const size_type i,
                                 const size_type j) const
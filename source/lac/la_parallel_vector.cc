@@ -39,6 +39,16 @@ namespace LinearAlgebra
     TEMPL_COPY_CONSTRUCTOR(std::complex<float>,std::complex<double>);
 
 #undef TEMPL_COPY_CONSTRUCTOR
+
+    // the same applies to sadd(s,V), where the case of equal number types is
+    // covered by the non-template overload
+#define TEMPL_SADD(S1,S2)                                               \
+  template void Vector<S1>::sadd<S2> (const S1, const Vector<S2> &)
+
+    TEMPL_SADD(double,float);
+    TEMPL_SADD(float,double);
+
+#undef TEMPL_SADD
   }
 }
 
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1999 - 2017 by the deal.II authors
+// Copyright (C) 1999 - 2018 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -27,6 +27,7 @@
 #include <deal.II/fe/mapping_q1.h>
 
 #include <sstream>
+#include <limits>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -66,7 +67,8 @@ build_one_patch
 (const std::pair<cell_iterator, unsigned int>                                                *cell_and_index,
  internal::DataOut::ParallelData<DoFHandlerType::dimension, DoFHandlerType::space_dimension> &scratch_data,
  const unsigned int                                                                           n_subdivisions,
- const CurvedCellRegion                                                                       curved_cell_region)
+ const CurvedCellRegion                                                                       curved_cell_region,
+ const unsigned int                                                                           first_patch_index)
 {
   // first create the output object that we will write into
   ::dealii::DataOutBase::Patch<DoFHandlerType::dimension, DoFHandlerType::space_dimension> patch;
@@ -355,13 +357,15 @@ build_one_patch
   const unsigned int patch_idx =
     (*scratch_data.cell_to_patch_index_map)[cell_and_index->first->level()][cell_and_index->first->index()];
   // did we mess up the indices?
-  Assert(patch_idx < this->patches.size(), ExcInternalError());
+  Assert(patch_idx >= first_patch_index &&
+         patch_idx - first_patch_index < this->patches.size(),
+         ExcInternalError());
   patch.patch_index = patch_idx;
 
   // Put the patch into the patches vector. instead of copying the data,
   // simply swap the contents to avoid the penalty of writing into another
   // processor's memory
-  this->patches[patch_idx].swap (patch);
+  this->patches[patch_idx - first_patch_index].swap (patch);
 }
 
 
@@ -378,8 +382,76 @@ void DataOut<dim,DoFHandlerType>::build_patches (const unsigned int n_subdivisio
 template <int dim, typename DoFHandlerType>
 void DataOut<dim,DoFHandlerType>::build_patches
 (const Mapping<DoFHandlerType::dimension,DoFHandlerType::space_dimension> &mapping,
- const unsigned int                                                        n_subdivisions_,
+ const unsigned int                                                        n_subdivisions,
  const CurvedCellRegion                                                    curved_region)
+{
+  build_patches_in_chunks (mapping, n_subdivisions, curved_region,
+                           numbers::invalid_unsigned_int,
+                           std::function<void ()>());
+}
+
+
+
+template <int dim, typename DoFHandlerType>
+void DataOut<dim,DoFHandlerType>::write_vtu_in_chunks
+(std::ostream       &out,
+ const unsigned int  n_subdivisions,
+ const unsigned int  n_cells_per_chunk)
+{
+  write_vtu_in_chunks (out,
+                       StaticMappingQ1<DoFHandlerType::dimension,DoFHandlerType::space_dimension>::mapping,
+                       n_subdivisions, no_curved_cells, n_cells_per_chunk);
+}
+
+
+
+template <int dim, typename DoFHandlerType>
+void DataOut<dim,DoFHandlerType>::write_vtu_in_chunks
+(std::ostream                                                             &out,
+ const Mapping<DoFHandlerType::dimension,DoFHandlerType::space_dimension> &mapping,
+ const unsigned int                                                        n_subdivisions,
+ const CurvedCellRegion                                                    curved_region,
+ const unsigned int                                                        n_cells_per_chunk)
+{
+  Assert (n_cells_per_chunk > 0,
+          ExcMessage ("The number of cells per chunk must be positive."));
+  AssertThrow (out, ExcIO());
+
+  DataOutBase::VtkFlags flags = this->get_vtk_flags();
+  DataOutBase::write_vtu_header (out, flags);
+
+  // write each chunk of patches as a piece of its own, so that the patches
+  // can be discarded right after. write_vtu_main() puts the time and cycle
+  // into a <FieldData> block in front of the piece, which a VTU file may
+  // only contain once, so reset them to their defaults after the first chunk
+  const std::vector<std::string> data_names = this->get_dataset_names();
+  const std::vector<std::tuple<unsigned int, unsigned int, std::string> >
+  vector_data_ranges = this->get_vector_data_ranges();
+  std::vector<char> appended_data;
+  build_patches_in_chunks (mapping, n_subdivisions, curved_region,
+                           n_cells_per_chunk,
+                           [&]()
+  {
+    DataOutBase::write_vtu_main (this->patches, data_names, vector_data_ranges,
+                                 flags, out, appended_data);
+    flags.time = std::numeric_limits<double>::min();
+    flags.cycle = std::numeric_limits<unsigned int>::min();
+  });
+  this->patches.clear ();
+
+  DataOutBase::write_vtu_footer (out, appended_data);
+  out << std::flush;
+}
+
+
+
+template <int dim, typename DoFHandlerType>
+void DataOut<dim,DoFHandlerType>::build_patches_in_chunks
+(const Mapping<DoFHandlerType::dimension,DoFHandlerType::space_dimension> &mapping,
+ const unsigned int                                                        n_subdivisions_,
+ const CurvedCellRegion                                                    curved_region,
+ const unsigned int                                                        n_cells_per_chunk,
+ const std::function<void ()>                                              &process_chunk)
 {
   // Check consistency of redundant template parameter
   Assert (dim==DoFHandlerType::dimension, ExcDimensionMismatch(dim, DoFHandlerType::dimension));
@@ -464,7 +536,6 @@ void DataOut<dim,DoFHandlerType>::build_patches
   }
 
   this->patches.clear ();
-  this->patches.resize(all_cells.size());
 
   // now create a default object for the WorkStream object to work with
   unsigned int n_datasets = 0;
@@ -505,31 +576,49 @@ void DataOut<dim,DoFHandlerType>::build_patches
                update_flags,
                cell_to_patch_index_map);
 
-  // now build the patches in parallel
-  if (all_cells.size() > 0)
-    WorkStream::run (&all_cells[0],
-                     &all_cells[0]+all_cells.size(),
-                     std::bind(&DataOut<dim,DoFHandlerType>::build_one_patch,
-                               this,
-                               std::placeholders::_1,
-                               std::placeholders::_2,
-                               /* no std::placeholders::_3, since this function doesn't actually need a
-                                  copy data object -- it just writes everything right into the
-                                  output array */
-                               n_subdivisions,
-                               curved_cell_region),
-                     // no copy-local-to-global function needed here
-                     std::function<void (const int &)>(),
-                     thread_data,
-                     /* dummy CopyData object = */ 0,
-                     // experimenting shows that we can make things run a bit
-                     // faster if we increase the number of cells we work on
-                     // per item (i.e., WorkStream's chunk_size argument,
-                     // about 10% improvement) and the items in flight at any
-                     // given time (another 5% on the testcase discussed in
-                     // @ref workstream_paper, on 32 cores) and if
-                     8*MultithreadInfo::n_threads(),
-                     64);
+  // now build the patches in parallel, one chunk after the other
+  const unsigned int chunk_size = std::max (std::min (n_cells_per_chunk,
+                                                      static_cast<unsigned int>(all_cells.size())),
+                                            1U);
+  for (unsigned int chunk_begin=0; chunk_begin<all_cells.size(); chunk_begin+=chunk_size)
+    {
+      const unsigned int chunk_end = std::min (chunk_begin+chunk_size,
+                                               static_cast<unsigned int>(all_cells.size()));
+      this->patches.clear ();
+      this->patches.resize (chunk_end-chunk_begin);
+
+      WorkStream::run (&all_cells[0]+chunk_begin,
+                       &all_cells[0]+chunk_end,
+                       std::bind(&DataOut<dim,DoFHandlerType>::build_one_patch,
+                                 this,
+                                 std::placeholders::_1,
+                                 std::placeholders::_2,
+                                 /* no std::placeholders::_3, since this function doesn't actually need a
+                                    copy data object -- it just writes everything right into the
+                                    output array */
+                                 n_subdivisions,
+                                 curved_cell_region,
+                                 chunk_begin),
+                       // no copy-local-to-global function needed here
+                       std::function<void (const int &)>(),
+                       thread_data,
+                       /* dummy CopyData object = */ 0,
+                       // experimenting shows that we can make things run a bit
+                       // faster if we increase the number of cells we work on
+                       // per item (i.e., WorkStream's chunk_size argument,
+                       // about 10% improvement) and the items in flight at any
+                       // given time (another 5% on the testcase discussed in
+                       // @ref workstream_paper, on 32 cores) and if
+                       8*MultithreadInfo::n_threads(),
+                       64);
+
+      if (process_chunk)
+        process_chunk ();
+    }
+
+  // even without any cells, let the caller produce its (empty) output
+  if (all_cells.size() == 0 && process_chunk)
+    process_chunk ();
 }
 
 
@@ -0,0 +1,157 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// write VTU output with VtkFlags::appended_raw_data and check that the raw
+// data of each array, found through its offset in the appended section, is
+// the same as the base64 decoded data of the inline output
+
+#include "../tests.h"
+#include <deal.II/base/data_out_base.h>
+
+#include <sstream>
+
+
+
+std::vector<unsigned char>
+decode_base64 (const std::string &encoded)
+{
+  const std::string characters
+    = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::vector<unsigned char> decoded;
+  unsigned int buffer = 0, n_bits = 0;
+  for (unsigned int i=0; i<encoded.size() && encoded[i] != '='; ++i)
+    {
+      buffer = (buffer << 6) | characters.find (encoded[i]);
+      n_bits += 6;
+      if (n_bits >= 8)
+        {
+          n_bits -= 8;
+          decoded.push_back ((buffer >> n_bits) & 0xff);
+        }
+    }
+  return decoded;
+}
+
+
+
+// decode the contents of all data arrays of an inline VTU file. the header
+// and the data are encoded separately
+std::vector<std::vector<unsigned char> >
+decode_inline_arrays (const std::string &vtu)
+{
+  std::vector<std::vector<unsigned char> > arrays;
+  for (std::string::size_type pos = vtu.find("format=\"binary\">");
+       pos != std::string::npos;
+       pos = vtu.find("format=\"binary\">", pos+1))
+    {
+      const std::string::size_type begin = vtu.find('>', pos) + 1;
+      const std::string::size_type end = vtu.find ("</DataArray>", begin);
+      std::string encoded;
+      for (std::string::size_type i=begin; i<end; ++i)
+        if (!std::isspace (vtu[i]))
+          encoded += vtu[i];
+
+      const std::vector<unsigned char> first = decode_base64 (encoded.substr (0, 8));
+      uint32_t n_blocks;
+      std::memcpy (&n_blocks, first.data(), sizeof(n_blocks));
+      const unsigned int header_length = 4*((4*(3+n_blocks)+2)/3);
+      std::vector<unsigned char> array = decode_base64 (encoded.substr (0, header_length));
+      const std::vector<unsigned char> data = decode_base64 (encoded.substr (header_length));
+      array.insert (array.end(), data.begin(), data.end());
+      arrays.push_back (array);
+    }
+  return arrays;
+}
+
+
+
+// split the appended section of a VTU file into the data of the arrays,
+// using their offsets
+std::vector<std::vector<unsigned char> >
+extract_appended_arrays (const std::string &vtu)
+{
+  const std::string start = "<AppendedData encoding=\"raw\">\n_";
+  const std::string::size_type begin = vtu.find (start) + start.size();
+  const std::string::size_type end = vtu.rfind ("\n</AppendedData>");
+  AssertThrow (vtu.rfind ("</UnstructuredGrid>", begin) != std::string::npos,
+               ExcInternalError());
+
+  std::vector<std::size_t> offsets;
+  const std::string key = "format=\"appended\" offset=\"";
+  for (std::string::size_type pos = vtu.find(key); pos < begin;
+       pos = vtu.find(key, pos+1))
+    offsets.push_back (Utilities::string_to_int
+                       (vtu.substr (pos+key.size(),
+                                    vtu.find('"', pos+key.size()) - pos - key.size())));
+  offsets.push_back (end - begin);
+
+  std::vector<std::vector<unsigned char> > arrays;
+  for (unsigned int i=0; i+1<offsets.size(); ++i)
+    {
+      AssertThrow (offsets[i] < offsets[i+1], ExcInternalError());
+      arrays.emplace_back (vtu.begin() + begin + offsets[i],
+                           vtu.begin() + begin + offsets[i+1]);
+    }
+  return arrays;
+}
+
+
+
+void test (const unsigned int n_patches)
+{
+  std::vector<DataOutBase::Patch<2,2> > patches (n_patches);
+  for (unsigned int p=0; p<n_patches; ++p)
+    {
+      for (unsigned int v=0; v<GeometryInfo<2>::vertices_per_cell; ++v)
+        patches[p].vertices[v] = Point<2>(p + v%2, v/2);
+      patches[p].data.reinit (3, GeometryInfo<2>::vertices_per_cell);
+      for (unsigned int v=0; v<GeometryInfo<2>::vertices_per_cell; ++v)
+        for (unsigned int c=0; c<3; ++c)
+          patches[p].data(c,v) = p + 0.25*v + c;
+      patches[p].patch_index = p;
+    }
+
+  std::vector<std::string> names = {"u", "v", "p"};
+  std::vector<std::tuple<unsigned int, unsigned int, std::string> > vectors
+  = {std::make_tuple (0U, 1U, std::string("velocity"))};
+  DataOutBase::VtkFlags flags;
+  flags.print_date_and_time = false;
+  std::ostringstream inline_output;
+  DataOutBase::write_vtu (patches, names, vectors, flags, inline_output);
+
+  flags.appended_raw_data = true;
+  std::ostringstream appended_output;
+  DataOutBase::write_vtu (patches, names, vectors, flags, appended_output);
+
+  const std::vector<std::vector<unsigned char> > inline_arrays
+    = decode_inline_arrays (inline_output.str());
+  const std::vector<std::vector<unsigned char> > appended_arrays
+    = extract_appended_arrays (appended_output.str());
+  deallog << n_patches << " patches: " << appended_arrays.size()
+          << " appended arrays, identical to inline data: "
+          << (inline_arrays == appended_arrays ? "yes" : "no") << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  test (10);
+  test (100000);
+}
@@ -0,0 +1,143 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// write VTU output with a points array large enough to be split into several
+// compressed blocks, then decode the base64 data, decompress the blocks and
+// compare with the vertices of the patches
+
+#include "../tests.h"
+#include <deal.II/base/data_out_base.h>
+
+#include <sstream>
+#include <zlib.h>
+
+
+
+std::vector<unsigned char>
+decode_base64 (const std::string &encoded)
+{
+  const std::string characters
+    = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::vector<unsigned char> decoded;
+  unsigned int buffer = 0, n_bits = 0;
+  for (unsigned int i=0; i<encoded.size() && encoded[i] != '='; ++i)
+    {
+      buffer = (buffer << 6) | characters.find (encoded[i]);
+      n_bits += 6;
+      if (n_bits >= 8)
+        {
+          n_bits -= 8;
+          decoded.push_back ((buffer >> n_bits) & 0xff);
+        }
+    }
+  return decoded;
+}
+
+
+
+template <typename T>
+T
+read_value (const std::vector<unsigned char> &bytes,
+            const unsigned int                position)
+{
+  T value;
+  std::memcpy (&value, &bytes[position], sizeof(T));
+  return value;
+}
+
+
+
+void test (const DataOutBase::VtkFlags::ZlibCompressionLevel compression_level)
+{
+  const unsigned int n_patches = 100000;
+  std::vector<DataOutBase::Patch<2,2> > patches (n_patches);
+  for (unsigned int p=0; p<n_patches; ++p)
+    {
+      for (unsigned int v=0; v<GeometryInfo<2>::vertices_per_cell; ++v)
+        patches[p].vertices[v] = Point<2>(p + v%2, v/2);
+      patches[p].data.reinit (1, GeometryInfo<2>::vertices_per_cell);
+      patches[p].patch_index = p;
+    }
+
+  std::vector<std::string> names (1, "data");
+  std::vector<std::tuple<unsigned int, unsigned int, std::string> > vectors;
+  DataOutBase::VtkFlags flags;
+  flags.compression_level = compression_level;
+  std::ostringstream out;
+  DataOutBase::write_vtu (patches, names, vectors, flags, out);
+
+  // extract the points array
+  const std::string output = out.str();
+  const std::string start = "<Points>\n    <DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"binary\">\n";
+  const std::string::size_type begin = output.find (start) + start.size();
+  const std::string::size_type end = output.find ("</DataArray>", begin);
+  std::string encoded;
+  for (std::string::size_type i=begin; i<end; ++i)
+    if (!std::isspace (output[i]))
+      encoded += output[i];
+
+  // the header is encoded separately from the data. the first entry is the
+  // number of blocks, from which we get the size of the header
+  const unsigned int n_blocks
+    = read_value<uint32_t> (decode_base64 (encoded.substr (0, 8)), 0);
+  const unsigned int header_length = 4*((4*(3+n_blocks)+2)/3);
+  const std::vector<unsigned char> header
+    = decode_base64 (encoded.substr (0, header_length));
+  const std::vector<unsigned char> compressed_data
+    = decode_base64 (encoded.substr (header_length));
+  deallog << "Number of blocks: " << n_blocks << std::endl;
+
+  std::vector<float> points;
+  unsigned int offset = 0;
+  for (unsigned int block=0; block<n_blocks; ++block)
+    {
+      const unsigned int block_size
+        = read_value<uint32_t> (header, 4*(block == n_blocks-1 ? 2 : 1));
+      const unsigned int compressed_size
+        = read_value<uint32_t> (header, 4*(3+block));
+      std::vector<float> block_data (block_size/sizeof(float));
+      uLongf uncompressed_size = block_size;
+      const int err = uncompress ((Bytef *)block_data.data(), &uncompressed_size,
+                                  &compressed_data[offset], compressed_size);
+      AssertThrow (err == Z_OK && uncompressed_size == block_size,
+                   ExcInternalError());
+      points.insert (points.end(), block_data.begin(), block_data.end());
+      offset += compressed_size;
+    }
+  AssertThrow (offset == compressed_data.size(), ExcInternalError());
+  AssertThrow (points.size() == 3*GeometryInfo<2>::vertices_per_cell*n_patches,
+               ExcInternalError());
+
+  bool points_match = true;
+  for (unsigned int p=0; p<n_patches; ++p)
+    for (unsigned int v=0; v<GeometryInfo<2>::vertices_per_cell; ++v)
+      for (unsigned int d=0; d<3; ++d)
+        if (points[(p*GeometryInfo<2>::vertices_per_cell+v)*3+d]
+            != (d<2 ? patches[p].vertices[v][d] : 0.))
+          points_match = false;
+  deallog << "Points match: " << (points_match ? "yes" : "no") << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  test (DataOutBase::VtkFlags::best_speed);
+  test (DataOutBase::VtkFlags::best_compression);
+}
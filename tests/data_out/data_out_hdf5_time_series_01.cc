@@ -0,0 +1,177 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+// tests HDF5TimeSeriesWriter: the mesh must only be written again into the
+// HDF5 file once the triangulation has been refined, and all time steps must
+// appear in the XDMF file. Read the data sets back and check their values,
+// their chunking and their filters
+
+#include "../tests.h"
+
+#include <deal.II/base/data_out_base.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/numerics/data_out.h>
+
+#include <hdf5.h>
+
+
+
+// read the two-dimensional data set with the given name and compare it with
+// the expected values
+template <typename T>
+void check_data_set (const hid_t           file_id,
+                     const std::string    &name,
+                     const hid_t           type,
+                     const std::vector<T> &expected_values)
+{
+  const hid_t dataset = H5Dopen2 (file_id, name.c_str(), H5P_DEFAULT);
+  AssertThrow (dataset >= 0, ExcIO());
+
+  const hid_t dataspace = H5Dget_space (dataset);
+  hsize_t dims[2];
+  AssertThrow (H5Sget_simple_extent_ndims (dataspace) == 2, ExcInternalError());
+  H5Sget_simple_extent_dims (dataspace, dims, nullptr);
+  H5Sclose (dataspace);
+
+  std::vector<T> values (dims[0]*dims[1]);
+  herr_t status = H5Dread (dataset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                           values.data());
+  AssertThrow (status >= 0, ExcIO());
+
+  // the layout and the filters are recorded in the creation property list
+  const hid_t plist = H5Dget_create_plist (dataset);
+  std::string layout = (H5Pget_layout (plist) == H5D_CHUNKED ? "chunked" : "contiguous");
+  hsize_t chunk_dims[2] = {0, 0};
+  if (H5Pget_layout (plist) == H5D_CHUNKED)
+    H5Pget_chunk (plist, 2, chunk_dims);
+  std::string filters;
+  for (int i=0; i<H5Pget_nfilters (plist); ++i)
+    {
+      unsigned int flags, filter_config;
+      std::size_t n_elements = 0;
+      char filter_name[64];
+      const H5Z_filter_t filter
+        = H5Pget_filter2 (plist, i, &flags, &n_elements, nullptr,
+                          sizeof(filter_name), filter_name, &filter_config);
+      filters += (filter == H5Z_FILTER_SHUFFLE ? " shuffle" :
+                  filter == H5Z_FILTER_DEFLATE ? " deflate" : " other");
+    }
+  H5Pclose (plist);
+  H5Dclose (dataset);
+
+  deallog << name << ": " << dims[0] << "x" << dims[1] << ", "
+          << layout << " with chunks of " << chunk_dims[0] << "x" << chunk_dims[1]
+          << ", filters:" << filters << ", values "
+          << (values == expected_values ? "OK" : "wrong") << std::endl;
+}
+
+
+
+void check()
+{
+  Triangulation<2> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (1);
+
+  FE_Q<2> fe (1);
+  DoFHandler<2> dof_handler (tria);
+
+  HDF5TimeSeriesWriter::AdditionalData additional_data;
+  additional_data.chunk_size = 10;
+  HDF5TimeSeriesWriter writer ("time_series.h5", "time_series.xdmf",
+                               MPI_COMM_SELF, additional_data);
+
+  // the data each step and each mesh is expected to contain
+  std::vector<std::vector<double> > expected_u;
+  std::vector<std::vector<double> > expected_nodes;
+  std::vector<std::vector<unsigned int> > expected_cells;
+
+  for (unsigned int step=0; step<3; ++step)
+    {
+      // refine the mesh before the last step
+      if (step == 2)
+        tria.refine_global (1);
+      dof_handler.distribute_dofs (fe);
+
+      Vector<double> solution (dof_handler.n_dofs());
+      for (unsigned int i=0; i<solution.size(); ++i)
+        solution(i) = step + 0.1*i;
+
+      DataOut<2> data_out;
+      data_out.attach_dof_handler (dof_handler);
+      data_out.add_data_vector (solution, "u");
+      data_out.build_patches ();
+
+      const unsigned int n_meshes_before = writer.n_meshes();
+      writer.write_time_step (data_out, 0.5*step);
+
+      deallog << "Time steps: " << writer.n_time_steps()
+              << ", meshes: " << writer.n_meshes() << std::endl;
+
+      DataOutBase::DataOutFilter data_filter
+      (DataOutBase::DataOutFilterFlags (false, true));
+      data_out.write_filtered_data (data_filter);
+      expected_u.emplace_back (data_filter.get_data_set(0),
+                               data_filter.get_data_set(0) + data_filter.n_nodes());
+      if (writer.n_meshes() > n_meshes_before)
+        {
+          expected_nodes.emplace_back ();
+          data_filter.fill_node_data (expected_nodes.back());
+          expected_cells.emplace_back ();
+          data_filter.fill_cell_data (0, expected_cells.back());
+        }
+    }
+
+  cat_file ("time_series.xdmf");
+
+  const hid_t file_id = H5Fopen ("time_series.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+  AssertThrow (file_id >= 0, ExcIO());
+
+  // the mesh of the second step must have been reused
+  for (unsigned int m=0; m<3; ++m)
+    {
+      const std::string group = "/mesh_" + Utilities::int_to_string(m);
+      deallog << group << " exists: "
+              << (H5Lexists (file_id, group.c_str(), H5P_DEFAULT) > 0 ? "yes" : "no")
+              << std::endl;
+    }
+
+  for (unsigned int m=0; m<expected_nodes.size(); ++m)
+    {
+      const std::string group = "/mesh_" + Utilities::int_to_string(m);
+      check_data_set (file_id, group + "/nodes", H5T_NATIVE_DOUBLE,
+                      expected_nodes[m]);
+      check_data_set (file_id, group + "/cells", H5T_NATIVE_UINT,
+                      expected_cells[m]);
+    }
+  for (unsigned int step=0; step<expected_u.size(); ++step)
+    check_data_set (file_id, "/step_" + Utilities::int_to_string(step) + "/u",
+                    H5T_NATIVE_DOUBLE, expected_u[step]);
+
+  H5Fclose (file_id);
+}
+
+
+
+int main()
+{
+  initlog();
+
+  check();
+}
@@ -0,0 +1,131 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check DataOut::write_vtu_in_chunks: with a single chunk the output must be
+// identical to build_patches() followed by write_vtu(), and with several
+// chunks the pieces must add up to the same number of points and cells while
+// the time and cycle are written only once
+
+#include "../tests.h"
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/numerics/data_out.h>
+#include <deal.II/numerics/vector_tools.h>
+#include <deal.II/base/function_lib.h>
+
+#include <sstream>
+
+
+
+// add up the values of the given attribute of all pieces in a VTU file
+unsigned int
+sum_attribute (const std::string &vtu,
+               const std::string &attribute)
+{
+  unsigned int sum = 0;
+  const std::string key = attribute + "=\"";
+  for (std::string::size_type pos = vtu.find(key); pos != std::string::npos;
+       pos = vtu.find(key, pos+1))
+    sum += Utilities::string_to_int (vtu.substr(pos+key.size(),
+                                                vtu.find('"', pos+key.size())
+                                                - pos - key.size()));
+  return sum;
+}
+
+
+
+unsigned int
+count_tags (const std::string &vtu,
+            const std::string &tag)
+{
+  unsigned int n = 0;
+  for (std::string::size_type pos = vtu.find(tag); pos != std::string::npos;
+       pos = vtu.find(tag, pos+1))
+    ++n;
+  return n;
+}
+
+
+
+template <int dim>
+void test ()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (5-dim);
+
+  FE_Q<dim> fe (2);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  Vector<double> solution (dof_handler.n_dofs());
+  VectorTools::interpolate (dof_handler, Functions::SquareFunction<dim>(),
+                            solution);
+  Vector<double> cell_data (tria.n_active_cells());
+  for (unsigned int i=0; i<cell_data.size(); ++i)
+    cell_data(i) = i;
+
+  DataOut<dim> data_out;
+  DataOutBase::VtkFlags flags;
+  flags.print_date_and_time = false;
+  flags.time = 0.5;
+  flags.cycle = 3;
+  data_out.set_flags (flags);
+  data_out.attach_dof_handler (dof_handler);
+  data_out.add_data_vector (solution, "solution");
+  data_out.add_data_vector (cell_data, "cell_data");
+
+  std::ostringstream reference;
+  data_out.build_patches (2);
+  data_out.write_vtu (reference);
+
+  std::ostringstream single_chunk;
+  data_out.write_vtu_in_chunks (single_chunk, 2, tria.n_active_cells());
+  deallog << "Single chunk identical: "
+          << (single_chunk.str() == reference.str() ? "yes" : "no")
+          << std::endl;
+
+  std::ostringstream chunked;
+  data_out.write_vtu_in_chunks (chunked, 2, 5);
+  deallog << "Pieces: " << count_tags (chunked.str(), "<Piece") << std::endl;
+  deallog << "FieldData blocks: " << count_tags (chunked.str(), "<FieldData>")
+          << " vs " << count_tags (reference.str(), "<FieldData>")
+          << std::endl;
+  deallog << "Points: " << sum_attribute (chunked.str(), "NumberOfPoints")
+          << " vs " << sum_attribute (reference.str(), "NumberOfPoints")
+          << std::endl;
+  deallog << "Cells: " << sum_attribute (chunked.str(), "NumberOfCells")
+          << " vs " << sum_attribute (reference.str(), "NumberOfCells")
+          << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  deallog.push ("2d");
+  test<2> ();
+  deallog.pop ();
+  deallog.push ("3d");
+  test<3> ();
+  deallog.pop ();
+}
@@ -0,0 +1,97 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// check that DoFHandler::distribute_dofs produces the same numbering when
+// the degrees of freedom are enumerated by several threads as when they
+// are enumerated by only one thread, on adaptively refined meshes that
+// are large enough for the parallel algorithm to kick in
+
+
+#include "../tests.h"
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_system.h>
+
+
+template <int dim>
+std::vector<types::global_dof_index>
+get_all_dof_indices (const DoFHandler<dim> &dof_handler)
+{
+  std::vector<types::global_dof_index> all_indices;
+  std::vector<types::global_dof_index> local_indices (dof_handler.get_fe().dofs_per_cell);
+  for (typename DoFHandler<dim>::active_cell_iterator
+       cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell)
+    {
+      cell->get_dof_indices (local_indices);
+      all_indices.insert (all_indices.end(), local_indices.begin(), local_indices.end());
+    }
+  return all_indices;
+}
+
+
+
+template <int dim>
+void test (const FiniteElement<dim> &fe)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (dim == 2 ? 5 : 3);
+
+  // refine every third cell to get hanging nodes
+  unsigned int index = 0;
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell, ++index)
+    if (index % 3 == 0)
+      cell->set_refine_flag ();
+  tria.execute_coarsening_and_refinement ();
+
+  DoFHandler<dim> dof_handler (tria);
+
+  MultithreadInfo::set_thread_limit (1);
+  dof_handler.distribute_dofs (fe);
+  const std::vector<types::global_dof_index> serial_indices
+    = get_all_dof_indices (dof_handler);
+  const types::global_dof_index serial_n_dofs = dof_handler.n_dofs();
+
+  MultithreadInfo::set_thread_limit (4);
+  dof_handler.distribute_dofs (fe);
+  const std::vector<types::global_dof_index> parallel_indices
+    = get_all_dof_indices (dof_handler);
+
+  deallog << fe.get_name()
+          << ": cells=" << tria.n_active_cells()
+          << " same n_dofs: " << (serial_n_dofs == dof_handler.n_dofs() ? "yes" : "no")
+          << " same numbering: " << (serial_indices == parallel_indices ? "yes" : "no")
+          << std::endl;
+}
+
+
+
+int main()
+{
+  initlog();
+
+  test<2> (FE_Q<2>(2));
+  test<2> (FESystem<2>(FE_Q<2>(3), 2, FE_DGQ<2>(1), 1));
+  test<3> (FE_Q<3>(2));
+  test<3> (FESystem<3>(FE_Q<3>(1), 3, FE_DGQ<3>(0), 1));
+}
@@ -0,0 +1,110 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// Check DoFRenumbering::hilbert_curve: on a uniformly refined cube, the cells
+// numbered consecutively by an FE_DGQ(0) must be face neighbors, and a second
+// renumbering must not change anything
+
+#include "../tests.h"
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_renumbering.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_dgq.h>
+
+
+
+bool
+is_identity (const std::vector<types::global_dof_index> &renumbering)
+{
+  for (unsigned int i=0; i<renumbering.size(); ++i)
+    if (renumbering[i] != i)
+      return false;
+  return true;
+}
+
+
+
+template <int dim>
+void
+check (const unsigned int n_refinements)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (n_refinements);
+
+  FE_DGQ<dim> fe_dg (0);
+  DoFHandler<dim> dof (tria);
+  dof.distribute_dofs (fe_dg);
+  DoFRenumbering::hilbert_curve (dof);
+
+  std::vector<typename DoFHandler<dim>::active_cell_iterator>
+  cells (dof.n_dofs());
+  std::vector<types::global_dof_index> dof_indices (1);
+  for (typename DoFHandler<dim>::active_cell_iterator cell=dof.begin_active();
+       cell != dof.end(); ++cell)
+    {
+      cell->get_dof_indices (dof_indices);
+      cells[dof_indices[0]] = cell;
+    }
+
+  bool all_neighbors = true;
+  for (unsigned int i=1; i<cells.size(); ++i)
+    {
+      bool found = false;
+      for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+        if (!cells[i]->at_boundary(f) && cells[i]->neighbor(f) == cells[i-1])
+          found = true;
+      all_neighbors = all_neighbors && found;
+    }
+  deallog << "first cell: " << cells.front()->center() << std::endl;
+  deallog << "last cell: " << cells.back()->center() << std::endl;
+  deallog << "neighbors: " << (all_neighbors ? "yes" : "no") << std::endl;
+
+  std::vector<types::global_dof_index> renumbering (dof.n_dofs());
+  DoFRenumbering::compute_hilbert_curve (renumbering, dof);
+  deallog << "FE_DGQ(0) unchanged: "
+          << (is_identity(renumbering) ? "yes" : "no") << std::endl;
+
+  FE_Q<dim> fe_q (2);
+  dof.distribute_dofs (fe_q);
+  DoFRenumbering::hilbert_curve (dof);
+  renumbering.resize (dof.n_dofs());
+  DoFRenumbering::compute_hilbert_curve (renumbering, dof);
+  deallog << "FE_Q(2) unchanged: "
+          << (is_identity(renumbering) ? "yes" : "no") << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+  deallog << std::setprecision (4);
+
+  deallog.push ("1d");
+  check<1> (5);
+  deallog.pop ();
+  deallog.push ("2d");
+  check<2> (3);
+  deallog.pop ();
+  deallog.push ("3d");
+  check<3> (2);
+  deallog.pop ();
+}
@@ -0,0 +1,118 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// DoFTools::make_sparsity_pattern builds a DynamicSparsityPattern with
+// several threads on large meshes. Check that the result is the same as
+// with a single thread, with and without constraints
+
+
+#include "../tests.h"
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/fe/fe_q.h>
+
+
+template <int dim>
+void
+make_pattern (const DoFHandler<dim>  &dof_handler,
+              const ConstraintMatrix &constraints,
+              const bool              keep_constrained_dofs,
+              DynamicSparsityPattern &dsp)
+{
+  dsp.reinit (dof_handler.n_dofs(), dof_handler.n_dofs());
+  DoFTools::make_sparsity_pattern (dof_handler, dsp, constraints,
+                                   keep_constrained_dofs);
+}
+
+
+
+bool
+are_equal (const DynamicSparsityPattern &dsp_1,
+           const DynamicSparsityPattern &dsp_2)
+{
+  if (dsp_1.n_rows() != dsp_2.n_rows() ||
+      dsp_1.n_nonzero_elements() != dsp_2.n_nonzero_elements())
+    return false;
+  for (types::global_dof_index row=0; row<dsp_1.n_rows(); ++row)
+    {
+      if (dsp_1.row_length(row) != dsp_2.row_length(row))
+        return false;
+      for (types::global_dof_index i=0; i<dsp_1.row_length(row); ++i)
+        if (dsp_1.column_number(row, i) != dsp_2.column_number(row, i))
+          return false;
+    }
+  return true;
+}
+
+
+
+template <int dim>
+void test (const FiniteElement<dim> &fe)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (dim == 2 ? 6 : 3);
+  unsigned int index = 0;
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell, ++index)
+    if (index % (dim == 2 ? 3 : 2) == 0)
+      cell->set_refine_flag ();
+  tria.execute_coarsening_and_refinement ();
+
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  ConstraintMatrix constraints;
+  DoFTools::make_hanging_node_constraints (dof_handler, constraints);
+  constraints.close ();
+
+  const ConstraintMatrix no_constraints;
+
+  for (unsigned int i=0; i<3; ++i)
+    {
+      const ConstraintMatrix &c = (i == 0 ? no_constraints : constraints);
+      const bool keep_constrained_dofs = (i != 2);
+
+      DynamicSparsityPattern serial, parallel;
+      MultithreadInfo::set_thread_limit (1);
+      make_pattern (dof_handler, c, keep_constrained_dofs, serial);
+      MultithreadInfo::set_thread_limit (4);
+      make_pattern (dof_handler, c, keep_constrained_dofs, parallel);
+
+      deallog << fe.get_name() << ' '
+              << (i == 0 ? "no constraints" :
+                  (i == 1 ? "hanging nodes" : "hanging nodes, eliminated"))
+              << ": identical: " << (are_equal (serial, parallel) ? "yes" : "no")
+              << std::endl;
+    }
+}
+
+
+
+int main()
+{
+  initlog();
+
+  test<2> (FE_Q<2>(2));
+  test<3> (FE_Q<3>(2));
+}
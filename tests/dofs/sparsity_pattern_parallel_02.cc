@@ -0,0 +1,130 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// DoFTools::make_sparsity_pattern builds a DynamicSparsityPattern with
+// several threads on large meshes, where every thread adds the entries of a
+// range of cells. Check that the result does not depend on the number of
+// threads, also if the pattern only stores a subset of the rows, and that
+// merging the patterns of the threads does not leave the rows with a
+// noticeably larger memory consumption than building them with one thread
+
+
+#include "../tests.h"
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/fe/fe_q.h>
+
+
+
+template <int dim>
+void
+make_pattern (const DoFHandler<dim>  &dof_handler,
+              const ConstraintMatrix &constraints,
+              const IndexSet         &row_set,
+              const unsigned int      n_threads,
+              DynamicSparsityPattern &dsp)
+{
+  MultithreadInfo::set_thread_limit (n_threads);
+  dsp.reinit (dof_handler.n_dofs(), dof_handler.n_dofs(), row_set);
+  DoFTools::make_sparsity_pattern (dof_handler, dsp, constraints);
+  MultithreadInfo::set_thread_limit (testing_max_num_threads());
+}
+
+
+
+bool
+are_equal (const DynamicSparsityPattern &dsp_1,
+           const DynamicSparsityPattern &dsp_2)
+{
+  if (dsp_1.n_rows() != dsp_2.n_rows() ||
+      dsp_1.n_nonzero_elements() != dsp_2.n_nonzero_elements())
+    return false;
+  for (types::global_dof_index row=0; row<dsp_1.n_rows(); ++row)
+    {
+      if (dsp_1.row_length(row) != dsp_2.row_length(row))
+        return false;
+      for (types::global_dof_index i=0; i<dsp_1.row_length(row); ++i)
+        if (dsp_1.column_number(row, i) != dsp_2.column_number(row, i))
+          return false;
+    }
+  return true;
+}
+
+
+
+template <int dim>
+void test (const FiniteElement<dim> &fe,
+           const unsigned int        n_refinements)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (n_refinements);
+
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  ConstraintMatrix constraints;
+  DoFTools::make_hanging_node_constraints (dof_handler, constraints);
+  constraints.close ();
+
+  deallog << fe.get_name() << ", " << tria.n_active_cells()
+          << " cells:" << std::endl;
+
+  // all rows, and the rows of the first half of the degrees of freedom
+  for (unsigned int i=0; i<2; ++i)
+    {
+      IndexSet row_set;
+      if (i == 1)
+        {
+          row_set.set_size (dof_handler.n_dofs());
+          row_set.add_range (0, dof_handler.n_dofs()/2);
+        }
+
+      DynamicSparsityPattern reference;
+      make_pattern (dof_handler, constraints, row_set, 1, reference);
+
+      for (unsigned int n_threads=2; n_threads<=8; n_threads*=2)
+        {
+          DynamicSparsityPattern dsp;
+          make_pattern (dof_handler, constraints, row_set, n_threads, dsp);
+
+          deallog << (i == 0 ? "all rows" : "half of the rows") << ", "
+                  << n_threads << " threads: identical to one thread: "
+                  << (are_equal (dsp, reference) ? "yes" : "no")
+                  << ", memory consumption at most 5% larger: "
+                  << (dsp.memory_consumption() <=
+                      1.05*reference.memory_consumption() ? "yes" : "no")
+                  << std::endl;
+        }
+    }
+}
+
+
+
+int main()
+{
+  initlog();
+
+  test<2> (FE_Q<2>(2), 7);
+  test<3> (FE_Q<3>(1), 5);
+}
@@ -0,0 +1,91 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// check that FEValues only detects translated cells with more than one
+// thread if allow_cell_similarity_with_threads() was called, and that the
+// data re-used from the previous cell is correct
+
+
+#include "../tests.h"
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_iterator.h>
+
+
+template <int dim>
+void test ()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (2);
+
+  FE_Q<dim> fe (2);
+  QGauss<dim> quadrature (3);
+  const UpdateFlags flags = update_gradients | update_JxW_values;
+
+  MultithreadInfo::set_thread_limit (4);
+
+  for (unsigned int allow=0; allow<2; ++allow)
+    {
+      FEValues<dim> fe_values (fe, quadrature, flags);
+      fe_values.allow_cell_similarity_with_threads (allow == 1);
+      FEValues<dim> reference_values (fe, quadrature, flags);
+
+      unsigned int n_translations = 0;
+      double max_error = 0;
+      for (typename Triangulation<dim>::active_cell_iterator
+           cell = tria.begin_active(); cell != tria.end(); ++cell)
+        {
+          fe_values.reinit (cell);
+          if (fe_values.get_cell_similarity() == CellSimilarity::translation)
+            ++n_translations;
+
+          // compare to an object that recomputes everything on each cell
+          reference_values.reinit (cell);
+          for (unsigned int q=0; q<quadrature.size(); ++q)
+            {
+              max_error = std::max (max_error,
+                                    std::abs (fe_values.JxW(q) -
+                                              reference_values.JxW(q)));
+              for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+                max_error = std::max (max_error,
+                                      (fe_values.shape_grad(i,q) -
+                                       reference_values.shape_grad(i,q)).norm());
+            }
+        }
+
+      deallog << "dim=" << dim
+              << " allow=" << allow
+              << " cells=" << tria.n_active_cells()
+              << " translations=" << n_translations
+              << " data correct: " << (max_error < 1e-12 ? "yes" : "no")
+              << std::endl;
+    }
+}
+
+
+
+int main()
+{
+  initlog();
+
+  test<2> ();
+  test<3> ();
+}
@@ -0,0 +1,159 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// compare the data computed by FEValuesBatch with the one of FEValues on
+// a curved mesh, including a batch that is only partially filled, and
+// check that the local Laplace matrices assembled in SIMD layout and
+// extracted lane by lane agree with the ones assembled with FEValues
+
+
+#include "../tests.h"
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/fe_values_batch.h>
+#include <deal.II/fe/mapping_q_generic.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/manifold_lib.h>
+#include <deal.II/grid/tria.h>
+
+
+template <int dim>
+void test (const FiniteElement<dim> &fe)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_ball (tria);
+  tria.set_all_manifold_ids_on_boundary (0);
+  static const SphericalManifold<dim> manifold;
+  tria.set_manifold (0, manifold);
+  tria.refine_global (1);
+
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  const MappingQGeneric<dim> mapping (2);
+  const QGauss<dim> quadrature (fe.degree+1);
+  const UpdateFlags flags = update_values | update_gradients |
+                            update_JxW_values | update_quadrature_points;
+  FEValues<dim> fe_values (mapping, fe, quadrature, flags);
+  FEValuesBatch<dim> fe_batch (mapping, fe, quadrature, flags);
+
+  const unsigned int n_lanes = FEValuesBatch<dim>::n_lanes;
+  const unsigned int dofs_per_cell = fe.dofs_per_cell;
+  const unsigned int n_q_points = quadrature.size();
+
+  Table<2,VectorizedArray<double> > batch_matrix (dofs_per_cell, dofs_per_cell);
+  FullMatrix<double> cell_matrix, reference_matrix (dofs_per_cell, dofs_per_cell);
+
+  double max_value_error = 0, max_grad_error = 0, max_jxw_error = 0,
+         max_point_error = 0, max_matrix_error = 0;
+  unsigned int n_batches = 0;
+
+  std::vector<typename DoFHandler<dim>::active_cell_iterator> cells;
+  typename DoFHandler<dim>::active_cell_iterator cell = dof_handler.begin_active();
+  while (cell != dof_handler.end())
+    {
+      // make the first batch only partially filled
+      const unsigned int batch_size = (n_batches == 0 && n_lanes > 1 ?
+                                       n_lanes-1 : n_lanes);
+      cells.clear ();
+      for (; cell != dof_handler.end() && cells.size() < batch_size; ++cell)
+        cells.push_back (cell);
+      fe_batch.reinit (cells);
+      ++n_batches;
+
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        for (unsigned int j=0; j<dofs_per_cell; ++j)
+          {
+            VectorizedArray<double> sum = VectorizedArray<double>();
+            if (fe.system_to_component_index(i).first ==
+                fe.system_to_component_index(j).first)
+              for (unsigned int q=0; q<n_q_points; ++q)
+                sum += fe_batch.shape_grad(i,q) * fe_batch.shape_grad(j,q)
+                       * fe_batch.JxW(q);
+            batch_matrix(i,j) = sum;
+          }
+
+      for (unsigned int lane=0; lane<cells.size(); ++lane)
+        {
+          fe_values.reinit (cells[lane]);
+          for (unsigned int q=0; q<n_q_points; ++q)
+            {
+              max_jxw_error = std::max (max_jxw_error,
+                                        std::abs (fe_values.JxW(q) -
+                                                  fe_batch.JxW(q)[lane]));
+              for (unsigned int d=0; d<dim; ++d)
+                max_point_error = std::max (max_point_error,
+                                            std::abs (fe_values.quadrature_point(q)[d] -
+                                                      fe_batch.quadrature_point(q)[d][lane]));
+              for (unsigned int i=0; i<dofs_per_cell; ++i)
+                {
+                  max_value_error = std::max (max_value_error,
+                                              std::abs (fe_values.shape_value(i,q) -
+                                                        fe_batch.shape_value(i,q)[lane]));
+                  for (unsigned int d=0; d<dim; ++d)
+                    max_grad_error = std::max (max_grad_error,
+                                               std::abs (fe_values.shape_grad(i,q)[d] -
+                                                         fe_batch.shape_grad(i,q)[d][lane]));
+                }
+            }
+
+          for (unsigned int i=0; i<dofs_per_cell; ++i)
+            for (unsigned int j=0; j<dofs_per_cell; ++j)
+              {
+                double sum = 0;
+                if (fe.system_to_component_index(i).first ==
+                    fe.system_to_component_index(j).first)
+                  for (unsigned int q=0; q<n_q_points; ++q)
+                    sum += fe_values.shape_grad(i,q) * fe_values.shape_grad(j,q)
+                           * fe_values.JxW(q);
+                reference_matrix(i,j) = sum;
+              }
+
+          FEValuesBatch<dim>::extract_lane (batch_matrix, lane, cell_matrix);
+          cell_matrix.add (-1., reference_matrix);
+          max_matrix_error = std::max (max_matrix_error,
+                                       cell_matrix.linfty_norm() /
+                                       reference_matrix.linfty_norm());
+        }
+
+      // the unused lanes must not contribute to integrals
+      for (unsigned int lane=cells.size(); lane<n_lanes; ++lane)
+        for (unsigned int q=0; q<n_q_points; ++q)
+          AssertThrow (fe_batch.JxW(q)[lane] == 0., ExcInternalError());
+    }
+
+  deallog << fe.get_name() << std::endl;
+  deallog << "Values agree:       " << (max_value_error < 1e-12 ? "yes" : "no") << std::endl;
+  deallog << "Gradients agree:    " << (max_grad_error < 1e-10 ? "yes" : "no") << std::endl;
+  deallog << "JxW agree:          " << (max_jxw_error < 1e-12 ? "yes" : "no") << std::endl;
+  deallog << "Points agree:       " << (max_point_error < 1e-12 ? "yes" : "no") << std::endl;
+  deallog << "Matrices agree:     " << (max_matrix_error < 1e-12 ? "yes" : "no") << std::endl;
+}
+
+
+
+int main()
+{
+  initlog();
+
+  test<2> (FE_Q<2>(1));
+  test<2> (FESystem<2>(FE_Q<2>(3), 2));
+  test<3> (FE_Q<3>(2));
+}
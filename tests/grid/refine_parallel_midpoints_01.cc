@@ -0,0 +1,131 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// The midpoints and children of refined lines are computed in parallel
+// during refinement. Check that the vertices and the cells are the same as
+// when refining with a single thread, for a flat manifold, a manifold of the
+// library, and a user-defined manifold.
+
+#include "../tests.h"
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/manifold_lib.h>
+
+
+// a manifold that only implements project_to_manifold(): it scales the
+// candidate point to the mean distance of the surrounding points from the
+// origin
+template <int dim>
+class ProjectingManifold : public Manifold<dim>
+{
+public:
+  virtual
+  Point<dim>
+  project_to_manifold (const ArrayView<const Point<dim>> &surrounding_points,
+                       const Point<dim>                  &candidate) const
+  {
+    double radius = 0;
+    for (unsigned int i=0; i<surrounding_points.size(); ++i)
+      radius += surrounding_points[i].norm();
+    radius /= surrounding_points.size();
+    return candidate * (radius / candidate.norm());
+  }
+};
+
+
+
+template <int dim>
+void create_and_refine (const Manifold<dim>   &manifold,
+                        const unsigned int     n_refinements,
+                        const unsigned int     n_threads,
+                        std::vector<Point<dim> > &vertices,
+                        std::vector<unsigned int> &cell_vertices)
+{
+  MultithreadInfo::set_thread_limit (n_threads);
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_shell (tria, Point<dim>(), 0.5, 1., dim == 2 ? 6 : 12);
+  tria.set_all_manifold_ids (0);
+  tria.set_manifold (0, manifold);
+  tria.refine_global (n_refinements);
+
+  vertices = tria.get_vertices();
+
+  // also refine adaptively, where only some of the lines get new vertices
+  unsigned int index = 0;
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell, ++index)
+    if (index % 3 == 0)
+      cell->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+
+  vertices.insert (vertices.end(),
+                   tria.get_vertices().begin(), tria.get_vertices().end());
+
+  cell_vertices.clear();
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+      cell_vertices.push_back (cell->vertex_index(v));
+
+  MultithreadInfo::set_thread_limit (testing_max_num_threads());
+}
+
+
+
+template <int dim>
+void test (const Manifold<dim> &manifold,
+           const unsigned int   n_refinements)
+{
+  std::vector<Point<dim> > serial, parallel;
+  std::vector<unsigned int> serial_cells, parallel_cells;
+  create_and_refine (manifold, n_refinements, 1, serial, serial_cells);
+  create_and_refine (manifold, n_refinements, 4, parallel, parallel_cells);
+
+  AssertDimension (serial.size(), parallel.size());
+  unsigned int n_different = 0;
+  double sum_of_radii = 0;
+  for (unsigned int i=0; i<serial.size(); ++i)
+    {
+      // the new vertices must be bit-for-bit identical
+      if (serial[i] != parallel[i])
+        ++n_different;
+      sum_of_radii += serial[i].norm();
+    }
+
+  deallog << "dim=" << dim << ": " << serial.size() << " vertices, "
+          << "sum of radii " << sum_of_radii << ", "
+          << n_different << " different, cells "
+          << (serial_cells == parallel_cells ? "identical" : "different")
+          << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  test<2> (FlatManifold<2>(), 3);
+  test<2> (SphericalManifold<2>(), 3);
+  test<2> (ProjectingManifold<2>(), 3);
+  test<3> (FlatManifold<3>(), 2);
+  test<3> (SphericalManifold<3>(), 2);
+  test<3> (ProjectingManifold<3>(), 2);
+}
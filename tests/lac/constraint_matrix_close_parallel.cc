@@ -0,0 +1,166 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// ConstraintMatrix::close() processes the constraint lines in parallel.
+// Check that the result is the same as with a single thread, both with
+// and without chains of constraints, and check that
+// distribute_local_to_global for a vector with a local matrix eliminates
+// inhomogeneous constraints from the right hand side in the same way as the
+// version that also assembles the matrix
+
+
+#include "../tests.h"
+#include <deal.II/base/function_lib.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/numerics/vector_tools.h>
+
+#include <sstream>
+
+
+template <int dim>
+std::string
+make_and_print_constraints (const DoFHandler<dim> &dof_handler,
+                            const bool             with_boundary_values)
+{
+  ConstraintMatrix constraints;
+  DoFTools::make_hanging_node_constraints (dof_handler, constraints);
+  if (with_boundary_values)
+    VectorTools::interpolate_boundary_values (dof_handler, 0,
+                                              Functions::ConstantFunction<dim>(1.),
+                                              constraints);
+  constraints.close ();
+
+  std::ostringstream out;
+  out.precision (16);
+  constraints.print (out);
+  return out.str();
+}
+
+
+
+template <int dim>
+void test ()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (dim == 2 ? 6 : 3);
+  for (unsigned int cycle=0; cycle<2; ++cycle)
+    {
+      unsigned int index = 0;
+      for (typename Triangulation<dim>::active_cell_iterator
+           cell = tria.begin_active(); cell != tria.end(); ++cell, ++index)
+        if (index % 4 == 0)
+          cell->set_refine_flag ();
+      tria.execute_coarsening_and_refinement ();
+    }
+
+  FE_Q<dim> fe (2);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  for (unsigned int with_bv=0; with_bv<2; ++with_bv)
+    {
+      MultithreadInfo::set_thread_limit (1);
+      const std::string serial = make_and_print_constraints (dof_handler, with_bv);
+      MultithreadInfo::set_thread_limit (4);
+      const std::string parallel = make_and_print_constraints (dof_handler, with_bv);
+
+      deallog << "dim=" << dim
+              << (with_bv ? " hanging nodes and boundary values"
+                  : " hanging nodes")
+              << ": identical: " << (serial == parallel ? "yes" : "no")
+              << std::endl;
+    }
+
+  // now check distribute_local_to_global for the right hand side with
+  // hanging nodes and inhomogeneous boundary values
+  ConstraintMatrix constraints;
+  DoFTools::make_hanging_node_constraints (dof_handler, constraints);
+  VectorTools::interpolate_boundary_values (dof_handler, 0,
+                                            Functions::SquareFunction<dim>(),
+                                            constraints);
+  constraints.close ();
+
+  DynamicSparsityPattern dsp (dof_handler.n_dofs());
+  DoFTools::make_sparsity_pattern (dof_handler, dsp, constraints, false);
+  SparsityPattern sparsity;
+  sparsity.copy_from (dsp);
+  SparseMatrix<double> matrix (sparsity);
+
+  // rhs_0 ignores the inhomogeneities, the other two eliminate them with
+  // the local matrix
+  Vector<double> rhs_0 (dof_handler.n_dofs()), rhs_1 (dof_handler.n_dofs()),
+         rhs_2 (dof_handler.n_dofs());
+  FullMatrix<double> local_matrix (fe.dofs_per_cell, fe.dofs_per_cell);
+  Vector<double> local_vector (fe.dofs_per_cell);
+  std::vector<types::global_dof_index> local_dof_indices (fe.dofs_per_cell);
+  for (typename DoFHandler<dim>::active_cell_iterator
+       cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell)
+    {
+      cell->get_dof_indices (local_dof_indices);
+      for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+        {
+          local_vector(i) = 1. + i + cell->active_cell_index();
+          for (unsigned int j=0; j<fe.dofs_per_cell; ++j)
+            local_matrix(i,j) = (i == j ? 10. : 1.) / (1. + i + j);
+        }
+      constraints.distribute_local_to_global (local_vector, local_dof_indices,
+                                              rhs_0);
+      constraints.distribute_local_to_global (local_vector, local_dof_indices,
+                                              rhs_1, local_matrix);
+      constraints.distribute_local_to_global (local_matrix, local_vector,
+                                              local_dof_indices,
+                                              matrix, rhs_2);
+    }
+
+  // the last two functions differ in the entries of the constrained
+  // degrees of freedom, which are not part of the linear system anyway
+  constraints.set_zero (rhs_1);
+  constraints.set_zero (rhs_2);
+  rhs_0 -= rhs_1;
+  deallog << "dim=" << dim
+          << " inhomogeneities change the rhs: "
+          << (rhs_0.linfty_norm() > 1e-10 * rhs_1.linfty_norm() ? "yes" : "no")
+          << std::endl;
+  rhs_1 -= rhs_2;
+  deallog << "dim=" << dim
+          << " rhs agrees with the one assembled together with the matrix: "
+          << (rhs_1.linfty_norm() < 1e-12 * rhs_2.linfty_norm() ? "yes" : "no")
+          << std::endl;
+}
+
+
+
+int main()
+{
+  initlog();
+
+  test<2> ();
+  test<3> ();
+}
@@ -0,0 +1,88 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check the mixed-precision operations copy, add and sadd between
+// LinearAlgebra::distributed::Vector objects of different number types
+// against the same operations on vectors of the same type. The entries are
+// chosen such that all results are exactly representable in float.
+
+#include "../tests.h"
+#include <deal.II/lac/la_parallel_vector.h>
+
+
+
+template <typename Number, typename Number2>
+void check ()
+{
+  deallog << "Number " << (std::is_same<Number,float>::value ? "float" : "double")
+          << ", Number2 " << (std::is_same<Number2,float>::value ? "float" : "double")
+          << std::endl;
+  for (unsigned int test=0; test<3; ++test)
+    {
+      const unsigned int size = 17 + test*1101;
+      const IndexSet complete_set = complete_index_set(size);
+      LinearAlgebra::distributed::Vector<Number> v (complete_set, MPI_COMM_SELF),
+                     ref (complete_set, MPI_COMM_SELF);
+      LinearAlgebra::distributed::Vector<Number2> w (complete_set, MPI_COMM_SELF);
+      LinearAlgebra::distributed::Vector<Number> w_same (complete_set, MPI_COMM_SELF);
+      for (unsigned int i=0; i<size; ++i)
+        {
+          v(i) = 0.25 * (i%17);
+          w(i) = 1.5 * (i%13) - 3.;
+          w_same(i) = w(i);
+        }
+
+      ref = v;
+      v.add(Number(2.), w);
+      ref.add(Number(2.), w_same);
+      ref -= v;
+      deallog << "Error add:       " << ref.linfty_norm() << std::endl;
+
+      ref = v;
+      v.sadd(Number(0.5), w);
+      ref.sadd(Number(0.5), w_same);
+      ref -= v;
+      deallog << "Error sadd:      " << ref.linfty_norm() << std::endl;
+
+      ref = v;
+      v.sadd(Number(0.5), Number(1.5), w);
+      ref.sadd(Number(0.5), Number(1.5), w_same);
+      ref -= v;
+      deallog << "Error sadd 2:    " << ref.linfty_norm() << std::endl;
+
+      ref = w_same;
+      v = w;
+      ref -= v;
+      deallog << "Error copy:      " << ref.linfty_norm() << std::endl;
+
+      v = 0.;
+      v.copy_locally_owned_data_from(w);
+      v -= w_same;
+      deallog << "Error copy data: " << v.linfty_norm() << std::endl;
+    }
+}
+
+
+
+int main()
+{
+  initlog();
+
+  check<double,float>();
+  check<float,double>();
+  check<float,float>();
+}
@@ -0,0 +1,122 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// compare SolverPipelinedCG with SolverCG on the five-point Laplacian for
+// dealii::Vector and LinearAlgebra::distributed::Vector. The iterates agree
+// in exact arithmetic, so we check that the solutions agree and that the
+// iteration counts differ by at most one due to roundoff. On a single
+// process, no time is recorded as overlapped with a reduction.
+
+#include "../tests.h"
+#include "../testmatrix.h"
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/vector_memory.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_pipelined_cg.h>
+#include <deal.II/lac/precondition.h>
+
+
+template <typename VectorType, typename MatrixType, typename PreconditionerType>
+void
+check_solve (const MatrixType         &A,
+             VectorType               &f,
+             const PreconditionerType &preconditioner)
+{
+  VectorType u_cg, u_pipelined;
+  u_cg.reinit(f);
+  u_pipelined.reinit(f);
+
+  SolverControl control_cg(500, 1e-10);
+  control_cg.log_result(false);
+  SolverCG<VectorType> solver_cg(control_cg);
+  solver_cg.solve(A, u_cg, f, preconditioner);
+
+  SolverControl control_pipelined(500, 1e-10);
+  control_pipelined.log_result(false);
+  SolverPipelinedCG<VectorType> solver_pipelined(control_pipelined);
+  solver_pipelined.solve(A, u_pipelined, f, preconditioner);
+
+  const unsigned int it_cg = control_cg.last_step();
+  const unsigned int it_pipelined = control_pipelined.last_step();
+  deallog << "Iteration counts agree: "
+          << ((it_cg > it_pipelined ? it_cg-it_pipelined : it_pipelined-it_cg) <= 1 ?
+              "yes" : "no")
+          << std::endl;
+  deallog << "Number of reductions equals iterations plus one: "
+          << (solver_pipelined.get_reduction_statistics().n_reductions ==
+              it_pipelined+1 ? "yes" : "no")
+          << std::endl;
+  // all reductions are complete before the overlapped computations start
+  deallog << "No overlapped computations recorded: "
+          << (solver_pipelined.get_reduction_statistics().overlapped_compute_time == 0. ?
+              "yes" : "no")
+          << std::endl;
+
+  u_pipelined -= u_cg;
+  deallog << "Solutions agree: "
+          << (u_pipelined.linfty_norm() < 1e-8 * u_cg.linfty_norm() ? "yes" : "no")
+          << std::endl;
+}
+
+
+
+int main()
+{
+  initlog();
+
+  for (unsigned int size=4; size <= 30; size *= 3)
+    {
+      unsigned int dim = (size-1)*(size-1);
+
+      deallog << "Size " << size << " Unknowns " << dim << std::endl;
+
+      FDMatrix testproblem(size, size);
+      SparsityPattern structure(dim, dim, 5);
+      testproblem.five_point_structure(structure);
+      structure.compress();
+      SparseMatrix<double>  A(structure);
+      testproblem.five_point(A);
+
+      PreconditionJacobi<> prec_jacobi;
+      prec_jacobi.initialize(A, 1.);
+      PreconditionSSOR<> prec_ssor;
+      prec_ssor.initialize(A, 1.2);
+
+      Vector<double> f(dim);
+      f = 1.;
+
+      deallog.push("Vector identity");
+      check_solve(A, f, PreconditionIdentity());
+      deallog.pop();
+      deallog.push("Vector Jacobi");
+      check_solve(A, f, prec_jacobi);
+      deallog.pop();
+      deallog.push("Vector SSOR");
+      check_solve(A, f, prec_ssor);
+      deallog.pop();
+
+      LinearAlgebra::distributed::Vector<double> f_dist(complete_index_set(dim),
+                                                        MPI_COMM_SELF);
+      f_dist = 1.;
+      deallog.push("LA::distributed::Vector identity");
+      check_solve(A, f_dist, PreconditionIdentity());
+      deallog.pop();
+    }
+}
@@ -0,0 +1,113 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// compare SolverSStepGMRES with SolverGMRES on a nonsymmetric five-point
+// matrix for dealii::Vector and LinearAlgebra::distributed::Vector with
+// left and right preconditioning. Check that the solutions agree and that
+// the block orthogonalization needs fewer global reductions than the
+// number of iterations for LinearAlgebra::distributed::Vector, whereas
+// every inner product is a reduction of its own for dealii::Vector
+
+#include "../tests.h"
+#include "../testmatrix.h"
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/vector_memory.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/solver_gmres.h>
+#include <deal.II/lac/precondition.h>
+
+
+template <typename VectorType, typename MatrixType, typename PreconditionerType>
+void
+check_solve (const MatrixType         &A,
+             VectorType               &f,
+             const PreconditionerType &preconditioner,
+             const bool                right_preconditioning)
+{
+  VectorType u_gmres, u_sstep;
+  u_gmres.reinit(f);
+  u_sstep.reinit(f);
+
+  SolverControl control_gmres(1000, 1e-10);
+  control_gmres.log_result(false);
+  typename SolverGMRES<VectorType>::AdditionalData data_gmres(32,
+      right_preconditioning);
+  SolverGMRES<VectorType> solver_gmres(control_gmres, data_gmres);
+  solver_gmres.solve(A, u_gmres, f, preconditioner);
+
+  SolverControl control_sstep(1000, 1e-10);
+  control_sstep.log_result(false);
+  typename SolverSStepGMRES<VectorType>::AdditionalData data_sstep(30, 5,
+      right_preconditioning);
+  SolverSStepGMRES<VectorType> solver_sstep(control_sstep, data_sstep);
+  solver_sstep.solve(A, u_sstep, f, preconditioner);
+
+  deallog << (solver_sstep.n_reductions() < control_sstep.last_step() ?
+              "Fewer" : "More")
+          << " reductions than iterations" << std::endl;
+
+  u_sstep -= u_gmres;
+  deallog << "Solutions agree: "
+          << (u_sstep.linfty_norm() < 1e-6 * u_gmres.linfty_norm() ? "yes" : "no")
+          << std::endl;
+}
+
+
+
+int main()
+{
+  initlog();
+
+  for (unsigned int size=12; size <= 36; size *= 3)
+    {
+      unsigned int dim = (size-1)*(size-1);
+
+      deallog << "Size " << size << " Unknowns " << dim << std::endl;
+
+      FDMatrix testproblem(size, size);
+      SparsityPattern structure(dim, dim, 5);
+      testproblem.five_point_structure(structure);
+      structure.compress();
+      SparseMatrix<double>  A(structure);
+      testproblem.five_point(A, true);
+
+      PreconditionJacobi<> prec_jacobi;
+      prec_jacobi.initialize(A, 1.);
+
+      Vector<double> f(dim);
+      f = 1.;
+
+      deallog.push("Vector identity");
+      check_solve(A, f, PreconditionIdentity(), false);
+      deallog.pop();
+      deallog.push("Vector Jacobi left");
+      check_solve(A, f, prec_jacobi, false);
+      deallog.pop();
+      deallog.push("Vector Jacobi right");
+      check_solve(A, f, prec_jacobi, true);
+      deallog.pop();
+
+      LinearAlgebra::distributed::Vector<double> f_dist(complete_index_set(dim),
+                                                        MPI_COMM_SELF);
+      f_dist = 1.;
+      deallog.push("LA::distributed::Vector identity");
+      check_solve(A, f_dist, PreconditionIdentity(), false);
+      deallog.pop();
+    }
+}
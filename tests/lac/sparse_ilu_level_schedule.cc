@@ -0,0 +1,100 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that SparseILU and SparseMIC give the same results when run on a
+// single thread and when the rows of the levels of the substitutions and
+// the factorization are processed in parallel. the matrix couples
+// unknowns at a distance 'stride', so the level schedules have few levels
+// with many rows each. since the matrix consists of independent tridiagonal
+// chains, ILU is exact
+
+#include "../tests.h"
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparse_ilu.h>
+#include <deal.II/lac/sparse_mic.h>
+#include <deal.II/lac/vector.h>
+
+
+template <typename PreconditionerType>
+void test (const SparseMatrix<double> &A)
+{
+  Vector<double> src (A.m()), dst_serial (A.m()), dst_parallel (A.m());
+  for (unsigned int i=0; i<src.size(); ++i)
+    src(i) = random_value<double>();
+
+  MultithreadInfo::set_thread_limit (1);
+  PreconditionerType prec_serial;
+  prec_serial.initialize (A);
+  prec_serial.vmult (dst_serial, src);
+
+  MultithreadInfo::set_thread_limit (testing_max_num_threads());
+  PreconditionerType prec_parallel;
+  prec_parallel.initialize (A);
+  prec_parallel.vmult (dst_parallel, src);
+
+  dst_parallel -= dst_serial;
+  deallog << "Difference serial/parallel: " << dst_parallel.linfty_norm()
+          << std::endl;
+
+  Vector<double> residual (A.m());
+  A.residual (residual, dst_serial, src);
+  deallog << "Preconditioner is exact: "
+          << (residual.linfty_norm() < 1e-12 * src.linfty_norm() ? "yes" : "no")
+          << std::endl;
+}
+
+
+
+int main()
+{
+  initlog();
+
+  const unsigned int stride = 2000;
+  const unsigned int N = 16 * stride;
+
+  DynamicSparsityPattern dsp (N, N);
+  for (unsigned int i=0; i<N; ++i)
+    {
+      dsp.add (i, i);
+      if (i >= stride)
+        dsp.add (i, i-stride);
+      if (i+stride < N)
+        dsp.add (i, i+stride);
+    }
+  SparsityPattern sparsity;
+  sparsity.copy_from (dsp);
+
+  SparseMatrix<double> A (sparsity);
+  for (unsigned int i=0; i<N; ++i)
+    {
+      A.set (i, i, 4.);
+      if (i >= stride)
+        A.set (i, i-stride, -1.);
+      if (i+stride < N)
+        A.set (i, i+stride, -1.);
+    }
+
+  deallog.push("ILU");
+  test<SparseILU<double> > (A);
+  deallog.pop();
+
+  deallog.push("MIC");
+  test<SparseMIC<double> > (A);
+  deallog.pop();
+}
@@ -0,0 +1,130 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// like sparse_ilu_level_schedule, but for the five-point Laplacian on a
+// square grid in the natural numbering, where the levels are the
+// anti-diagonals of the grid. the grid is large enough for the levels to be
+// processed in parallel. unlike for the tridiagonal chains of the other
+// test, the factorization of a row visits entries of earlier rows that are
+// not in the diagonal column. in the second case, the pattern also couples
+// the grid points (i,j) and (i+1,j+1) with a zero entry, so some of these
+// entries are also found in the row being factorized and receive fill-in.
+// this does not change the levels
+
+#include "../tests.h"
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparse_ilu.h>
+#include <deal.II/lac/sparse_mic.h>
+#include <deal.II/lac/vector.h>
+
+
+template <typename PreconditionerType>
+void test (const SparseMatrix<double> &A)
+{
+  Vector<double> src (A.m()), dst_serial (A.m()), dst_parallel (A.m());
+  for (unsigned int i=0; i<src.size(); ++i)
+    src(i) = random_value<double>();
+
+  MultithreadInfo::set_thread_limit (1);
+  PreconditionerType prec_serial;
+  prec_serial.initialize (A);
+  prec_serial.vmult (dst_serial, src);
+
+  MultithreadInfo::set_thread_limit (testing_max_num_threads());
+  PreconditionerType prec_parallel;
+  prec_parallel.initialize (A);
+  prec_parallel.vmult (dst_parallel, src);
+
+  deallog << "Norm of result: " << dst_serial.l2_norm() / src.l2_norm()
+          << std::endl;
+  dst_parallel -= dst_serial;
+  deallog << "Difference serial/parallel: " << dst_parallel.linfty_norm()
+          << std::endl;
+}
+
+
+
+void test (const unsigned int n,
+           const bool         with_fill_in)
+{
+  const unsigned int N = n*n;
+
+  DynamicSparsityPattern dsp (N, N);
+  for (unsigned int i=0; i<n; ++i)
+    for (unsigned int j=0; j<n; ++j)
+      {
+        const unsigned int row = i*n+j;
+        dsp.add (row, row);
+        if (j > 0)
+          dsp.add (row, row-1);
+        if (j+1 < n)
+          dsp.add (row, row+1);
+        if (i > 0)
+          dsp.add (row, row-n);
+        if (i+1 < n)
+          dsp.add (row, row+n);
+        if (with_fill_in && i > 0 && j > 0)
+          dsp.add (row, row-n-1);
+        if (with_fill_in && i+1 < n && j+1 < n)
+          dsp.add (row, row+n+1);
+      }
+  SparsityPattern sparsity;
+  sparsity.copy_from (dsp);
+
+  // the entries at the additional positions are zero
+  SparseMatrix<double> A (sparsity);
+  for (unsigned int i=0; i<n; ++i)
+    for (unsigned int j=0; j<n; ++j)
+      {
+        const unsigned int row = i*n+j;
+        A.set (row, row, 4.);
+        if (j > 0)
+          A.set (row, row-1, -1.);
+        if (j+1 < n)
+          A.set (row, row+1, -1.);
+        if (i > 0)
+          A.set (row, row-n, -1.);
+        if (i+1 < n)
+          A.set (row, row+n, -1.);
+      }
+
+  deallog << "Grid " << n << "x" << n
+          << (with_fill_in ? ", with fill-in" : "") << std::endl;
+
+  deallog.push("ILU");
+  test<SparseILU<double> > (A);
+  deallog.pop();
+
+  deallog.push("MIC");
+  test<SparseMIC<double> > (A);
+  deallog.pop();
+}
+
+
+
+int main()
+{
+  initlog();
+
+  // with 2n-1 levels for n^2 rows, the levels are only processed in
+  // parallel if there are at most n^2/256 of them, and the rows of a level
+  // only if there are at least 512
+  test (600, false);
+  test (600, true);
+}
@@ -0,0 +1,161 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check SparseMatrixSELL: compare vmult, Tvmult, the Jacobi methods and
+// element access against SparseMatrix for a nonsymmetric matrix with rows
+// of different lengths, and use it as matrix type in SolverCG with
+// PreconditionJacobi and PreconditionChebyshev
+
+#include "../tests.h"
+#include "../testmatrix.h"
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparse_matrix_sell.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/precondition.h>
+
+
+template <typename number, typename VectorType>
+void
+check_products (const SparseMatrix<number> &A,
+                const unsigned int          sigma)
+{
+  SparseMatrixSELL<number> A_sell (A, sigma);
+  deallog << "sigma=" << sigma << " entries: "
+          << (A_sell.n_nonzero_elements() == A.n_nonzero_elements() ? "ok" : "wrong")
+          << std::endl;
+
+  VectorType src, dst, ref;
+  src.reinit (A.n());
+  dst.reinit (A.m());
+  ref.reinit (A.m());
+  for (unsigned int i=0; i<src.size(); ++i)
+    src(i) = random_value<typename VectorType::value_type>();
+
+  A.vmult (ref, src);
+  A_sell.vmult (dst, src);
+  dst -= ref;
+  deallog << "vmult error: " << (dst.linfty_norm() < 1e-5*ref.linfty_norm() ? "0" : "large")
+          << std::endl;
+
+  A.Tvmult (ref, src);
+  A_sell.Tvmult (dst, src);
+  dst -= ref;
+  deallog << "Tvmult error: " << (dst.linfty_norm() < 1e-5*ref.linfty_norm() ? "0" : "large")
+          << std::endl;
+
+  A.vmult (ref, src);
+  ref.add (1., src);
+  dst = src;
+  A_sell.vmult_add (dst, src);
+  dst -= ref;
+  deallog << "vmult_add error: " << (dst.linfty_norm() < 1e-5*ref.linfty_norm() ? "0" : "large")
+          << std::endl;
+
+  bool elements_match = true;
+  for (unsigned int i=0; i<A.m(); ++i)
+    for (unsigned int j=0; j<A.n(); ++j)
+      if (A.el(i,j) != A_sell.el(i,j))
+        elements_match = false;
+  deallog << "Elements match: " << (elements_match ? "yes" : "no") << std::endl;
+}
+
+
+
+int main()
+{
+  initlog();
+
+  const unsigned int size = 33;
+  const unsigned int dim = (size-1)*(size-1);
+
+  FDMatrix testproblem(size, size);
+  SparsityPattern structure(dim, dim, 9);
+  testproblem.nine_point_structure(structure);
+  structure.compress();
+
+  // a nonsymmetric matrix where some rows have fewer entries because the
+  // upwind part is only added below the diagonal
+  {
+    SparseMatrix<double> A(structure);
+    testproblem.five_point(A, true);
+
+    deallog.push("double");
+    check_products<double, Vector<double> > (A, 1);
+    check_products<double, Vector<double> > (A, 64);
+    check_products<double, Vector<double> > (A, dim);
+    check_products<double, Vector<float> > (A, 64);
+    check_products<double, LinearAlgebra::distributed::Vector<double> > (A, 64);
+    deallog.pop();
+
+    SparseMatrix<float> A_float(structure);
+    A_float.copy_from (A);
+    deallog.push("float");
+    check_products<float, Vector<float> > (A_float, 64);
+    deallog.pop();
+  }
+
+  // solve with SolverCG and compare to the solution with SparseMatrix
+  {
+    SparseMatrix<double> A(structure);
+    testproblem.five_point(A);
+    SparseMatrixSELL<double> A_sell(A);
+
+    Vector<double> f(dim), u(dim), u_sell(dim);
+    f = 1.;
+
+    SolverControl control (200, 1e-10);
+    control.log_result (false);
+    SolverCG<> solver (control);
+
+    PreconditionJacobi<SparseMatrix<double> > jacobi;
+    jacobi.initialize (A, 0.8);
+    solver.solve (A, u, f, jacobi);
+    const unsigned int n_iterations = control.last_step();
+
+    PreconditionJacobi<SparseMatrixSELL<double> > jacobi_sell;
+    jacobi_sell.initialize (A_sell, 0.8);
+    solver.solve (A_sell, u_sell, f, jacobi_sell);
+    deallog << "Jacobi iterations equal: "
+            << (n_iterations == control.last_step() ? "yes" : "no") << std::endl;
+    u_sell -= u;
+    deallog << "Jacobi solution error: "
+            << (u_sell.linfty_norm() < 1e-8*u.linfty_norm() ? "0" : "large") << std::endl;
+
+    typedef PreconditionChebyshev<SparseMatrixSELL<double>, Vector<double> > Chebyshev;
+    Chebyshev chebyshev;
+    Chebyshev::AdditionalData data;
+    data.degree = 3;
+    data.smoothing_range = 20.;
+    chebyshev.initialize (A_sell, data);
+    u_sell = 0.;
+    solver.solve (A_sell, u_sell, f, chebyshev);
+    u_sell -= u;
+    deallog << "Chebyshev solution error: "
+            << (u_sell.linfty_norm() < 1e-7*u.linfty_norm() ? "0" : "large") << std::endl;
+
+    // one Jacobi step from zero starting vector
+    Vector<double> v(dim), v_sell(dim);
+    A.Jacobi_step (v, f, 0.7);
+    A_sell.Jacobi_step (v_sell, f, 0.7);
+    v_sell -= v;
+    deallog << "Jacobi step error: "
+            << (v_sell.linfty_norm() < 1e-12*v.linfty_norm() ? "0" : "large") << std::endl;
+  }
+}
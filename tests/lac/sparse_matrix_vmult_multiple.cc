@@ -0,0 +1,108 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check SparseMatrix::vmult and SparseMatrix::Tvmult with several vectors
+// at once, stored either as columns of a FullMatrix or as a std::vector of
+// vectors, against the single-vector versions on a rectangular matrix
+
+#include "../tests.h"
+
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.h>
+
+
+template <typename number>
+void test (const unsigned int m,
+           const unsigned int n,
+           const unsigned int n_vectors)
+{
+  DynamicSparsityPattern dsp (m, n);
+  for (unsigned int i=0; i<m; ++i)
+    for (unsigned int j=0; j<n; ++j)
+      if ((i+2*j) % 7 == 0 || (i*j) % 5 == 1)
+        dsp.add (i,j);
+  SparsityPattern sp;
+  sp.copy_from (dsp);
+
+  SparseMatrix<double> A (sp);
+  for (unsigned int i=0; i<m; ++i)
+    for (SparseMatrix<double>::iterator it=A.begin(i); it!=A.end(i); ++it)
+      it->value() = random_value<double>();
+
+  std::vector<Vector<number> > src (n_vectors, Vector<number>(n));
+  std::vector<Vector<number> > src_t (n_vectors, Vector<number>(m));
+  FullMatrix<number> src_full (n, n_vectors), src_full_t (m, n_vectors);
+  for (unsigned int v=0; v<n_vectors; ++v)
+    {
+      for (unsigned int i=0; i<n; ++i)
+        src_full(i,v) = src[v](i) = random_value<number>();
+      for (unsigned int i=0; i<m; ++i)
+        src_full_t(i,v) = src_t[v](i) = random_value<number>();
+    }
+
+  std::vector<Vector<number> > dst, dst_t;
+  A.vmult (dst, src);
+  A.Tvmult (dst_t, src_t);
+
+  FullMatrix<number> dst_full (m, n_vectors), dst_full_t (n, n_vectors);
+  A.vmult (dst_full, src_full);
+  A.Tvmult (dst_full_t, src_full_t);
+
+  double error = 0, error_t = 0;
+  Vector<number> ref (m), ref_t (n);
+  for (unsigned int v=0; v<n_vectors; ++v)
+    {
+      A.vmult (ref, src[v]);
+      A.Tvmult (ref_t, src_t[v]);
+      for (unsigned int i=0; i<m; ++i)
+        error = std::max (error,
+                          std::abs(double(dst_full(i,v))-ref(i)) / ref.linfty_norm());
+      for (unsigned int i=0; i<n; ++i)
+        error_t = std::max (error_t,
+                            std::abs(double(dst_full_t(i,v))-ref_t(i)) / ref_t.linfty_norm());
+      dst[v] -= ref;
+      dst_t[v] -= ref_t;
+      error = std::max (error, double(dst[v].linfty_norm() / ref.linfty_norm()));
+      error_t = std::max (error_t, double(dst_t[v].linfty_norm() / ref_t.linfty_norm()));
+    }
+
+  deallog << "m=" << m << " n=" << n << " vectors=" << n_vectors
+          << "  vmult ok: " << (error < 1e-5 ? "yes" : "no")
+          << "  Tvmult ok: " << (error_t < 1e-5 ? "yes" : "no")
+          << std::endl;
+}
+
+
+
+int main()
+{
+  initlog();
+
+  deallog.push("double");
+  test<double> (50, 50, 1);
+  test<double> (200, 137, 3);
+  test<double> (137, 1000, 8);
+  deallog.pop();
+  deallog.push("float");
+  test<float> (50, 50, 1);
+  test<float> (200, 137, 3);
+  test<float> (137, 1000, 8);
+  deallog.pop();
+}
@@ -0,0 +1,123 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that MappingQCache gives the same results as MappingQGeneric on a
+// curved mesh, and that the cache is discarded when the mesh changes
+
+#include "../tests.h"
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q_cache.h>
+#include <deal.II/fe/mapping_q_generic.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/manifold_lib.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+
+#include <memory>
+
+
+template <int dim>
+double
+compare (const Mapping<dim>        &mapping,
+         const Triangulation<dim> &tria)
+{
+  const MappingQGeneric<dim> reference_mapping (3);
+  FE_Q<dim> fe (2);
+  QGauss<dim> quadrature (4);
+  const UpdateFlags flags = update_quadrature_points | update_JxW_values |
+                            update_gradients;
+  FEValues<dim> fe_values (mapping, fe, quadrature, flags);
+  FEValues<dim> reference_values (reference_mapping, fe, quadrature, flags);
+
+  double max_error = 0;
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    {
+      fe_values.reinit (cell);
+      reference_values.reinit (cell);
+      for (unsigned int q=0; q<quadrature.size(); ++q)
+        {
+          max_error = std::max (max_error,
+                                fe_values.quadrature_point(q).distance
+                                (reference_values.quadrature_point(q)));
+          max_error = std::max (max_error,
+                                std::abs (fe_values.JxW(q) -
+                                          reference_values.JxW(q)));
+          for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+            max_error = std::max (max_error,
+                                  (fe_values.shape_grad(i,q) -
+                                   reference_values.shape_grad(i,q)).norm());
+        }
+    }
+  return max_error;
+}
+
+
+
+template <int dim>
+void test ()
+{
+  deallog << "dim = " << dim << std::endl;
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_ball (tria);
+  tria.set_all_manifold_ids_on_boundary (0);
+  const SphericalManifold<dim> manifold;
+  tria.set_manifold (0, manifold);
+  tria.refine_global (1);
+
+  MappingQCache<dim> mapping (3);
+  deallog << "initialized: " << mapping.is_initialized() << std::endl;
+  mapping.initialize (tria);
+  deallog << "initialized: " << mapping.is_initialized() << std::endl;
+  deallog << "error: " << compare (mapping, tria) << std::endl;
+
+  // a clone shares the cache
+  const std::unique_ptr<Mapping<dim> > clone (mapping.clone());
+  deallog << "error clone: " << compare (*clone, tria) << std::endl;
+
+  // refinement invalidates the cache, but the mapping still gives the
+  // correct result
+  tria.refine_global (1);
+  deallog << "initialized after refinement: " << mapping.is_initialized()
+          << std::endl;
+  deallog << "error: " << compare (mapping, tria) << std::endl;
+  mapping.initialize (tria);
+  deallog << "error after initialize: " << compare (mapping, tria) << std::endl;
+
+  // so does moving the mesh
+  GridTools::scale (2., tria);
+  deallog << "initialized after scaling: " << mapping.is_initialized()
+          << std::endl;
+  deallog << "error: " << compare (mapping, tria) << std::endl;
+
+  tria.set_manifold (0);
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  test<2>();
+  test<3>();
+}
@@ -0,0 +1,228 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that the evaluation of MappingQGeneric by sum factorization, used
+// for isotropic and anisotropic tensor product quadrature formulas on cells
+// and faces, gives the same quantities as the evaluation with the full
+// shape function arrays, which is used for quadrature formulas that are not
+// tensor products. this includes all derivatives of the Jacobian
+
+#include "../tests.h"
+#include <deal.II/base/qprojector.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/fe/fe_nothing.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q_generic.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/manifold_lib.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+
+
+const UpdateFlags mapping_flags =
+  update_quadrature_points | update_jacobians | update_inverse_jacobians |
+  update_jacobian_grads | update_jacobian_pushed_forward_grads |
+  update_jacobian_2nd_derivatives |
+  update_jacobian_pushed_forward_2nd_derivatives |
+  update_jacobian_3rd_derivatives |
+  update_jacobian_pushed_forward_3rd_derivatives;
+
+
+
+template <typename T>
+double relative_difference (const T &a, const T &b)
+{
+  return (a-b).norm() / std::max(1., b.norm());
+}
+
+
+
+template <int order, int dim, int spacedim>
+double relative_difference (const DerivativeForm<order,dim,spacedim> &a,
+                            const DerivativeForm<order,dim,spacedim> &b)
+{
+  double difference = 0;
+  for (unsigned int i=0; i<spacedim; ++i)
+    difference = std::max (difference,
+                           relative_difference (a[i], b[i]));
+  return difference;
+}
+
+
+
+template <int dim>
+double compare (const FEValuesBase<dim> &fe_values,
+                const FEValuesBase<dim> &reference_values)
+{
+  double error = 0;
+  for (unsigned int q=0; q<fe_values.n_quadrature_points; ++q)
+    {
+      error = std::max (error, relative_difference
+                        (Tensor<1,dim>(fe_values.quadrature_point(q)),
+                         Tensor<1,dim>(reference_values.quadrature_point(q))));
+      error = std::max (error, relative_difference
+                        (fe_values.jacobian(q), reference_values.jacobian(q)));
+      error = std::max (error, relative_difference
+                        (fe_values.inverse_jacobian(q),
+                         reference_values.inverse_jacobian(q)));
+      error = std::max (error, relative_difference
+                        (fe_values.jacobian_grad(q),
+                         reference_values.jacobian_grad(q)));
+      error = std::max (error, relative_difference
+                        (fe_values.jacobian_pushed_forward_grad(q),
+                         reference_values.jacobian_pushed_forward_grad(q)));
+      error = std::max (error, relative_difference
+                        (fe_values.jacobian_2nd_derivative(q),
+                         reference_values.jacobian_2nd_derivative(q)));
+      error = std::max (error, relative_difference
+                        (fe_values.jacobian_pushed_forward_2nd_derivative(q),
+                         reference_values.jacobian_pushed_forward_2nd_derivative(q)));
+      error = std::max (error, relative_difference
+                        (fe_values.jacobian_3rd_derivative(q),
+                         reference_values.jacobian_3rd_derivative(q)));
+      error = std::max (error, relative_difference
+                        (fe_values.jacobian_pushed_forward_3rd_derivative(q),
+                         reference_values.jacobian_pushed_forward_3rd_derivative(q)));
+    }
+  return error;
+}
+
+
+
+template <int dim>
+void test_cells (const Triangulation<dim> &tria,
+                 const Mapping<dim>       &mapping,
+                 const Quadrature<dim>    &quadrature)
+{
+  // a copy of the quadrature formula that is not marked as a tensor
+  // product
+  const Quadrature<dim> reference_quadrature (quadrature.get_points(),
+                                              quadrature.get_weights());
+  FE_Nothing<dim> fe;
+  FEValues<dim> fe_values (mapping, fe, quadrature,
+                           mapping_flags | update_JxW_values);
+  FEValues<dim> reference_values (mapping, fe, reference_quadrature,
+                                  mapping_flags | update_JxW_values);
+
+  double error = 0;
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    {
+      fe_values.reinit (cell);
+      reference_values.reinit (cell);
+      error = std::max (error, compare (fe_values, reference_values));
+      for (unsigned int q=0; q<quadrature.size(); ++q)
+        error = std::max (error, std::abs (fe_values.JxW(q) -
+                                           reference_values.JxW(q)));
+    }
+  deallog << "cells, " << quadrature.size() << " points: "
+          << (error < 1e-10 ? "OK" : "failed") << std::endl;
+}
+
+
+
+template <int dim>
+void test_faces (const Triangulation<dim>  &tria,
+                 const Mapping<dim>        &mapping,
+                 const Quadrature<dim-1>   &quadrature)
+{
+  FE_Nothing<dim> fe;
+  FEFaceValues<dim> fe_values (mapping, fe, quadrature, mapping_flags);
+
+  double error = 0;
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+      {
+        // the points of faces in non-standard orientation come in a
+        // different order than the ones of the projected quadrature
+        if (cell->face_orientation(f) == false ||
+            cell->face_flip(f) == true ||
+            cell->face_rotation(f) == true)
+          continue;
+
+        // evaluate the cell quantities in the same points with a
+        // quadrature formula that is not a tensor product
+        const Quadrature<dim> projected_quadrature
+          = QProjector<dim>::project_to_face (quadrature, f);
+        FEValues<dim> reference_values (mapping, fe, projected_quadrature,
+                                        mapping_flags);
+        fe_values.reinit (cell, f);
+        reference_values.reinit (cell);
+        error = std::max (error, compare (fe_values, reference_values));
+      }
+  deallog << "faces, " << quadrature.size() << " points: "
+          << (error < 1e-10 ? "OK" : "failed") << std::endl;
+}
+
+
+
+template <int dim>
+Quadrature<dim> anisotropic_quadrature ();
+
+template <>
+Quadrature<1> anisotropic_quadrature<1> ()
+{
+  return QGauss<1>(3);
+}
+
+template <>
+Quadrature<2> anisotropic_quadrature<2> ()
+{
+  return QAnisotropic<2>(QGauss<1>(3), QGaussLobatto<1>(6));
+}
+
+template <>
+Quadrature<3> anisotropic_quadrature<3> ()
+{
+  return QAnisotropic<3>(QGauss<1>(3), QGaussLobatto<1>(6), QGauss<1>(4));
+}
+
+
+
+template <int dim>
+void test ()
+{
+  deallog << "dim = " << dim << std::endl;
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_ball (tria);
+  tria.set_all_manifold_ids_on_boundary (0);
+  const SphericalManifold<dim> manifold;
+  tria.set_manifold (0, manifold);
+
+  const MappingQGeneric<dim> mapping (4);
+
+  test_cells (tria, mapping, QGauss<dim>(5));
+  test_cells (tria, mapping, anisotropic_quadrature<dim>());
+
+  test_faces (tria, mapping, QGauss<dim-1>(5));
+  test_faces (tria, mapping, anisotropic_quadrature<dim-1>());
+
+  tria.set_manifold (0);
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  test<2>();
+  test<3>();
+}
@@ -0,0 +1,123 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// compares the time for FEValues::reinit() with MappingQGeneric between the
+// evaluation by sum factorization, used for tensor product quadrature
+// formulas, and the evaluation with the full shape function arrays, used
+// for the same points given as a quadrature formula that is not a tensor
+// product, for several combinations of update flags. The run times of the
+// two variants are printed to the screen, not to the output file.
+
+#include "../tests.h"
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/timer.h>
+#include <deal.II/fe/fe_nothing.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q_generic.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/manifold_lib.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+
+
+
+template <int dim>
+double time_reinit (const Triangulation<dim> &tria,
+                    FEValues<dim>            &fe_values)
+{
+  const unsigned int n_repeat = 5;
+  Timer timer;
+  for (unsigned int i=0; i<n_repeat; ++i)
+    for (typename Triangulation<dim>::active_cell_iterator
+         cell = tria.begin_active(); cell != tria.end(); ++cell)
+      fe_values.reinit (cell);
+  return timer.wall_time()/n_repeat;
+}
+
+
+
+template <int dim>
+void test (const UpdateFlags  update_flags,
+           const std::string &name)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_ball (tria);
+  tria.set_all_manifold_ids_on_boundary (0);
+  const SphericalManifold<dim> manifold;
+  tria.set_manifold (0, manifold);
+  tria.refine_global (1);
+
+  const MappingQGeneric<dim> mapping (4);
+  const QGauss<dim> quadrature (5);
+  const Quadrature<dim> reference_quadrature (quadrature.get_points(),
+                                              quadrature.get_weights());
+  FE_Nothing<dim> fe;
+  FEValues<dim> fe_values (mapping, fe, quadrature, update_flags);
+  FEValues<dim> reference_values (mapping, fe, reference_quadrature,
+                                  update_flags);
+
+  const double time_sum_factorization = time_reinit (tria, fe_values);
+  const double time_full = time_reinit (tria, reference_values);
+  std::cout << "dim=" << dim << ", " << name << ": sum factorization "
+            << time_sum_factorization << "s, full shape functions "
+            << time_full << "s" << std::endl;
+
+  // the last cell is still set in both objects
+  double error = 0;
+  for (unsigned int q=0; q<quadrature.size(); ++q)
+    {
+      if (update_flags & update_quadrature_points)
+        error = std::max (error, fe_values.quadrature_point(q).distance
+                          (reference_values.quadrature_point(q)));
+      if (update_flags & update_jacobians)
+        error = std::max (error, (Tensor<2,dim>(fe_values.jacobian(q)) -
+                                  Tensor<2,dim>(reference_values.jacobian(q))).norm());
+      if (update_flags & update_JxW_values)
+        error = std::max (error, std::abs (fe_values.JxW(q) -
+                                           reference_values.JxW(q)));
+    }
+  tria.set_manifold (0);
+
+  deallog << "dim=" << dim << ", " << name << ": "
+          << (error < 1e-10 ? "OK" : "failed") << std::endl;
+}
+
+
+
+template <int dim>
+void test ()
+{
+  test<dim> (update_quadrature_points, "points");
+  test<dim> (update_JxW_values | update_inverse_jacobians,
+             "JxW, inverse Jacobians");
+  test<dim> (update_quadrature_points | update_jacobians |
+             update_jacobian_grads, "points, Jacobians, Jacobian gradients");
+  test<dim> (update_JxW_values | update_jacobian_pushed_forward_grads |
+             update_jacobian_pushed_forward_2nd_derivatives,
+             "JxW, pushed forward derivatives");
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  test<2>();
+  test<3>();
+}
@@ -0,0 +1,279 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// tests the variant of MatrixFree::cell_loop with operations on vector
+// entries before and after the loop: each locally owned entry must be
+// passed exactly once to each operation, the matrix-vector product must be
+// the same as with the plain cell_loop, and SolverCG with fused vector
+// updates and PreconditionChebyshev, which merge their vector updates into
+// such a matrix-vector product, must give the same results up to roundoff
+// as with a matrix that only provides the plain vmult
+
+#include "../tests.h"
+
+#include <deal.II/base/function.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/diagonal_matrix.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+
+#include "matrix_vector_mf.h"
+
+
+template <int dim, int fe_degree, typename Number>
+class FusedMatrixFreeTest : public Subscriptor
+{
+public:
+  typedef LinearAlgebra::distributed::Vector<Number> VectorType;
+
+  FusedMatrixFreeTest(const MatrixFree<dim,Number> &data_in):
+    data (data_in)
+  {};
+
+  void vmult (VectorType       &dst,
+              const VectorType &src) const
+  {
+    vmult (dst, src,
+           [] (const unsigned int, const unsigned int) {},
+           [] (const unsigned int, const unsigned int) {});
+  }
+
+  void vmult (VectorType       &dst,
+              const VectorType &src,
+              const std::function<void(const unsigned int, const unsigned int)> &operation_before,
+              const std::function<void(const unsigned int, const unsigned int)> &operation_after) const
+  {
+    const std::function<void(const MatrixFree<dim,Number> &,
+                             VectorType &,
+                             const VectorType &,
+                             const std::pair<unsigned int,unsigned int> &)>
+    wrap = helmholtz_operator<dim,fe_degree,VectorType,fe_degree+1>;
+    data.cell_loop (wrap, dst, src,
+                    [&] (const unsigned int begin, const unsigned int end)
+    {
+      for (unsigned int i=begin; i<end; ++i)
+        dst.local_element(i) = 0;
+      operation_before(begin, end);
+    },
+    operation_after);
+  }
+
+  types::global_dof_index m() const
+  {
+    return data.get_vector_partitioner()->size();
+  }
+
+  Number el (const unsigned int, const unsigned int) const
+  {
+    AssertThrow(false, ExcNotImplemented());
+    return 0;
+  }
+
+private:
+  const MatrixFree<dim,Number> &data;
+};
+
+
+
+// hides the vmult variant with additional operations of the operator above
+template <typename OperatorType>
+class PlainOperator : public Subscriptor
+{
+public:
+  typedef typename OperatorType::VectorType VectorType;
+
+  PlainOperator(const OperatorType &op):
+    op (op)
+  {};
+
+  void vmult (VectorType       &dst,
+              const VectorType &src) const
+  {
+    op.vmult(dst, src);
+  }
+
+  types::global_dof_index m() const
+  {
+    return op.m();
+  }
+
+  double el (const unsigned int i, const unsigned int j) const
+  {
+    return op.el(i, j);
+  }
+
+private:
+  const OperatorType &op;
+};
+
+
+
+template <int dim, int fe_degree>
+void test ()
+{
+  typedef double number;
+  typedef LinearAlgebra::distributed::Vector<number> VectorType;
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global(6-dim);
+
+  FE_Q<dim> fe (fe_degree);
+  DoFHandler<dim> dof (tria);
+  dof.distribute_dofs(fe);
+  ConstraintMatrix constraints;
+  constraints.close();
+
+  deallog << "Testing " << fe.get_name() << std::endl;
+
+  MatrixFree<dim,number> mf_data;
+  {
+    const QGauss<1> quad (fe_degree+1);
+    typename MatrixFree<dim,number>::AdditionalData data;
+    data.tasks_parallel_scheme =
+      MatrixFree<dim,number>::AdditionalData::none;
+    mf_data.reinit (dof, constraints, quad, data);
+  }
+
+  FusedMatrixFreeTest<dim,fe_degree,number> fused_mf (mf_data);
+  PlainOperator<FusedMatrixFreeTest<dim,fe_degree,number> > plain_mf (fused_mf);
+  MatrixFreeTest<dim,fe_degree,number,VectorType> mf (mf_data);
+
+  VectorType src, result, ref;
+  mf_data.initialize_dof_vector(src);
+  mf_data.initialize_dof_vector(result);
+  mf_data.initialize_dof_vector(ref);
+  for (unsigned int i=0; i<src.local_size(); ++i)
+    src.local_element(i) = random_value<double>();
+
+  // count how often the operations visit each entry
+  std::vector<unsigned int> visits_before(src.local_size()),
+      visits_after(src.local_size());
+  bool after_before_before = true;
+  result = 1.;
+  fused_mf.vmult(result, src,
+                 [&] (const unsigned int begin, const unsigned int end)
+  {
+    for (unsigned int i=begin; i<end; ++i)
+      ++visits_before[i];
+  },
+  [&] (const unsigned int begin, const unsigned int end)
+  {
+    for (unsigned int i=begin; i<end; ++i)
+      {
+        ++visits_after[i];
+        if (visits_before[i] != 1)
+          after_before_before = false;
+      }
+  });
+  bool visits_ok = after_before_before;
+  for (unsigned int i=0; i<src.local_size(); ++i)
+    if (visits_before[i] != 1 || visits_after[i] != 1)
+      visits_ok = false;
+  deallog << "Each entry visited once: " << (visits_ok ? "yes" : "no")
+          << std::endl;
+
+  mf.vmult(ref, src);
+  result -= ref;
+  deallog << "Matrix-vector product agrees: "
+          << (result.linfty_norm() < 1e-12 * ref.linfty_norm() ? "yes" : "no")
+          << std::endl;
+
+  // solve with the identity and a (random) diagonal preconditioner
+  VectorType diagonal;
+  mf_data.initialize_dof_vector(diagonal);
+  for (unsigned int i=0; i<diagonal.local_size(); ++i)
+    diagonal.local_element(i) = 0.5 + random_value<double>();
+  DiagonalMatrix<VectorType> jacobi;
+  jacobi.get_vector() = diagonal;
+
+  for (unsigned int precondition=0; precondition<2; ++precondition)
+    {
+      SolverControl control_fused(500, 1e-10*src.l2_norm(), false, false);
+      SolverControl control(500, 1e-10*src.l2_norm(), false, false);
+      SolverCG<VectorType> solver_fused(control_fused,
+                                        typename SolverCG<VectorType>::AdditionalData(true));
+      SolverCG<VectorType> solver(control);
+      result = 0;
+      ref = 0;
+      if (precondition == 0)
+        {
+          solver_fused.solve(fused_mf, result, src, PreconditionIdentity());
+          solver.solve(plain_mf, ref, src, PreconditionIdentity());
+        }
+      else
+        {
+          solver_fused.solve(fused_mf, result, src, jacobi);
+          solver.solve(plain_mf, ref, src, jacobi);
+        }
+      deallog << "Same number of CG iterations "
+              << (precondition ? "Jacobi: " : "identity: ")
+              << (control_fused.last_step() == control.last_step() ? "yes" : "no")
+              << std::endl;
+      result -= ref;
+      deallog << "CG solution agrees: "
+              << (result.linfty_norm() < 1e-8 * ref.linfty_norm() ? "yes" : "no")
+              << std::endl;
+    }
+
+  // apply Chebyshev iteration with the fused and the plain matrix-vector
+  // product
+  {
+    typedef PreconditionChebyshev<FusedMatrixFreeTest<dim,fe_degree,number>,VectorType>
+    FusedChebyshev;
+    typedef PreconditionChebyshev<PlainOperator<FusedMatrixFreeTest<dim,fe_degree,number> >,VectorType>
+    Chebyshev;
+    typename FusedChebyshev::AdditionalData data_fused;
+    data_fused.degree = 4;
+    data_fused.smoothing_range = 20;
+    data_fused.preconditioner.reset(new DiagonalMatrix<VectorType>());
+    data_fused.preconditioner->get_vector() = diagonal;
+    typename Chebyshev::AdditionalData data;
+    data.degree = 4;
+    data.smoothing_range = 20;
+    data.preconditioner = data_fused.preconditioner;
+
+    FusedChebyshev chebyshev_fused;
+    chebyshev_fused.initialize(fused_mf, data_fused);
+    Chebyshev chebyshev;
+    chebyshev.initialize(plain_mf, data);
+    chebyshev_fused.vmult(result, src);
+    chebyshev.vmult(ref, src);
+    result -= ref;
+    deallog << "Chebyshev agrees: "
+            << (result.linfty_norm() < 1e-12 * ref.linfty_norm() ? "yes" : "no")
+            << std::endl;
+  }
+  deallog << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  test<2,1>();
+  test<2,2>();
+  test<3,1>();
+  test<3,2>();
+}
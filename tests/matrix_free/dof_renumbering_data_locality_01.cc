@@ -0,0 +1,102 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check DoFRenumbering::matrix_free_data_locality: after renumbering the
+// degrees of freedom in the order MatrixFree visits the cells, a MatrixFree
+// object set up on the renumbered DoFHandler must see the degrees of freedom
+// in ascending order, i.e., a second renumbering is the identity
+
+#include "../tests.h"
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/dofs/dof_renumbering.h>
+#include <deal.II/lac/constraint_matrix.h>
+
+#include "create_mesh.h"
+
+
+
+template <int dim, typename Number>
+void setup (const DoFHandler<dim>  &dof,
+            MatrixFree<dim,Number> &mf_data)
+{
+  ConstraintMatrix constraints;
+  DoFTools::make_hanging_node_constraints (dof, constraints);
+  constraints.close();
+
+  typename MatrixFree<dim,Number>::AdditionalData data;
+  data.tasks_parallel_scheme = MatrixFree<dim,Number>::AdditionalData::none;
+  mf_data.reinit (dof, constraints, QGauss<1>(3), data);
+}
+
+
+
+template <int dim, typename Number>
+void test ()
+{
+  Triangulation<dim> tria;
+  create_mesh (tria);
+  tria.refine_global(4-dim);
+
+  // refine a few cells
+  for (unsigned int i=0; i<10-3*dim; ++i)
+    {
+      typename Triangulation<dim>::active_cell_iterator
+      cell = tria.begin_active (),
+      endc = tria.end();
+      unsigned int counter = 0;
+      for (; cell!=endc; ++cell, ++counter)
+        if (counter % (7-i) == 0)
+          cell->set_refine_flag();
+      tria.execute_coarsening_and_refinement();
+    }
+
+  FE_Q<dim> fe (2);
+  DoFHandler<dim> dof (tria);
+  dof.distribute_dofs(fe);
+
+  MatrixFree<dim,Number> mf_data;
+  setup (dof, mf_data);
+
+  DoFRenumbering::matrix_free_data_locality (dof, mf_data);
+  setup (dof, mf_data);
+
+  std::vector<types::global_dof_index> renumbering (dof.n_dofs());
+  DoFRenumbering::compute_matrix_free_data_locality (renumbering, dof, mf_data);
+  bool is_identity = true;
+  for (unsigned int i=0; i<renumbering.size(); ++i)
+    if (renumbering[i] != i)
+      is_identity = false;
+  deallog << "Numbering unchanged: " << (is_identity ? "yes" : "no")
+          << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  deallog.push("2d");
+  test<2,double>();
+  deallog.pop();
+  deallog.push("3d");
+  test<3,float>();
+  deallog.pop();
+}
@@ -0,0 +1,156 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// compares the sparse matrix-vector product and the matrix-free operator
+// evaluation before and after DoFRenumbering::hilbert_curve and
+// DoFRenumbering::matrix_free_data_locality, respectively. The input vector
+// is interpolated from the same function in all cases, so the norm of the
+// result must not depend on the numbering. The run times before and after
+// the renumbering are printed to the screen, not to the output file.
+
+#include "../tests.h"
+
+#include <deal.II/base/function_lib.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/timer.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/dofs/dof_renumbering.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/numerics/matrix_tools.h>
+#include <deal.II/numerics/vector_tools.h>
+
+#include "matrix_vector_mf.h"
+
+
+const unsigned int n_repeat = 20;
+
+
+
+template <int dim>
+double sparse_vmult (const DoFHandler<dim> &dof,
+                     const std::string     &name)
+{
+  DynamicSparsityPattern dsp (dof.n_dofs());
+  DoFTools::make_sparsity_pattern (dof, dsp);
+  SparsityPattern sparsity;
+  sparsity.copy_from (dsp);
+  SparseMatrix<double> matrix (sparsity);
+  MatrixCreator::create_laplace_matrix (dof, QGauss<dim>(3), matrix);
+
+  Vector<double> src (dof.n_dofs()), dst (dof.n_dofs());
+  VectorTools::interpolate (dof, Functions::CosineFunction<dim>(), src);
+
+  Timer timer;
+  for (unsigned int i=0; i<n_repeat; ++i)
+    matrix.vmult (dst, src);
+  std::cout << "SparseMatrix::vmult, " << name << ": "
+            << timer.wall_time()/n_repeat << "s" << std::endl;
+
+  return dst.l2_norm();
+}
+
+
+
+template <int dim>
+void setup (const DoFHandler<dim>  &dof,
+            MatrixFree<dim,double> &mf_data)
+{
+  ConstraintMatrix constraints;
+  constraints.close();
+
+  typename MatrixFree<dim,double>::AdditionalData data;
+  data.tasks_parallel_scheme = MatrixFree<dim,double>::AdditionalData::none;
+  mf_data.reinit (dof, constraints, QGauss<1>(3), data);
+}
+
+
+
+template <int dim>
+double matrix_free_vmult (const DoFHandler<dim>        &dof,
+                          const MatrixFree<dim,double> &mf_data,
+                          const std::string            &name)
+{
+  MatrixFreeTest<dim,2,double> mf (mf_data);
+
+  Vector<double> src (dof.n_dofs()), dst (dof.n_dofs());
+  VectorTools::interpolate (dof, Functions::CosineFunction<dim>(), src);
+
+  Timer timer;
+  for (unsigned int i=0; i<n_repeat; ++i)
+    mf.vmult (dst, src);
+  std::cout << "MatrixFree vmult, " << name << ": "
+            << timer.wall_time()/n_repeat << "s" << std::endl;
+
+  return dst.l2_norm();
+}
+
+
+
+template <int dim>
+void test (const unsigned int n_refinements)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (n_refinements);
+
+  FE_Q<dim> fe (2);
+  DoFHandler<dim> dof (tria);
+  dof.distribute_dofs (fe);
+  deallog << "Number of degrees of freedom: " << dof.n_dofs() << std::endl;
+
+  {
+    const double before = sparse_vmult (dof, "default numbering");
+    DoFRenumbering::hilbert_curve (dof);
+    const double after = sparse_vmult (dof, "Hilbert curve numbering");
+    deallog << "SparseMatrix::vmult, norm of result unchanged: "
+            << (std::abs(before-after) < 1e-12*before ? "yes" : "no")
+            << std::endl;
+  }
+
+  dof.distribute_dofs (fe);
+  {
+    MatrixFree<dim,double> mf_data;
+    setup (dof, mf_data);
+    const double before = matrix_free_vmult (dof, mf_data, "default numbering");
+    DoFRenumbering::matrix_free_data_locality (dof, mf_data);
+    setup (dof, mf_data);
+    const double after = matrix_free_vmult (dof, mf_data, "data locality numbering");
+    deallog << "MatrixFree vmult, norm of result unchanged: "
+            << (std::abs(before-after) < 1e-12*before ? "yes" : "no")
+            << std::endl;
+  }
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  deallog.push ("2d");
+  test<2> (6);
+  deallog.pop ();
+  deallog.push ("3d");
+  test<3> (4);
+  deallog.pop ();
+}
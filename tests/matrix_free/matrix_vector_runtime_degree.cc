@@ -0,0 +1,151 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// compares the matrix-vector product of FEEvaluation with the polynomial
+// degree given as a template argument to the one with fe_degree=-1 where the
+// kernels are selected at run time, for symmetric and non-symmetric shape
+// functions, degrees up to 12 that are dispatched to precompiled kernels as
+// well as for combinations of degrees and quadrature points that use the
+// kernels with variable loop bounds. The run times of the two variants are
+// printed to the screen, not to the output file.
+
+#include "../tests.h"
+
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/timer.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_dgp.h>
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_q_dg0.h>
+#include <deal.II/lac/constraint_matrix.h>
+
+#include "matrix_vector_mf.h"
+
+
+template <int dim, int fe_degree, int n_q_points_1d>
+void do_test (const FiniteElement<dim> &fe)
+{
+  typedef double number;
+  typedef Vector<number> VectorType;
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global(dim == 2 ? 2 : 1);
+
+  DoFHandler<dim> dof (tria);
+  dof.distribute_dofs(fe);
+  ConstraintMatrix constraints;
+  constraints.close();
+
+  MatrixFree<dim,number> mf_data;
+  {
+    typename MatrixFree<dim,number>::AdditionalData data;
+    data.tasks_parallel_scheme = MatrixFree<dim,number>::AdditionalData::none;
+    mf_data.reinit (dof, constraints, QGauss<1>(n_q_points_1d), data);
+  }
+
+  MatrixFreeTest<dim,fe_degree,number,VectorType,n_q_points_1d> mf_template (mf_data);
+  MatrixFreeTest<dim,-1,number,VectorType,n_q_points_1d> mf_runtime (mf_data);
+
+  VectorType src(dof.n_dofs()), result_template(src), result_runtime(src);
+  for (unsigned int i=0; i<src.size(); ++i)
+    src(i) = random_value<double>();
+
+  const unsigned int n_repeat = 10;
+  Timer timer;
+  for (unsigned int i=0; i<n_repeat; ++i)
+    mf_template.vmult(result_template, src);
+  const double time_template = timer.wall_time();
+  timer.restart();
+  for (unsigned int i=0; i<n_repeat; ++i)
+    mf_runtime.vmult(result_runtime, src);
+  const double time_runtime = timer.wall_time();
+  std::cout << fe.get_name() << " n_q_points_1d=" << n_q_points_1d
+            << ": template " << time_template/n_repeat << "s, run time degree "
+            << time_runtime/n_repeat << "s" << std::endl;
+
+  result_runtime -= result_template;
+  deallog << fe.get_name() << " n_q_points_1d=" << n_q_points_1d
+          << ": error " << result_runtime.linfty_norm() / result_template.linfty_norm()
+          << std::endl;
+}
+
+
+
+// nodes that are not symmetric about the midpoint of the unit interval
+Quadrature<1> non_symmetric_nodes (const unsigned int n_points)
+{
+  const QGaussLobatto<1> gl(n_points);
+  std::vector<Point<1> > points(n_points);
+  for (unsigned int i=0; i<n_points; ++i)
+    points[i][0] = std::pow(gl.point(i)[0], 1.2);
+  return Quadrature<1>(points);
+}
+
+
+
+template <int dim, int fe_degree>
+void test ()
+{
+  do_test<dim,fe_degree,fe_degree+1>(FE_Q<dim>(fe_degree));
+  do_test<dim,fe_degree,fe_degree+2>(FE_Q<dim>(fe_degree));
+  do_test<dim,fe_degree,fe_degree+1>(FE_DGQArbitraryNodes<dim>(non_symmetric_nodes(fe_degree+1)));
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  deallog.push("2d");
+  test<2,1>();
+  test<2,2>();
+  test<2,3>();
+  test<2,4>();
+  test<2,5>();
+  test<2,6>();
+  test<2,7>();
+  test<2,8>();
+  test<2,9>();
+  test<2,10>();
+  test<2,11>();
+  test<2,12>();
+
+  // fallback with variable loop bounds
+  do_test<2,13,14>(FE_Q<2>(13));
+  do_test<2,3,7>(FE_Q<2>(3));
+  do_test<2,4,4>(FE_Q<2>(4));
+  do_test<2,3,7>(FE_DGQArbitraryNodes<2>(non_symmetric_nodes(4)));
+
+  // other element types
+  do_test<2,3,4>(FE_DGP<2>(3));
+  do_test<2,3,4>(FE_Q_DG0<2>(3));
+  deallog.pop();
+
+  deallog.push("3d");
+  test<3,1>();
+  test<3,2>();
+  test<3,3>();
+  test<3,4>();
+  do_test<3,3,6>(FE_Q<3>(3));
+  do_test<3,2,3>(FE_Q_DG0<3>(2));
+  deallog.pop();
+}
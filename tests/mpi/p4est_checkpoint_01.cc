@@ -0,0 +1,218 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// write a checkpoint of a triangulation with one solution vector and with
+// additional data whose size varies from cell to cell, and read it back on
+// all processes, with and without autopartitioning, as well as on only one
+// and two of the processes that wrote it
+
+#include "../tests.h"
+#include <deal.II/grid/tria.h>
+#include <deal.II/distributed/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/base/function.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/distributed/solution_transfer.h>
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+
+
+template <int dim>
+void
+pack_level (const typename parallel::distributed::Triangulation<dim>::cell_iterator &cell,
+            std::vector<char>                                                        &data)
+{
+  // store level+1 bytes, so that the data size varies between cells
+  data.insert (data.end(), cell->level()+1, static_cast<char>(cell->level()));
+}
+
+
+
+// the solution is interpolated from this function, so that it can be checked
+// independently of the numbering of the degrees of freedom, which depends on
+// the partition
+template <int dim>
+class LinearFunction : public Function<dim>
+{
+public:
+  virtual double value (const Point<dim>   &p,
+                        const unsigned int  /*component*/) const
+  {
+    double value = 0;
+    for (unsigned int d=0; d<dim; ++d)
+      value += (d+1) * p[d];
+    return value;
+  }
+};
+
+
+
+template <int dim>
+void save (const std::string &filename)
+{
+  parallel::distributed::Triangulation<dim> tr(MPI_COMM_WORLD);
+
+  GridGenerator::hyper_cube(tr);
+  tr.refine_global(2);
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tr.begin_active();
+       cell != tr.end(); ++cell)
+    if (cell->is_locally_owned() && cell->center().norm() < 0.3)
+      cell->set_refine_flag();
+  tr.execute_coarsening_and_refinement ();
+
+  FE_Q<dim> fe(1);
+  DoFHandler<dim> dh(tr);
+  dh.distribute_dofs(fe);
+
+  IndexSet locally_relevant_dofs;
+  DoFTools::extract_locally_relevant_dofs (dh, locally_relevant_dofs);
+
+  LinearAlgebra::distributed::Vector<double> solution(dh.locally_owned_dofs(),
+                                                      locally_relevant_dofs,
+                                                      MPI_COMM_WORLD);
+  VectorTools::interpolate (dh, LinearFunction<dim>(), solution);
+  solution.update_ghost_values();
+
+  parallel::distributed::SolutionTransfer<dim,LinearAlgebra::distributed::Vector<double> > soltrans(dh);
+  soltrans.prepare_checkpoint (solution);
+  tr.register_checkpoint_data_attach (&pack_level<dim>);
+
+  tr.save_checkpoint(filename);
+
+  deallog << "#cells = " << tr.n_global_active_cells() << std::endl;
+}
+
+
+
+// load the checkpoint on the first n_processes processes
+template <int dim>
+void load (const std::string  &filename,
+           const unsigned int  n_processes,
+           const bool          autopartition)
+{
+  const unsigned int myid = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+  MPI_Comm comm;
+  MPI_Comm_split (MPI_COMM_WORLD, myid < n_processes ? 0 : MPI_UNDEFINED,
+                  myid, &comm);
+
+  if (myid < n_processes)
+    {
+      parallel::distributed::Triangulation<dim> tr(comm);
+
+      GridGenerator::hyper_cube(tr);
+      tr.load_checkpoint(filename, autopartition);
+
+      FE_Q<dim> fe(1);
+      DoFHandler<dim> dh(tr);
+      dh.distribute_dofs(fe);
+
+      IndexSet locally_relevant_dofs;
+      DoFTools::extract_locally_relevant_dofs (dh, locally_relevant_dofs);
+
+      LinearAlgebra::distributed::Vector<double> solution(dh.locally_owned_dofs(),
+                                                          locally_relevant_dofs,
+                                                          comm);
+      parallel::distributed::SolutionTransfer<dim,LinearAlgebra::distributed::Vector<double> > soltrans(dh);
+      soltrans.restore_checkpoint(solution);
+
+      unsigned int n_wrong_cells = 0;
+      tr.notify_ready_to_unpack_checkpoint
+      ([&](const typename parallel::distributed::Triangulation<dim>::cell_iterator &cell,
+           const char *begin,
+           const char *end)
+      {
+        if (end-begin != cell->level()+1 ||
+            std::count(begin, end, static_cast<char>(cell->level())) != end-begin)
+          ++n_wrong_cells;
+      });
+
+      LinearAlgebra::distributed::Vector<double> reference(dh.locally_owned_dofs(),
+                                                           comm);
+      VectorTools::interpolate (dh, LinearFunction<dim>(), reference);
+      unsigned int n_wrong_dofs = 0;
+      for (const types::global_dof_index idx : dh.locally_owned_dofs())
+        if (std::abs (solution(idx) - reference(idx)) > 1e-12)
+          ++n_wrong_dofs;
+
+      n_wrong_cells = Utilities::MPI::sum (n_wrong_cells, comm);
+      n_wrong_dofs = Utilities::MPI::sum (n_wrong_dofs, comm);
+      deallog << "#cells = " << tr.n_global_active_cells() << std::endl;
+      deallog << "wrong cell data: " << n_wrong_cells << std::endl;
+      deallog << "wrong vector entries: " << n_wrong_dofs << std::endl;
+
+      MPI_Comm_free (&comm);
+    }
+  MPI_Barrier(MPI_COMM_WORLD);
+}
+
+
+
+template <int dim>
+void test()
+{
+  const unsigned int n_procs = Utilities::MPI::n_mpi_processes (MPI_COMM_WORLD);
+  const std::string filename = "checkpoint";
+
+  save<dim> (filename);
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  deallog.push ("same partition");
+  load<dim> (filename, n_procs, false);
+  deallog.pop ();
+
+  deallog.push ("autopartition");
+  load<dim> (filename, n_procs, true);
+  deallog.pop ();
+
+  deallog.push ("one process");
+  load<dim> (filename, 1, false);
+  deallog.pop ();
+
+  deallog.push ("two processes");
+  load<dim> (filename, std::min (n_procs, 2U), false);
+  deallog.pop ();
+
+  deallog << "OK" << std::endl;
+}
+
+
+int main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, 1);
+
+  const unsigned int myid = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+  deallog.push(Utilities::int_to_string(myid));
+  if (myid == 0)
+    initlog();
+
+  deallog.push("2d");
+  test<2>();
+  deallog.pop();
+
+  deallog.push("3d");
+  test<3>();
+  deallog.pop();
+}
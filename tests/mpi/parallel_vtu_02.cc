@@ -0,0 +1,103 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check DataOutInterface::write_vtu_in_parallel with different numbers of
+// aggregators: every process writes the same data, so the file must consist
+// of the header, one copy of the piece per process, and the footer
+
+#include "../tests.h"
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/numerics/data_out.h>
+
+#include <sstream>
+
+
+
+template <int dim>
+void test()
+{
+  const unsigned int myid = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+  const unsigned int n_procs = Utilities::MPI::n_mpi_processes (MPI_COMM_WORLD);
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (3);
+  DoFHandler<dim> dof_handler (tria);
+  FE_Q<dim> fe (1);
+  dof_handler.distribute_dofs (fe);
+
+  Vector<double> x (dof_handler.n_dofs());
+  for (unsigned int i=0; i<x.size(); ++i)
+    x(i) = i;
+
+  DataOut<dim> data_out;
+  DataOutBase::VtkFlags flags;
+  flags.print_date_and_time = false;
+  data_out.set_flags (flags);
+  data_out.attach_dof_handler (dof_handler);
+  data_out.add_data_vector (x, "x");
+  data_out.build_patches ();
+
+  // split the serial output into header, piece, and footer
+  std::ostringstream serial;
+  data_out.write_vtu (serial);
+  const std::string::size_type header_end
+    = serial.str().find ("<UnstructuredGrid>\n") + std::string("<UnstructuredGrid>\n").size();
+  const std::string::size_type footer_begin
+    = serial.str().find (" </UnstructuredGrid>");
+  std::string expected = serial.str().substr (0, header_end);
+  for (unsigned int p=0; p<n_procs; ++p)
+    expected += serial.str().substr (header_end, footer_begin-header_end);
+  expected += serial.str().substr (footer_begin);
+
+  for (unsigned int n_aggregators=0; n_aggregators<=2; ++n_aggregators)
+    {
+      const DataOutBase::ParallelWriteStatistics statistics
+        = data_out.write_vtu_in_parallel ("output.vtu", MPI_COMM_WORLD,
+                                          n_aggregators);
+
+      if (myid == 0)
+        {
+          std::ifstream in ("output.vtu");
+          std::ostringstream file;
+          file << in.rdbuf();
+
+          deallog << "Requested aggregators: " << n_aggregators
+                  << ", used: " << statistics.n_aggregators
+                  << ", size ok: "
+                  << (statistics.n_bytes == expected.size() ? "yes" : "no")
+                  << ", contents ok: "
+                  << (file.str() == expected ? "yes" : "no")
+                  << std::endl;
+        }
+      MPI_Barrier (MPI_COMM_WORLD);
+    }
+}
+
+
+
+int main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, 1);
+  MPILogInitAll log;
+
+  test<2>();
+}
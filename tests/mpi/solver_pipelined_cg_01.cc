@@ -0,0 +1,139 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// compare SolverPipelinedCG with SolverCG for LinearAlgebra::distributed::Vector
+// on several processes, where the reductions are non-blocking, and check
+// that the statistics only record overlapped computations when a reduction
+// was actually outstanding
+
+#include "../tests.h"
+#include <deal.II/base/index_set.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_pipelined_cg.h>
+#include <deal.II/lac/precondition.h>
+
+
+// a one-dimensional finite difference operator with a reaction term,
+// distributed by contiguous ranges of rows
+class DiffusionReactionOperator
+{
+public:
+  DiffusionReactionOperator (const IndexSet &locally_owned,
+                             const IndexSet &ghosts,
+                             const MPI_Comm  communicator)
+    :
+    ghosted (locally_owned, ghosts, communicator)
+  {}
+
+  void vmult (LinearAlgebra::distributed::Vector<double>       &dst,
+              const LinearAlgebra::distributed::Vector<double> &src) const
+  {
+    ghosted.copy_locally_owned_data_from (src);
+    ghosted.update_ghost_values ();
+    const types::global_dof_index n = src.size();
+    for (const types::global_dof_index i : src.locally_owned_elements())
+      dst(i) = 2.5 * ghosted(i)
+               - (i > 0 ? ghosted(i-1) : 0.)
+               - (i+1 < n ? ghosted(i+1) : 0.);
+  }
+
+private:
+  mutable LinearAlgebra::distributed::Vector<double> ghosted;
+};
+
+
+
+void test ()
+{
+  const MPI_Comm comm = MPI_COMM_WORLD;
+  const unsigned int myid = Utilities::MPI::this_mpi_process (comm);
+  const unsigned int n_procs = Utilities::MPI::n_mpi_processes (comm);
+
+  const types::global_dof_index n = 1000;
+  const types::global_dof_index begin = n*myid/n_procs, end = n*(myid+1)/n_procs;
+  IndexSet locally_owned (n), ghosts (n);
+  locally_owned.add_range (begin, end);
+  if (begin > 0)
+    ghosts.add_index (begin-1);
+  if (end < n)
+    ghosts.add_index (end);
+
+  const DiffusionReactionOperator A (locally_owned, ghosts, comm);
+  LinearAlgebra::distributed::Vector<double> f (locally_owned, comm);
+  for (const types::global_dof_index i : locally_owned)
+    f(i) = 1. + 0.001 * i;
+
+  LinearAlgebra::distributed::Vector<double> u_cg, u_pipelined;
+  u_cg.reinit (f);
+  u_pipelined.reinit (f);
+
+  SolverControl control_cg (100, 1e-10);
+  control_cg.log_result (false);
+  SolverCG<LinearAlgebra::distributed::Vector<double> > solver_cg (control_cg);
+  solver_cg.solve (A, u_cg, f, PreconditionIdentity());
+
+  SolverControl control_pipelined (100, 1e-10);
+  control_pipelined.log_result (false);
+  SolverPipelinedCG<LinearAlgebra::distributed::Vector<double> >
+  solver_pipelined (control_pipelined);
+  solver_pipelined.solve (A, u_pipelined, f, PreconditionIdentity());
+
+  const unsigned int it_cg = control_cg.last_step();
+  const unsigned int it_pipelined = control_pipelined.last_step();
+  deallog << "Iteration counts agree: "
+          << ((it_cg > it_pipelined ? it_cg-it_pipelined : it_pipelined-it_cg) <= 1 ?
+              "yes" : "no")
+          << std::endl;
+
+  u_pipelined -= u_cg;
+  deallog << "Solutions agree: "
+          << (u_pipelined.linfty_norm() < 1e-8 * u_cg.linfty_norm() ? "yes" : "no")
+          << std::endl;
+
+  // the reductions are only outstanding during the computations if they are
+  // non-blocking, which requires MPI 3.0 and more than one process
+  const SolverPipelinedCG<LinearAlgebra::distributed::Vector<double> >::
+  ReductionStatistics &statistics = solver_pipelined.get_reduction_statistics();
+#if MPI_VERSION >= 3
+  const bool non_blocking = (n_procs > 1);
+#else
+  const bool non_blocking = false;
+#endif
+  deallog << "Number of reductions equals iterations plus one: "
+          << (statistics.n_reductions == it_pipelined+1 ? "yes" : "no")
+          << std::endl;
+  deallog << "Overlapped computations recorded as expected: "
+          << ((statistics.overlapped_compute_time > 0.) == non_blocking ?
+              "yes" : "no")
+          << std::endl;
+  deallog << "Hidden fraction within [0,1]: "
+          << (statistics.hidden_fraction() >= 0. &&
+              statistics.hidden_fraction() <= 1. ? "yes" : "no")
+          << std::endl;
+}
+
+
+
+int main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, 1);
+  MPILogInitAll log;
+
+  test ();
+}
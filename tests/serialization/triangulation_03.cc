@@ -0,0 +1,206 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// check that archives of a Triangulation written before the per-object
+// flags were stored as bytes (serialization version 0, taken from the
+// output of triangulation_01) can still be read
+
+#include "serialization.h"
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+
+namespace dealii
+{
+  template <int dim, int spacedim>
+  bool operator == (const Triangulation<dim,spacedim> &t1,
+                    const Triangulation<dim,spacedim> &t2)
+  {
+    // test a few attributes, though we can't
+    // test everything unfortunately...
+    if (t1.n_active_cells() != t2.n_active_cells())
+      return false;
+
+    if (t1.n_cells() != t2.n_cells())
+      return false;
+
+    if (t1.n_faces() != t2.n_faces())
+      return false;
+
+    typename Triangulation<dim,spacedim>::cell_iterator
+    c1 = t1.begin(),
+    c2 = t2.begin();
+    for (; (c1 != t1.end()) && (c2 != t2.end()); ++c1, ++c2)
+      {
+        for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+          {
+            if (c1->vertex(v) != c2->vertex(v))
+              return false;
+            if (c1->vertex_index(v) != c2->vertex_index(v))
+              return false;
+          }
+
+        for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+          {
+            if (c1->face(f)->at_boundary() != c2->face(f)->at_boundary())
+              return false;
+
+            if (c1->face(f)->manifold_id() != c2->face(f)->manifold_id())
+              return false;
+
+            if (c1->face(f)->at_boundary())
+              {
+                if (c1->face(f)->boundary_id() !=
+                    c2->face(f)->boundary_id())
+                  return false;
+              }
+            else
+              {
+                if (c1->neighbor(f)->level() != c2->neighbor(f)->level())
+                  return false;
+                if (c1->neighbor(f)->index() != c2->neighbor(f)->index())
+                  return false;
+              }
+          }
+
+        if (c1->active() && c2->active()
+            && (c1->subdomain_id() != c2->subdomain_id()))
+          return false;
+
+        if (c1->level_subdomain_id() != c2->level_subdomain_id())
+          return false;
+
+        if (c1->material_id() != c2->material_id())
+          return false;
+
+        if (c1->user_index() != c2->user_index())
+          return false;
+
+        if (c1->user_flag_set() != c2->user_flag_set())
+          return false;
+
+        if (c1->manifold_id() != c2->manifold_id())
+          return false;
+
+        if (c1->active() && c2->active())
+          if (c1->active_cell_index() != c2->active_cell_index())
+            return false;
+
+        if (c1->level()>0)
+          if (c1->parent_index() != c2->parent_index())
+            return false;
+      }
+
+    // also check the order of raw iterators as they contain
+    // something about the history of the triangulation
+    typename Triangulation<dim,spacedim>::cell_iterator
+    r1 = t1.begin(),
+    r2 = t2.begin();
+    for (; (r1 != t1.end()) && (r2 != t2.end()); ++r1, ++r2)
+      {
+        if (r1->level() != r2->level())
+          return false;
+        if (r1->index() != r2->index())
+          return false;
+      }
+
+    return true;
+  }
+}
+
+
+template <int dim, int spacedim>
+void do_boundary (Triangulation<dim,spacedim> &t1)
+{
+  typename Triangulation<dim,spacedim>::cell_iterator
+  c1 = t1.begin();
+  for (; c1 != t1.end(); ++c1)
+    for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+      if (c1->at_boundary(f))
+        c1->face(f)->set_boundary_id (42);
+}
+
+
+template <int spacedim>
+void do_boundary (Triangulation<1,spacedim> &)
+{}
+
+
+template <int dim, int spacedim>
+void test (const std::string &old_archive)
+{
+  Triangulation<dim,spacedim> tria_1, tria_2;
+
+  GridGenerator::hyper_cube (tria_1);
+  tria_1.refine_global (2);
+  tria_1.begin_active()->set_subdomain_id (1);
+  tria_1.begin_active()->set_level_subdomain_id (4);
+  tria_1.begin_active()->set_material_id (2);
+  tria_1.begin_active()->set_user_index (3);
+  tria_1.begin_active()->set_user_flag ();
+  tria_1.begin_active()->set_refine_flag (RefinementCase<dim>::cut_x);
+
+  do_boundary (tria_1);
+
+  std::istringstream iss (old_archive);
+  boost::archive::text_iarchive ia (iss, boost::archive::no_header);
+  ia >> tria_2;
+
+  AssertThrow (tria_1 == tria_2, ExcInternalError());
+
+  unsigned int n_user_flags = 0;
+  for (typename Triangulation<dim,spacedim>::cell_iterator
+       cell = tria_2.begin(); cell != tria_2.end(); ++cell)
+    if (cell->user_flag_set())
+      ++n_user_flags;
+
+  deallog << "dim=" << dim << ", spacedim=" << spacedim
+          << ": " << tria_2.n_cells() << " cells, "
+          << tria_2.n_used_vertices() << " used vertices, "
+          << n_user_flags << " user flags set" << std::endl;
+}
+
+
+// archive of the 1d mesh of triangulation_01
+const char *archive_1d = R"(0 0 0 3 0 0 2 1 0
+0 1 0 0 1 0 0 0 2 0 0 0 -1 -1 -1 -1 1 0 0 1 0 0 1 0 -1 0 0 0 0 0 1 0 0 0 2 0 1 1 0 0 0 0 0 0 1 1 1 0 0 0 1 0 0 0 0 1 0 4294967295 0 0 1 0 0 1 0 0 0 0 0 2
+1 2 0 0 0 2 0 0 4 0 -1 -1 1 1 1 0 -1 -1 2 0 0 0 2 0 0 0 1 0 0 0 2 0 2 0 2 2 2 1 2 0 0 2 0 0 2 1 1 2 0 0 2 0 0 0 2 0 4294967295 4294967295 1 0 1 2 0 0 0 0 2
+2 4 0 1 0 0 0 4 0 0 0 0 8 0 -1 -1 2 1 2 0 2 2 2 1 2 3 2 2 -1 -1 4 0 1 0 0 0 4 0 4 0 0 0 2 0 0 1 0 4 0 2 0 3 2 3 2 2 2 4 2 4 1 4 0 -1 -1 -1 -1 0 0 4 1 1 1 1 4 1 0 0 0 4 0 2 0 0 0 4 0 4294967295 4294967295 4294967295 4294967295 3 0 1 4 0 3 0 0 0 2 1 0 0 5 0 0 0 0 0 1 0 0 0.00000000000000000e+00 1 1.00000000000000000e+00 1 5.00000000000000000e-01 1 2.50000000000000000e-01 1 7.50000000000000000e-01 5 1 1 1 1 1 0 0 0 3 7 3 0 1 2 4 4 3 0 0 0 4 0 0 0 23 1 0
+3 2 0 0 0 0 0 1 1 23
+4 5 0 0 4294967295 1 4294967295 2 4294967295 3 4294967295 4 4294967295
+)";
+
+// archive of the 2d mesh of triangulation_01
+const char *archive_2d = R"(0 0 0 3 0 0 2 1 0
+0 1 0 0 1 0 0 0 4 0 0 0 -1 -1 -1 -1 -1 -1 -1 -1 1 0 0 1 0 0 1 0 -1 0 0 0 0 0 1 0 0 0 4 1 2 0 3 2 0 0 2 0 0 1 0 0 0 3 1 1 1 0 0 0 1 0 0 0 0 1 0 4294967295 0 0 1 0 0 1 0 0 0 0 0 2
+1 4 0 0 0 0 0 4 0 0 0 0 16 0 -1 -1 1 1 -1 -1 1 2 1 0 -1 -1 -1 -1 1 3 -1 -1 1 3 1 0 -1 -1 1 2 -1 -1 1 1 -1 -1 4 0 0 0 0 0 4 0 0 0 0 0 2 0 0 0 0 4 0 4 6 12 4 14 4 12 8 5 15 4 7 13 14 10 4 13 9 15 11 8 0 0 2 4 6 8 10 12 14 4 0 3 3 3 3 4 1 1 1 1 4 0 0 0 0 4 0 0 0 0 0 4 0 4294967295 4294967295 4294967295 4294967295 3 0 1 4 0 0 0 0 0 0 2
+2 16 0 1 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 16 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 64 0 -1 -1 2 1 -1 -1 2 2 2 0 2 4 -1 -1 2 3 -1 -1 2 3 2 0 2 8 2 2 2 6 2 1 2 9 2 1 2 5 -1 -1 2 6 2 4 -1 -1 -1 -1 2 7 2 3 2 7 2 4 2 12 2 6 -1 -1 2 5 2 13 -1 -1 2 9 2 2 2 10 2 8 2 12 2 3 2 11 -1 -1 2 11 2 8 -1 -1 2 10 2 14 2 9 -1 -1 2 9 2 13 2 6 2 14 2 12 -1 -1 2 7 2 15 2 11 2 15 2 12 -1 -1 2 14 -1 -1 2 13 -1 -1 16 0 1 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 16 0 4 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 8 0 0 0 1 1 2 2 3 3 0 16 0 4 20 40 16 42 4 40 32 17 43 4 21 41 42 36 4 41 33 43 37 4 32 44 18 46 4 44 24 19 47 4 33 45 46 38 4 45 25 47 39 4 22 48 36 50 4 48 34 37 51 4 23 49 50 28 4 49 35 51 29 4 34 52 38 54 4 52 26 39 55 4 35 53 54 30 4 53 27 55 31 32 0 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 16 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 16 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 16 1 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 16 0 2 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 16 0 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 15 0 1 16 0 3 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 2 0 0 0 19 1 0
+3 0 0 0 0 56 0 0 0 2 0 1 2 0 2 2 1 3 2 2 3 2 0 4 2 4 1 2 0 5 2 5 2 2 1 6 2 6 3 2 2 7 2 7 3 2 4 8 2 8 7 2 5 8 2 8 6 2 0 9 2 9 4 2 4 10 2 10 1 2 0 11 2 11 5 2 5 12 2 12 2 2 1 13 2 13 6 2 6 14 2 14 3 2 2 15 2 15 7 2 7 16 2 16 3 2 4 17 2 17 8 2 8 18 2 18 7 2 5 19 2 19 8 2 8 20 2 20 6 2 9 21 2 21 19 2 11 21 2 21 17 2 10 22 2 22 20 2 17 22 2 22 13 2 19 23 2 23 15 2 12 23 2 23 18 2 20 24 2 24 16 2 18 24 2 24 14 56 0 4 6 8 10 16 18 20 22 24 26 28 30 32 34 36 38 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 -1 0 0 0 0 56 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 56 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 56 0 0 0 42 42 42 42 42 42 42 42 42 42 42 42 4294967295 4294967295 4294967295 4294967295 42 42 42 42 42 42 42 42 42 42 42 42 42 42 42 42 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 56 0 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 4294967295 55 0 1 0 0 56 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 25 0 0 0 0 0 2 0 0 0.00000000000000000e+00 0.00000000000000000e+00 2 1.00000000000000000e+00 0.00000000000000000e+00 2 0.00000000000000000e+00 1.00000000000000000e+00 2 1.00000000000000000e+00 1.00000000000000000e+00 2 5.00000000000000000e-01 0.00000000000000000e+00 2 0.00000000000000000e+00 5.00000000000000000e-01 2 1.00000000000000000e+00 5.00000000000000000e-01 2 5.00000000000000000e-01 1.00000000000000000e+00 2 5.00000000000000000e-01 5.00000000000000000e-01 2 2.50000000000000000e-01 0.00000000000000000e+00 2 7.50000000000000000e-01 0.00000000000000000e+00 2 0.00000000000000000e+00 2.50000000000000000e-01 2 0.00000000000000000e+00 7.50000000000000000e-01 2 1.00000000000000000e+00 2.50000000000000000e-01 2 1.00000000000000000e+00 7.50000000000000000e-01 2 2.50000000000000000e-01 1.00000000000000000e+00 2 7.50000000000000000e-01 1.00000000000000000e+00 2 5.00000000000000000e-01 2.50000000000000000e-01 2 5.00000000000000000e-01 7.50000000000000000e-01 2 2.50000000000000000e-01 5.00000000000000000e-01 2 7.50000000000000000e-01 5.00000000000000000e-01 2 2.50000000000000000e-01 2.50000000000000000e-01 2 7.50000000000000000e-01 2.50000000000000000e-01 2 2.50000000000000000e-01 7.50000000000000000e-01 2 7.50000000000000000e-01 7.50000000000000000e-01 25 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 0 0 0 3 56 0 0 40 0 0 21 3 0 1 4 16 16 3 0 0 0 16 0
+)";
+
+
+int main ()
+{
+  std::ofstream logfile("output");
+  deallog << std::setprecision(3);
+  deallog.attach(logfile);
+
+  test<1,1> (archive_1d);
+  test<2,2> (archive_2d);
+
+  deallog << "OK" << std::endl;
+}